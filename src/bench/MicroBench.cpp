@@ -0,0 +1,476 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <babeltrace/babeltrace.h>
+#include <babeltrace/ctf/events.h>
+#include <babeltrace/ctf/iterator.h>
+
+#include <common/trace/TraceSet.hpp>
+#include <common/trace/Event.hpp>
+#include <common/trace/EventValueFactory.hpp>
+#include <common/trace/EventValuePool.hpp>
+#include <common/trace/SintEventValue.hpp>
+#include <common/trace/DictEventValue.hpp>
+#include <common/state/StateHistorySink.hpp>
+#include <common/state/CurrentState.hpp>
+#include <common/state/StringDb.hpp>
+#include <common/mq/MqContext.hpp>
+#include <common/mq/MqMessage.hpp>
+#include <tibeebuild/rpc/BuilderJsonRpcMessageEncoder.hpp>
+#include <tibeebuild/rpc/ProgressUpdateRpcNotification.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+// minimum duration of a measured run
+const double MIN_RUN_SECONDS = 0.1;
+
+// measured runs per benchmark: the fastest one is kept
+const std::size_t RUNS = 5;
+
+// operations per event in trace benchmarks
+const std::size_t OPS_PER_EVENT = 16;
+
+// number of distinct state paths
+const std::size_t PATHS_COUNT = 1024;
+
+struct Result
+{
+    std::string name;
+    std::uint64_t ops;
+    double seconds;
+};
+
+// checksum to make sure nothing is optimized out
+std::uint64_t checksum = 0;
+
+double getSeconds(Clock::time_point begin, Clock::time_point end)
+{
+    return std::chrono::duration<double> {end - begin}.count();
+}
+
+double getNsPerOp(const Result& result)
+{
+    return result.ops == 0 ? 0 : result.seconds * 1e9 / result.ops;
+}
+
+Result makeResult(const std::string& name, std::uint64_t ops, double seconds)
+{
+    Result result {name, ops, seconds};
+
+    std::cerr << name << ": " << getNsPerOp(result) << " ns/op" << std::endl;
+
+    return result;
+}
+
+/*
+ * Calls batch(n), which must do n operations, doubling n until a call
+ * lasts at least MIN_RUN_SECONDS, then keeps the fastest of RUNS calls.
+ */
+template<typename BatchFunc>
+Result measure(const std::string& name, BatchFunc batch)
+{
+    std::uint64_t ops = 1;
+    double seconds;
+
+    for (;;) {
+        auto begin = Clock::now();
+
+        batch(ops);
+        seconds = getSeconds(begin, Clock::now());
+
+        if (seconds >= MIN_RUN_SECONDS) {
+            break;
+        }
+
+        ops *= 2;
+    }
+
+    for (std::size_t x = 1; x < RUNS; ++x) {
+        auto begin = Clock::now();
+
+        batch(ops);
+        seconds = std::min(seconds, getSeconds(begin, Clock::now()));
+    }
+
+    return makeResult(name, ops, seconds);
+}
+
+Result benchEventValuePoolGet()
+{
+    tibee::common::EventValuePool<tibee::common::SintEventValue> pool;
+
+    return measure("event-value-pool-get", [&pool] (std::uint64_t ops) {
+        for (std::uint64_t x = 0; x < ops; ++x) {
+            // typical event: a few dozen values, then a reset
+            if ((x & 31) == 0) {
+                pool.reset();
+            }
+
+            checksum += reinterpret_cast<std::uintptr_t>(pool.get());
+        }
+    });
+}
+
+/*
+ * Builds the fields dictionary of each event of the traces
+ * OPS_PER_EVENT times, straight from Babeltrace definitions.
+ */
+Result benchBuildEventValue(const std::vector<bfs::path>& tracesPaths)
+{
+    auto btCtx = ::bt_context_create();
+
+    for (const auto& path : tracesPaths) {
+        ::bt_context_add_trace(btCtx, path.string().c_str(), "ctf",
+                               nullptr, nullptr, nullptr);
+    }
+
+    ::bt_iter_pos beginPos;
+    beginPos.type = ::BT_SEEK_BEGIN;
+    beginPos.u.seek_time = 0;
+
+    auto btCtfIter = ::bt_ctf_iter_create(btCtx, &beginPos, nullptr);
+    tibee::common::EventValueFactory factory;
+    std::uint64_t ops = 0;
+    double seconds = 0;
+
+    for (auto btEvent = ::bt_ctf_iter_read_event(btCtfIter); btEvent;
+            btEvent = ::bt_ctf_iter_read_event(btCtfIter)) {
+        auto def = ::bt_ctf_get_top_level_scope(btEvent, ::BT_EVENT_FIELDS);
+
+        if (def) {
+            auto begin = Clock::now();
+
+            for (std::size_t x = 0; x < OPS_PER_EVENT; ++x) {
+                auto fields = factory.buildEventValue(def, btEvent)->asDict();
+
+                checksum += fields->size();
+            }
+
+            seconds += getSeconds(begin, Clock::now());
+            ops += OPS_PER_EVENT;
+            factory.resetPools();
+        }
+
+        if (::bt_iter_next(::bt_ctf_get_iter(btCtfIter)) < 0) {
+            break;
+        }
+    }
+
+    ::bt_ctf_iter_destroy(btCtfIter);
+    ::bt_context_put(btCtx);
+
+    return makeResult("build-event-value", ops, seconds);
+}
+
+/*
+ * Looks up the last field of each event by name (worst case of the
+ * linear search) OPS_PER_EVENT times.
+ */
+Result benchEventSubscript(tibee::common::TraceSet& traceSet)
+{
+    std::uint64_t ops = 0;
+    double seconds = 0;
+
+    for (auto& event : traceSet) {
+        auto fields = event.getFields();
+
+        if (!fields || fields->size() == 0) {
+            continue;
+        }
+
+        auto name = fields->getKeyName(fields->size() - 1);
+        auto begin = Clock::now();
+
+        for (std::size_t x = 0; x < OPS_PER_EVENT; ++x) {
+            checksum += reinterpret_cast<std::uintptr_t>(event[name]);
+        }
+
+        seconds += getSeconds(begin, Clock::now());
+        ops += OPS_PER_EVENT;
+    }
+
+    return makeResult("event-subscript", ops, seconds);
+}
+
+std::vector<std::string> getStatePaths()
+{
+    std::vector<std::string> paths;
+
+    // shaped like the paths of the Linux state provider
+    for (std::size_t x = 0; x < PATHS_COUNT; ++x) {
+        paths.push_back("linux/threads/" + std::to_string(1000 + x) + "/cpu");
+    }
+
+    return paths;
+}
+
+Result benchGetPathQuark(tibee::common::StateHistorySink& sink)
+{
+    auto paths = getStatePaths();
+    auto& state = sink.getCurrentState();
+
+    // only existing paths: the common case
+    for (const auto& path : paths) {
+        state.getPathQuark(path);
+    }
+
+    return measure("current-state-get-path-quark", [&] (std::uint64_t ops) {
+        for (std::uint64_t x = 0; x < ops; ++x) {
+            checksum += state.getPathQuark(paths[x % PATHS_COUNT]);
+        }
+    });
+}
+
+/*
+ * Each new state value closes the previous one: one interval is
+ * written per operation.
+ */
+Result benchSetState(tibee::common::StateHistorySink& sink)
+{
+    auto paths = getStatePaths();
+    auto& state = sink.getCurrentState();
+    std::vector<tibee::common::quark_t> quarks;
+
+    for (const auto& path : paths) {
+        quarks.push_back(state.getPathQuark(path));
+    }
+
+    tibee::common::timestamp_t ts = sink.getCurrentTimestamp();
+
+    return measure("state-history-set-state", [&] (std::uint64_t ops) {
+        for (std::uint64_t x = 0; x < ops; ++x) {
+            sink.setCurrentTimestamp(++ts);
+            state.setUint32State(quarks[x % PATHS_COUNT],
+                                 static_cast<std::uint32_t>(x));
+        }
+    });
+}
+
+/*
+ * Same steps as StateHistorySink::writeStringDb(), for a database of
+ * PATHS_COUNT paths.
+ */
+Result benchWriteStringDb(const bfs::path& dir)
+{
+    auto paths = getStatePaths();
+    std::vector<const std::string*> strings;
+
+    for (const auto& path : paths) {
+        strings.push_back(&path);
+    }
+
+    auto path = dir / "strings.db";
+    auto tmpPath = dir / "strings.db.tmp";
+
+    return measure("write-string-db", [&] (std::uint64_t ops) {
+        for (std::uint64_t x = 0; x < ops; ++x) {
+            std::vector<std::uint8_t> image;
+
+            tibee::common::StringDb::buildImage(strings, image);
+
+            bfs::ofstream output;
+
+            output.open(tmpPath, std::ios::binary);
+            output.write(reinterpret_cast<const char*>(image.data()),
+                         image.size());
+            output.close();
+            bfs::rename(tmpPath, path);
+            checksum += image.size();
+        }
+    });
+}
+
+Result benchEncodeProgress()
+{
+    tibee::BuilderJsonRpcMessageEncoder encoder;
+    tibee::ProgressUpdateRpcNotification notification;
+
+    notification.setProcessedEvents(123456789);
+    notification.setBeginTs(1400000000000000000ULL);
+    notification.setEndTs(1400000100000000000ULL);
+    notification.setCurTs(1400000042000000000ULL);
+    notification.setStateChanges(98765432);
+    notification.setTotalBytes(4000000000ULL);
+    notification.setCurBytes(1680000000ULL);
+    notification.setEstimatedEvents(300000000);
+    notification.setEventsRate(2345678.9);
+    notification.setStateChangesRate(1234567.8);
+    notification.setTracesPaths({"/home/user/lttng-traces/kernel"});
+    notification.setStateProvidersPaths({"/usr/lib/tibee/providers/linux.so"});
+
+    return measure("encode-progress-json", [&] (std::uint64_t ops) {
+        for (std::uint64_t x = 0; x < ops; ++x) {
+            checksum += encoder.encodeProgressUpdateRpcNotification(notification)->size();
+        }
+    });
+}
+
+/*
+ * Request/reply of a small message through in-process sockets.
+ */
+Result benchMqRoundTrip()
+{
+    tibee::common::MqContext context {1};
+    auto reply = context.createReplySocket();
+    auto request = context.createRequestSocket();
+    std::string payload(256, 'x');
+
+    reply->bind("inproc://tibee-microbench");
+    request->connect("inproc://tibee-microbench");
+
+    auto result = measure("mq-message-round-trip", [&] (std::uint64_t ops) {
+        for (std::uint64_t x = 0; x < ops; ++x) {
+            tibee::common::MqMessage::UP msg {
+                new tibee::common::MqMessage {payload.data(), payload.size()}
+            };
+
+            request->send(std::move(msg));
+            reply->send(reply->recv());
+            checksum += request->recv()->size();
+        }
+    });
+
+    request->close();
+    reply->close();
+
+    return result;
+}
+
+void printResults(const std::vector<Result>& results)
+{
+    std::cout << "{" << std::endl << "  \"benchmarks\": [";
+
+    for (std::size_t x = 0; x < results.size(); ++x) {
+        const auto& result = results[x];
+
+        std::cout << (x == 0 ? "" : ",") << std::endl <<
+                     "    {\"name\": \"" << result.name << "\", " <<
+                     "\"ops\": " << result.ops << ", " <<
+                     "\"seconds\": " << result.seconds << ", " <<
+                     "\"ns-per-op\": " << getNsPerOp(result) << "}";
+    }
+
+    std::cout << std::endl << "  ]," << std::endl <<
+                 "  \"checksum\": " << checksum << std::endl <<
+                 "}" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    std::vector<bfs::path> tracesPaths;
+
+    for (int x = 1; x < argc; ++x) {
+        if (std::strcmp(argv[x], "-f") == 0 && x + 1 < argc) {
+            filter = argv[++x];
+        } else if (argv[x][0] == '-') {
+            std::cerr << "usage: microbench [-f <name filter>] [<trace path>...]" <<
+                         std::endl;
+            return 1;
+        } else {
+            tracesPaths.push_back(bfs::path {argv[x]});
+        }
+    }
+
+    auto enabled = [&filter] (const char* name) {
+        return std::strstr(name, filter.c_str()) != nullptr;
+    };
+
+    std::vector<Result> results;
+
+    if (enabled("event-value-pool-get")) {
+        results.push_back(benchEventValuePoolGet());
+    }
+
+    // decoding benchmarks need real events
+    if (!tracesPaths.empty()) {
+        if (enabled("build-event-value")) {
+            results.push_back(benchBuildEventValue(tracesPaths));
+        }
+
+        if (enabled("event-subscript")) {
+            std::unique_ptr<tibee::common::TraceSet> traceSet {
+                new tibee::common::TraceSet
+            };
+
+            for (const auto& path : tracesPaths) {
+                if (!traceSet->addTrace(path)) {
+                    std::cerr << "Error: could not add trace " << path << std::endl;
+                    return 1;
+                }
+            }
+
+            results.push_back(benchEventSubscript(*traceSet));
+        }
+    }
+
+    auto dir = bfs::temp_directory_path() / bfs::unique_path("tibee-microbench-%%%%%%");
+
+    bfs::create_directories(dir);
+
+    {
+        tibee::common::StateHistorySink sink {
+            dir / "paths-quarks.db",
+            dir / "values-quarks.db",
+            dir / "history"
+        };
+
+        if (enabled("current-state-get-path-quark")) {
+            results.push_back(benchGetPathQuark(sink));
+        }
+
+        if (enabled("state-history-set-state")) {
+            results.push_back(benchSetState(sink));
+        }
+    }
+
+    if (enabled("write-string-db")) {
+        results.push_back(benchWriteStringDb(dir));
+    }
+
+    bfs::remove_all(dir);
+
+    if (enabled("encode-progress-json")) {
+        results.push_back(benchEncodeProgress());
+    }
+
+    if (enabled("mq-message-round-trip")) {
+        results.push_back(benchMqRoundTrip());
+    }
+
+    printResults(results);
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include <common/mq/MqContext.hpp>
+#include <common/mq/MqMessage.hpp>
+#include <common/mq/AsyncRpcClient.hpp>
+#include <common/mq/AsyncRpcServer.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+double getSeconds(Clock::time_point begin, Clock::time_point end)
+{
+    return std::chrono::duration<double> {end - begin}.count();
+}
+
+void printResult(std::size_t inFlight, std::uint64_t requests, double seconds)
+{
+    std::cout << inFlight << " in flight: " << requests << " requests in " <<
+                 seconds << " s (" <<
+                 static_cast<std::uint64_t>(requests / seconds) <<
+                 " requests/s)" << std::endl;
+}
+
+class BenchRequest :
+    public tibee::common::AbstractRpcRequest
+{
+public:
+    BenchRequest() :
+        tibee::common::AbstractRpcRequest {"get-state"}
+    {
+    }
+};
+
+// echoes requests until the context is terminated
+void serve(tibee::common::AsyncRpcServer::UP server)
+{
+    tibee::common::AsyncRpcServer::Request request;
+
+    while (server->recv(request)) {
+        server->reply(request, std::move(request.payload));
+    }
+}
+
+void bench(tibee::common::AsyncRpcClient& client, const std::string& payload,
+           std::size_t inFlight, std::uint64_t requests)
+{
+    BenchRequest request;
+    std::uint64_t sent = 0;
+    std::uint64_t completed = 0;
+    auto callback = [&completed] (tibee::common::MqMessage::UP reply) {
+        if (reply) {
+            completed++;
+        }
+    };
+
+    auto begin = Clock::now();
+
+    while (completed < requests) {
+        // keep the pipeline full
+        while (client.getInFlight() < inFlight && sent < requests) {
+            tibee::common::MqMessage::UP msg {
+                new tibee::common::MqMessage {payload.data(), payload.size()}
+            };
+
+            request.setId(static_cast<tibee::common::rpc_msg_id_t>(sent));
+
+            if (!client.call(request, std::move(msg), callback)) {
+                std::cerr << "Error: could not send request" << std::endl;
+                std::exit(1);
+            }
+
+            sent++;
+        }
+
+        client.processReplies(-1);
+    }
+
+    auto end = Clock::now();
+
+    printResult(inFlight, requests, getSeconds(begin, end));
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string addr {"ipc:///tmp/tibee-mqbench"};
+    std::uint64_t requests = 100000;
+
+    if (argc > 3) {
+        std::cerr << "usage: mqbench [<address> [<requests>]]" << std::endl;
+        return 1;
+    }
+
+    if (argc > 1) {
+        addr = argv[1];
+    }
+
+    if (argc > 2) {
+        requests = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    std::unique_ptr<tibee::common::MqContext> context {
+        new tibee::common::MqContext {1}
+    };
+    tibee::common::AsyncRpcServer::UP server {
+        new tibee::common::AsyncRpcServer {context.get(), addr}
+    };
+    std::thread serverThread {serve, std::move(server)};
+    tibee::common::AsyncRpcClient::UP client {
+        new tibee::common::AsyncRpcClient {context.get(), addr}
+    };
+
+    // typical small request
+    std::string payload {
+        "{\"method\": \"get-state\", \"id\": 23, \"params\": "
+        "[{\"path\": \"linux/threads/1234/cpu\", \"ts\": 1400000001234567890}]}"
+    };
+
+    for (std::size_t inFlight : {1, 8, 64}) {
+        bench(*client, payload, inFlight, requests);
+    }
+
+    // terminating the context stops the server
+    client = nullptr;
+    context = nullptr;
+    serverThread.join();
+
+    return 0;
+}
@@ -0,0 +1,401 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <common/rpc/AbstractJsonRpcMessageDecoder.hpp>
+#include <common/rpc/AbstractMsgPackRpcMessageDecoder.hpp>
+#include <common/rpc/MsgPackWriter.hpp>
+#include <common/rpc/RpcRequestDecoder.hpp>
+#include <common/rpc/RpcRequestDispatcher.hpp>
+#include <tibeebuild/rpc/BuilderJsonRpcMessageEncoder.hpp>
+#include <tibeebuild/rpc/BuilderMsgPackRpcMessageEncoder.hpp>
+#include <tibeebuild/rpc/ProgressUpdateRpcNotification.hpp>
+#include <tibeecore/rpc/CoreJsonRpcMessageEncoder.hpp>
+#include <tibeecore/rpc/CoreMsgPackRpcMessageEncoder.hpp>
+#include <tibeecore/rpc/StateMatrixRpcResponse.hpp>
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+double getSeconds(Clock::time_point begin, Clock::time_point end)
+{
+    return std::chrono::duration<double> {end - begin}.count();
+}
+
+void printResult(const char* name, std::uint64_t messages, std::size_t size,
+                 double seconds)
+{
+    std::cout << name << ": " << messages << " messages of " << size <<
+                 " bytes in " << seconds << " s (" <<
+                 static_cast<std::uint64_t>(messages / seconds) <<
+                 " messages/s, " <<
+                 static_cast<std::uint64_t>(messages * size / seconds / 1e6) <<
+                 " MB/s)" << std::endl;
+}
+
+// progress update, as published periodically by tibeebuild
+tibee::ProgressUpdateRpcNotification getProgressUpdate()
+{
+    tibee::ProgressUpdateRpcNotification notification;
+
+    notification.setProcessedEvents(123456789);
+    notification.setBeginTs(1400000000000000000ULL);
+    notification.setEndTs(1400000100000000000ULL);
+    notification.setCurTs(1400000042000000000ULL);
+    notification.setStateChanges(98765432);
+    notification.setTotalBytes(4000000000ULL);
+    notification.setCurBytes(1680000000ULL);
+    notification.setEstimatedEvents(300000000);
+    notification.setEventsRate(2345678.9);
+    notification.setStateChangesRate(1234567.8);
+    notification.setTracesPaths({"/home/user/lttng-traces/kernel"});
+    notification.setStateProvidersPaths({"/usr/lib/tibee/providers/linux.so"});
+
+    return notification;
+}
+
+/* State matrix of about `count` values, shaped like the answer to a
+ * batch request of a timeline view: rows alternate between CPU numbers
+ * (numeric rows), thread names (string rows) and a few missing states.
+ */
+void fillStateMatrix(tibee::StateMatrixRpcResponse& matrix,
+                     std::vector<std::string>& paths, std::size_t count)
+{
+    static const char* names[] = {
+        "swapper/0", "bash", "lttng-sessiond", "Xorg", "kworker/1:2",
+    };
+    const std::size_t rowsCount = 64;
+    std::size_t colsCount = std::max<std::size_t>(count / rowsCount, 1);
+    std::uint64_t ts = 1400000000000000000ULL;
+
+    matrix.setId(23);
+
+    for (std::size_t col = 0; col < colsCount; ++col) {
+        ts += 1000 + std::rand() % 100000;
+        matrix.getTimestamps().push_back(ts);
+    }
+
+    for (std::size_t row = 0; row < rowsCount; ++row) {
+        auto tid = 1000 + row / 2;
+
+        paths.push_back("linux/threads/" + std::to_string(tid) +
+                        (row % 2 ? "/name" : "/cpu"));
+    }
+
+    for (std::size_t row = 0; row < rowsCount; ++row) {
+        matrix.getPathQuarks().push_back(row);
+        matrix.getPaths().push_back(paths[row].c_str());
+
+        for (std::size_t col = 0; col < colsCount; ++col) {
+            tibee::StateValue value {};
+
+            if (std::rand() % 16 == 0) {
+                value.isNull = true;
+            } else if (row % 2 == 0) {
+                value.type = tibee::common::StateValueType::UINT32;
+                value.uint = std::rand() % 8;
+            } else {
+                value.type = tibee::common::StateValueType::QUARK;
+                value.str = names[std::rand() % 5];
+            }
+
+            matrix.getValues().push_back(value);
+        }
+    }
+}
+
+// counts decoded values; typed arrays are counted without expansion
+template <typename Decoder>
+class CountingDecoder :
+    public Decoder
+{
+public:
+    CountingDecoder() :
+        _count {0}
+    {
+    }
+
+    bool decode(const std::string& msg)
+    {
+        return this->parse(msg.data(), msg.size());
+    }
+
+    std::uint64_t getCount() const
+    {
+        return _count;
+    }
+
+protected:
+    void count(std::uint64_t count = 1)
+    {
+        _count += count;
+    }
+
+private:
+    void processNull()
+    {
+        this->count();
+    }
+
+    void processBoolean(bool)
+    {
+        this->count();
+    }
+
+    void processInteger(long long)
+    {
+        this->count();
+    }
+
+    void processDouble(double)
+    {
+        this->count();
+    }
+
+    void processNumber(const char*, std::size_t)
+    {
+        this->count();
+    }
+
+    void processString(const char*, std::size_t)
+    {
+        this->count();
+    }
+
+    void processStartMap()
+    {
+    }
+
+    void processMapKey(const char*, std::size_t)
+    {
+    }
+
+    void processEndMap()
+    {
+    }
+
+    void processStartArray()
+    {
+    }
+
+    void processEndArray()
+    {
+    }
+
+private:
+    std::uint64_t _count;
+};
+
+typedef CountingDecoder<tibee::common::AbstractJsonRpcMessageDecoder> JsonDecoder;
+
+class MsgPackDecoder :
+    public CountingDecoder<tibee::common::AbstractMsgPackRpcMessageDecoder>
+{
+private:
+    void processTypedArray(tibee::common::MsgPackTypedArrayType,
+                           const std::uint8_t*, std::size_t count)
+    {
+        this->count(count);
+    }
+};
+
+template <typename Encoder, typename Decoder, typename Message>
+void bench(const char* name,
+           std::unique_ptr<std::string> (Encoder::*encode)(const Message&),
+           const Message& object, std::uint64_t iterations,
+           std::uint64_t& checksum)
+{
+    Encoder encoder;
+    Decoder decoder;
+    std::unique_ptr<std::string> msg;
+    std::string encodeName {name};
+    std::string decodeName {name};
+
+    encodeName += " encode";
+    decodeName += " decode";
+
+    auto begin = Clock::now();
+
+    for (std::uint64_t x = 0; x < iterations; ++x) {
+        msg = (encoder.*encode)(object);
+        checksum += msg->size();
+    }
+
+    auto end = Clock::now();
+
+    printResult(encodeName.c_str(), iterations, msg->size(),
+                getSeconds(begin, end));
+
+    begin = Clock::now();
+
+    for (std::uint64_t x = 0; x < iterations; ++x) {
+        if (!decoder.decode(*msg)) {
+            std::cerr << "Error: could not decode " << name << " message" << std::endl;
+            std::exit(1);
+        }
+    }
+
+    end = Clock::now();
+
+    printResult(decodeName.c_str(), iterations, msg->size(),
+                getSeconds(begin, end));
+
+    checksum += decoder.getCount();
+}
+
+// typed request of the dispatch benchmark
+struct SmallRequest
+{
+    std::string path;
+    std::uint64_t ts;
+};
+
+const char* decodeSmallRequest(const tibee::common::RpcRequestDecoder& decoder,
+                               SmallRequest& request)
+{
+    tibee::common::RpcString path;
+
+    if (!decoder.getStringParam("path", path) ||
+            !decoder.getUintParam("ts", request.ts)) {
+        return "wrong parameters";
+    }
+
+    request.path.assign(path.data, path.len);
+
+    return nullptr;
+}
+
+std::string getMsgPackSmallRequest()
+{
+    std::string msg;
+    tibee::common::MsgPackWriter writer;
+
+    writer.setOutput(&msg);
+    writer.writeMapHeader(3);
+    writer.writeString("method");
+    writer.writeString("get-state");
+    writer.writeString("id");
+    writer.writeUint(23);
+    writer.writeString("params");
+    writer.writeArrayHeader(1);
+    writer.writeMapHeader(2);
+    writer.writeString("path");
+    writer.writeString("linux/threads/1234/cpu");
+    writer.writeString("ts");
+    writer.writeUint(1400000001234567890ULL);
+
+    return msg;
+}
+
+void benchDispatch(const char* name, const std::string& msg,
+                   std::uint64_t iterations, std::uint64_t& checksum)
+{
+    tibee::common::RpcRequestDispatcher dispatcher;
+
+    dispatcher.addMethod<SmallRequest>("get-state", decodeSmallRequest,
+                                       [&checksum] (SmallRequest& request) {
+        checksum += request.ts + request.path.size();
+    });
+
+    auto begin = Clock::now();
+
+    for (std::uint64_t x = 0; x < iterations; ++x) {
+        if (dispatcher.dispatch(msg.data(), msg.size()) != tibee::common::RpcRequestStatus::OK) {
+            std::cerr << "Error: could not dispatch " << name << " request: " <<
+                         dispatcher.getErrorMessage() << std::endl;
+            std::exit(1);
+        }
+    }
+
+    auto end = Clock::now();
+
+    printResult(name, iterations, msg.size(), getSeconds(begin, end));
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t count = 10000;
+    std::uint64_t iterations = 1000;
+
+    if (argc > 3) {
+        std::cerr << "usage: rpcbench [<values per state matrix> [<iterations>]]" << std::endl;
+        return 1;
+    }
+
+    if (argc > 1) {
+        count = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    if (argc > 2) {
+        iterations = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    // checksum to make sure nothing is optimized out
+    std::uint64_t checksum = 0;
+
+    // progress updates of tibeebuild
+    auto progress = getProgressUpdate();
+
+    bench<tibee::BuilderJsonRpcMessageEncoder, JsonDecoder>(
+        "json progress",
+        &tibee::BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotification,
+        progress, iterations * 100, checksum);
+    bench<tibee::BuilderMsgPackRpcMessageEncoder, MsgPackDecoder>(
+        "msgpack progress",
+        &tibee::BuilderMsgPackRpcMessageEncoder::encodeProgressUpdateRpcNotification,
+        progress, iterations * 100, checksum);
+
+    // state matrix responses of tibeecore (paths must outlive the matrix)
+    std::vector<std::string> paths;
+    tibee::StateMatrixRpcResponse matrix;
+
+    fillStateMatrix(matrix, paths, count);
+    bench<tibee::CoreJsonRpcMessageEncoder, JsonDecoder>(
+        "json state matrix",
+        &tibee::CoreJsonRpcMessageEncoder::encodeStateMatrixRpcResponse,
+        matrix, iterations, checksum);
+    bench<tibee::CoreMsgPackRpcMessageEncoder, MsgPackDecoder>(
+        "msgpack state matrix",
+        &tibee::CoreMsgPackRpcMessageEncoder::encodeStateMatrixRpcResponse,
+        matrix, iterations, checksum);
+
+    // small requests, decoded and dispatched to a typed handler
+    std::string jsonRequest {
+        "{\"method\": \"get-state\", \"id\": 23, \"params\": "
+        "[{\"path\": \"linux/threads/1234/cpu\", \"ts\": 1400000001234567890}]}"
+    };
+
+    benchDispatch("json dispatch", jsonRequest, iterations * 100, checksum);
+    benchDispatch("msgpack dispatch", getMsgPackSmallRequest(),
+                  iterations * 100, checksum);
+
+    std::cout << "checksum: " << checksum << std::endl;
+
+    return 0;
+}
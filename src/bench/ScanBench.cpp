@@ -0,0 +1,102 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <boost/filesystem/path.hpp>
+
+#include <common/trace/TraceSet.hpp>
+#include <common/trace/TraceSetCursor.hpp>
+#include <common/trace/Event.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+double getSeconds(Clock::time_point begin, Clock::time_point end)
+{
+    return std::chrono::duration<double> {end - begin}.count();
+}
+
+void printResult(const char* name, std::uint64_t events, double seconds)
+{
+    std::cout << name << ": " << events << " events in " << seconds <<
+                 " s (" << static_cast<std::uint64_t>(events / seconds) <<
+                 " events/s)" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "usage: scanbench <trace path>..." << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<tibee::common::TraceSet> traceSet {new tibee::common::TraceSet};
+
+    for (int x = 1; x < argc; ++x) {
+        if (!traceSet->addTrace(bfs::path {argv[x]})) {
+            std::cerr << "Error: could not add trace " << argv[x] << std::endl;
+            return 1;
+        }
+    }
+
+    // checksum to make sure nothing is optimized out
+    std::uint64_t checksum = 0;
+
+    // full decoding: what a state provider typically does
+    std::uint64_t fullEvents = 0;
+    auto begin = Clock::now();
+
+    for (auto& event : *traceSet) {
+        auto fields = event.getFields();
+
+        checksum += event.getTimestamp() + event.getId() +
+                    (fields ? fields->size() : 0);
+        fullEvents++;
+    }
+
+    auto end = Clock::now();
+
+    printResult("iterator (fields)", fullEvents, getSeconds(begin, end));
+
+    // timestamp/ID only cursor
+    std::uint64_t cursorEvents = 0;
+
+    begin = Clock::now();
+
+    for (auto cursor = traceSet->cursor(); !cursor.isAtEnd(); cursor.next()) {
+        checksum += cursor.getTimestamp() + cursor.getId() +
+                    cursor.getTraceId();
+        cursorEvents++;
+    }
+
+    end = Clock::now();
+
+    printResult("cursor", cursorEvents, getSeconds(begin, end));
+
+    std::cout << "checksum: " << checksum << std::endl;
+
+    return 0;
+}
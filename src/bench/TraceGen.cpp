@@ -0,0 +1,1016 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/program_options.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+/*
+ * Event field types. Every field is byte-aligned, like in LTTng
+ * kernel traces, so that events are packed without padding.
+ */
+enum class FieldType
+{
+    UINT,
+    SINT,
+    STRING,
+
+    // 16 characters array, like LTTng's comm fields
+    COMM,
+};
+
+// how to generate the value of a field
+enum class FieldValue
+{
+    RANDOM,
+
+    // small integer: FD, priority, IRQ, ...
+    SMALL,
+
+    // current thread of the stream's CPU, before a switch
+    PREV_TID,
+    PREV_COMM,
+
+    // next thread of the stream's CPU, after a switch
+    NEXT_TID,
+    NEXT_COMM,
+
+    // stream's CPU
+    CPU,
+
+    // file path
+    FILENAME,
+};
+
+struct FieldClass
+{
+    std::string name;
+    FieldType type;
+
+    // size of integers (bits)
+    unsigned int size;
+
+    FieldValue value;
+};
+
+struct EventClass
+{
+    std::string name;
+    double weight;
+    std::vector<FieldClass> fields;
+
+    // true if this event switches the current thread of its CPU
+    bool switchesThread;
+};
+
+struct Options
+{
+    bfs::path outputDir;
+    std::string domain;
+    std::vector<EventClass> eventClasses;
+    std::size_t streams;
+    double rate;
+    std::string distribution;
+    std::uint64_t size;
+    std::size_t packetSize;
+    std::uint64_t beginTs;
+    std::uint64_t seed;
+    std::size_t jobs;
+};
+
+// CTF packet header magic number
+const std::uint32_t CTF_MAGIC = 0xc1fc1fc1;
+
+// packet header and context size (bytes)
+const std::size_t PACKET_HEADER_CONTEXT_SIZE = 4 + 16 + 4 + 5 * 8 + 4;
+
+// event header size (bytes)
+const std::size_t EVENT_HEADER_SIZE = 4 + 8;
+
+// threads per CPU
+const std::size_t THREADS_PER_CPU = 64;
+
+// events per burst or idle phase of the bursty distribution
+const std::uint64_t BURST_EVENTS = 1024;
+
+const char* COMMS[] = {
+    "bash", "sshd", "kworker/0:1", "firefox", "gcc", "make", "Xorg",
+    "systemd", "rcu_sched", "python3", "ksoftirqd/0", "postgres",
+};
+
+const char* FILENAMES[] = {
+    "/etc/ld.so.cache", "/lib/x86_64-linux-gnu/libc.so.6",
+    "/proc/self/stat", "/usr/share/locale/locale.alias",
+    "/home/user/.bashrc", "/tmp/ccX3fGhT.s", "/dev/null",
+    "/var/log/syslog", "/usr/lib/python3/dist-packages/six.py",
+};
+
+FieldClass makeUint(const std::string& name, unsigned int size,
+                    FieldValue value = FieldValue::RANDOM)
+{
+    return FieldClass {name, FieldType::UINT, size, value};
+}
+
+FieldClass makeSint(const std::string& name, unsigned int size,
+                    FieldValue value = FieldValue::RANDOM)
+{
+    return FieldClass {name, FieldType::SINT, size, value};
+}
+
+FieldClass makeString(const std::string& name,
+                      FieldValue value = FieldValue::FILENAME)
+{
+    return FieldClass {name, FieldType::STRING, 0, value};
+}
+
+FieldClass makeComm(const std::string& name, FieldValue value)
+{
+    return FieldClass {name, FieldType::COMM, 0, value};
+}
+
+/*
+ * Event classes and field layouts of LTTng 2.4 kernel traces, with
+ * weights shaped like a busy system.
+ */
+std::vector<EventClass> getLttngKernelEventClasses()
+{
+    return {
+        {"sched_switch", 20, {
+            makeComm("prev_comm", FieldValue::PREV_COMM),
+            makeSint("prev_tid", 32, FieldValue::PREV_TID),
+            makeSint("prev_prio", 32, FieldValue::SMALL),
+            makeSint("prev_state", 64, FieldValue::SMALL),
+            makeComm("next_comm", FieldValue::NEXT_COMM),
+            makeSint("next_tid", 32, FieldValue::NEXT_TID),
+            makeSint("next_prio", 32, FieldValue::SMALL),
+        }, true},
+        {"sched_wakeup", 10, {
+            makeComm("comm", FieldValue::NEXT_COMM),
+            makeSint("tid", 32, FieldValue::NEXT_TID),
+            makeSint("prio", 32, FieldValue::SMALL),
+            makeSint("success", 32, FieldValue::SMALL),
+            makeSint("target_cpu", 32, FieldValue::CPU),
+        }, false},
+        {"sys_open", 4, {
+            makeString("filename"),
+            makeSint("flags", 32, FieldValue::SMALL),
+            makeUint("mode", 16, FieldValue::SMALL),
+        }, false},
+        {"sys_close", 4, {
+            makeUint("fd", 32, FieldValue::SMALL),
+        }, false},
+        {"sys_read", 12, {
+            makeUint("fd", 32, FieldValue::SMALL),
+            makeUint("buf", 64),
+            makeUint("count", 64, FieldValue::SMALL),
+        }, false},
+        {"sys_write", 8, {
+            makeUint("fd", 32, FieldValue::SMALL),
+            makeUint("buf", 64),
+            makeUint("count", 64, FieldValue::SMALL),
+        }, false},
+        {"exit_syscall", 28, {
+            makeSint("ret", 64, FieldValue::SMALL),
+        }, false},
+        {"irq_handler_entry", 3, {
+            makeSint("irq", 32, FieldValue::SMALL),
+            makeString("name"),
+        }, false},
+        {"irq_handler_exit", 3, {
+            makeSint("irq", 32, FieldValue::SMALL),
+            makeSint("ret", 32, FieldValue::SMALL),
+        }, false},
+        {"softirq_entry", 4, {
+            makeUint("vec", 32, FieldValue::SMALL),
+        }, false},
+        {"softirq_exit", 4, {
+            makeUint("vec", 32, FieldValue::SMALL),
+        }, false},
+    };
+}
+
+/*
+ * A few event classes covering all field types.
+ */
+std::vector<EventClass> getGenericEventClasses()
+{
+    return {
+        {"tick", 50, {
+            makeUint("counter", 64),
+        }, false},
+        {"sample", 30, {
+            makeUint("id", 32),
+            makeSint("value", 64),
+            makeUint("flags", 8),
+            makeUint("port", 16),
+        }, false},
+        {"message", 20, {
+            makeUint("level", 8, FieldValue::SMALL),
+            makeString("text"),
+        }, false},
+    };
+}
+
+bool parseFieldType(const std::string& str, FieldType& type, unsigned int& size)
+{
+    if (str == "string") {
+        type = FieldType::STRING;
+        size = 0;
+
+        return true;
+    }
+
+    if (str == "comm") {
+        type = FieldType::COMM;
+        size = 0;
+
+        return true;
+    }
+
+    if (str.size() < 2 || (str[0] != 'u' && str[0] != 's')) {
+        return false;
+    }
+
+    type = str[0] == 'u' ? FieldType::UINT : FieldType::SINT;
+    size = std::atoi(str.c_str() + 1);
+
+    return size == 8 || size == 16 || size == 32 || size == 64;
+}
+
+/*
+ * Parses an event class specification:
+ *
+ *     <name>:<weight>[:<field>=<type>[,<field>=<type>]...]
+ *
+ * where <type> is u8, u16, u32, u64, s8, s16, s32, s64, string or comm.
+ */
+bool parseEventClass(const std::string& spec, EventClass& eventClass)
+{
+    std::vector<std::string> parts;
+    std::istringstream specStream {spec};
+    std::string part;
+
+    while (std::getline(specStream, part, ':')) {
+        parts.push_back(part);
+    }
+
+    if (parts.size() < 2 || parts.size() > 3 || parts[0].empty()) {
+        return false;
+    }
+
+    eventClass.name = parts[0];
+    eventClass.weight = std::atof(parts[1].c_str());
+    eventClass.switchesThread = false;
+    eventClass.fields.clear();
+
+    if (eventClass.weight <= 0) {
+        return false;
+    }
+
+    if (parts.size() == 2) {
+        return true;
+    }
+
+    std::istringstream fieldsStream {parts[2]};
+    std::string field;
+
+    while (std::getline(fieldsStream, field, ',')) {
+        auto pos = field.find('=');
+
+        if (pos == std::string::npos || pos == 0) {
+            return false;
+        }
+
+        FieldClass fieldClass;
+
+        fieldClass.name = field.substr(0, pos);
+        fieldClass.value = FieldValue::RANDOM;
+
+        if (!parseFieldType(field.substr(pos + 1), fieldClass.type,
+                            fieldClass.size)) {
+            return false;
+        }
+
+        if (fieldClass.type == FieldType::STRING) {
+            fieldClass.value = FieldValue::FILENAME;
+        } else if (fieldClass.type == FieldType::COMM) {
+            fieldClass.value = FieldValue::NEXT_COMM;
+        }
+
+        eventClass.fields.push_back(fieldClass);
+    }
+
+    return true;
+}
+
+bool parseSize(const std::string& str, std::uint64_t& size)
+{
+    char* end;
+
+    size = std::strtoull(str.c_str(), &end, 10);
+
+    switch (*end) {
+    case 'T':
+        size *= 1024;
+    case 'G':
+        size *= 1024;
+    case 'M':
+        size *= 1024;
+    case 'K':
+        size *= 1024;
+        end++;
+        break;
+
+    default:
+        break;
+    }
+
+    return *end == '\0' && size > 0;
+}
+
+std::string makeUuid(std::mt19937_64& rng, std::uint8_t* bytes)
+{
+    std::ostringstream ss;
+
+    for (std::size_t x = 0; x < 16; ++x) {
+        bytes[x] = static_cast<std::uint8_t>(rng());
+    }
+
+    // RFC 4122 version 4
+    bytes[6] = (bytes[6] & 0x0f) | 0x40;
+    bytes[8] = (bytes[8] & 0x3f) | 0x80;
+
+    for (std::size_t x = 0; x < 16; ++x) {
+        if (x == 4 || x == 6 || x == 8 || x == 10) {
+            ss << '-';
+        }
+
+        ss << std::hex << std::setw(2) << std::setfill('0') <<
+              static_cast<unsigned int>(bytes[x]);
+    }
+
+    return ss.str();
+}
+
+std::string getFieldDecl(const FieldClass& fieldClass)
+{
+    std::ostringstream ss;
+
+    // leading underscores are removed by readers, like with LTTng
+    switch (fieldClass.type) {
+    case FieldType::UINT:
+    case FieldType::SINT:
+        ss << "integer { size = " << fieldClass.size << "; align = 8; " <<
+              "signed = " << (fieldClass.type == FieldType::SINT ? 1 : 0) <<
+              "; encoding = none; base = 10; } _" << fieldClass.name << ";";
+        break;
+
+    case FieldType::STRING:
+        ss << "string _" << fieldClass.name << ";";
+        break;
+
+    case FieldType::COMM:
+        ss << "integer { size = 8; align = 8; signed = 1; encoding = UTF8; " <<
+              "base = 10; } _" << fieldClass.name << "[16];";
+        break;
+    }
+
+    return ss.str();
+}
+
+void writeMetadata(const Options& options, const std::string& uuid)
+{
+    bfs::ofstream output {options.outputDir / "metadata"};
+
+    output <<
+        "/* CTF 1.8 */" << std::endl <<
+        std::endl <<
+        "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;" << std::endl <<
+        "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;" << std::endl <<
+        "typealias integer { size = 64; align = 8; signed = false; } := uint64_t;" << std::endl <<
+        std::endl <<
+        "trace {" << std::endl <<
+        "    major = 1;" << std::endl <<
+        "    minor = 8;" << std::endl <<
+        "    uuid = \"" << uuid << "\";" << std::endl <<
+        "    byte_order = le;" << std::endl <<
+        "    packet.header := struct {" << std::endl <<
+        "        uint32_t magic;" << std::endl <<
+        "        uint8_t uuid[16];" << std::endl <<
+        "        uint32_t stream_id;" << std::endl <<
+        "    };" << std::endl <<
+        "};" << std::endl <<
+        std::endl <<
+        "env {" << std::endl <<
+        "    hostname = \"tracegen\";" << std::endl <<
+        "    domain = \"" << options.domain << "\";" << std::endl <<
+        "    sysname = \"Linux\";" << std::endl <<
+        "    kernel_release = \"3.13.0\";" << std::endl <<
+        "    kernel_version = \"#1 SMP\";" << std::endl <<
+        "    tracer_name = \"lttng-modules\";" << std::endl <<
+        "    tracer_major = 2;" << std::endl <<
+        "    tracer_minor = 4;" << std::endl <<
+        "    tracer_patchlevel = 0;" << std::endl <<
+        "};" << std::endl <<
+        std::endl <<
+        "clock {" << std::endl <<
+        "    name = monotonic;" << std::endl <<
+        "    uuid = \"" << uuid << "\";" << std::endl <<
+        "    description = \"Monotonic Clock\";" << std::endl <<
+        "    freq = 1000000000;" << std::endl <<
+        "    offset = 0;" << std::endl <<
+        "};" << std::endl <<
+        std::endl <<
+        "typealias integer {" << std::endl <<
+        "    size = 64; align = 8; signed = false;" << std::endl <<
+        "    map = clock.monotonic.value;" << std::endl <<
+        "} := uint64_clock_monotonic_t;" << std::endl <<
+        std::endl <<
+        "struct packet_context {" << std::endl <<
+        "    uint64_clock_monotonic_t timestamp_begin;" << std::endl <<
+        "    uint64_clock_monotonic_t timestamp_end;" << std::endl <<
+        "    uint64_t content_size;" << std::endl <<
+        "    uint64_t packet_size;" << std::endl <<
+        "    uint64_t events_discarded;" << std::endl <<
+        "    uint32_t cpu_id;" << std::endl <<
+        "};" << std::endl <<
+        std::endl <<
+        "struct event_header {" << std::endl <<
+        "    uint32_t id;" << std::endl <<
+        "    uint64_clock_monotonic_t timestamp;" << std::endl <<
+        "};" << std::endl <<
+        std::endl <<
+        "stream {" << std::endl <<
+        "    id = 0;" << std::endl <<
+        "    event.header := struct event_header;" << std::endl <<
+        "    packet.context := struct packet_context;" << std::endl <<
+        "};" << std::endl;
+
+    for (std::size_t id = 0; id < options.eventClasses.size(); ++id) {
+        const auto& eventClass = options.eventClasses[id];
+
+        output << std::endl <<
+            "event {" << std::endl <<
+            "    name = \"" << eventClass.name << "\";" << std::endl <<
+            "    id = " << id << ";" << std::endl <<
+            "    stream_id = 0;" << std::endl <<
+            "    fields := struct {" << std::endl;
+
+        for (const auto& fieldClass : eventClass.fields) {
+            output << "        " << getFieldDecl(fieldClass) << std::endl;
+        }
+
+        output <<
+            "    };" << std::endl <<
+            "};" << std::endl;
+    }
+}
+
+/*
+ * Generates one stream file (one CPU), packet by packet.
+ */
+class StreamGenerator
+{
+public:
+    StreamGenerator(const Options& options, const std::uint8_t* uuid,
+                    std::uint32_t cpu) :
+        _options (options),
+        _uuid {uuid},
+        _cpu {cpu},
+        _rng {options.seed * 1000003 + cpu},
+        _eventClassDist {makeEventClassDist(options.eventClasses)},
+        _packet(options.packetSize),
+        _pos {0},
+        _ts {static_cast<double>(options.beginTs)},
+        _lastTs {options.beginTs},
+        _eventsCount {0}
+    {
+        // threads of this CPU
+        for (std::size_t x = 0; x < THREADS_PER_CPU; ++x) {
+            auto tid = static_cast<std::int32_t>(1000 + cpu * THREADS_PER_CPU + x);
+
+            _tids.push_back(tid);
+            _comms.push_back(COMMS[_rng() % (sizeof(COMMS) / sizeof(*COMMS))]);
+        }
+
+        _curThread = 0;
+        _nextThread = 1;
+    }
+
+    void generate(std::uint64_t size)
+    {
+        bfs::ofstream output {
+            _options.outputDir / ("channel0_" + std::to_string(_cpu)),
+            std::ios::binary
+        };
+        std::uint64_t written = 0;
+
+        this->openPacket();
+
+        while (written < size) {
+            auto ts = this->getNextTs();
+            auto id = _eventClassDist(_rng);
+
+            this->buildEvent(id, ts);
+
+            if (_pos + _event.size() > _packet.size()) {
+                this->closePacket(output);
+                written += _packet.size();
+                this->openPacket();
+            }
+
+            if (_pos == PACKET_HEADER_CONTEXT_SIZE) {
+                this->putUint(PACKET_HEADER_CONTEXT_SIZE - 5 * 8 - 4, ts, 8);
+            }
+
+            std::memcpy(&_packet[_pos], _event.data(), _event.size());
+            _pos += _event.size();
+            _lastTs = ts;
+            _eventsCount++;
+        }
+
+        this->closePacket(output);
+    }
+
+    std::uint64_t getEventsCount() const
+    {
+        return _eventsCount;
+    }
+
+    std::uint64_t getEndTs() const
+    {
+        return _lastTs;
+    }
+
+private:
+    static std::discrete_distribution<std::size_t> makeEventClassDist(const std::vector<EventClass>& eventClasses)
+    {
+        std::vector<double> weights;
+
+        for (const auto& eventClass : eventClasses) {
+            weights.push_back(eventClass.weight);
+        }
+
+        return std::discrete_distribution<std::size_t>(weights.begin(),
+                                                       weights.end());
+    }
+
+    std::uint64_t getNextTs()
+    {
+        double mean = 1e9 / _options.rate;
+
+        if (_options.distribution == "constant") {
+            _ts += mean;
+        } else if (_options.distribution == "bursty") {
+            // alternate bursts and idle phases, keeping the mean rate
+            bool burst = (_eventsCount / BURST_EVENTS) % 2 == 0;
+            std::exponential_distribution<double> dist {
+                1 / (burst ? mean / 4 : mean * 7 / 4)
+            };
+
+            _ts += dist(_rng);
+        } else {
+            std::exponential_distribution<double> dist {1 / mean};
+
+            _ts += dist(_rng);
+        }
+
+        return static_cast<std::uint64_t>(_ts);
+    }
+
+    // little-endian integer at a given packet offset
+    void putUint(std::size_t offset, std::uint64_t value, std::size_t bytes)
+    {
+        for (std::size_t x = 0; x < bytes; ++x) {
+            _packet[offset + x] = static_cast<std::uint8_t>(value >> (x * 8));
+        }
+    }
+
+    void pushUint(std::uint64_t value, std::size_t bytes)
+    {
+        for (std::size_t x = 0; x < bytes; ++x) {
+            _event.push_back(static_cast<std::uint8_t>(value >> (x * 8)));
+        }
+    }
+
+    void pushString(const char* str, std::size_t size)
+    {
+        _event.insert(_event.end(), str, str + size);
+    }
+
+    void openPacket()
+    {
+        std::size_t offset = 0;
+
+        putUint(offset, CTF_MAGIC, 4);
+        offset += 4;
+        std::memcpy(&_packet[offset], _uuid, 16);
+        offset += 16;
+
+        // stream ID
+        putUint(offset, 0, 4);
+        offset += 4;
+
+        // begin timestamp, end timestamp, content size and packet size
+        // are set when the first event is added or when closing
+        offset += 4 * 8;
+
+        // events discarded
+        putUint(offset, 0, 8);
+        offset += 8;
+        putUint(offset, _cpu, 4);
+        _pos = PACKET_HEADER_CONTEXT_SIZE;
+    }
+
+    void closePacket(bfs::ofstream& output)
+    {
+        std::size_t offset = 4 + 16 + 4;
+
+        putUint(offset + 8, _lastTs, 8);
+        putUint(offset + 16, _pos * 8, 8);
+        putUint(offset + 24, _packet.size() * 8, 8);
+        std::memset(&_packet[_pos], 0, _packet.size() - _pos);
+        output.write(reinterpret_cast<const char*>(_packet.data()),
+                     _packet.size());
+    }
+
+    void buildEvent(std::size_t id, std::uint64_t ts)
+    {
+        const auto& eventClass = _options.eventClasses[id];
+
+        _event.clear();
+        this->pushUint(id, 4);
+        this->pushUint(ts, 8);
+
+        if (eventClass.switchesThread) {
+            // pick another thread of this CPU
+            _nextThread = (_curThread + 1 + _rng() % (THREADS_PER_CPU - 1)) %
+                          THREADS_PER_CPU;
+        } else {
+            _nextThread = _rng() % THREADS_PER_CPU;
+        }
+
+        for (const auto& fieldClass : eventClass.fields) {
+            this->pushField(fieldClass);
+        }
+
+        if (eventClass.switchesThread) {
+            _curThread = _nextThread;
+        }
+    }
+
+    void pushField(const FieldClass& fieldClass)
+    {
+        std::uint64_t value;
+
+        switch (fieldClass.value) {
+        case FieldValue::SMALL:
+            value = _rng() % 1024;
+            break;
+
+        case FieldValue::PREV_TID:
+            value = _tids[_curThread];
+            break;
+
+        case FieldValue::NEXT_TID:
+            value = _tids[_nextThread];
+            break;
+
+        case FieldValue::CPU:
+            value = _cpu;
+            break;
+
+        default:
+            value = _rng();
+            break;
+        }
+
+        switch (fieldClass.type) {
+        case FieldType::UINT:
+        case FieldType::SINT:
+            this->pushUint(value, fieldClass.size / 8);
+            break;
+
+        case FieldType::STRING:
+        {
+            auto str = FILENAMES[_rng() % (sizeof(FILENAMES) / sizeof(*FILENAMES))];
+
+            this->pushString(str, std::strlen(str) + 1);
+            break;
+        }
+
+        case FieldType::COMM:
+        {
+            char comm[16] = {0};
+            auto thread = fieldClass.value == FieldValue::PREV_COMM ?
+                          _curThread : _nextThread;
+
+            std::strncpy(comm, _comms[thread], sizeof(comm) - 1);
+            this->pushString(comm, sizeof(comm));
+            break;
+        }
+        }
+    }
+
+private:
+    const Options& _options;
+    const std::uint8_t* _uuid;
+    std::uint32_t _cpu;
+    std::mt19937_64 _rng;
+    std::discrete_distribution<std::size_t> _eventClassDist;
+    std::vector<std::uint8_t> _packet;
+    std::size_t _pos;
+    std::vector<std::uint8_t> _event;
+    double _ts;
+    std::uint64_t _lastTs;
+    std::uint64_t _eventsCount;
+    std::vector<std::int32_t> _tids;
+    std::vector<const char*> _comms;
+    std::size_t _curThread;
+    std::size_t _nextThread;
+};
+
+std::size_t getMaxEventSize(const std::vector<EventClass>& eventClasses)
+{
+    std::size_t maxStringSize = 0;
+    std::size_t maxSize = 0;
+
+    for (auto filename : FILENAMES) {
+        maxStringSize = std::max(maxStringSize, std::strlen(filename) + 1);
+    }
+
+    for (const auto& eventClass : eventClasses) {
+        std::size_t size = EVENT_HEADER_SIZE;
+
+        for (const auto& fieldClass : eventClass.fields) {
+            switch (fieldClass.type) {
+            case FieldType::UINT:
+            case FieldType::SINT:
+                size += fieldClass.size / 8;
+                break;
+
+            case FieldType::STRING:
+                size += maxStringSize;
+                break;
+
+            case FieldType::COMM:
+                size += 16;
+                break;
+            }
+        }
+
+        maxSize = std::max(maxSize, size);
+    }
+
+    return maxSize;
+}
+
+int parseOptions(int argc, char* argv[], Options& options)
+{
+    namespace bpo = boost::program_options;
+
+    bpo::options_description desc;
+
+    desc.add_options()
+        ("help,h", "help")
+        ("output", bpo::value<std::string>())
+        ("profile,p", bpo::value<std::string>()->default_value("lttng-kernel"))
+        ("event,e", bpo::value<std::vector<std::string>>())
+        ("streams,s", bpo::value<std::size_t>()->default_value(4))
+        ("rate,r", bpo::value<double>()->default_value(1000000))
+        ("distribution,d", bpo::value<std::string>()->default_value("exponential"))
+        ("size,S", bpo::value<std::string>()->default_value("256M"))
+        ("packet-size", bpo::value<std::string>()->default_value("1M"))
+        ("begin", bpo::value<std::uint64_t>()->default_value(1400000000000000000ULL))
+        ("seed", bpo::value<std::uint64_t>()->default_value(0))
+        ("jobs,j", bpo::value<std::size_t>())
+    ;
+
+    bpo::positional_options_description pos;
+
+    pos.add("output", 1);
+
+    bpo::variables_map vm;
+
+    try {
+        auto cliParser = bpo::command_line_parser(argc, argv);
+        auto parsedOptions = cliParser.options(desc).positional(pos).run();
+
+        bpo::store(parsedOptions, vm);
+        vm.notify();
+    } catch (const std::exception& ex) {
+        std::cerr << "Command line error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (!vm["help"].empty() || vm["output"].empty()) {
+        std::cout <<
+            "usage: tracegen [options] <output directory>" << std::endl <<
+            std::endl <<
+            "Writes a synthetic CTF trace." << std::endl <<
+            std::endl <<
+            "options:" << std::endl <<
+            std::endl <<
+            "  -h, --help               print this help message" << std::endl <<
+            "  -p, --profile <profile>  lttng-kernel (default), generic or none" << std::endl <<
+            "  -e <name>:<weight>[:<field>=<type>,...]" << std::endl <<
+            "                           add an event class (any number); <type> is" << std::endl <<
+            "                           u8 to u64, s8 to s64, string or comm" << std::endl <<
+            "  -s, --streams <count>    number of streams/CPUs (default: 4)" << std::endl <<
+            "  -r, --rate <events/s>    mean event rate per stream (default: 1000000)" << std::endl <<
+            "  -d, --distribution <d>   event intervals: constant, exponential" << std::endl <<
+            "                           (default) or bursty" << std::endl <<
+            "  -S, --size <size>        total size of streams, K/M/G/T suffix (default: 256M)" << std::endl <<
+            "  --packet-size <size>     packet size (default: 1M)" << std::endl <<
+            "  --begin <ts>             first timestamp (ns)" << std::endl <<
+            "  --seed <seed>            random seed (default: 0)" << std::endl <<
+            "  -j, --jobs <count>       streams written in parallel (default: CPUs)" << std::endl;
+
+        return -1;
+    }
+
+    options.outputDir = vm["output"].as<std::string>();
+
+    // profile
+    auto profile = vm["profile"].as<std::string>();
+
+    options.domain = "kernel";
+
+    if (profile == "lttng-kernel") {
+        options.eventClasses = getLttngKernelEventClasses();
+    } else if (profile == "generic") {
+        options.domain = "ust";
+        options.eventClasses = getGenericEventClasses();
+    } else if (profile != "none") {
+        std::cerr << "Command line error: unknown profile \"" << profile <<
+                     "\"" << std::endl;
+        return 1;
+    }
+
+    // custom event classes
+    if (!vm["event"].empty()) {
+        for (const auto& spec : vm["event"].as<std::vector<std::string>>()) {
+            EventClass eventClass;
+
+            if (!parseEventClass(spec, eventClass)) {
+                std::cerr << "Command line error: wrong event class \"" <<
+                             spec << "\"" << std::endl;
+                return 1;
+            }
+
+            options.eventClasses.push_back(eventClass);
+        }
+    }
+
+    if (options.eventClasses.empty()) {
+        std::cerr << "Command line error: no event classes" << std::endl;
+        return 1;
+    }
+
+    options.streams = vm["streams"].as<std::size_t>();
+    options.rate = vm["rate"].as<double>();
+    options.distribution = vm["distribution"].as<std::string>();
+    options.beginTs = vm["begin"].as<std::uint64_t>();
+    options.seed = vm["seed"].as<std::uint64_t>();
+
+    if (options.streams == 0 || options.rate <= 0) {
+        std::cerr << "Command line error: need at least one stream and a positive rate" << std::endl;
+        return 1;
+    }
+
+    if (options.distribution != "constant" &&
+            options.distribution != "exponential" &&
+            options.distribution != "bursty") {
+        std::cerr << "Command line error: unknown distribution \"" <<
+                     options.distribution << "\"" << std::endl;
+        return 1;
+    }
+
+    std::uint64_t packetSize;
+
+    if (!parseSize(vm["size"].as<std::string>(), options.size) ||
+            !parseSize(vm["packet-size"].as<std::string>(), packetSize)) {
+        std::cerr << "Command line error: wrong size" << std::endl;
+        return 1;
+    }
+
+    // the largest event must fit in an empty packet
+    if (packetSize < PACKET_HEADER_CONTEXT_SIZE + getMaxEventSize(options.eventClasses)) {
+        std::cerr << "Command line error: packet size is too small" << std::endl;
+        return 1;
+    }
+
+    options.packetSize = packetSize;
+    options.jobs = std::thread::hardware_concurrency();
+
+    if (!vm["jobs"].empty()) {
+        options.jobs = vm["jobs"].as<std::size_t>();
+    }
+
+    if (options.jobs == 0) {
+        options.jobs = 1;
+    }
+
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    auto ret = parseOptions(argc, argv, options);
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    bfs::create_directories(options.outputDir);
+
+    std::mt19937_64 rng {options.seed};
+    std::uint8_t uuidBytes[16];
+    auto uuid = makeUuid(rng, uuidBytes);
+
+    writeMetadata(options, uuid);
+
+    // streams are independent: generate them in parallel
+    std::vector<std::uint64_t> eventsCounts(options.streams);
+    std::vector<std::uint64_t> endTss(options.streams);
+    std::atomic<std::size_t> nextStream {0};
+    std::vector<std::thread> jobs;
+    auto streamSize = (options.size + options.streams - 1) / options.streams;
+    auto begin = std::chrono::steady_clock::now();
+
+    for (std::size_t x = 0; x < std::min(options.jobs, options.streams); ++x) {
+        jobs.push_back(std::thread {[&] {
+            for (auto stream = nextStream++; stream < options.streams;
+                    stream = nextStream++) {
+                StreamGenerator generator {
+                    options, uuidBytes, static_cast<std::uint32_t>(stream)
+                };
+
+                generator.generate(streamSize);
+                eventsCounts[stream] = generator.getEventsCount();
+                endTss[stream] = generator.getEndTs();
+            }
+        }});
+    }
+
+    for (auto& job : jobs) {
+        job.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    std::uint64_t eventsCount = 0;
+    std::uint64_t endTs = options.beginTs;
+
+    for (std::size_t x = 0; x < options.streams; ++x) {
+        eventsCount += eventsCounts[x];
+        endTs = std::max(endTs, endTss[x]);
+    }
+
+    std::cout << "trace:    " << options.outputDir.string() << std::endl <<
+                 "uuid:     " << uuid << std::endl <<
+                 "streams:  " << options.streams << std::endl <<
+                 "events:   " << eventsCount << std::endl <<
+                 "duration: " << (endTs - options.beginTs) / 1e9 << " s" << std::endl <<
+                 "written in " << elapsed.count() << " s (" <<
+                 static_cast<std::uint64_t>(options.size / elapsed.count() / 1e6) <<
+                 " MB/s)" << std::endl;
+
+    return 0;
+}
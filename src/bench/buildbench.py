@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+
+# End-to-end build benchmark: generates traces of several sizes and
+# profiles with tracegen, builds them with tibeebuild, and compares
+# the results with stored baselines. Every trace must have a baseline
+# (see --save-baselines).
+
+import os
+import sys
+import json
+import shutil
+import argparse
+import statistics
+import subprocess
+
+
+_BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+_SRC_DIR = os.path.dirname(_BENCH_DIR)
+
+_DEFAULT_PROFILES = ['lttng-kernel', 'generic']
+_DEFAULT_SIZES = ['64M', '256M', '1G']
+
+# metric name -> True if higher is better
+_METRICS = {
+    'events-per-second': True,
+    'state-changes-per-second': True,
+    'time': False,
+    'cpu-time': False,
+    'peak-rss': False,
+    'output-size': False,
+}
+
+
+class _Error(Exception):
+    pass
+
+
+def _get_dir_size(path):
+    size = 0
+
+    for dirpath, dirnames, filenames in os.walk(path):
+        for filename in filenames:
+            size += os.path.getsize(os.path.join(dirpath, filename))
+
+    return size
+
+
+def _run(cmd):
+    try:
+        subprocess.check_call(cmd, stdout=subprocess.DEVNULL)
+    except (OSError, subprocess.CalledProcessError) as e:
+        raise _Error('cannot run "{}": {}'.format(' '.join(cmd), e))
+
+
+def _generate_trace(args, profile, size):
+    trace_dir = os.path.join(args.work_dir, 'traces',
+                             '{}-{}'.format(profile, size))
+
+    # traces are deterministic (fixed seed): reuse them
+    if os.path.isfile(os.path.join(trace_dir, 'metadata')):
+        return trace_dir
+
+    print('generating {} trace of {}'.format(profile, size), file=sys.stderr)
+    tmp_dir = trace_dir + '.tmp'
+    shutil.rmtree(tmp_dir, ignore_errors=True)
+    _run([args.tracegen, '-p', profile, '-S', size, '-s', str(args.streams),
+          '--seed', '0', tmp_dir])
+    os.rename(tmp_dir, trace_dir)
+
+    return trace_dir
+
+
+def _build(args, trace_dir):
+    cache_dir = os.path.join(args.work_dir, 'cache')
+    stats_path = os.path.join(args.work_dir, 'stats.json')
+
+    shutil.rmtree(cache_dir, ignore_errors=True)
+    os.makedirs(cache_dir)
+    _run([args.tibeebuild, '-f', '-d', cache_dir, '-s', args.provider,
+          '--stats', stats_path, trace_dir])
+
+    with open(stats_path) as f:
+        stats = json.load(f)
+
+    metrics = {
+        'events-per-second': stats['events'] / stats['time'],
+        'state-changes-per-second': stats['state-changes'] / stats['time'],
+        'time': stats['time'],
+        'cpu-time': stats['cpu-time'],
+        'peak-rss': stats['peak-rss'],
+        'output-size': _get_dir_size(cache_dir),
+    }
+
+    for stage in stats['stages']:
+        metrics['stage-{}'.format(stage['name'])] = stage['time']
+
+    return metrics
+
+
+def _bench(args, profile, size):
+    trace_dir = _generate_trace(args, profile, size)
+    runs = []
+
+    for run in range(args.runs):
+        print('building {} trace of {} ({}/{})'.format(profile, size,
+                                                      run + 1, args.runs),
+              file=sys.stderr)
+        runs.append(_build(args, trace_dir))
+
+    # median of each metric: robust to a single noisy run
+    return {name: statistics.median([run[name] for run in runs])
+            for name in runs[0]}
+
+
+def _is_higher_better(name):
+    # stages times are lower-is-better
+    return _METRICS.get(name, False)
+
+
+def _compare(name, metrics, baseline, threshold):
+    regressions = []
+    missing = []
+
+    print('{}:'.format(name))
+
+    for metric in sorted(metrics):
+        value = metrics[metric]
+        line = '  {:<28}{:>16.6g}'.format(metric, value)
+
+        if metric not in baseline:
+            line += '  NO BASELINE'
+            missing.append(metric)
+        elif baseline[metric] == 0:
+            # no relative change from zero
+            line += '{:>16.6g}'.format(baseline[metric])
+        else:
+            base = baseline[metric]
+            change = (value - base) / base * 100
+
+            if _is_higher_better(metric):
+                worse = -change
+            else:
+                worse = change
+
+            line += '{:>16.6g}{:>+9.1f} %'.format(base, change)
+
+            if worse > threshold:
+                line += '  REGRESSION'
+                regressions.append(metric)
+
+        print(line)
+
+    return regressions, missing
+
+
+def _parse_args():
+    ap = argparse.ArgumentParser(description='End-to-end build benchmark',
+                                 epilog='exit status: 0 if no regression, 1 if '
+                                        'regressions, 2 on error, 3 if '
+                                        'baselines are missing')
+    ap.add_argument('--tibeebuild',
+                    default=os.path.join(_SRC_DIR, 'tibeebuild', 'tibeebuild'),
+                    help='tibeebuild path')
+    ap.add_argument('--tracegen',
+                    default=os.path.join(_BENCH_DIR, 'tracegen'),
+                    help='tracegen path')
+    ap.add_argument('--provider',
+                    default=os.path.join(_SRC_DIR, 'providers', 'linux', 'linux.so'),
+                    help='state provider path')
+    ap.add_argument('-p', '--profiles', nargs='+', default=_DEFAULT_PROFILES,
+                    help='tracegen profiles (default: %(default)s)')
+    ap.add_argument('-S', '--sizes', nargs='+', default=_DEFAULT_SIZES,
+                    help='trace sizes (default: %(default)s)')
+    ap.add_argument('--streams', type=int, default=4,
+                    help='streams per trace (default: %(default)s)')
+    ap.add_argument('-r', '--runs', type=int, default=3,
+                    help='builds per trace (default: %(default)s)')
+    ap.add_argument('-w', '--work-dir',
+                    default=os.path.join(_BENCH_DIR, 'buildbench-work'),
+                    help='generated traces and caches directory')
+    ap.add_argument('-b', '--baselines',
+                    default=os.path.join(_BENCH_DIR, 'baselines'),
+                    help='baselines directory')
+    ap.add_argument('--save-baselines', action='store_true',
+                    help='replace baselines with these results')
+    ap.add_argument('-t', '--threshold', type=float, default=10,
+                    help='regression threshold (%%, default: %(default)s)')
+    ap.add_argument('-o', '--output',
+                    help='write all results to this JSON file')
+
+    args = ap.parse_args()
+
+    if args.runs < 1:
+        ap.error('need at least one run')
+
+    return args
+
+
+def _get_baseline_path(args, name):
+    return os.path.join(args.baselines, name + '.json')
+
+
+def _main():
+    args = _parse_args()
+    results = {}
+    regressions = []
+    missing = []
+    names = ['{}-{}'.format(profile, size)
+             for profile in args.profiles for size in args.sizes]
+
+    # fail before the (long) builds rather than compare with nothing
+    if not args.save_baselines:
+        missing_paths = [_get_baseline_path(args, name) for name in names
+                         if not os.path.isfile(_get_baseline_path(args, name))]
+
+        if missing_paths:
+            print('error: missing baselines (use --save-baselines to create them):',
+                  file=sys.stderr)
+
+            for path in missing_paths:
+                print('  {}'.format(path), file=sys.stderr)
+
+            return 3
+
+    os.makedirs(args.work_dir, exist_ok=True)
+
+    for profile in args.profiles:
+        for size in args.sizes:
+            name = '{}-{}'.format(profile, size)
+            baseline_path = _get_baseline_path(args, name)
+            baseline = {}
+
+            try:
+                metrics = _bench(args, profile, size)
+            except _Error as e:
+                print('error: {}'.format(e), file=sys.stderr)
+                return 2
+
+            if os.path.isfile(baseline_path):
+                with open(baseline_path) as f:
+                    baseline = json.load(f)
+
+            name_regressions, name_missing = _compare(name, metrics, baseline,
+                                                      args.threshold)
+
+            for metric in name_regressions:
+                regressions.append('{}: {}'.format(name, metric))
+
+            for metric in name_missing:
+                missing.append('{}: {}'.format(name, metric))
+
+            results[name] = metrics
+
+            if args.save_baselines:
+                os.makedirs(args.baselines, exist_ok=True)
+
+                with open(baseline_path, 'w') as f:
+                    json.dump(metrics, f, indent=2, sort_keys=True)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    if args.save_baselines:
+        return 0
+
+    if missing:
+        print('metrics missing from baselines (use --save-baselines to update them):')
+
+        for metric in missing:
+            print('  {}'.format(metric))
+
+    if regressions:
+        print('regressions beyond {} %:'.format(args.threshold))
+
+        for regression in regressions:
+            print('  {}'.format(regression))
+
+        return 1
+
+    if missing:
+        return 3
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(_main())
@@ -0,0 +1,87 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_EVENTDENSITYFORMAT_HPP
+#define _TIBEE_COMMON_EVENTDENSITYFORMAT_HPP
+
+#include <cstdint>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * @file
+ * On-disk layout of an event density file.
+ *
+ * An event density file contains, for each (trace ID, event ID) pair
+ * met during a build, the number of events found in each bucket of a
+ * fixed time grid. Multiple grids (levels) are stored, level 0 being
+ * the finest one; each next level has buckets 4 times larger.
+ *
+ * The file is:
+ *
+ *   * one EventDensityFileHeader
+ *   * \a levelsCount EventDensityFileLevel objects
+ *   * \a entriesCount EventDensityFileEntry objects, sorted by
+ *     (trace ID, event ID)
+ *   * for each level, \a entriesCount arrays of \a bucketsCount 32-bit
+ *     counts, starting at the level's \a countsOffset
+ *
+ * Everything is written in native byte order and naturally aligned so
+ * that a reader may use the mapped file as is.
+ */
+
+/// Event density file magic number ("TBED")
+static const std::uint32_t EVENT_DENSITY_FILE_MAGIC = 0x54424544;
+
+/// Event density file format version
+static const std::uint32_t EVENT_DENSITY_FILE_VERSION = 1;
+
+/// Event density file header
+struct EventDensityFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t beginTs;
+    std::uint64_t endTs;
+    std::uint32_t levelsCount;
+    std::uint32_t entriesCount;
+};
+
+/// Event density file level descriptor
+struct EventDensityFileLevel
+{
+    std::uint64_t bucketDuration;
+    std::uint32_t bucketsCount;
+    std::uint32_t reserved;
+    std::uint64_t countsOffset;
+};
+
+/// Event density file (trace ID, event ID) entry
+struct EventDensityFileEntry
+{
+    std::int32_t traceId;
+    std::int32_t eventId;
+    std::uint64_t total;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_EVENTDENSITYFORMAT_HPP
@@ -0,0 +1,215 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <limits>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <common/cache/EventDensityFormat.hpp>
+#include <common/cache/EventDensitySink.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+EventDensitySink::EventDensitySink(const bfs::path& path,
+                                   timestamp_t beginTs, timestamp_t endTs,
+                                   std::size_t maxBuckets,
+                                   std::size_t maxLevels) :
+    _path {path},
+    _beginTs {beginTs},
+    _span {1},
+    _shift {0},
+    _maxLevels {std::max(maxLevels, static_cast<std::size_t>(1))},
+    _lastEntry {nullptr},
+    _lastKey {0},
+    _opened {true}
+{
+    if (endTs > beginTs) {
+        _span = endTs - beginTs + 1;
+    }
+
+    if (maxBuckets == 0) {
+        maxBuckets = 1;
+    }
+
+    // smallest power of two bucket duration giving at most maxBuckets buckets
+    while ((_span - 1) >> _shift >= maxBuckets) {
+        _shift++;
+    }
+
+    _bucketsCount = static_cast<std::size_t>(((_span - 1) >> _shift) + 1);
+}
+
+EventDensitySink::~EventDensitySink()
+{
+    this->close();
+}
+
+EventDensitySink::Entry* EventDensitySink::getEntry(std::uint64_t key,
+                                                    trace_id_t traceId,
+                                                    event_id_t eventId)
+{
+    auto it = _entries.find(key);
+
+    if (it != _entries.end()) {
+        return &it->second;
+    }
+
+    // new (trace ID, event ID) pair: create its finest level buckets
+    auto& entry = _entries[key];
+
+    entry.traceId = traceId;
+    entry.eventId = eventId;
+    entry.total = 0;
+    entry.counts.resize(_bucketsCount, 0);
+
+    return &entry;
+}
+
+void EventDensitySink::close()
+{
+    // silently ignore if already closed
+    if (!_opened) {
+        return;
+    }
+
+    _opened = false;
+
+    // sort entries by (trace ID, event ID) so that readers may bisect
+    std::vector<const Entry*> entries;
+
+    for (const auto& keyEntryPair : _entries) {
+        entries.push_back(&keyEntryPair.second);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [] (const Entry* a, const Entry* b) {
+        if (a->traceId != b->traceId) {
+            return a->traceId < b->traceId;
+        }
+
+        return a->eventId < b->eventId;
+    });
+
+    // compute levels (each one has buckets 4 times larger than the previous)
+    std::vector<EventDensityFileLevel> levels;
+
+    for (std::size_t x = 0; x < _maxLevels; ++x) {
+        auto shift = _shift + 2 * x;
+
+        if (shift >= static_cast<unsigned int>(std::numeric_limits<timestamp_t>::digits)) {
+            break;
+        }
+
+        EventDensityFileLevel level;
+
+        level.bucketDuration = static_cast<std::uint64_t>(1) << shift;
+        level.bucketsCount = static_cast<std::uint32_t>(((_span - 1) >> shift) + 1);
+        level.reserved = 0;
+        level.countsOffset = 0;
+        levels.push_back(level);
+
+        // no need to go coarser than a single bucket
+        if (level.bucketsCount == 1) {
+            break;
+        }
+    }
+
+    auto offset = sizeof(EventDensityFileHeader);
+
+    offset += levels.size() * sizeof(EventDensityFileLevel);
+    offset += entries.size() * sizeof(EventDensityFileEntry);
+
+    for (auto& level : levels) {
+        level.countsOffset = offset;
+        offset += entries.size() * level.bucketsCount * sizeof(std::uint32_t);
+    }
+
+    // header
+    EventDensityFileHeader header;
+
+    header.magic = EVENT_DENSITY_FILE_MAGIC;
+    header.version = EVENT_DENSITY_FILE_VERSION;
+    header.beginTs = _beginTs;
+    header.endTs = _beginTs + _span - 1;
+    header.levelsCount = static_cast<std::uint32_t>(levels.size());
+    header.entriesCount = static_cast<std::uint32_t>(entries.size());
+
+    // derive coarser levels: each bucket merges 4 buckets of the previous level
+    std::vector<std::vector<std::vector<std::uint32_t>>> coarseCounts(levels.size());
+
+    for (std::size_t l = 1; l < levels.size(); ++l) {
+        coarseCounts[l].resize(entries.size());
+
+        for (std::size_t e = 0; e < entries.size(); ++e) {
+            const auto& prev = (l == 1) ? entries[e]->counts : coarseCounts[l - 1][e];
+            auto& counts = coarseCounts[l][e];
+
+            counts.assign(levels[l].bucketsCount, 0);
+
+            for (std::size_t b = 0; b < prev.size(); ++b) {
+                std::uint64_t sum = static_cast<std::uint64_t>(counts[b >> 2]) + prev[b];
+
+                // saturate rather than wrap
+                counts[b >> 2] = static_cast<std::uint32_t>(std::min(sum,
+                    static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max())));
+            }
+        }
+    }
+
+    // write everything
+    bfs::ofstream output;
+
+    output.open(_path, std::ios::binary);
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(levels.data()),
+                 levels.size() * sizeof(EventDensityFileLevel));
+
+    for (auto entry : entries) {
+        EventDensityFileEntry fileEntry;
+
+        fileEntry.traceId = entry->traceId;
+        fileEntry.eventId = entry->eventId;
+        fileEntry.total = entry->total;
+        output.write(reinterpret_cast<const char*>(&fileEntry),
+                     sizeof(fileEntry));
+    }
+
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+        for (std::size_t e = 0; e < entries.size(); ++e) {
+            const auto& counts = (l == 0) ? entries[e]->counts : coarseCounts[l][e];
+
+            output.write(reinterpret_cast<const char*>(counts.data()),
+                         counts.size() * sizeof(std::uint32_t));
+        }
+    }
+
+    output.close();
+
+    // free memory
+    _entries.clear();
+    _lastEntry = nullptr;
+}
+
+}
+}
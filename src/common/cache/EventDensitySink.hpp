@@ -0,0 +1,162 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_EVENTDENSITYSINK_HPP
+#define _TIBEE_COMMON_EVENTDENSITYSINK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * An event density sink.
+ *
+ * Counts events per (trace ID, event ID) pair in fixed time buckets
+ * and writes the result, at several resolutions, to an event density
+ * file when closed (see EventDensityFormat.hpp).
+ *
+ * Only the finest resolution is accumulated while events are added;
+ * coarser levels are derived when closing. The bucket duration is
+ * rounded up to a power of two so that finding the bucket of an event
+ * is a subtraction and a shift.
+ *
+ * @author Philippe Proulx
+ */
+class EventDensitySink :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds an event density sink.
+     *
+     * Events with timestamps outside [\p beginTs, \p endTs] are
+     * counted in the first or last bucket.
+     *
+     * @param path        Path to event density file (to be created)
+     * @param beginTs     Begin timestamp of the histogram
+     * @param endTs       End timestamp of the histogram
+     * @param maxBuckets  Maximum number of buckets of the finest level
+     * @param maxLevels   Maximum number of levels
+     */
+    EventDensitySink(const boost::filesystem::path& path,
+                     timestamp_t beginTs, timestamp_t endTs,
+                     std::size_t maxBuckets = 4096,
+                     std::size_t maxLevels = 5);
+
+    ~EventDensitySink();
+
+    /**
+     * Counts one event.
+     *
+     * @param traceId Trace ID of event
+     * @param eventId Event ID
+     * @param ts      Event timestamp
+     */
+    void addEvent(trace_id_t traceId, event_id_t eventId, timestamp_t ts)
+    {
+        auto key = EventDensitySink::getKey(traceId, eventId);
+
+        // consecutive events often share the same type
+        if (!_lastEntry || key != _lastKey) {
+            _lastEntry = this->getEntry(key, traceId, eventId);
+            _lastKey = key;
+        }
+
+        std::size_t bucket = 0;
+
+        if (ts > _beginTs) {
+            bucket = static_cast<std::size_t>((ts - _beginTs) >> _shift);
+
+            if (bucket >= _bucketsCount) {
+                bucket = _bucketsCount - 1;
+            }
+        }
+
+        _lastEntry->counts[bucket]++;
+        _lastEntry->total++;
+    }
+
+    /**
+     * Writes the event density file and marks this sink as closed.
+     *
+     * Silently ignored if already closed.
+     */
+    void close();
+
+private:
+    struct Entry
+    {
+        trace_id_t traceId;
+        event_id_t eventId;
+        std::uint64_t total;
+        std::vector<std::uint32_t> counts;
+    };
+
+private:
+    static std::uint64_t getKey(trace_id_t traceId, event_id_t eventId)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(traceId)) << 32) |
+               static_cast<std::uint32_t>(eventId);
+    }
+
+    Entry* getEntry(std::uint64_t key, trace_id_t traceId,
+                    event_id_t eventId);
+
+private:
+    // path to file to create
+    boost::filesystem::path _path;
+
+    // histogram begin timestamp
+    timestamp_t _beginTs;
+
+    // histogram span (ns)
+    timestamp_t _span;
+
+    // finest bucket duration is (1 << _shift)
+    unsigned int _shift;
+
+    // number of buckets of the finest level
+    std::size_t _bucketsCount;
+
+    // maximum number of levels
+    std::size_t _maxLevels;
+
+    // entries ((trace ID, event ID) key -> entry)
+    std::unordered_map<std::uint64_t, Entry> _entries;
+
+    // last used entry and its key
+    Entry* _lastEntry;
+    std::uint64_t _lastKey;
+
+    // open state
+    bool _opened;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_EVENTDENSITYSINK_HPP
@@ -0,0 +1,107 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <boost/filesystem/path.hpp>
+
+#include <common/cache/EventDensityFormat.hpp>
+#include <common/cache/EventDensitySource.hpp>
+#include <common/ex/EventDensitySource.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+EventDensitySource::EventDensitySource(const bfs::path& path) :
+    _mappedFile {path}
+{
+    _header = _mappedFile.getAt<EventDensityFileHeader>(0);
+
+    if (!_header || _header->magic != EVENT_DENSITY_FILE_MAGIC) {
+        throw ex::EventDensitySource {"not an event density file"};
+    }
+
+    if (_header->version != EVENT_DENSITY_FILE_VERSION) {
+        throw ex::EventDensitySource {"unsupported event density file version"};
+    }
+
+    std::uint64_t offset = sizeof(EventDensityFileHeader);
+
+    _levels = _mappedFile.getAt<EventDensityFileLevel>(offset,
+                                                       _header->levelsCount);
+    offset += _header->levelsCount * sizeof(EventDensityFileLevel);
+    _entries = _mappedFile.getAt<EventDensityFileEntry>(offset,
+                                                        _header->entriesCount);
+
+    if (!_levels || !_entries || _header->levelsCount == 0) {
+        throw ex::EventDensitySource {"truncated event density file"};
+    }
+
+    // make sure all counts are in the file
+    for (std::size_t x = 0; x < _header->levelsCount; ++x) {
+        const auto& level = _levels[x];
+        auto count = static_cast<std::size_t>(level.bucketsCount) *
+                     _header->entriesCount;
+
+        if (!_mappedFile.getAt<std::uint32_t>(level.countsOffset, count)) {
+            throw ex::EventDensitySource {"truncated event density file"};
+        }
+    }
+}
+
+std::size_t EventDensitySource::getLevelForBuckets(std::size_t bucketsCount) const
+{
+    // levels go from finest to coarsest
+    for (std::size_t x = this->getLevelsCount(); x > 0; --x) {
+        if (this->getBucketsCount(x - 1) >= bucketsCount) {
+            return x - 1;
+        }
+    }
+
+    return 0;
+}
+
+bool EventDensitySource::findEntry(trace_id_t traceId, event_id_t eventId,
+                                   std::size_t& index) const
+{
+    auto begin = _entries;
+    auto end = _entries + _header->entriesCount;
+
+    auto it = std::lower_bound(begin, end, std::make_pair(traceId, eventId),
+                               [] (const EventDensityFileEntry& entry,
+                                   const std::pair<trace_id_t, event_id_t>& key) {
+        if (entry.traceId != key.first) {
+            return entry.traceId < key.first;
+        }
+
+        return entry.eventId < key.second;
+    });
+
+    if (it == end || it->traceId != traceId || it->eventId != eventId) {
+        return false;
+    }
+
+    index = static_cast<std::size_t>(it - begin);
+
+    return true;
+}
+
+}
+}
@@ -0,0 +1,182 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_EVENTDENSITYSOURCE_HPP
+#define _TIBEE_COMMON_EVENTDENSITYSOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/cache/EventDensityFormat.hpp>
+#include <common/utils/MappedFile.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * An event density source; reads an event density file written by
+ * an EventDensitySink.
+ *
+ * The file is memory-mapped and only its header is validated when
+ * opening, so building this object takes a few microseconds whatever
+ * the file size. Counts are returned as pointers inside the mapping.
+ *
+ * @author Philippe Proulx
+ */
+class EventDensitySource :
+    boost::noncopyable
+{
+public:
+    /**
+     * Opens an event density file.
+     *
+     * Throws ex::EventDensitySource if the file is not a valid event
+     * density file.
+     *
+     * @param path Path of event density file
+     */
+    EventDensitySource(const boost::filesystem::path& path);
+
+    /**
+     * Returns the begin timestamp of the histograms.
+     *
+     * @returns Begin timestamp
+     */
+    timestamp_t getBegin() const
+    {
+        return _header->beginTs;
+    }
+
+    /**
+     * Returns the end timestamp of the histograms.
+     *
+     * @returns End timestamp
+     */
+    timestamp_t getEnd() const
+    {
+        return _header->endTs;
+    }
+
+    /**
+     * Returns the number of levels (resolutions), level 0 being the
+     * finest one.
+     *
+     * @returns Number of levels
+     */
+    std::size_t getLevelsCount() const
+    {
+        return _header->levelsCount;
+    }
+
+    /**
+     * Returns the number of buckets of level \p level.
+     *
+     * @param level Level index
+     * @returns     Number of buckets
+     */
+    std::size_t getBucketsCount(std::size_t level) const
+    {
+        return _levels[level].bucketsCount;
+    }
+
+    /**
+     * Returns the duration of one bucket of level \p level.
+     *
+     * @param level Level index
+     * @returns     Bucket duration
+     */
+    timestamp_t getBucketDuration(std::size_t level) const
+    {
+        return _levels[level].bucketDuration;
+    }
+
+    /**
+     * Returns the coarsest level having at least \p bucketsCount
+     * buckets, or the finest level if none has that many.
+     *
+     * @param bucketsCount Minimum number of buckets
+     * @returns            Level index
+     */
+    std::size_t getLevelForBuckets(std::size_t bucketsCount) const;
+
+    /**
+     * Returns the number of (trace ID, event ID) entries.
+     *
+     * @returns Number of entries
+     */
+    std::size_t getEntriesCount() const
+    {
+        return _header->entriesCount;
+    }
+
+    /**
+     * Returns entry \p index without checking bounds.
+     *
+     * @param index Entry index
+     * @returns     Entry
+     */
+    const EventDensityFileEntry& getEntry(std::size_t index) const
+    {
+        return _entries[index];
+    }
+
+    /**
+     * Finds the entry of a (trace ID, event ID) pair.
+     *
+     * @param traceId Trace ID
+     * @param eventId Event ID
+     * @param index   Found entry index (set if found)
+     * @returns       True if found
+     */
+    bool findEntry(trace_id_t traceId, event_id_t eventId,
+                   std::size_t& index) const;
+
+    /**
+     * Returns the bucket counts of entry \p entryIndex at level
+     * \p level, without checking bounds. The returned array contains
+     * getBucketsCount(\p level) counts and remains valid as long as
+     * this source exists.
+     *
+     * @param level      Level index
+     * @param entryIndex Entry index
+     * @returns          Bucket counts
+     */
+    const std::uint32_t* getCounts(std::size_t level,
+                                   std::size_t entryIndex) const
+    {
+        const auto& lvl = _levels[level];
+
+        return _mappedFile.getAt<std::uint32_t>(lvl.countsOffset) +
+               entryIndex * lvl.bucketsCount;
+    }
+
+private:
+    MappedFile _mappedFile;
+    const EventDensityFileHeader* _header;
+    const EventDensityFileLevel* _levels;
+    const EventDensityFileEntry* _entries;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_EVENTDENSITYSOURCE_HPP
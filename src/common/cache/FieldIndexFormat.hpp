@@ -0,0 +1,105 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_FIELDINDEXFORMAT_HPP
+#define _TIBEE_COMMON_FIELDINDEXFORMAT_HPP
+
+#include <cstdint>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * @file
+ * On-disk layout of a field index file.
+ *
+ * A field index file indexes the values of one field of one event
+ * type: for each distinct value met during a build, it contains the
+ * sorted timestamps of all the events having this value (a posting
+ * list).
+ *
+ * The file is:
+ *
+ *   * one FieldIndexFileHeader
+ *   * \a valuesCount FieldIndexFileValue objects (the directory),
+ *     sorted by value
+ *   * the string pool (only for string values): null-terminated
+ *     strings, at \a stringsOffset
+ *   * the posting lists, at \a postingsOffset
+ *
+ * A posting list is a sequence of unsigned LEB128 numbers: the first
+ * one is the first timestamp, and each next one is the difference
+ * between a timestamp and the previous one.
+ *
+ * For string values, the \a value member of a directory entry is the
+ * offset of the string within the string pool. Integer values are
+ * stored as is (signed values are reinterpreted as unsigned ones).
+ *
+ * Everything is written in native byte order and naturally aligned.
+ */
+
+/// Field index file magic number ("TBFI")
+static const std::uint32_t FIELD_INDEX_FILE_MAGIC = 0x54424649;
+
+/// Field index file format version
+static const std::uint32_t FIELD_INDEX_FILE_VERSION = 1;
+
+/// Field index value types
+enum class FieldIndexValueType : std::uint32_t
+{
+    /// No value was indexed
+    NONE = 0,
+
+    /// Signed integer
+    SINT = 1,
+
+    /// Unsigned integer (also enumerations)
+    UINT = 2,
+
+    /// String
+    STRING = 3,
+};
+
+/// Field index file header
+struct FieldIndexFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    FieldIndexValueType valueType;
+    std::uint32_t reserved;
+    std::uint64_t valuesCount;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+    std::uint64_t postingsOffset;
+    std::uint64_t postingsSize;
+};
+
+/// Field index file directory entry
+struct FieldIndexFileValue
+{
+    std::uint64_t value;
+    std::uint64_t postingsOffset;
+    std::uint64_t postingsSize;
+    std::uint64_t postingsCount;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_FIELDINDEXFORMAT_HPP
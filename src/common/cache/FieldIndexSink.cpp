@@ -0,0 +1,152 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <common/cache/FieldIndexFormat.hpp>
+#include <common/cache/FieldIndexSink.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+FieldIndexSink::FieldIndexSink(const bfs::path& path) :
+    _path {path},
+    _valueType {FieldIndexValueType::NONE},
+    _opened {true}
+{
+}
+
+FieldIndexSink::~FieldIndexSink()
+{
+    this->close();
+}
+
+void FieldIndexSink::close()
+{
+    // silently ignore if already closed
+    if (!_opened) {
+        return;
+    }
+
+    _opened = false;
+
+    // build the sorted directory
+    std::vector<FieldIndexFileValue> values;
+    std::vector<const Postings*> postings;
+    std::string strings;
+
+    if (_valueType == FieldIndexValueType::STRING) {
+        std::vector<const std::pair<const std::string, Postings>*> pairs;
+
+        for (const auto& pair : _strPostings) {
+            pairs.push_back(&pair);
+        }
+
+        std::sort(pairs.begin(), pairs.end(), [] (decltype(pairs[0]) a,
+                                                  decltype(pairs[0]) b) {
+            return a->first < b->first;
+        });
+
+        for (auto pair : pairs) {
+            FieldIndexFileValue value;
+
+            value.value = strings.size();
+            strings.append(pair->first.c_str(), pair->first.size() + 1);
+            values.push_back(value);
+            postings.push_back(&pair->second);
+        }
+    } else {
+        std::vector<const std::pair<const std::uint64_t, Postings>*> pairs;
+
+        for (const auto& pair : _intPostings) {
+            pairs.push_back(&pair);
+        }
+
+        bool isSigned = (_valueType == FieldIndexValueType::SINT);
+
+        std::sort(pairs.begin(), pairs.end(), [isSigned] (decltype(pairs[0]) a,
+                                                          decltype(pairs[0]) b) {
+            if (isSigned) {
+                return static_cast<std::int64_t>(a->first) <
+                       static_cast<std::int64_t>(b->first);
+            }
+
+            return a->first < b->first;
+        });
+
+        for (auto pair : pairs) {
+            FieldIndexFileValue value;
+
+            value.value = pair->first;
+            values.push_back(value);
+            postings.push_back(&pair->second);
+        }
+    }
+
+    // compute offsets
+    FieldIndexFileHeader header;
+
+    header.magic = FIELD_INDEX_FILE_MAGIC;
+    header.version = FIELD_INDEX_FILE_VERSION;
+    header.valueType = _valueType;
+    header.reserved = 0;
+    header.valuesCount = values.size();
+    header.stringsOffset = sizeof(header) + values.size() * sizeof(FieldIndexFileValue);
+    header.stringsSize = strings.size();
+    header.postingsOffset = header.stringsOffset + header.stringsSize;
+
+    std::uint64_t postingsOffset = 0;
+
+    for (std::size_t x = 0; x < values.size(); ++x) {
+        values[x].postingsOffset = postingsOffset;
+        values[x].postingsSize = postings[x]->data.size();
+        values[x].postingsCount = postings[x]->count;
+        postingsOffset += values[x].postingsSize;
+    }
+
+    header.postingsSize = postingsOffset;
+
+    // write everything
+    bfs::ofstream output;
+
+    output.open(_path, std::ios::binary);
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(values.data()),
+                 values.size() * sizeof(FieldIndexFileValue));
+    output.write(strings.data(), strings.size());
+
+    for (auto p : postings) {
+        output.write(reinterpret_cast<const char*>(p->data.data()),
+                     p->data.size());
+    }
+
+    output.close();
+
+    // free memory
+    _intPostings.clear();
+    _strPostings.clear();
+}
+
+}
+}
@@ -0,0 +1,180 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_FIELDINDEXSINK_HPP
+#define _TIBEE_COMMON_FIELDINDEXSINK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/cache/FieldIndexFormat.hpp>
+#include <common/utils/Leb128.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A field index sink.
+ *
+ * Accumulates, for each distinct value of one event field, the
+ * timestamps of the events having this value, and writes the
+ * resulting field index file when closed (see FieldIndexFormat.hpp).
+ *
+ * Posting lists are delta-encoded as they grow, so memory usage stays
+ * close to the final file size. Timestamps must be added in
+ * nondecreasing order, which is the case during a trace playback.
+ *
+ * The value type of the index is the type of the first added value;
+ * values of any other type (including the other integer signedness,
+ * since values are sorted with the index signedness) are ignored.
+ *
+ * @author Philippe Proulx
+ */
+class FieldIndexSink :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds a field index sink.
+     *
+     * @param path Path to field index file (to be created)
+     */
+    FieldIndexSink(const boost::filesystem::path& path);
+
+    ~FieldIndexSink();
+
+    /**
+     * Adds a signed integer value.
+     *
+     * @param value Field value
+     * @param ts    Event timestamp
+     */
+    void addSint(std::int64_t value, timestamp_t ts)
+    {
+        if (!this->acceptInteger(FieldIndexValueType::SINT)) {
+            return;
+        }
+
+        FieldIndexSink::addTimestamp(_intPostings[static_cast<std::uint64_t>(value)], ts);
+    }
+
+    /**
+     * Adds an unsigned integer value.
+     *
+     * @param value Field value
+     * @param ts    Event timestamp
+     */
+    void addUint(std::uint64_t value, timestamp_t ts)
+    {
+        if (!this->acceptInteger(FieldIndexValueType::UINT)) {
+            return;
+        }
+
+        FieldIndexSink::addTimestamp(_intPostings[value], ts);
+    }
+
+    /**
+     * Adds a string value.
+     *
+     * @param value Field value
+     * @param ts    Event timestamp
+     */
+    void addString(const char* value, timestamp_t ts)
+    {
+        if (_valueType == FieldIndexValueType::NONE) {
+            _valueType = FieldIndexValueType::STRING;
+        } else if (_valueType != FieldIndexValueType::STRING) {
+            return;
+        }
+
+        FieldIndexSink::addTimestamp(_strPostings[value], ts);
+    }
+
+    /**
+     * Writes the field index file and marks this sink as closed.
+     *
+     * Silently ignored if already closed.
+     */
+    void close();
+
+private:
+    struct Postings
+    {
+        Postings() :
+            lastTs {0},
+            count {0}
+        {
+        }
+
+        timestamp_t lastTs;
+        std::uint64_t count;
+        std::vector<std::uint8_t> data;
+    };
+
+private:
+    static void addTimestamp(Postings& postings, timestamp_t ts)
+    {
+        // out of order timestamps are recorded as the previous one
+        timestamp_t delta = 0;
+
+        if (ts > postings.lastTs) {
+            delta = ts - postings.lastTs;
+            postings.lastTs = ts;
+        }
+
+        leb128Append(delta, postings.data);
+        postings.count++;
+    }
+
+    bool acceptInteger(FieldIndexValueType type)
+    {
+        if (_valueType == FieldIndexValueType::NONE) {
+            _valueType = type;
+        }
+
+        return _valueType == type;
+    }
+
+private:
+    // path to file to create
+    boost::filesystem::path _path;
+
+    // value type of this index
+    FieldIndexValueType _valueType;
+
+    // postings of integer values
+    std::unordered_map<std::uint64_t, Postings> _intPostings;
+
+    // postings of string values
+    std::unordered_map<std::string, Postings> _strPostings;
+
+    // open state
+    bool _opened;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_FIELDINDEXSINK_HPP
@@ -0,0 +1,189 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstring>
+#include <boost/filesystem/path.hpp>
+
+#include <common/cache/FieldIndexFormat.hpp>
+#include <common/cache/FieldIndexSource.hpp>
+#include <common/utils/Leb128.hpp>
+#include <common/ex/FieldIndexSource.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+FieldIndexSource::FieldIndexSource(const bfs::path& path) :
+    _mappedFile {path}
+{
+    _header = _mappedFile.getAt<FieldIndexFileHeader>(0);
+
+    if (!_header || _header->magic != FIELD_INDEX_FILE_MAGIC) {
+        throw ex::FieldIndexSource {"not a field index file"};
+    }
+
+    if (_header->version != FIELD_INDEX_FILE_VERSION) {
+        throw ex::FieldIndexSource {"unsupported field index file version"};
+    }
+
+    _values = _mappedFile.getAt<FieldIndexFileValue>(sizeof(FieldIndexFileHeader),
+                                                     _header->valuesCount);
+    _strings = _mappedFile.getAt<char>(_header->stringsOffset,
+                                       _header->stringsSize);
+    _postings = _mappedFile.getAt<std::uint8_t>(_header->postingsOffset,
+                                                _header->postingsSize);
+
+    if (!_values || !_strings || !_postings) {
+        throw ex::FieldIndexSource {"truncated field index file"};
+    }
+
+    // the string pool must end with a null character
+    if (_header->stringsSize > 0 &&
+            _strings[_header->stringsSize - 1] != '\0') {
+        throw ex::FieldIndexSource {"corrupted field index string pool"};
+    }
+}
+
+const char* FieldIndexSource::getString(const FieldIndexFileValue& value) const
+{
+    if (value.value >= _header->stringsSize) {
+        return "";
+    }
+
+    return _strings + value.value;
+}
+
+std::size_t FieldIndexSource::decodePostings(const FieldIndexFileValue& value,
+                                             std::vector<timestamp_t>& timestamps) const
+{
+    if (value.postingsOffset > _header->postingsSize ||
+            _header->postingsSize - value.postingsOffset < value.postingsSize) {
+        throw ex::FieldIndexSource {"corrupted field index posting list"};
+    }
+
+    auto data = _postings + value.postingsOffset;
+    auto end = data + value.postingsSize;
+    timestamp_t ts = 0;
+    std::size_t count = 0;
+
+    while (data < end && count < value.postingsCount) {
+        std::uint64_t delta;
+
+        if (!leb128Read(data, end, delta)) {
+            throw ex::FieldIndexSource {"corrupted field index posting list"};
+        }
+
+        ts += delta;
+        timestamps.push_back(ts);
+        count++;
+    }
+
+    return count;
+}
+
+std::size_t FieldIndexSource::lookupSint(std::int64_t value,
+                                         std::vector<timestamp_t>& timestamps) const
+{
+    return this->lookupSintRange(value, value, timestamps);
+}
+
+std::size_t FieldIndexSource::lookupUint(std::uint64_t value,
+                                         std::vector<timestamp_t>& timestamps) const
+{
+    return this->lookupUintRange(value, value, timestamps);
+}
+
+std::size_t FieldIndexSource::lookupString(const std::string& value,
+                                           std::vector<timestamp_t>& timestamps) const
+{
+    if (_header->valueType != FieldIndexValueType::STRING) {
+        return 0;
+    }
+
+    auto begin = _values;
+    auto end = _values + _header->valuesCount;
+
+    auto it = std::lower_bound(begin, end, value,
+                               [this] (const FieldIndexFileValue& entry,
+                                       const std::string& key) {
+        return std::strcmp(this->getString(entry), key.c_str()) < 0;
+    });
+
+    if (it == end || value != this->getString(*it)) {
+        return 0;
+    }
+
+    return this->decodePostings(*it, timestamps);
+}
+
+template<typename T>
+std::size_t FieldIndexSource::lookupIntegerRange(T begin, T end,
+                                                 std::vector<timestamp_t>& timestamps) const
+{
+    auto valuesBegin = _values;
+    auto valuesEnd = _values + _header->valuesCount;
+
+    auto it = std::lower_bound(valuesBegin, valuesEnd, begin,
+                               [] (const FieldIndexFileValue& entry, T key) {
+        return static_cast<T>(entry.value) < key;
+    });
+
+    // decode all matching posting lists, then sort them once
+    auto firstPos = timestamps.size();
+    std::size_t count = 0;
+    std::size_t lists = 0;
+
+    for (; it != valuesEnd && static_cast<T>(it->value) <= end; ++it) {
+        count += this->decodePostings(*it, timestamps);
+        lists++;
+    }
+
+    if (lists > 1) {
+        std::sort(timestamps.begin() + firstPos, timestamps.end());
+    }
+
+    return count;
+}
+
+std::size_t FieldIndexSource::lookupSintRange(std::int64_t begin,
+                                              std::int64_t end,
+                                              std::vector<timestamp_t>& timestamps) const
+{
+    if (_header->valueType != FieldIndexValueType::SINT) {
+        return 0;
+    }
+
+    return this->lookupIntegerRange(begin, end, timestamps);
+}
+
+std::size_t FieldIndexSource::lookupUintRange(std::uint64_t begin,
+                                              std::uint64_t end,
+                                              std::vector<timestamp_t>& timestamps) const
+{
+    if (_header->valueType != FieldIndexValueType::UINT) {
+        return 0;
+    }
+
+    return this->lookupIntegerRange(begin, end, timestamps);
+}
+
+}
+}
@@ -0,0 +1,154 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_FIELDINDEXSOURCE_HPP
+#define _TIBEE_COMMON_FIELDINDEXSOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/cache/FieldIndexFormat.hpp>
+#include <common/utils/MappedFile.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A field index source; answers value and value range lookups using a
+ * field index file written by a FieldIndexSink.
+ *
+ * Lookups bisect the value directory and only decode the posting
+ * lists of matching values, so the cost of a lookup depends on the
+ * number of results, not on the trace size.
+ *
+ * @author Philippe Proulx
+ */
+class FieldIndexSource :
+    boost::noncopyable
+{
+public:
+    /**
+     * Opens a field index file.
+     *
+     * Throws ex::FieldIndexSource if the file is not a valid field
+     * index file.
+     *
+     * @param path Path of field index file
+     */
+    FieldIndexSource(const boost::filesystem::path& path);
+
+    /**
+     * Returns the value type of this index.
+     *
+     * @returns Value type
+     */
+    FieldIndexValueType getValueType() const
+    {
+        return _header->valueType;
+    }
+
+    /**
+     * Returns the number of distinct indexed values.
+     *
+     * @returns Number of distinct values
+     */
+    std::size_t getValuesCount() const
+    {
+        return _header->valuesCount;
+    }
+
+    /**
+     * Appends to \p timestamps the timestamps of the events having
+     * integer value \p value, in ascending order.
+     *
+     * Nothing is appended if this index is not a signed integer
+     * index (respectively, an unsigned integer index for
+     * lookupUint()).
+     *
+     * @param value      Value to look up
+     * @param timestamps Timestamps output
+     * @returns          Number of appended timestamps
+     */
+    std::size_t lookupSint(std::int64_t value,
+                           std::vector<timestamp_t>& timestamps) const;
+
+    /**
+     * @see lookupSint()
+     */
+    std::size_t lookupUint(std::uint64_t value,
+                           std::vector<timestamp_t>& timestamps) const;
+
+    /**
+     * Appends to \p timestamps the timestamps of the events having
+     * string value \p value, in ascending order.
+     *
+     * @param value      Value to look up
+     * @param timestamps Timestamps output
+     * @returns          Number of appended timestamps
+     */
+    std::size_t lookupString(const std::string& value,
+                             std::vector<timestamp_t>& timestamps) const;
+
+    /**
+     * Appends to \p timestamps the timestamps of the events having an
+     * integer value within [\p begin, \p end], in ascending order.
+     *
+     * Nothing is appended if this index is not a signed integer
+     * index (respectively, an unsigned integer index for
+     * lookupUintRange()).
+     *
+     * @param begin      Range begin (inclusive)
+     * @param end        Range end (inclusive)
+     * @param timestamps Timestamps output
+     * @returns          Number of appended timestamps
+     */
+    std::size_t lookupSintRange(std::int64_t begin, std::int64_t end,
+                                std::vector<timestamp_t>& timestamps) const;
+
+    /**
+     * @see lookupSintRange()
+     */
+    std::size_t lookupUintRange(std::uint64_t begin, std::uint64_t end,
+                                std::vector<timestamp_t>& timestamps) const;
+
+private:
+    template<typename T>
+    std::size_t lookupIntegerRange(T begin, T end,
+                                   std::vector<timestamp_t>& timestamps) const;
+    const char* getString(const FieldIndexFileValue& value) const;
+    std::size_t decodePostings(const FieldIndexFileValue& value,
+                               std::vector<timestamp_t>& timestamps) const;
+
+private:
+    MappedFile _mappedFile;
+    const FieldIndexFileHeader* _header;
+    const FieldIndexFileValue* _values;
+    const char* _strings;
+    const std::uint8_t* _postings;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_FIELDINDEXSOURCE_HPP
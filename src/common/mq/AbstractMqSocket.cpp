@@ -78,11 +78,86 @@ MqMessage::UP AbstractMqSocket::recv()
     return msg;
 }
 
-bool AbstractMqSocket::send(MqMessage::UP msg)
+bool AbstractMqSocket::poll(long timeout)
 {
-    auto ret = ::zmq_sendmsg(_socket, msg->getInternalMessage(), 0);
+    ::zmq_pollitem_t item;
 
-    return ret == 0;
+    item.socket = _socket;
+    item.fd = 0;
+    item.events = ZMQ_POLLIN;
+    item.revents = 0;
+
+    auto ret = ::zmq_poll(&item, 1, timeout);
+
+    // on error, recv() will fail immediately
+    return ret != 0;
+}
+
+bool AbstractMqSocket::hasMore()
+{
+    int more = 0;
+    std::size_t size = sizeof(more);
+
+    if (::zmq_getsockopt(_socket, ZMQ_RCVMORE, &more, &size) != 0) {
+        return false;
+    }
+
+    return more != 0;
+}
+
+bool AbstractMqSocket::send(MqMessage::UP msg, bool more)
+{
+    auto ret = ::zmq_sendmsg(_socket, msg->getInternalMessage(),
+                             more ? ZMQ_SNDMORE : 0);
+
+    // number of bytes sent on success
+    return ret >= 0;
+}
+
+bool AbstractMqSocket::poll(const std::vector<AbstractMqSocket*>& sockets,
+                            std::vector<bool>& ready, long timeout)
+{
+    std::vector<::zmq_pollitem_t> items(sockets.size());
+
+    for (std::size_t x = 0; x < sockets.size(); ++x) {
+        items[x].socket = sockets[x]->_socket;
+        items[x].fd = 0;
+        items[x].events = ZMQ_POLLIN;
+        items[x].revents = 0;
+    }
+
+    auto ret = ::zmq_poll(items.data(), static_cast<int>(items.size()), timeout);
+
+    ready.assign(sockets.size(), false);
+
+    if (ret < 0) {
+        return false;
+    }
+
+    for (std::size_t x = 0; x < sockets.size(); ++x) {
+        ready[x] = (items[x].revents & ZMQ_POLLIN) != 0;
+    }
+
+    return true;
+}
+
+bool AbstractMqSocket::isTerminated()
+{
+    return ::zmq_errno() == ETERM;
+}
+
+bool AbstractMqSocket::isInterrupted()
+{
+    return ::zmq_errno() == EINTR;
+}
+
+bool AbstractMqSocket::proxy(AbstractMqSocket& frontend,
+                             AbstractMqSocket& backend)
+{
+    ::zmq_proxy(frontend._socket, backend._socket, nullptr);
+
+    // zmq_proxy() always returns -1
+    return ::zmq_errno() == ETERM;
 }
 
 }
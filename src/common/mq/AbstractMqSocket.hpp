@@ -19,6 +19,7 @@
 #define _TIBEE_COMMON_ABSTRACTMQSOCKET_HPP
 
 #include <memory>
+#include <vector>
 #include <cstdint>
 #include <boost/utility.hpp>
 
@@ -83,13 +84,75 @@ public:
      */
     MqMessage::UP recv();
 
+    /**
+     * Waits until a message may be received from this socket.
+     *
+     * @param timeout Maximum time to wait (ms); 0 returns immediately
+     *                and -1 waits forever
+     * @returns       True if recv() would not block (a message is
+     *                available or an error occured)
+     */
+    bool poll(long timeout);
+
+    /**
+     * Returns whether or not the last received message is followed by
+     * other parts of the same multipart message.
+     *
+     * @returns True if more parts are to be received
+     */
+    bool hasMore();
+
     /**
      * Sends a message on this socket.
      *
-     * @param msg Message to send
-     * @returns   True if successful
+     * @param msg  Message to send
+     * @param more True if other parts of the same multipart message
+     *             follow this one
+     * @returns    True if successful
+     */
+    bool send(MqMessage::UP msg, bool more = false);
+
+    /**
+     * Waits until messages may be received from some sockets.
+     *
+     * @param sockets Sockets to poll
+     * @param ready   Set to true, for each socket of \p sockets, if
+     *                a message may be received from it
+     * @param timeout Maximum time to wait (ms); 0 returns immediately
+     *                and -1 waits forever
+     * @returns       False if any error occured
+     */
+    static bool poll(const std::vector<AbstractMqSocket*>& sockets,
+                     std::vector<bool>& ready, long timeout);
+
+    /**
+     * Returns whether or not the last failed operation of the calling
+     * thread failed because the message queue context was terminated.
+     *
+     * @returns True if the context was terminated
+     */
+    static bool isTerminated();
+
+    /**
+     * Returns whether or not the last failed operation of the calling
+     * thread failed because it was interrupted by a signal.
+     *
+     * @returns True if interrupted by a signal
+     */
+    static bool isInterrupted();
+
+    /**
+     * Shuttles messages between a frontend and a backend socket until
+     * the message queue context is terminated.
+     *
+     * Typically used with a router frontend socket, to which clients
+     * connect, and a dealer backend socket, to which workers connect.
+     *
+     * @param frontend Frontend socket
+     * @param backend  Backend socket
+     * @returns        True if the context was terminated normally
      */
-    bool send(MqMessage::UP msg);
+    static bool proxy(AbstractMqSocket& frontend, AbstractMqSocket& backend);
 
 protected:
     void* getInternalSocket()
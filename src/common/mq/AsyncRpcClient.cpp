@@ -0,0 +1,186 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+
+#include <common/ex/MqSocket.hpp>
+#include <common/mq/MqContext.hpp>
+#include <common/mq/AsyncRpcClient.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+AsyncRpcClient::AsyncRpcClient(MqContext* context, const std::string& addr) :
+    _context {context},
+    _addr {addr}
+{
+    if (!this->connect()) {
+        throw ex::MqSocket {"cannot connect to " + addr};
+    }
+}
+
+AsyncRpcClient::~AsyncRpcClient()
+{
+    // calls in flight will never complete
+    for (auto& pending : _pending) {
+        pending.second(nullptr);
+    }
+}
+
+bool AsyncRpcClient::connect()
+{
+    _socket = _context->createDealerSocket();
+
+    return _socket->connect(_addr);
+}
+
+void AsyncRpcClient::reset()
+{
+    // replies of calls in flight would come back on the old socket
+    auto pending = std::move(_pending);
+
+    _pending.clear();
+
+    for (auto& call : pending) {
+        call.second(nullptr);
+    }
+
+    _socket->close();
+
+    if (!this->connect()) {
+        throw ex::MqSocket {"cannot reconnect to " + _addr};
+    }
+}
+
+bool AsyncRpcClient::call(const AbstractRpcRequest& request,
+                          MqMessage::UP msg, Callback callback)
+{
+    auto id = request.getId();
+
+    if (!msg || _pending.count(id)) {
+        return false;
+    }
+
+    // correlation frame, empty delimiter, then request
+    MqMessage::UP frames[] = {
+        MqMessage::UP {new MqMessage {&id, sizeof(id)}},
+        MqMessage::UP {new MqMessage {&id, 0}},
+        std::move(msg),
+    };
+    const std::size_t framesCount = sizeof(frames) / sizeof(frames[0]);
+
+    for (std::size_t x = 0; x < framesCount; ++x) {
+        if (!_socket->send(std::move(frames[x]), x + 1 < framesCount)) {
+            /* The server would take whatever frames come next as the
+             * rest of this partial message: start over with a new
+             * socket.
+             */
+            if (x > 0) {
+                this->reset();
+            }
+
+            return false;
+        }
+    }
+
+    _pending[id] = std::move(callback);
+
+    return true;
+}
+
+std::future<MqMessage::UP> AsyncRpcClient::call(const AbstractRpcRequest& request,
+                                                MqMessage::UP msg)
+{
+    // callbacks must be copyable: share the promise
+    auto promise = std::make_shared<std::promise<MqMessage::UP>>();
+    auto future = promise->get_future();
+    auto callback = [promise] (MqMessage::UP reply) {
+        promise->set_value(std::move(reply));
+    };
+
+    if (!this->call(request, std::move(msg), callback)) {
+        promise->set_value(nullptr);
+    }
+
+    return future;
+}
+
+bool AsyncRpcClient::processReply(bool& completed)
+{
+    completed = false;
+    _parts.clear();
+
+    do {
+        auto part = _socket->recv();
+
+        if (!part) {
+            return false;
+        }
+
+        _parts.push_back(std::move(part));
+    } while (_socket->hasMore());
+
+    // correlation frame, delimiter, then reply (ignore anything else)
+    rpc_msg_id_t id;
+
+    if (_parts.size() != 3 || _parts[0]->size() != sizeof(id)) {
+        return true;
+    }
+
+    std::memcpy(&id, _parts[0]->data(), sizeof(id));
+
+    auto it = _pending.find(id);
+
+    if (it == _pending.end()) {
+        return true;
+    }
+
+    auto callback = std::move(it->second);
+
+    _pending.erase(it);
+    callback(std::move(_parts[2]));
+    completed = true;
+
+    return true;
+}
+
+std::size_t AsyncRpcClient::processReplies(long timeout)
+{
+    std::size_t completed = 0;
+
+    // wait for the first reply only, then take what's there
+    while (_socket->poll(timeout)) {
+        bool replyCompleted;
+
+        if (!this->processReply(replyCompleted)) {
+            break;
+        }
+
+        if (replyCompleted) {
+            completed++;
+        }
+
+        timeout = 0;
+    }
+
+    return completed;
+}
+
+}
+}
@@ -0,0 +1,165 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_ASYNCRPCCLIENT_HPP
+#define _TIBEE_COMMON_ASYNCRPCCLIENT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/mq/MqMessage.hpp>
+#include <common/mq/DealerMqSocket.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+class MqContext;
+
+/**
+ * Pipelined asynchronous RPC client.
+ *
+ * Unlike a request socket, which must receive a reply before sending
+ * the next request, this client, built on a dealer socket, may have
+ * any number of requests in flight. Each request is sent with a
+ * correlation frame holding its ID (see AbstractRpcRequest::getId()),
+ * followed by an empty delimiter and the encoded request:
+ *
+ *     [request ID] [] [encoded request]
+ *
+ * A server echoes the routing envelope (everything before the encoded
+ * request) with its reply; AsyncRpcServer and the analysis core broker
+ * do. Replies may thus come back in any order.
+ *
+ * Replies are only received by processReplies(), which completes the
+ * matching calls (futures or callbacks) from the calling thread. Like
+ * any message queue socket, a client must only be used by one thread.
+ *
+ * @author Philippe Proulx
+ */
+class AsyncRpcClient :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to asynchronous RPC client
+    typedef std::unique_ptr<AsyncRpcClient> UP;
+
+    /// Completion callback (reply is \a nullptr if the call failed)
+    typedef std::function<void (MqMessage::UP reply)> Callback;
+
+public:
+    /**
+     * Builds an asynchronous RPC client connected to \p addr.
+     *
+     * Throws ex::MqSocket if the socket cannot be created or
+     * connected.
+     *
+     * \p context must outlive this client, since the socket is
+     * recreated if a request is only partially sent.
+     *
+     * @param context Message queue context
+     * @param addr    Address of server to connect to
+     */
+    AsyncRpcClient(MqContext* context, const std::string& addr);
+
+    ~AsyncRpcClient();
+
+    /**
+     * Sends an encoded request; \p callback is called by
+     * processReplies() when its reply is received.
+     *
+     * If the request is only partially sent, the socket is recreated
+     * and all calls in flight fail (their callbacks are called with
+     * \a nullptr) before returning. Throws ex::MqSocket if the new
+     * socket cannot be connected.
+     *
+     * @param request  Request (only its ID is used)
+     * @param msg      Encoded request
+     * @param callback Completion callback
+     * @returns        True if sent, false if a request with the same
+     *                 ID is in flight or on error
+     */
+    bool call(const AbstractRpcRequest& request, MqMessage::UP msg,
+              Callback callback);
+
+    /**
+     * Sends an encoded request and returns a future of its reply,
+     * ready once processReplies() receives it.
+     *
+     * The reply is \a nullptr if the request cannot be sent (a request
+     * with the same ID is in flight or on error).
+     *
+     * @param request Request (only its ID is used)
+     * @param msg     Encoded request
+     * @returns       Future of reply
+     */
+    std::future<MqMessage::UP> call(const AbstractRpcRequest& request,
+                                    MqMessage::UP msg);
+
+    /**
+     * Receives available replies, waiting at most \p timeout
+     * milliseconds for the first one (-1 to wait indefinitely), and
+     * completes their calls.
+     *
+     * @param timeout Timeout (ms)
+     * @returns       Number of completed calls
+     */
+    std::size_t processReplies(long timeout);
+
+    /**
+     * Returns the number of requests in flight.
+     *
+     * @returns Number of requests in flight
+     */
+    std::size_t getInFlight() const
+    {
+        return _pending.size();
+    }
+
+private:
+    bool connect();
+    void reset();
+    bool processReply(bool& completed);
+
+private:
+    // message queue context and server address (to recreate the socket)
+    MqContext* _context;
+    std::string _addr;
+
+    // dealer socket connected to the server
+    std::unique_ptr<DealerMqSocket> _socket;
+
+    // completion callbacks of requests in flight
+    std::unordered_map<rpc_msg_id_t, Callback> _pending;
+
+    // parts of the last received reply
+    std::vector<MqMessage::UP> _parts;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_ASYNCRPCCLIENT_HPP
@@ -0,0 +1,77 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <common/ex/MqSocket.hpp>
+#include <common/mq/MqContext.hpp>
+#include <common/mq/AsyncRpcServer.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+AsyncRpcServer::AsyncRpcServer(MqContext* context, const std::string& addr)
+{
+    _socket = context->createRouterSocket();
+
+    if (!_socket->bind(addr)) {
+        throw ex::MqSocket {"cannot bind to " + addr};
+    }
+}
+
+bool AsyncRpcServer::recv(Request& request)
+{
+    for (;;) {
+        request.envelope.clear();
+        request.payload = nullptr;
+
+        // the request is the last part; everything before is envelope
+        do {
+            auto part = _socket->recv();
+
+            if (!part) {
+                return false;
+            }
+
+            if (request.payload) {
+                request.envelope.push_back(std::move(request.payload));
+            }
+
+            request.payload = std::move(part);
+        } while (_socket->hasMore());
+
+        if (!request.envelope.empty()) {
+            return true;
+        }
+    }
+}
+
+bool AsyncRpcServer::reply(Request& request, MqMessage::UP reply)
+{
+    for (auto& part : request.envelope) {
+        if (!_socket->send(std::move(part), true)) {
+            return false;
+        }
+    }
+
+    request.envelope.clear();
+
+    return _socket->send(std::move(reply));
+}
+
+}
+}
@@ -0,0 +1,120 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_ASYNCRPCSERVER_HPP
+#define _TIBEE_COMMON_ASYNCRPCSERVER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/mq/MqMessage.hpp>
+#include <common/mq/RouterMqSocket.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+class MqContext;
+
+/**
+ * Asynchronous RPC server.
+ *
+ * Built on a router socket, this server receives requests from many
+ * clients (request sockets or AsyncRpcClient objects) and may answer
+ * them in any order: each received request keeps its routing envelope
+ * (identity of its client, then everything before the encoded request,
+ * like the correlation frame of an AsyncRpcClient request), which
+ * reply() sends back before the reply.
+ *
+ * Like any message queue socket, a server must only be used by one
+ * thread.
+ *
+ * @author Philippe Proulx
+ */
+class AsyncRpcServer :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to asynchronous RPC server
+    typedef std::unique_ptr<AsyncRpcServer> UP;
+
+    /**
+     * Received request.
+     */
+    struct Request
+    {
+        /// Routing envelope, sent back by reply()
+        std::vector<MqMessage::UP> envelope;
+
+        /// Encoded request
+        MqMessage::UP payload;
+    };
+
+public:
+    /**
+     * Builds an asynchronous RPC server bound to \p addr.
+     *
+     * Throws ex::MqSocket if the socket cannot be created or bound.
+     *
+     * @param context Message queue context
+     * @param addr    Bind address
+     */
+    AsyncRpcServer(MqContext* context, const std::string& addr);
+
+    /**
+     * Waits at most \p timeout milliseconds for a request (-1 to wait
+     * indefinitely).
+     *
+     * @param timeout Timeout (ms)
+     * @returns       True if a request may be received
+     */
+    bool poll(long timeout)
+    {
+        return _socket->poll(timeout);
+    }
+
+    /**
+     * Receives the next request, blocking until one is available.
+     * Malformed messages (no envelope) are skipped.
+     *
+     * @param request Received request (replaced)
+     * @returns       True if received, false if the message queue
+     *                context is terminated or on error
+     */
+    bool recv(Request& request);
+
+    /**
+     * Sends a reply to a received request, consuming its envelope.
+     *
+     * @param request Request to reply to
+     * @param reply   Encoded reply
+     * @returns       True if sent
+     */
+    bool reply(Request& request, MqMessage::UP reply);
+
+private:
+    // router socket bound to the server address
+    std::unique_ptr<RouterMqSocket> _socket;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_ASYNCRPCSERVER_HPP
@@ -0,0 +1,59 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_DEALERMQSOCKET_HPP
+#define _TIBEE_COMMON_DEALERMQSOCKET_HPP
+
+#include <zmq.h>
+
+#include <common/mq/AbstractMqSocket.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+class MqContext;
+
+/**
+ * Dealer message queue socket.
+ *
+ * A dealer socket load-balances outgoing messages among its connected
+ * peers and fair-queues incoming ones. Use it as the backend of a
+ * broker dispatching requests to reply sockets of workers.
+ *
+ * @author Philippe Proulx
+ */
+class DealerMqSocket :
+    public AbstractMqSocket
+{
+    friend class MqContext;
+
+private:
+    /**
+     * Builds a dealer socket.
+     */
+    DealerMqSocket(MqContext* context) :
+        AbstractMqSocket {context, ZMQ_DEALER}
+    {
+    }
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_DEALERMQSOCKET_HPP
@@ -23,6 +23,8 @@
 #include <common/mq/ReplyMqSocket.hpp>
 #include <common/mq/PublishMqSocket.hpp>
 #include <common/mq/SubscribeMqSocket.hpp>
+#include <common/mq/RouterMqSocket.hpp>
+#include <common/mq/DealerMqSocket.hpp>
 #include <common/ex/MqContext.hpp>
 #include <common/mq/MqContext.hpp>
 
@@ -68,5 +70,15 @@ std::unique_ptr<SubscribeMqSocket> MqContext::createSubscribeSocket()
     return std::unique_ptr<SubscribeMqSocket> {new SubscribeMqSocket {this}};
 }
 
+std::unique_ptr<RouterMqSocket> MqContext::createRouterSocket()
+{
+    return std::unique_ptr<RouterMqSocket> {new RouterMqSocket {this}};
+}
+
+std::unique_ptr<DealerMqSocket> MqContext::createDealerSocket()
+{
+    return std::unique_ptr<DealerMqSocket> {new DealerMqSocket {this}};
+}
+
 }
 }
@@ -24,6 +24,8 @@
 #include <common/mq/ReplyMqSocket.hpp>
 #include <common/mq/PublishMqSocket.hpp>
 #include <common/mq/SubscribeMqSocket.hpp>
+#include <common/mq/RouterMqSocket.hpp>
+#include <common/mq/DealerMqSocket.hpp>
 
 namespace tibee
 {
@@ -79,6 +81,20 @@ public:
      */
     std::unique_ptr<SubscribeMqSocket> createSubscribeSocket();
 
+    /**
+     * Creates and returns a router socket.
+     *
+     * @returns New router socket or \a nullptr if any error occured
+     */
+    std::unique_ptr<RouterMqSocket> createRouterSocket();
+
+    /**
+     * Creates and returns a dealer socket.
+     *
+     * @returns New dealer socket or \a nullptr if any error occured
+     */
+    std::unique_ptr<DealerMqSocket> createDealerSocket();
+
 private:
     // internal context
     void* _context;
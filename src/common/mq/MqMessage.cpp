@@ -17,6 +17,9 @@
  */
 #include <cstddef>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
 #include <zmq.h>
 
 #include <common/ex/MqMessage.hpp>
@@ -47,6 +50,71 @@ MqMessage::MqMessage(const void* data, std::size_t size)
     std::memcpy(::zmq_msg_data(std::addressof(_msg)), data, size);
 }
 
+MqMessage::MqMessage(std::unique_ptr<std::string> data)
+{
+    auto str = data.get();
+
+    this->initData(&(*str)[0], str->size(), MqMessage::freeString, str);
+    data.release();
+}
+
+MqMessage::MqMessage(std::string&& data)
+{
+    std::unique_ptr<std::string> str {new std::string {std::move(data)}};
+
+    this->initData(&(*str)[0], str->size(), MqMessage::freeString, str.get());
+    str.release();
+}
+
+MqMessage::MqMessage(std::vector<char>&& data)
+{
+    std::unique_ptr<std::vector<char>> vec {
+        new std::vector<char> {std::move(data)}
+    };
+
+    this->initData(vec->data(), vec->size(), MqMessage::freeVector, vec.get());
+    vec.release();
+}
+
+MqMessage::MqMessage(std::shared_ptr<const void> owner, const void* data,
+                     std::size_t size)
+{
+    std::unique_ptr<std::shared_ptr<const void>> ownerRef {
+        new std::shared_ptr<const void> {std::move(owner)}
+    };
+
+    // the message queue never writes to sent data
+    this->initData(const_cast<void*>(data), size, MqMessage::freeOwner,
+                   ownerRef.get());
+    ownerRef.release();
+}
+
+void MqMessage::initData(void* data, std::size_t size, ::zmq_free_fn* freeFn,
+                         void* hint)
+{
+    auto ret = ::zmq_msg_init_data(std::addressof(_msg), data, size, freeFn,
+                                   hint);
+
+    if (ret < 0) {
+        throw ex::MqMessage {"cannot create message queue message"};
+    }
+}
+
+void MqMessage::freeString(void*, void* hint)
+{
+    delete static_cast<std::string*>(hint);
+}
+
+void MqMessage::freeVector(void*, void* hint)
+{
+    delete static_cast<std::vector<char>*>(hint);
+}
+
+void MqMessage::freeOwner(void*, void* hint)
+{
+    delete static_cast<std::shared_ptr<const void>*>(hint);
+}
+
 MqMessage::~MqMessage()
 {
     // TODO: verify if safe to call with a nullified message
@@ -21,6 +21,8 @@
 #include <zmq.h>
 #include <memory>
 #include <cstddef>
+#include <string>
+#include <vector>
 #include <boost/utility.hpp>
 
 namespace tibee
@@ -32,6 +34,11 @@ namespace common
  * Message queue message. This is the atomic element sent and received
  * on message queue sockets.
  *
+ * A message may either copy user data or take ownership of a buffer,
+ * in which case the data is never copied: the buffer is freed by the
+ * message queue once the message is sent, possibly from another
+ * thread.
+ *
  * @author Philippe Proulx
  */
 class MqMessage :
@@ -52,6 +59,42 @@ public:
      */
     MqMessage(const void* data, std::size_t size);
 
+    /**
+     * Builds a message taking ownership of a string, without copying
+     * its data.
+     *
+     * @param data String to send (owned by the message)
+     */
+    explicit MqMessage(std::unique_ptr<std::string> data);
+
+    /**
+     * Builds a message taking ownership of a string, without copying
+     * its data.
+     *
+     * @param data String to send (moved into the message)
+     */
+    explicit MqMessage(std::string&& data);
+
+    /**
+     * Builds a message taking ownership of a buffer, without copying
+     * its data.
+     *
+     * @param data Buffer to send (moved into the message)
+     */
+    explicit MqMessage(std::vector<char>&& data);
+
+    /**
+     * Builds a message sending a block of memory owned by \p owner
+     * (an arena, a memory-mapped file, etc.), without copying it.
+     * The message keeps a reference on \p owner until it's sent.
+     *
+     * @param owner Owner of block (shared)
+     * @param data  Block to send
+     * @param size  Size of block in bytes
+     */
+    MqMessage(std::shared_ptr<const void> owner, const void* data,
+              std::size_t size);
+
     ~MqMessage();
 
     /**
@@ -70,6 +113,11 @@ public:
 
 private:
     MqMessage();
+    void initData(void* data, std::size_t size, ::zmq_free_fn* freeFn,
+                  void* hint);
+    static void freeString(void* data, void* hint);
+    static void freeVector(void* data, void* hint);
+    static void freeOwner(void* data, void* hint);
 
     ::zmq_msg_t* getInternalMessage()
     {
@@ -0,0 +1,60 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_ROUTERMQSOCKET_HPP
+#define _TIBEE_COMMON_ROUTERMQSOCKET_HPP
+
+#include <zmq.h>
+
+#include <common/mq/AbstractMqSocket.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+class MqContext;
+
+/**
+ * Router message queue socket.
+ *
+ * A router socket is used by a service to receive requests from many
+ * clients and send replies to them, each message being prefixed with
+ * the identity of its peer. Use it as the frontend of a broker
+ * dispatching requests to workers.
+ *
+ * @author Philippe Proulx
+ */
+class RouterMqSocket :
+    public AbstractMqSocket
+{
+    friend class MqContext;
+
+private:
+    /**
+     * Builds a router socket.
+     */
+    RouterMqSocket(MqContext* context) :
+        AbstractMqSocket {context, ZMQ_ROUTER}
+    {
+    }
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_ROUTERMQSOCKET_HPP
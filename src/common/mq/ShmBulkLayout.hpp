@@ -0,0 +1,122 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_SHMBULKLAYOUT_HPP
+#define _TIBEE_COMMON_SHMBULKLAYOUT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tibee
+{
+namespace common
+{
+
+/*
+ * Layout of a shared memory bulk segment and of its descriptors,
+ * shared by ShmBulkWriter and ShmBulkReader.
+ *
+ * A segment is a segment header followed by the ring data area, made
+ * of contiguous blocks (block header, then payload), all aligned on
+ * SHM_BULK_ALIGN bytes. A block never wraps around the end of the
+ * data area: the writer pads the end with an empty block instead.
+ *
+ * The state word of a block holds the generation of the block (a
+ * number given by the writer to each written block, also found in
+ * its descriptor) and its state: published by the writer, claimed by
+ * the reader of its descriptor, or free. Reader and writer change it
+ * with compare-and-swap operations only, so that a stale or
+ * duplicated descriptor never claims nor releases a reused block.
+ */
+
+// alignment of blocks (and size of headers)
+const std::size_t SHM_BULK_ALIGN = 64;
+
+// segment magic number and layout version
+const std::uint32_t SHM_BULK_MAGIC = 0x54425348;
+const std::uint32_t SHM_BULK_VERSION = 2;
+
+// block states (two lowest bits of a block state word)
+const std::uint64_t SHM_BULK_BLOCK_FREE = 0;
+const std::uint64_t SHM_BULK_BLOCK_PUBLISHED = 1;
+const std::uint64_t SHM_BULK_BLOCK_CLAIMED = 2;
+
+// returns a block state word
+inline std::uint64_t makeShmBulkBlockState(std::uint64_t generation,
+                                           std::uint64_t state)
+{
+    return (generation << 2) | state;
+}
+
+// segment header
+struct ShmBulkSegmentHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+
+    // size of the data area following the header (bytes)
+    std::uint64_t dataSize;
+};
+
+// block header
+struct ShmBulkBlockHeader
+{
+    // whole block size, header included (bytes)
+    std::uint64_t blockSize;
+
+    // payload size (bytes)
+    std::uint64_t size;
+
+    // generation and state of this block
+    std::atomic<std::uint64_t> state;
+
+    // publication time (writer's steady clock, ns): only read by the writer
+    std::uint64_t publishTime;
+};
+
+// descriptor message magic ("TBSH"), never the first byte of a JSON
+// text or of a MessagePack map
+const char SHM_BULK_DESCRIPTOR_MAGIC[] = {'T', 'B', 'S', 'H'};
+
+// descriptor message (segment name follows)
+struct ShmBulkDescriptor
+{
+    char magic[4];
+    std::uint32_t nameLen;
+
+    // block offset within the data area
+    std::uint64_t offset;
+
+    // block generation
+    std::uint64_t generation;
+
+    // payload size (bytes)
+    std::uint64_t size;
+};
+
+static_assert(sizeof(ShmBulkSegmentHeader) <= SHM_BULK_ALIGN,
+              "segment header does not fit its aligned size");
+static_assert(sizeof(ShmBulkBlockHeader) <= SHM_BULK_ALIGN,
+              "block header does not fit its aligned size");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "block state words must be lock-free to be shared");
+
+}
+}
+
+#endif // _TIBEE_COMMON_SHMBULKLAYOUT_HPP
@@ -0,0 +1,187 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <common/mq/ShmBulkLayout.hpp>
+#include <common/mq/ShmBulkReader.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+ShmBulkBuffer::ShmBulkBuffer(std::shared_ptr<const void> mapping,
+                             std::atomic<std::uint64_t>* state,
+                             std::uint64_t generation,
+                             const std::uint8_t* data, std::size_t size) :
+    _mapping {std::move(mapping)},
+    _state {state},
+    _generation {generation},
+    _data {data},
+    _size {size}
+{
+}
+
+ShmBulkBuffer::~ShmBulkBuffer()
+{
+    // the writer may now reuse the block (nothing to do if it already did)
+    auto claimed = makeShmBulkBlockState(_generation, SHM_BULK_BLOCK_CLAIMED);
+
+    _state->compare_exchange_strong(claimed,
+                                    makeShmBulkBlockState(_generation, SHM_BULK_BLOCK_FREE),
+                                    std::memory_order_release,
+                                    std::memory_order_relaxed);
+}
+
+ShmBulkReader::ShmBulkReader()
+{
+}
+
+bool ShmBulkReader::isDescriptor(const void* data, std::size_t size)
+{
+    return size >= sizeof(ShmBulkDescriptor) &&
+           std::memcmp(data, SHM_BULK_DESCRIPTOR_MAGIC,
+                       sizeof(SHM_BULK_DESCRIPTOR_MAGIC)) == 0;
+}
+
+const ShmBulkReader::Segment* ShmBulkReader::getSegment(const std::string& name)
+{
+    auto it = _segments.find(name);
+
+    if (it != _segments.end()) {
+        return &it->second;
+    }
+
+    // read-write: claiming and releasing a block write its state
+    auto fd = ::shm_open(name.c_str(), O_RDWR, 0);
+
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct ::stat st;
+
+    if (::fstat(fd, &st) < 0 ||
+            static_cast<std::size_t>(st.st_size) < SHM_BULK_ALIGN) {
+        ::close(fd);
+
+        return nullptr;
+    }
+
+    auto mappingSize = static_cast<std::size_t>(st.st_size);
+    auto addr = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+
+    ::close(fd);
+
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // unmapped when the last buffer and this reader are done with it
+    std::shared_ptr<const void> mapping {addr, [mappingSize] (const void* addr) {
+        ::munmap(const_cast<void*>(addr), mappingSize);
+    }};
+
+    auto header = static_cast<const ShmBulkSegmentHeader*>(addr);
+
+    if (header->magic != SHM_BULK_MAGIC ||
+            header->version != SHM_BULK_VERSION ||
+            header->dataSize > mappingSize - SHM_BULK_ALIGN) {
+        return nullptr;
+    }
+
+    Segment segment;
+
+    segment.mapping = mapping;
+    segment.data = static_cast<std::uint8_t*>(addr) + SHM_BULK_ALIGN;
+    segment.dataSize = header->dataSize;
+
+    return &(_segments[name] = segment);
+}
+
+ShmBulkBuffer::UP ShmBulkReader::read(const void* data, std::size_t size)
+{
+    if (!ShmBulkReader::isDescriptor(data, size)) {
+        return nullptr;
+    }
+
+    ShmBulkDescriptor descriptor;
+
+    std::memcpy(&descriptor, data, sizeof(descriptor));
+
+    if (size - sizeof(descriptor) != descriptor.nameLen) {
+        return nullptr;
+    }
+
+    std::string name {
+        static_cast<const char*>(data) + sizeof(descriptor),
+        descriptor.nameLen
+    };
+
+    // a cached mapping may be of a segment replaced by a new writer
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (attempt > 0) {
+            _segments.erase(name);
+        }
+
+        auto segment = this->getSegment(name);
+
+        if (!segment) {
+            return nullptr;
+        }
+
+        // the block and its payload must be within the data area
+        if (descriptor.offset % SHM_BULK_ALIGN != 0 ||
+                descriptor.offset >= segment->dataSize ||
+                segment->dataSize - descriptor.offset - SHM_BULK_ALIGN < descriptor.size) {
+            continue;
+        }
+
+        auto block = reinterpret_cast<ShmBulkBlockHeader*>(segment->data + descriptor.offset);
+
+        // claim: synchronizes with the writer publishing the payload
+        auto published = makeShmBulkBlockState(descriptor.generation,
+                                               SHM_BULK_BLOCK_PUBLISHED);
+        auto claimed = makeShmBulkBlockState(descriptor.generation,
+                                             SHM_BULK_BLOCK_CLAIMED);
+
+        if (!block->state.compare_exchange_strong(published, claimed,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_relaxed)) {
+            continue;
+        }
+
+        return ShmBulkBuffer::UP {
+            new ShmBulkBuffer {
+                segment->mapping, &block->state, descriptor.generation,
+                segment->data + descriptor.offset + SHM_BULK_ALIGN,
+                static_cast<std::size_t>(descriptor.size)
+            }
+        };
+    }
+
+    return nullptr;
+}
+
+}
+}
@@ -0,0 +1,153 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_SHMBULKREADER_HPP
+#define _TIBEE_COMMON_SHMBULKREADER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <boost/utility.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+class ShmBulkReader;
+
+/**
+ * Payload read in place from a shared memory bulk segment.
+ *
+ * The payload block is claimed by this object and released (so that
+ * the writer may reuse it) when this object is destroyed.
+ *
+ * @author Philippe Proulx
+ */
+class ShmBulkBuffer :
+    boost::noncopyable
+{
+    friend class ShmBulkReader;
+
+public:
+    /// Unique pointer to shared memory bulk buffer
+    typedef std::unique_ptr<ShmBulkBuffer> UP;
+
+public:
+    ~ShmBulkBuffer();
+
+    /**
+     * Returns the payload.
+     *
+     * @returns Payload (not aligned beyond 64 bytes)
+     */
+    const std::uint8_t* getData() const
+    {
+        return _data;
+    }
+
+    /**
+     * Returns the payload size.
+     *
+     * @returns Payload size (bytes)
+     */
+    std::size_t getSize() const
+    {
+        return _size;
+    }
+
+private:
+    ShmBulkBuffer(std::shared_ptr<const void> mapping,
+                  std::atomic<std::uint64_t>* state, std::uint64_t generation,
+                  const std::uint8_t* data, std::size_t size);
+
+private:
+    // keeps the segment mapped
+    std::shared_ptr<const void> _mapping;
+
+    // state word and generation of the claimed block
+    std::atomic<std::uint64_t>* _state;
+    std::uint64_t _generation;
+
+    const std::uint8_t* _data;
+    std::size_t _size;
+};
+
+/**
+ * Shared memory bulk payload reader.
+ *
+ * Maps the segments named by the descriptor messages of ShmBulkWriter
+ * objects (mappings are kept for the next descriptors) and gives
+ * access to their payloads in place.
+ *
+ * @author Philippe Proulx
+ */
+class ShmBulkReader :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds a reader without mappings.
+     */
+    ShmBulkReader();
+
+    /**
+     * Returns whether or not a message is a shared memory bulk
+     * descriptor rather than a payload.
+     *
+     * @param data Message data
+     * @param size Message size (bytes)
+     * @returns    True if the message is a descriptor
+     */
+    static bool isDescriptor(const void* data, std::size_t size);
+
+    /**
+     * Reads the payload designated by a descriptor message, claiming
+     * its block. A descriptor may only be read once.
+     *
+     * @param data Descriptor message data
+     * @param size Descriptor message size (bytes)
+     * @returns    Payload or \a nullptr if the descriptor is invalid
+     *             or already read, if its block was reclaimed by the
+     *             writer (see ShmBulkWriter::LEASE_MS), or if its
+     *             segment cannot be mapped
+     */
+    ShmBulkBuffer::UP read(const void* data, std::size_t size);
+
+private:
+    struct Segment
+    {
+        std::shared_ptr<const void> mapping;
+        std::uint8_t* data;
+        std::uint64_t dataSize;
+    };
+
+private:
+    const Segment* getSegment(const std::string& name);
+
+private:
+    // mapped segments by name
+    std::unordered_map<std::string, Segment> _segments;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_SHMBULKREADER_HPP
@@ -0,0 +1,250 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <common/ex/ShmBulk.hpp>
+#include <common/mq/ShmBulkLayout.hpp>
+#include <common/mq/ShmBulkWriter.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+namespace
+{
+
+std::uint64_t alignSize(std::uint64_t size)
+{
+    return (size + SHM_BULK_ALIGN - 1) & ~static_cast<std::uint64_t>(SHM_BULK_ALIGN - 1);
+}
+
+}
+
+ShmBulkWriter::ShmBulkWriter(const std::string& name, std::size_t size,
+                             std::size_t minSize) :
+    _name {name},
+    _minSize {minSize},
+    _head {0},
+    _tail {0},
+    _used {0},
+    _generation {1}
+{
+    _dataSize = size & ~static_cast<std::uint64_t>(SHM_BULK_ALIGN - 1);
+    _mappingSize = SHM_BULK_ALIGN + _dataSize;
+
+    // remove a segment left by a crashed process
+    ::shm_unlink(name.c_str());
+
+    auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (fd < 0) {
+        throw ex::ShmBulk {"cannot create shared memory segment", name};
+    }
+
+    if (::ftruncate(fd, static_cast<::off_t>(_mappingSize)) < 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+
+        throw ex::ShmBulk {"cannot size shared memory segment", name};
+    }
+
+    auto addr = ::mmap(nullptr, _mappingSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+
+    // the mapping keeps its own reference to the segment
+    ::close(fd);
+
+    if (addr == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+
+        throw ex::ShmBulk {"cannot map shared memory segment", name};
+    }
+
+    _addr = static_cast<std::uint8_t*>(addr);
+    _data = _addr + SHM_BULK_ALIGN;
+
+    auto header = reinterpret_cast<ShmBulkSegmentHeader*>(_addr);
+
+    header->magic = SHM_BULK_MAGIC;
+    header->version = SHM_BULK_VERSION;
+    header->dataSize = _dataSize;
+}
+
+ShmBulkWriter::~ShmBulkWriter()
+{
+    ::munmap(_addr, _mappingSize);
+    ::shm_unlink(_name.c_str());
+}
+
+bool ShmBulkWriter::isLocalAddress(const std::string& addr)
+{
+    return addr.compare(0, 6, "ipc://") == 0 ||
+           addr.compare(0, 9, "inproc://") == 0;
+}
+
+std::uint64_t ShmBulkWriter::getTime()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+void ShmBulkWriter::placeBlock(std::uint64_t offset, std::uint64_t blockSize,
+                               std::uint64_t size, std::uint64_t state)
+{
+    auto block = new (_data + offset) ShmBulkBlockHeader;
+
+    block->blockSize = blockSize;
+    block->size = size;
+    block->publishTime = ShmBulkWriter::getTime();
+    block->state.store(state, std::memory_order_release);
+}
+
+bool ShmBulkWriter::isReclaimable(ShmBulkBlockHeader& block, std::uint64_t now)
+{
+    auto state = block.state.load(std::memory_order_acquire);
+    auto generation = state >> 2;
+
+    switch (state & 3) {
+    case SHM_BULK_BLOCK_FREE:
+        return true;
+
+    case SHM_BULK_BLOCK_PUBLISHED:
+        // never claimed: make a late claim fail
+        return now - block.publishTime >= LEASE_MS * 1000000 &&
+               block.state.compare_exchange_strong(state,
+                                                   makeShmBulkBlockState(generation, SHM_BULK_BLOCK_FREE),
+                                                   std::memory_order_acquire,
+                                                   std::memory_order_relaxed);
+
+    default:
+        // claimed: in use by a reader
+        return false;
+    }
+}
+
+void ShmBulkWriter::reclaim()
+{
+    auto now = ShmBulkWriter::getTime();
+
+    // released blocks are reused in order
+    while (_used > 0) {
+        auto block = reinterpret_cast<ShmBulkBlockHeader*>(_data + _tail);
+
+        if (!this->isReclaimable(*block, now)) {
+            break;
+        }
+
+        _used -= block->blockSize;
+        _tail += block->blockSize;
+
+        if (_tail == _dataSize) {
+            _tail = 0;
+        }
+    }
+
+    if (_used == 0) {
+        _head = 0;
+        _tail = 0;
+    }
+}
+
+bool ShmBulkWriter::allocate(std::uint64_t blockSize, std::uint64_t& offset)
+{
+    this->reclaim();
+
+    if (_used == _dataSize) {
+        return false;
+    }
+
+    if (_head < _tail) {
+        // free space is between head and tail
+        if (_tail - _head < blockSize) {
+            return false;
+        }
+    } else if (_dataSize - _head < blockSize) {
+        // free space is after head and before tail: pad the end, wrap
+        if (_tail < blockSize) {
+            return false;
+        }
+
+        this->placeBlock(_head, _dataSize - _head, 0,
+                         makeShmBulkBlockState(0, SHM_BULK_BLOCK_FREE));
+        _used += _dataSize - _head;
+        _head = 0;
+    }
+
+    offset = _head;
+    _head += blockSize;
+    _used += blockSize;
+
+    if (_head == _dataSize) {
+        _head = 0;
+    }
+
+    return true;
+}
+
+MqMessage::UP ShmBulkWriter::write(const void* data, std::size_t size)
+{
+    if (size < _minSize) {
+        return nullptr;
+    }
+
+    auto blockSize = SHM_BULK_ALIGN + alignSize(size);
+    std::uint64_t offset;
+
+    if (blockSize > _dataSize || !this->allocate(blockSize, offset)) {
+        return nullptr;
+    }
+
+    // payload first: the block state publishes it
+    auto generation = _generation++;
+
+    std::memcpy(_data + offset + SHM_BULK_ALIGN, data, size);
+    this->placeBlock(offset, blockSize, size,
+                     makeShmBulkBlockState(generation, SHM_BULK_BLOCK_PUBLISHED));
+
+    // descriptor, then segment name
+    ShmBulkDescriptor descriptor;
+
+    std::memcpy(descriptor.magic, SHM_BULK_DESCRIPTOR_MAGIC,
+                sizeof(descriptor.magic));
+    descriptor.nameLen = static_cast<std::uint32_t>(_name.size());
+    descriptor.offset = offset;
+    descriptor.generation = generation;
+    descriptor.size = size;
+
+    std::vector<char> msg(sizeof(descriptor) + _name.size());
+
+    std::memcpy(msg.data(), &descriptor, sizeof(descriptor));
+    std::memcpy(msg.data() + sizeof(descriptor), _name.data(), _name.size());
+
+    return MqMessage::UP {new MqMessage {std::move(msg)}};
+}
+
+}
+}
@@ -0,0 +1,156 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_SHMBULKWRITER_HPP
+#define _TIBEE_COMMON_SHMBULKWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <boost/utility.hpp>
+
+#include <common/mq/MqMessage.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+struct ShmBulkBlockHeader;
+
+/**
+ * Shared memory bulk payload writer.
+ *
+ * For clients on the same host, copying a multi-megabyte payload
+ * through a message queue socket is wasteful. This writer owns a named
+ * shared memory segment used as a ring of payload blocks: write()
+ * copies a payload into the ring and returns a small descriptor
+ * message to send instead of the payload. A ShmBulkReader maps the
+ * segment, reads the payload in place and releases its block.
+ *
+ * Each block has a state in shared memory (see ShmBulkLayout.hpp):
+ * published by write(), claimed by the reader of its descriptor, and
+ * freed by the reader when done; the writer reuses blocks in order
+ * once freed. A block which is still not claimed LEASE_MS
+ * milliseconds after being published (descriptor lost, or sent to a
+ * remote client which cannot map the segment) is reclaimed, so that
+ * it does not pin the ring. If the ring is full (slow or dead reader),
+ * or if the payload is too small to be worth it, write() returns
+ * \a nullptr and the payload should be sent as usual.
+ *
+ * Only clients on the same host can map the segment: see
+ * isLocalAddress().
+ *
+ * A writer must only be used by one thread.
+ *
+ * @author Philippe Proulx
+ */
+class ShmBulkWriter :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to shared memory bulk writer
+    typedef std::unique_ptr<ShmBulkWriter> UP;
+
+    /// Default minimum size of written payloads (bytes)
+    static const std::size_t DEFAULT_MIN_SIZE = 64 * 1024;
+
+    /// Time after which an unclaimed block is reclaimed (ms)
+    static const std::uint64_t LEASE_MS = 30000;
+
+public:
+    /**
+     * Creates the shared memory segment named \p name (see
+     * shm_open()), replacing any existing one.
+     *
+     * Throws ex::ShmBulk if the segment cannot be created.
+     *
+     * @param name    Segment name (starting with \c /)
+     * @param size    Ring size (bytes)
+     * @param minSize Minimum size of payloads to write (bytes)
+     */
+    ShmBulkWriter(const std::string& name, std::size_t size,
+                  std::size_t minSize);
+
+    /**
+     * Unmaps and removes the segment. Readers keep their mapping.
+     */
+    ~ShmBulkWriter();
+
+    /**
+     * Copies a payload into the ring.
+     *
+     * @param data Payload
+     * @param size Payload size (bytes)
+     * @returns    Descriptor message to send instead of the payload,
+     *             or \a nullptr if the payload must be sent as usual
+     */
+    MqMessage::UP write(const void* data, std::size_t size);
+
+    /**
+     * Returns whether clients connected through the message queue
+     * address \p addr are on the same host, that is, whether they may
+     * be sent descriptors (\c ipc:// and \c inproc:// transports).
+     *
+     * @param addr Message queue address
+     * @returns    True if descriptors may be sent through \p addr
+     */
+    static bool isLocalAddress(const std::string& addr);
+
+    /**
+     * Returns the segment name.
+     *
+     * @returns Segment name
+     */
+    const std::string& getName() const
+    {
+        return _name;
+    }
+
+private:
+    void reclaim();
+    bool allocate(std::uint64_t blockSize, std::uint64_t& offset);
+    bool isReclaimable(ShmBulkBlockHeader& block, std::uint64_t now);
+    void placeBlock(std::uint64_t offset, std::uint64_t blockSize,
+                    std::uint64_t size, std::uint64_t state);
+    static std::uint64_t getTime();
+
+private:
+    std::string _name;
+    std::size_t _minSize;
+
+    // whole mapping and data area
+    std::uint8_t* _addr;
+    std::size_t _mappingSize;
+    std::uint8_t* _data;
+    std::uint64_t _dataSize;
+
+    // offsets of next block and of oldest unreleased block, and
+    // bytes between them
+    std::uint64_t _head;
+    std::uint64_t _tail;
+    std::uint64_t _used;
+
+    // generation of the next block
+    std::uint64_t _generation;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_SHMBULKWRITER_HPP
@@ -15,6 +15,8 @@
  * You should have received a copy of the GNU General Public License
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <cstddef>
+#include <cstring>
 #include <yajl_parse.h>
 
 #include <common/rpc/AbstractJsonRpcMessageDecoder.hpp>
@@ -24,66 +26,86 @@ namespace tibee
 namespace common
 {
 
+namespace
+{
+
+/* Size of the header of yajl allocations, which keeps the allocation
+ * size for yajlRealloc() while keeping the data aligned.
+ */
+const std::size_t YAJL_HEADER_SIZE = alignof(std::max_align_t);
+
+// arena chunk size: a handle, its lexer and their usual buffers
+const std::size_t YAJL_ARENA_CHUNK_SIZE = 8192;
+
+}
+
 AbstractJsonRpcMessageDecoder::AbstractJsonRpcMessageDecoder() :
+    _yajlArena {YAJL_ARENA_CHUNK_SIZE},
     _yajlHandle {nullptr}
 {
-    static const ::yajl_callbacks callbacks = {
-        processNullCb,
-        processBooleanCb,
-        processIntegerCb,
-        processDoubleCb,
-        processNumberCb,
-        processStringCb,
-        processStartMapCb,
-        processMapKeyCb,
-        processEndMapCb,
-        processStartArrayCb,
-        processEndArrayCb,
-    };
-
-    _yajlHandle = ::yajl_alloc(std::addressof(callbacks), nullptr,
-                               static_cast<void*>(this));
+    _yajlAllocFuncs.malloc = AbstractJsonRpcMessageDecoder::yajlMalloc;
+    _yajlAllocFuncs.realloc = AbstractJsonRpcMessageDecoder::yajlRealloc;
+    _yajlAllocFuncs.free = AbstractJsonRpcMessageDecoder::yajlFree;
+    _yajlAllocFuncs.ctx = static_cast<void*>(&_yajlArena);
+    this->resetHandle();
 }
 
 AbstractJsonRpcMessageDecoder::~AbstractJsonRpcMessageDecoder()
 {
-    if (_yajlHandle) {
-        ::yajl_free(_yajlHandle);
-    }
+    // the arena owns all the memory of the handle
 }
 
-int AbstractJsonRpcMessageDecoder::processNullCb(void* ctx)
+void* AbstractJsonRpcMessageDecoder::yajlMalloc(void* ctx, std::size_t size)
 {
-    AbstractJsonRpcMessageDecoder* decoder = static_cast<AbstractJsonRpcMessageDecoder*>(ctx);
+    auto arena = static_cast<RpcArena*>(ctx);
+    auto block = static_cast<char*>(arena->allocate(YAJL_HEADER_SIZE + size));
 
-    decoder->processNull();
+    *reinterpret_cast<std::size_t*>(block) = size;
 
-    return 1;
+    return block + YAJL_HEADER_SIZE;
 }
 
-int AbstractJsonRpcMessageDecoder::processBooleanCb(void* ctx, int value)
+void* AbstractJsonRpcMessageDecoder::yajlRealloc(void* ctx, void* ptr,
+                                                 std::size_t size)
 {
-    AbstractJsonRpcMessageDecoder* decoder = static_cast<AbstractJsonRpcMessageDecoder*>(ctx);
+    if (!ptr) {
+        return AbstractJsonRpcMessageDecoder::yajlMalloc(ctx, size);
+    }
 
-    decoder->processBoolean(value != 0);
+    auto oldSize = *reinterpret_cast<std::size_t*>(static_cast<char*>(ptr) -
+                                                   YAJL_HEADER_SIZE);
 
-    return 1;
+    if (size <= oldSize) {
+        return ptr;
+    }
+
+    // yajl grows its buffers geometrically: the old block is wasted until the next reset
+    auto newPtr = AbstractJsonRpcMessageDecoder::yajlMalloc(ctx, size);
+
+    std::memcpy(newPtr, ptr, oldSize);
+
+    return newPtr;
+}
+
+void AbstractJsonRpcMessageDecoder::yajlFree(void* ctx, void* ptr)
+{
+    // freed all at once when resetting the arena
 }
 
-int AbstractJsonRpcMessageDecoder::processIntegerCb(void* ctx, long long value)
+int AbstractJsonRpcMessageDecoder::processNullCb(void* ctx)
 {
     AbstractJsonRpcMessageDecoder* decoder = static_cast<AbstractJsonRpcMessageDecoder*>(ctx);
 
-    decoder->processInteger(value != 0);
+    decoder->processNull();
 
     return 1;
 }
 
-int AbstractJsonRpcMessageDecoder::processDoubleCb(void* ctx, double value)
+int AbstractJsonRpcMessageDecoder::processBooleanCb(void* ctx, int value)
 {
     AbstractJsonRpcMessageDecoder* decoder = static_cast<AbstractJsonRpcMessageDecoder*>(ctx);
 
-    decoder->processDouble(value);
+    decoder->processBoolean(value != 0);
 
     return 1;
 }
@@ -151,12 +173,44 @@ int AbstractJsonRpcMessageDecoder::processEndArrayCb(void* ctx)
     return 1;
 }
 
+void AbstractJsonRpcMessageDecoder::resetHandle()
+{
+    // yajl calls the number callback instead of the integer/double ones
+    static const ::yajl_callbacks callbacks = {
+        processNullCb,
+        processBooleanCb,
+        nullptr,
+        nullptr,
+        processNumberCb,
+        processStringCb,
+        processStartMapCb,
+        processMapKeyCb,
+        processEndMapCb,
+        processStartArrayCb,
+        processEndArrayCb,
+    };
+
+    // no yajl_free(): resetting the arena frees the previous handle
+    _yajlArena.reset();
+    _yajlHandle = ::yajl_alloc(std::addressof(callbacks), &_yajlAllocFuncs,
+                               static_cast<void*>(this));
+}
+
 bool AbstractJsonRpcMessageDecoder::parse(const char* json, std::size_t len)
 {
+    // a yajl handle cannot parse anything after a complete document
+    this->resetHandle();
+
     auto ret = ::yajl_parse(_yajlHandle,
                             reinterpret_cast<const unsigned char*>(json),
                             len);
 
+    if (ret != ::yajl_status_ok) {
+        return false;
+    }
+
+    ret = ::yajl_complete_parse(_yajlHandle);
+
     return ret == ::yajl_status_ok;
 }
 
@@ -24,6 +24,8 @@
 #include <memory>
 #include <functional>
 
+#include <common/rpc/RpcArena.hpp>
+
 namespace tibee
 {
 namespace common
@@ -37,6 +39,13 @@ namespace common
  * possible message, each one setting a specific object state (object
  * currently decoded, stack of JSON states, etc.) and call parse().
  *
+ * All JSON numbers are reported as is to processNumber(), which is
+ * the only way to get 64-bit unsigned integers out of yajl.
+ *
+ * The parser's memory comes from an arena owned by the decoder and
+ * reset before each document, so that, once warmed up, parsing does
+ * not touch the heap.
+ *
  * @author Philippe Proulx
  */
 class AbstractJsonRpcMessageDecoder
@@ -49,11 +58,23 @@ public:
 
     virtual ~AbstractJsonRpcMessageDecoder();
 
+protected:
+    /**
+     * Parses a complete JSON string, calling appropriate callbacks
+     * below when meeting new tokens.
+     *
+     * This may be called many times on the same decoder, each call
+     * parsing a whole new JSON document.
+     *
+     * @param json JSON string to parse
+     * @param len  JSON string length (bytes)
+     * @returns    True if successfully decoded
+     */
+    bool parse(const char* json, std::size_t len);
+
 private:
     virtual void processNull() = 0;
     virtual void processBoolean(bool value) = 0;
-    virtual void processInteger(long long value) = 0;
-    virtual void processDouble(double value) = 0;
     virtual void processNumber(const char* number, std::size_t len) = 0;
     virtual void processString(const char* value, std::size_t len) = 0;
     virtual void processStartMap() = 0;
@@ -62,20 +83,10 @@ private:
     virtual void processStartArray() = 0;
     virtual void processEndArray() = 0;
 
-    /**
-     * Parses a JSON string, calling appropriate callbacks above when
-     * meeting new tokens.
-     *
-     * @param json JSON string to parse
-     * @param len  JSON string length (bytes)
-     * @returns    True if successfully decoded
-     */
-    bool parse(const char* json, std::size_t len);
+    void resetHandle();
 
     static int processNullCb(void* ctx);
     static int processBooleanCb(void* ctx, int value);
-    static int processIntegerCb(void* ctx, long long value);
-    static int processDoubleCb(void* ctx, double value);
     static int processNumberCb(void* ctx, const char* number, std::size_t len);
     static int processStringCb(void* ctx, const unsigned char* value, std::size_t len);
     static int processStartMapCb(void* ctx);
@@ -83,8 +94,14 @@ private:
     static int processEndMapCb(void* ctx);
     static int processStartArrayCb(void* ctx);
     static int processEndArrayCb(void* ctx);
+    static void* yajlMalloc(void* ctx, std::size_t size);
+    static void* yajlRealloc(void* ctx, void* ptr, std::size_t size);
+    static void yajlFree(void* ctx, void* ptr);
 
 private:
+    // memory of the yajl handle, reset with it
+    RpcArena _yajlArena;
+    ::yajl_alloc_funcs _yajlAllocFuncs;
     ::yajl_handle _yajlHandle;
 };
 
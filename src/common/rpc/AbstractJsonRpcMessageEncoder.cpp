@@ -25,9 +25,14 @@ namespace common
 {
 
 AbstractJsonRpcMessageEncoder::AbstractJsonRpcMessageEncoder() :
-    _yajlGen {nullptr}
+    _yajlGen {nullptr},
+    _lastSize {0}
 {
     _yajlGen = ::yajl_gen_alloc(nullptr);
+
+    // print directly to the output string instead of yajl's buffer
+    ::yajl_gen_config(_yajlGen, ::yajl_gen_print_callback,
+                      AbstractJsonRpcMessageEncoder::print, this);
 }
 
 AbstractJsonRpcMessageEncoder::~AbstractJsonRpcMessageEncoder()
@@ -41,6 +46,18 @@ void AbstractJsonRpcMessageEncoder::resetGenerator()
 {
     ::yajl_gen_reset(_yajlGen, nullptr);
     ::yajl_gen_clear(_yajlGen);
+
+    // messages of a given encoder usually have similar sizes
+    _output = std::unique_ptr<std::string> {new std::string};
+    _output->reserve(_lastSize);
+}
+
+void AbstractJsonRpcMessageEncoder::print(void* ctx, const char* str,
+                                          std::size_t len)
+{
+    auto encoder = static_cast<AbstractJsonRpcMessageEncoder*>(ctx);
+
+    encoder->_output->append(str, len);
 }
 
 std::unique_ptr<std::string>
@@ -148,17 +165,10 @@ AbstractJsonRpcMessageEncoder::encodeNotification(const AbstractRpcNotification&
 std::unique_ptr<std::string>
 AbstractJsonRpcMessageEncoder::getJsonStringFromBuffer()
 {
-    // copy buffer
-    const unsigned char* buf;
-    std::size_t len;
-
-    ::yajl_gen_get_buf(_yajlGen, std::addressof(buf), std::addressof(len));
-
-    std::unique_ptr<std::string> str {
-        new std::string {reinterpret_cast<const char*>(buf), len}
-    };
+    // hand the output string over (no copy)
+    _lastSize = _output->size();
 
-    return str;
+    return std::move(_output);
 }
 
 }
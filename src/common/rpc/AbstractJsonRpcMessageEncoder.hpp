@@ -24,6 +24,7 @@
 #include <memory>
 #include <cstring>
 #include <functional>
+#include <string>
 
 #include <common/rpc/AbstractRpcMessage.hpp>
 #include <common/rpc/AbstractRpcRequest.hpp>
@@ -96,9 +97,16 @@ protected:
 private:
     void resetGenerator();
     std::unique_ptr<std::string> getJsonStringFromBuffer();
+    static void print(void* ctx, const char* str, std::size_t len);
 
 private:
     ::yajl_gen _yajlGen;
+
+    // output string of the message being encoded
+    std::unique_ptr<std::string> _output;
+
+    // size of the last encoded message
+    std::size_t _lastSize;
 };
 
 }
@@ -0,0 +1,448 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <common/rpc/AbstractMsgPackRpcMessageDecoder.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+AbstractMsgPackRpcMessageDecoder::AbstractMsgPackRpcMessageDecoder() :
+    _at {nullptr},
+    _end {nullptr}
+{
+}
+
+AbstractMsgPackRpcMessageDecoder::~AbstractMsgPackRpcMessageDecoder()
+{
+}
+
+bool AbstractMsgPackRpcMessageDecoder::isMsgPack(const char* data,
+                                                 std::size_t len)
+{
+    if (len == 0) {
+        return false;
+    }
+
+    auto first = static_cast<std::uint8_t>(data[0]);
+
+    // fixmap, map 16 or map 32
+    return (first & 0xf0) == 0x80 || first == 0xde || first == 0xdf;
+}
+
+bool AbstractMsgPackRpcMessageDecoder::read(std::size_t size,
+                                            const std::uint8_t*& bytes)
+{
+    if (static_cast<std::size_t>(_end - _at) < size) {
+        return false;
+    }
+
+    bytes = _at;
+    _at += size;
+
+    return true;
+}
+
+bool AbstractMsgPackRpcMessageDecoder::readBigEndian(std::size_t size,
+                                                     std::uint64_t& value)
+{
+    const std::uint8_t* bytes;
+
+    if (!this->read(size, bytes)) {
+        return false;
+    }
+
+    value = 0;
+
+    for (std::size_t x = 0; x < size; ++x) {
+        value = (value << 8) | bytes[x];
+    }
+
+    return true;
+}
+
+std::uint64_t AbstractMsgPackRpcMessageDecoder::getLittleEndian(const std::uint8_t* bytes,
+                                                                std::size_t size)
+{
+    std::uint64_t value = 0;
+
+    for (std::size_t x = size; x > 0; --x) {
+        value = (value << 8) | bytes[x - 1];
+    }
+
+    return value;
+}
+
+void AbstractMsgPackRpcMessageDecoder::processUint(std::uint64_t value)
+{
+    if (value <= static_cast<std::uint64_t>(std::numeric_limits<long long>::max())) {
+        this->processInteger(static_cast<long long>(value));
+
+        return;
+    }
+
+    // too large for a long long: report as text, like yajl does
+    auto str = std::to_string(value);
+
+    this->processNumber(str.c_str(), str.size());
+}
+
+void AbstractMsgPackRpcMessageDecoder::processTypedArray(MsgPackTypedArrayType type,
+                                                         const std::uint8_t* data,
+                                                         std::size_t count)
+{
+    this->processStartArray();
+
+    for (std::size_t x = 0; x < count; ++x) {
+        switch (type) {
+        case MsgPackTypedArrayType::UINT32:
+            this->processUint(getLittleEndian(data + x * 4, 4));
+            break;
+
+        case MsgPackTypedArrayType::UINT64:
+            this->processUint(getLittleEndian(data + x * 8, 8));
+            break;
+
+        case MsgPackTypedArrayType::INT64:
+            this->processInteger(static_cast<long long>(getLittleEndian(data + x * 8, 8)));
+            break;
+
+        case MsgPackTypedArrayType::FLOAT64:
+        {
+            auto bits = getLittleEndian(data + x * 8, 8);
+            double value;
+
+            std::memcpy(&value, &bits, sizeof(value));
+            this->processDouble(value);
+            break;
+        }
+        }
+    }
+
+    this->processEndArray();
+}
+
+bool AbstractMsgPackRpcMessageDecoder::parseExt(std::size_t size)
+{
+    const std::uint8_t* type;
+    const std::uint8_t* data;
+
+    if (!this->read(1, type) || !this->read(size, data)) {
+        return false;
+    }
+
+    std::size_t elemSize;
+
+    switch (static_cast<MsgPackTypedArrayType>(*type)) {
+    case MsgPackTypedArrayType::UINT32:
+        elemSize = 4;
+        break;
+
+    case MsgPackTypedArrayType::UINT64:
+    case MsgPackTypedArrayType::INT64:
+    case MsgPackTypedArrayType::FLOAT64:
+        elemSize = 8;
+        break;
+
+    default:
+        // unknown extension
+        return false;
+    }
+
+    if (size % elemSize != 0) {
+        return false;
+    }
+
+    this->processTypedArray(static_cast<MsgPackTypedArrayType>(*type), data,
+                            size / elemSize);
+
+    return true;
+}
+
+bool AbstractMsgPackRpcMessageDecoder::parseString(std::size_t size,
+                                                   bool isKey)
+{
+    const std::uint8_t* bytes;
+
+    if (!this->read(size, bytes)) {
+        return false;
+    }
+
+    auto str = reinterpret_cast<const char*>(bytes);
+
+    if (isKey) {
+        this->processMapKey(str, size);
+    } else {
+        this->processString(str, size);
+    }
+
+    return true;
+}
+
+bool AbstractMsgPackRpcMessageDecoder::openContainer(bool isMap,
+                                                     std::uint64_t size)
+{
+    // each value takes at least one byte
+    auto values = isMap ? size * 2 : size;
+
+    if (values > static_cast<std::uint64_t>(_end - _at)) {
+        return false;
+    }
+
+    if (isMap) {
+        this->processStartMap();
+    } else {
+        this->processStartArray();
+    }
+
+    _containers.push_back({isMap, values});
+
+    return true;
+}
+
+bool AbstractMsgPackRpcMessageDecoder::parseValue()
+{
+    const std::uint8_t* bytes;
+
+    if (!this->read(1, bytes)) {
+        return false;
+    }
+
+    auto marker = *bytes;
+    bool isKey = !_containers.empty() && _containers.back().isMap &&
+                 _containers.back().remaining % 2 == 0;
+
+    if (!_containers.empty()) {
+        _containers.back().remaining--;
+    }
+
+    // fixstr
+    if ((marker & 0xe0) == 0xa0) {
+        return this->parseString(marker & 0x1f, isKey);
+    }
+
+    // a map key must be a string (str 8/16/32 or bin 8/16/32)
+    if (isKey && marker != 0xd9 && marker != 0xda && marker != 0xdb &&
+            marker != 0xc4 && marker != 0xc5 && marker != 0xc6) {
+        return false;
+    }
+
+    // positive fixint
+    if (marker <= 0x7f) {
+        this->processInteger(marker);
+
+        return true;
+    }
+
+    // negative fixint
+    if (marker >= 0xe0) {
+        this->processInteger(static_cast<std::int8_t>(marker));
+
+        return true;
+    }
+
+    // fixmap and fixarray
+    if ((marker & 0xf0) == 0x80) {
+        return this->openContainer(true, marker & 0x0f);
+    }
+
+    if ((marker & 0xf0) == 0x90) {
+        return this->openContainer(false, marker & 0x0f);
+    }
+
+    std::uint64_t value;
+
+    switch (marker) {
+    case 0xc0:
+        this->processNull();
+
+        return true;
+
+    case 0xc2:
+    case 0xc3:
+        this->processBoolean(marker == 0xc3);
+
+        return true;
+
+    case 0xc4:
+    case 0xc5:
+    case 0xc6:
+        // bin 8/16/32 (reported as a string)
+        if (!this->readBigEndian(static_cast<std::size_t>(1) << (marker - 0xc4), value)) {
+            return false;
+        }
+
+        return this->parseString(static_cast<std::size_t>(value), isKey);
+
+    case 0xd9:
+    case 0xda:
+    case 0xdb:
+        // str 8/16/32
+        if (!this->readBigEndian(static_cast<std::size_t>(1) << (marker - 0xd9), value)) {
+            return false;
+        }
+
+        return this->parseString(static_cast<std::size_t>(value), isKey);
+
+    case 0xc7:
+    case 0xc8:
+    case 0xc9:
+        // ext 8/16/32
+        if (!this->readBigEndian(static_cast<std::size_t>(1) << (marker - 0xc7), value)) {
+            return false;
+        }
+
+        return this->parseExt(static_cast<std::size_t>(value));
+
+    case 0xd4:
+    case 0xd5:
+    case 0xd6:
+    case 0xd7:
+    case 0xd8:
+        // fixext 1/2/4/8/16
+        return this->parseExt(static_cast<std::size_t>(1) << (marker - 0xd4));
+
+    case 0xca:
+    {
+        // float 32
+        std::uint32_t bits;
+        float flt;
+
+        if (!this->readBigEndian(4, value)) {
+            return false;
+        }
+
+        bits = static_cast<std::uint32_t>(value);
+        std::memcpy(&flt, &bits, sizeof(flt));
+        this->processDouble(flt);
+
+        return true;
+    }
+
+    case 0xcb:
+    {
+        // float 64
+        double dbl;
+
+        if (!this->readBigEndian(8, value)) {
+            return false;
+        }
+
+        std::memcpy(&dbl, &value, sizeof(dbl));
+        this->processDouble(dbl);
+
+        return true;
+    }
+
+    case 0xcc:
+    case 0xcd:
+    case 0xce:
+    case 0xcf:
+        // uint 8/16/32/64
+        if (!this->readBigEndian(static_cast<std::size_t>(1) << (marker - 0xcc), value)) {
+            return false;
+        }
+
+        this->processUint(value);
+
+        return true;
+
+    case 0xd0:
+    case 0xd1:
+    case 0xd2:
+    case 0xd3:
+    {
+        // int 8/16/32/64: sign-extend
+        std::size_t intSize = static_cast<std::size_t>(1) << (marker - 0xd0);
+
+        if (!this->readBigEndian(intSize, value)) {
+            return false;
+        }
+
+        if (intSize < 8 && (value >> (intSize * 8 - 1)) != 0) {
+            value |= ~static_cast<std::uint64_t>(0) << (intSize * 8);
+        }
+
+        this->processInteger(static_cast<long long>(value));
+
+        return true;
+    }
+
+    case 0xdc:
+    case 0xde:
+        // array 16, map 16
+        if (!this->readBigEndian(2, value)) {
+            return false;
+        }
+
+        return this->openContainer(marker == 0xde, value);
+
+    case 0xdd:
+    case 0xdf:
+        // array 32, map 32
+        if (!this->readBigEndian(4, value)) {
+            return false;
+        }
+
+        return this->openContainer(marker == 0xdf, value);
+    }
+
+    // reserved (0xc1)
+    return false;
+}
+
+void AbstractMsgPackRpcMessageDecoder::closeContainers()
+{
+    while (!_containers.empty() && _containers.back().remaining == 0) {
+        if (_containers.back().isMap) {
+            this->processEndMap();
+        } else {
+            this->processEndArray();
+        }
+
+        _containers.pop_back();
+    }
+}
+
+bool AbstractMsgPackRpcMessageDecoder::parse(const char* data, std::size_t len)
+{
+    _at = reinterpret_cast<const std::uint8_t*>(data);
+    _end = _at + len;
+    _containers.clear();
+
+    // one top-level value, then all the values of open containers
+    do {
+        if (!this->parseValue()) {
+            return false;
+        }
+
+        this->closeContainers();
+    } while (!_containers.empty());
+
+    // nothing may follow the document
+    return _at == _end;
+}
+
+}
+}
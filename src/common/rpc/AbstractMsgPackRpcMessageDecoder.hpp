@@ -0,0 +1,147 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_ABSTRACTMSGPACKRPCMESSAGEDECODER_HPP
+#define _TIBEE_COMMON_ABSTRACTMSGPACKRPCMESSAGEDECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <common/rpc/MsgPackWriter.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Abstract MessagePack RPC message decoder.
+ *
+ * The parser calls the same callbacks as AbstractJsonRpcMessageDecoder
+ * does for the equivalent JSON document, so that a concrete decoder
+ * may implement both. Map keys must be strings; binary values are
+ * reported as strings. Typed arrays (see MsgPackWriter) are reported
+ * with processTypedArray().
+ *
+ * @author Philippe Proulx
+ */
+class AbstractMsgPackRpcMessageDecoder
+{
+public:
+    /**
+     * Builds an abstract MessagePack RPC message decoder.
+     */
+    AbstractMsgPackRpcMessageDecoder();
+
+    virtual ~AbstractMsgPackRpcMessageDecoder();
+
+    /**
+     * Returns whether or not a message looks like a MessagePack RPC
+     * message rather than JSON text: a MessagePack RPC message is a
+     * map, which never starts with a valid JSON character.
+     *
+     * @param data Message data
+     * @param len  Message length (bytes)
+     * @returns    True if the message is MessagePack
+     */
+    static bool isMsgPack(const char* data, std::size_t len);
+
+protected:
+    /**
+     * Parses a complete MessagePack document, calling appropriate
+     * callbacks below when meeting new values.
+     *
+     * This may be called many times on the same decoder, each call
+     * parsing a whole new document.
+     *
+     * @param data MessagePack data to parse
+     * @param len  MessagePack data length (bytes)
+     * @returns    True if successfully decoded
+     */
+    bool parse(const char* data, std::size_t len);
+
+    /**
+     * Reads a little-endian unsigned integer (typed array element).
+     *
+     * @param bytes Integer bytes (need not be aligned)
+     * @param size  Integer size (bytes, at most 8)
+     * @returns     Integer value
+     */
+    static std::uint64_t getLittleEndian(const std::uint8_t* bytes,
+                                         std::size_t size);
+
+private:
+    virtual void processNull() = 0;
+    virtual void processBoolean(bool value) = 0;
+    virtual void processInteger(long long value) = 0;
+    virtual void processDouble(double value) = 0;
+    virtual void processNumber(const char* number, std::size_t len) = 0;
+    virtual void processString(const char* value, std::size_t len) = 0;
+    virtual void processStartMap() = 0;
+    virtual void processMapKey(const char* key, std::size_t len) = 0;
+    virtual void processEndMap() = 0;
+    virtual void processStartArray() = 0;
+    virtual void processEndArray() = 0;
+
+    /**
+     * Called when meeting a typed array. \p data is not aligned and
+     * its elements are little-endian.
+     *
+     * The default implementation reports an array of scalars, as if
+     * the array was not typed.
+     *
+     * @param type  Typed array type
+     * @param data  Packed elements
+     * @param count Number of elements
+     */
+    virtual void processTypedArray(MsgPackTypedArrayType type,
+                                   const std::uint8_t* data,
+                                   std::size_t count);
+
+    void processUint(std::uint64_t value);
+    bool parseValue();
+    bool parseString(std::size_t size, bool isKey);
+    bool openContainer(bool isMap, std::uint64_t size);
+    bool parseExt(std::size_t size);
+    void closeContainers();
+    bool read(std::size_t size, const std::uint8_t*& bytes);
+    bool readBigEndian(std::size_t size, std::uint64_t& value);
+
+private:
+    // container being parsed
+    struct Container
+    {
+        bool isMap;
+
+        // remaining values (keys and values for a map)
+        std::uint64_t remaining;
+    };
+
+private:
+    // current position and end of data
+    const std::uint8_t* _at;
+    const std::uint8_t* _end;
+
+    // containers being parsed, innermost last
+    std::vector<Container> _containers;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_ABSTRACTMSGPACKRPCMESSAGEDECODER_HPP
@@ -0,0 +1,122 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <common/rpc/AbstractMsgPackRpcMessageEncoder.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+AbstractMsgPackRpcMessageEncoder::AbstractMsgPackRpcMessageEncoder() :
+    _lastSize {0}
+{
+}
+
+AbstractMsgPackRpcMessageEncoder::~AbstractMsgPackRpcMessageEncoder()
+{
+}
+
+void AbstractMsgPackRpcMessageEncoder::resetWriter()
+{
+    // messages of a given encoder usually have similar sizes
+    _output = std::unique_ptr<std::string> {new std::string};
+    _output->reserve(_lastSize);
+    _writer.setOutput(_output.get());
+}
+
+std::unique_ptr<std::string>
+AbstractMsgPackRpcMessageEncoder::encodeRequest(const AbstractRpcRequest& request,
+                                                const ObjectEncodeFunc& paramsEncodeFunc)
+{
+    this->resetWriter();
+
+    // method, ID, parameters
+    _writer.writeMapHeader(3);
+    _writer.writeString("method", 6);
+    _writer.writeString(request.getMethod());
+    _writer.writeString("id", 2);
+    _writer.writeUint(request.getId());
+    _writer.writeString("params", 6);
+    _writer.writeArrayHeader(1);
+
+    if (!paramsEncodeFunc(request, _writer)) {
+        return nullptr;
+    }
+
+    return this->getOutput();
+}
+
+std::unique_ptr<std::string>
+AbstractMsgPackRpcMessageEncoder::encodeResponse(const AbstractRpcResponse& response,
+                                                 const ObjectEncodeFunc& resultEncodeFunc,
+                                                 const ObjectEncodeFunc& errorEncodeFunc)
+{
+    this->resetWriter();
+
+    // ID, result, error
+    _writer.writeMapHeader(3);
+    _writer.writeString("id", 2);
+    _writer.writeUint(response.getId());
+    _writer.writeString("result", 6);
+
+    if (!resultEncodeFunc(response, _writer)) {
+        return nullptr;
+    }
+
+    _writer.writeString("error", 5);
+
+    if (!errorEncodeFunc(response, _writer)) {
+        return nullptr;
+    }
+
+    return this->getOutput();
+}
+
+std::unique_ptr<std::string>
+AbstractMsgPackRpcMessageEncoder::encodeNotification(const AbstractRpcNotification& notification,
+                                                     const ObjectEncodeFunc& paramsEncodeFunc)
+{
+    this->resetWriter();
+
+    // method, ID (nil), parameters
+    _writer.writeMapHeader(3);
+    _writer.writeString("method", 6);
+    _writer.writeString(notification.getMethod());
+    _writer.writeString("id", 2);
+    _writer.writeNil();
+    _writer.writeString("params", 6);
+    _writer.writeArrayHeader(1);
+
+    if (!paramsEncodeFunc(notification, _writer)) {
+        return nullptr;
+    }
+
+    return this->getOutput();
+}
+
+std::unique_ptr<std::string> AbstractMsgPackRpcMessageEncoder::getOutput()
+{
+    // hand the output string over (no copy)
+    _lastSize = _output->size();
+    _writer.setOutput(nullptr);
+
+    return std::move(_output);
+}
+
+}
+}
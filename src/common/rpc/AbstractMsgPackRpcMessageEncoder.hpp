@@ -0,0 +1,113 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_ABSTRACTMSGPACKRPCMESSAGEENCODER_HPP
+#define _TIBEE_COMMON_ABSTRACTMSGPACKRPCMESSAGEENCODER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <functional>
+#include <string>
+
+#include <common/rpc/MsgPackWriter.hpp>
+#include <common/rpc/AbstractRpcMessage.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+#include <common/rpc/AbstractRpcResponse.hpp>
+#include <common/rpc/AbstractRpcNotification.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Abstract MessagePack RPC message encoder.
+ *
+ * Messages have the same structure as their JSON-RPC counterparts
+ * (see AbstractJsonRpcMessageEncoder), but are encoded as MessagePack,
+ * with typed arrays for large numeric arrays.
+ *
+ * @author Philippe Proulx
+ */
+class AbstractMsgPackRpcMessageEncoder
+{
+public:
+    /**
+     * Builds an abstract MessagePack RPC message encoder.
+     */
+    AbstractMsgPackRpcMessageEncoder();
+
+    virtual ~AbstractMsgPackRpcMessageEncoder();
+
+protected:
+    typedef std::function<bool (const AbstractRpcMessage&, MsgPackWriter&)> ObjectEncodeFunc;
+
+protected:
+    /**
+     * Encodes an RPC request as MessagePack.
+     *
+     * @param request          RPC request to encode
+     * @param paramsEncodeFunc Encode function to use for parameters
+     *                         (must write exactly one value)
+     * @returns                Encoded request or \a nullptr if an error occured
+     */
+    std::unique_ptr<std::string> encodeRequest(const AbstractRpcRequest& request,
+                                               const ObjectEncodeFunc& paramsEncodeFunc);
+
+    /**
+     * Encodes an RPC response as MessagePack.
+     *
+     * @param response         RPC response to encode
+     * @param resultEncodeFunc Encode function to use for result (must
+     *                         write exactly one value)
+     * @param errorEncodeFunc  Encode function to use for error (must
+     *                         write exactly one value)
+     * @returns                Encoded response or \a nullptr if an error occured
+     */
+    std::unique_ptr<std::string> encodeResponse(const AbstractRpcResponse& response,
+                                                const ObjectEncodeFunc& resultEncodeFunc,
+                                                const ObjectEncodeFunc& errorEncodeFunc);
+
+    /**
+     * Encodes an RPC notification as MessagePack.
+     *
+     * @param notification     RPC notification to encode
+     * @param paramsEncodeFunc Encode function to use for parameters
+     *                         (must write exactly one value)
+     * @returns                Encoded notification or \a nullptr if an error occured
+     */
+    std::unique_ptr<std::string> encodeNotification(const AbstractRpcNotification& notification,
+                                                    const ObjectEncodeFunc& paramsEncodeFunc);
+
+private:
+    void resetWriter();
+    std::unique_ptr<std::string> getOutput();
+
+private:
+    MsgPackWriter _writer;
+
+    // output string of the message being encoded
+    std::unique_ptr<std::string> _output;
+
+    // size of the last encoded message
+    std::size_t _lastSize;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_ABSTRACTMSGPACKRPCMESSAGEENCODER_HPP
@@ -0,0 +1,231 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <common/rpc/MsgPackWriter.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+MsgPackWriter::MsgPackWriter() :
+    _output {nullptr}
+{
+}
+
+void MsgPackWriter::writeByte(std::uint8_t value)
+{
+    _output->push_back(static_cast<char>(value));
+}
+
+void MsgPackWriter::writeBigEndian(std::uint64_t value, std::size_t size)
+{
+    char bytes[8];
+
+    for (std::size_t x = 0; x < size; ++x) {
+        bytes[size - 1 - x] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+
+    _output->append(bytes, size);
+}
+
+void MsgPackWriter::writeNil()
+{
+    this->writeByte(0xc0);
+}
+
+void MsgPackWriter::writeBool(bool value)
+{
+    this->writeByte(value ? 0xc3 : 0xc2);
+}
+
+void MsgPackWriter::writeInt(std::int64_t value)
+{
+    if (value >= 0) {
+        this->writeUint(static_cast<std::uint64_t>(value));
+
+        return;
+    }
+
+    if (value >= -32) {
+        // negative fixint
+        this->writeByte(static_cast<std::uint8_t>(value));
+    } else if (value >= INT8_MIN) {
+        this->writeByte(0xd0);
+        this->writeBigEndian(static_cast<std::uint64_t>(value), 1);
+    } else if (value >= INT16_MIN) {
+        this->writeByte(0xd1);
+        this->writeBigEndian(static_cast<std::uint64_t>(value), 2);
+    } else if (value >= INT32_MIN) {
+        this->writeByte(0xd2);
+        this->writeBigEndian(static_cast<std::uint64_t>(value), 4);
+    } else {
+        this->writeByte(0xd3);
+        this->writeBigEndian(static_cast<std::uint64_t>(value), 8);
+    }
+}
+
+void MsgPackWriter::writeUint(std::uint64_t value)
+{
+    if (value <= 0x7f) {
+        // positive fixint
+        this->writeByte(static_cast<std::uint8_t>(value));
+    } else if (value <= UINT8_MAX) {
+        this->writeByte(0xcc);
+        this->writeBigEndian(value, 1);
+    } else if (value <= UINT16_MAX) {
+        this->writeByte(0xcd);
+        this->writeBigEndian(value, 2);
+    } else if (value <= UINT32_MAX) {
+        this->writeByte(0xce);
+        this->writeBigEndian(value, 4);
+    } else {
+        this->writeByte(0xcf);
+        this->writeBigEndian(value, 8);
+    }
+}
+
+void MsgPackWriter::writeDouble(double value)
+{
+    std::uint64_t bits;
+
+    std::memcpy(&bits, &value, sizeof(bits));
+    this->writeByte(0xcb);
+    this->writeBigEndian(bits, 8);
+}
+
+void MsgPackWriter::writeString(const char* str, std::size_t len)
+{
+    if (len <= 31) {
+        // fixstr
+        this->writeByte(static_cast<std::uint8_t>(0xa0 | len));
+    } else if (len <= UINT8_MAX) {
+        this->writeByte(0xd9);
+        this->writeBigEndian(len, 1);
+    } else if (len <= UINT16_MAX) {
+        this->writeByte(0xda);
+        this->writeBigEndian(len, 2);
+    } else {
+        this->writeByte(0xdb);
+        this->writeBigEndian(len, 4);
+    }
+
+    _output->append(str, len);
+}
+
+void MsgPackWriter::writeString(const char* str)
+{
+    this->writeString(str, std::strlen(str));
+}
+
+void MsgPackWriter::writeArrayHeader(std::size_t count)
+{
+    if (count <= 15) {
+        // fixarray
+        this->writeByte(static_cast<std::uint8_t>(0x90 | count));
+    } else if (count <= UINT16_MAX) {
+        this->writeByte(0xdc);
+        this->writeBigEndian(count, 2);
+    } else {
+        this->writeByte(0xdd);
+        this->writeBigEndian(count, 4);
+    }
+}
+
+void MsgPackWriter::writeMapHeader(std::size_t count)
+{
+    if (count <= 15) {
+        // fixmap
+        this->writeByte(static_cast<std::uint8_t>(0x80 | count));
+    } else if (count <= UINT16_MAX) {
+        this->writeByte(0xde);
+        this->writeBigEndian(count, 2);
+    } else {
+        this->writeByte(0xdf);
+        this->writeBigEndian(count, 4);
+    }
+}
+
+void MsgPackWriter::writeTypedArrayData(MsgPackTypedArrayType type,
+                                        const void* values,
+                                        std::size_t elemSize,
+                                        std::size_t count)
+{
+    auto size = elemSize * count;
+
+    // ext header
+    if (size <= UINT8_MAX) {
+        this->writeByte(0xc7);
+        this->writeBigEndian(size, 1);
+    } else if (size <= UINT16_MAX) {
+        this->writeByte(0xc8);
+        this->writeBigEndian(size, 2);
+    } else {
+        this->writeByte(0xc9);
+        this->writeBigEndian(size, 4);
+    }
+
+    this->writeByte(static_cast<std::uint8_t>(type));
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    _output->append(static_cast<const char*>(values), size);
+#else
+    auto bytes = static_cast<const char*>(values);
+
+    for (std::size_t x = 0; x < count; ++x) {
+        for (std::size_t b = elemSize; b > 0; --b) {
+            _output->push_back(bytes[x * elemSize + b - 1]);
+        }
+    }
+#endif
+}
+
+void MsgPackWriter::writeTypedArray(const std::uint32_t* values,
+                                    std::size_t count)
+{
+    this->writeTypedArrayData(MsgPackTypedArrayType::UINT32, values,
+                              sizeof(*values), count);
+}
+
+void MsgPackWriter::writeTypedArray(const std::uint64_t* values,
+                                    std::size_t count)
+{
+    this->writeTypedArrayData(MsgPackTypedArrayType::UINT64, values,
+                              sizeof(*values), count);
+}
+
+void MsgPackWriter::writeTypedArray(const std::int64_t* values,
+                                    std::size_t count)
+{
+    this->writeTypedArrayData(MsgPackTypedArrayType::INT64, values,
+                              sizeof(*values), count);
+}
+
+void MsgPackWriter::writeTypedArray(const double* values, std::size_t count)
+{
+    this->writeTypedArrayData(MsgPackTypedArrayType::FLOAT64, values,
+                              sizeof(*values), count);
+}
+
+}
+}
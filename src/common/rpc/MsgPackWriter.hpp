@@ -0,0 +1,199 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_MSGPACKWRITER_HPP
+#define _TIBEE_COMMON_MSGPACKWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <boost/utility.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Typed array MessagePack extension types.
+ *
+ * A typed array is a MessagePack extension value whose data is the
+ * array elements, packed in little-endian byte order. The number of
+ * elements is the data size divided by the element size.
+ */
+enum class MsgPackTypedArrayType
+{
+    /// 32-bit unsigned integers
+    UINT32 = 1,
+
+    /// 64-bit unsigned integers
+    UINT64 = 2,
+
+    /// 64-bit signed integers
+    INT64 = 3,
+
+    /// 64-bit IEEE 754 floating point numbers
+    FLOAT64 = 4,
+};
+
+/**
+ * MessagePack writer.
+ *
+ * Appends MessagePack values to an output string. The caller is
+ * responsible for writing the right number of values after an array
+ * or map header (one key and one value per map entry).
+ *
+ * @author Philippe Proulx
+ */
+class MsgPackWriter :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds a MessagePack writer without output.
+     */
+    MsgPackWriter();
+
+    /**
+     * Sets the output string; values are appended to it.
+     *
+     * @param output Output string (must outlive the writes)
+     */
+    void setOutput(std::string* output)
+    {
+        _output = output;
+    }
+
+    /**
+     * Writes nil.
+     */
+    void writeNil();
+
+    /**
+     * Writes a boolean.
+     *
+     * @param value Boolean value
+     */
+    void writeBool(bool value);
+
+    /**
+     * Writes a signed integer using the smallest possible format.
+     *
+     * @param value Signed integer value
+     */
+    void writeInt(std::int64_t value);
+
+    /**
+     * Writes an unsigned integer using the smallest possible format.
+     *
+     * @param value Unsigned integer value
+     */
+    void writeUint(std::uint64_t value);
+
+    /**
+     * Writes a 64-bit floating point number.
+     *
+     * @param value Floating point number value
+     */
+    void writeDouble(double value);
+
+    /**
+     * Writes a string.
+     *
+     * @param str String
+     * @param len String length (bytes)
+     */
+    void writeString(const char* str, std::size_t len);
+
+    /**
+     * Writes a string.
+     *
+     * @param str String
+     */
+    void writeString(const std::string& str)
+    {
+        this->writeString(str.data(), str.size());
+    }
+
+    /**
+     * Writes a null-terminated string.
+     *
+     * @param str Null-terminated string
+     */
+    void writeString(const char* str);
+
+    /**
+     * Writes an array header; \p count values must follow.
+     *
+     * @param count Number of array elements
+     */
+    void writeArrayHeader(std::size_t count);
+
+    /**
+     * Writes a map header; \p count key/value pairs must follow.
+     *
+     * @param count Number of map entries
+     */
+    void writeMapHeader(std::size_t count);
+
+    /**
+     * Writes a typed array of 32-bit unsigned integers.
+     *
+     * @param values Values
+     * @param count  Number of values
+     */
+    void writeTypedArray(const std::uint32_t* values, std::size_t count);
+
+    /**
+     * Writes a typed array of 64-bit unsigned integers.
+     *
+     * @param values Values
+     * @param count  Number of values
+     */
+    void writeTypedArray(const std::uint64_t* values, std::size_t count);
+
+    /**
+     * Writes a typed array of 64-bit signed integers.
+     *
+     * @param values Values
+     * @param count  Number of values
+     */
+    void writeTypedArray(const std::int64_t* values, std::size_t count);
+
+    /**
+     * Writes a typed array of 64-bit floating point numbers.
+     *
+     * @param values Values
+     * @param count  Number of values
+     */
+    void writeTypedArray(const double* values, std::size_t count);
+
+private:
+    void writeByte(std::uint8_t value);
+    void writeBigEndian(std::uint64_t value, std::size_t size);
+    void writeTypedArrayData(MsgPackTypedArrayType type, const void* values,
+                             std::size_t elemSize, std::size_t count);
+
+private:
+    // output string
+    std::string* _output;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_MSGPACKWRITER_HPP
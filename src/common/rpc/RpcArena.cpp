@@ -0,0 +1,101 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include <common/rpc/RpcArena.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+namespace
+{
+
+// alignment of every allocation
+const std::size_t ALIGN = alignof(std::max_align_t);
+
+}
+
+bool RpcString::equals(const char* str) const
+{
+    return std::strlen(str) == len && std::memcmp(data, str, len) == 0;
+}
+
+RpcArena::RpcArena(std::size_t chunkSize) :
+    _chunkSize {chunkSize},
+    _curChunk {0},
+    _curOffset {0}
+{
+}
+
+void* RpcArena::allocate(std::size_t size)
+{
+    size = (size + ALIGN - 1) & ~(ALIGN - 1);
+
+    // find a chunk with enough room, starting with the current one
+    while (_curChunk < _chunks.size()) {
+        auto& chunk = _chunks[_curChunk];
+
+        if (chunk.size - _curOffset >= size) {
+            auto ptr = chunk.data.get() + _curOffset;
+
+            _curOffset += size;
+
+            return ptr;
+        }
+
+        _curChunk++;
+        _curOffset = 0;
+    }
+
+    // none: add one (big allocations get their own chunk)
+    Chunk chunk;
+
+    chunk.size = std::max(_chunkSize, size);
+    chunk.data = std::unique_ptr<char[]> {new char[chunk.size]};
+    _chunks.push_back(std::move(chunk));
+    _curOffset = size;
+
+    return _chunks.back().data.get();
+}
+
+RpcString RpcArena::copyString(const char* str, std::size_t len)
+{
+    auto data = static_cast<char*>(this->allocate(len));
+
+    std::memcpy(data, str, len);
+
+    return RpcString {data, len};
+}
+
+std::size_t RpcArena::getCapacity() const
+{
+    std::size_t capacity = 0;
+
+    for (const auto& chunk : _chunks) {
+        capacity += chunk.size;
+    }
+
+    return capacity;
+}
+
+}
+}
@@ -0,0 +1,126 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_RPCARENA_HPP
+#define _TIBEE_COMMON_RPCARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <boost/utility.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * String view into memory owned by someone else (usually an RpcArena).
+ */
+struct RpcString
+{
+    /// First character (not null-terminated)
+    const char* data;
+
+    /// Length (bytes)
+    std::size_t len;
+
+    /**
+     * Returns whether this string is equal to null-terminated
+     * string \p str.
+     *
+     * @param str Null-terminated string to compare with
+     * @returns   True if equal
+     */
+    bool equals(const char* str) const;
+};
+
+/**
+ * Bump allocator for decoding RPC messages.
+ *
+ * Memory is allocated from big chunks and is never freed until the
+ * arena is destroyed: reset() makes all chunks available again. Once
+ * the chunks are big enough for the usual messages of a connection,
+ * decoding a message does not touch the heap.
+ *
+ * @author Philippe Proulx
+ */
+class RpcArena :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds an empty arena.
+     *
+     * @param chunkSize Minimum size of allocated chunks (bytes)
+     */
+    explicit RpcArena(std::size_t chunkSize = 4096);
+
+    /**
+     * Allocates \p size bytes aligned for any scalar type.
+     *
+     * @param size Size to allocate (bytes)
+     * @returns    Allocated memory, valid until the next reset()
+     */
+    void* allocate(std::size_t size);
+
+    /**
+     * Copies a string into the arena.
+     *
+     * @param str String to copy
+     * @param len String length (bytes)
+     * @returns   View of the copy, valid until the next reset()
+     */
+    RpcString copyString(const char* str, std::size_t len);
+
+    /**
+     * Makes all the memory of this arena available again. Previously
+     * allocated memory becomes invalid.
+     */
+    void reset()
+    {
+        _curChunk = 0;
+        _curOffset = 0;
+    }
+
+    /**
+     * Returns the total size of the chunks of this arena.
+     *
+     * @returns Total chunks size (bytes)
+     */
+    std::size_t getCapacity() const;
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+private:
+    std::size_t _chunkSize;
+    std::vector<Chunk> _chunks;
+
+    // current chunk index and offset within it
+    std::size_t _curChunk;
+    std::size_t _curOffset;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_RPCARENA_HPP
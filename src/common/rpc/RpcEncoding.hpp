@@ -0,0 +1,42 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_RPCENCODING_HPP
+#define _TIBEE_COMMON_RPCENCODING_HPP
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Encoding of RPC messages on the wire.
+ *
+ * Both encodings carry the same JSON-RPC messages: MSGPACK is the
+ * MessagePack encoding of the JSON-RPC objects, with typed arrays for
+ * large numeric arrays (see MsgPackWriter).
+ */
+enum class RpcEncoding
+{
+    JSON,
+    MSGPACK,
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_RPCENCODING_HPP
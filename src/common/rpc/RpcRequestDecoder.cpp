@@ -0,0 +1,390 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <common/rpc/RpcRequestDecoder.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+RpcRequestDecoder::RpcRequestDecoder()
+{
+    this->reset();
+}
+
+void RpcRequestDecoder::reset()
+{
+    _arena.reset();
+    _mapDepth = 0;
+    _inParams = false;
+    _inParamArray = false;
+    _unexpected = false;
+    _curKey = RpcString {"", 0};
+    _encoding = RpcEncoding::JSON;
+    _method = RpcString {"", 0};
+    _id = 0;
+    _params.clear();
+    _arrayValues.clear();
+}
+
+RpcRequestStatus RpcRequestDecoder::decode(const char* data, std::size_t len)
+{
+    this->reset();
+
+    bool parsed;
+
+    if (AbstractMsgPackRpcMessageDecoder::isMsgPack(data, len)) {
+        _encoding = RpcEncoding::MSGPACK;
+        parsed = AbstractMsgPackRpcMessageDecoder::parse(data, len);
+    } else {
+        parsed = AbstractJsonRpcMessageDecoder::parse(data, len);
+    }
+
+    if (!parsed) {
+        return RpcRequestStatus::PARSE_ERROR;
+    }
+
+    if (_unexpected || _method.len == 0) {
+        return RpcRequestStatus::INVALID_REQUEST;
+    }
+
+    return RpcRequestStatus::OK;
+}
+
+const RpcRequestDecoder::Param* RpcRequestDecoder::findParam(const char* key) const
+{
+    // last one wins
+    for (auto it = _params.rbegin(); it != _params.rend(); ++it) {
+        if (it->key.equals(key)) {
+            return &(*it);
+        }
+    }
+
+    return nullptr;
+}
+
+const RpcValue* RpcRequestDecoder::getParam(const char* key) const
+{
+    auto param = this->findParam(key);
+
+    if (!param || param->isArray) {
+        return nullptr;
+    }
+
+    return &param->value;
+}
+
+const RpcValue* RpcRequestDecoder::getArrayParam(const char* key,
+                                                 std::size_t& count) const
+{
+    static const RpcValue noValue {};
+
+    auto param = this->findParam(key);
+
+    if (!param || !param->isArray) {
+        return nullptr;
+    }
+
+    count = param->arrayCount;
+
+    // valid pointer, even for an empty array
+    if (count == 0) {
+        return &noValue;
+    }
+
+    return _arrayValues.data() + param->arrayBegin;
+}
+
+bool RpcRequestDecoder::toUint(const RpcValue& value, std::uint64_t& uint)
+{
+    if (value.type == RpcValueType::UINT) {
+        uint = value.uint;
+
+        return true;
+    }
+
+    if (value.type != RpcValueType::STRING || value.str.len == 0 ||
+            value.str.len > 20) {
+        return false;
+    }
+
+    // decimal digits only
+    std::uint64_t result = 0;
+
+    for (std::size_t x = 0; x < value.str.len; ++x) {
+        auto ch = value.str.data[x];
+
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+
+        auto digit = static_cast<std::uint64_t>(ch - '0');
+
+        if (result > (std::numeric_limits<std::uint64_t>::max() - digit) / 10) {
+            return false;
+        }
+
+        result = result * 10 + digit;
+    }
+
+    uint = result;
+
+    return true;
+}
+
+bool RpcRequestDecoder::getUintParam(const char* key,
+                                     std::uint64_t& value) const
+{
+    auto param = this->getParam(key);
+
+    return param && RpcRequestDecoder::toUint(*param, value);
+}
+
+bool RpcRequestDecoder::getStringParam(const char* key,
+                                       RpcString& value) const
+{
+    auto param = this->getParam(key);
+
+    if (!param || param->type != RpcValueType::STRING) {
+        return false;
+    }
+
+    value = param->str;
+
+    return true;
+}
+
+void RpcRequestDecoder::processValue(const RpcValue& value)
+{
+    if (_mapDepth == 1 && !_inParams) {
+        // top-level member
+        if (_curKey.equals("method")) {
+            if (value.type != RpcValueType::STRING) {
+                _unexpected = true;
+
+                return;
+            }
+
+            _method = value.str;
+        } else if (_curKey.equals("id")) {
+            std::uint64_t id;
+
+            if (RpcRequestDecoder::toUint(value, id)) {
+                _id = static_cast<rpc_msg_id_t>(id);
+            }
+        }
+    } else if (_mapDepth == 2 && _inParams) {
+        // parameter
+        if (_inParamArray) {
+            _arrayValues.push_back(value);
+            _params.back().arrayCount++;
+        } else {
+            Param param;
+
+            param.key = _curKey;
+            param.isArray = false;
+            param.value = value;
+            _params.push_back(param);
+        }
+    } else {
+        _unexpected = true;
+    }
+}
+
+void RpcRequestDecoder::processNull()
+{
+    RpcValue value;
+
+    value.type = RpcValueType::NUL;
+    this->processValue(value);
+}
+
+void RpcRequestDecoder::processBoolean(bool boolean)
+{
+    RpcValue value;
+
+    value.type = RpcValueType::BOOL;
+    value.boolean = boolean;
+    this->processValue(value);
+}
+
+void RpcRequestDecoder::processInteger(long long integer)
+{
+    RpcValue value;
+
+    if (integer < 0) {
+        value.type = RpcValueType::SINT;
+        value.sint = integer;
+    } else {
+        value.type = RpcValueType::UINT;
+        value.uint = static_cast<std::uint64_t>(integer);
+    }
+
+    this->processValue(value);
+}
+
+void RpcRequestDecoder::processDouble(double dbl)
+{
+    RpcValue value;
+
+    value.type = RpcValueType::DOUBLE;
+    value.dbl = dbl;
+    this->processValue(value);
+}
+
+void RpcRequestDecoder::processNumber(const char* number, std::size_t len)
+{
+    // null-terminated copy for the standard conversion functions
+    auto str = static_cast<char*>(_arena.allocate(len + 1));
+
+    std::memcpy(str, number, len);
+    str[len] = '\0';
+
+    RpcValue value;
+    char* end;
+    bool isInteger = std::strpbrk(str, ".eE") == nullptr;
+
+    errno = 0;
+
+    if (isInteger && str[0] == '-') {
+        value.type = RpcValueType::SINT;
+        value.sint = std::strtoll(str, &end, 10);
+    } else if (isInteger) {
+        value.type = RpcValueType::UINT;
+        value.uint = std::strtoull(str, &end, 10);
+    }
+
+    // not an integer or too large for one: keep as a double
+    if (!isInteger || errno != 0) {
+        errno = 0;
+        value.type = RpcValueType::DOUBLE;
+        value.dbl = std::strtod(str, &end);
+    }
+
+    this->processValue(value);
+}
+
+void RpcRequestDecoder::processString(const char* str, std::size_t len)
+{
+    RpcValue value;
+
+    value.type = RpcValueType::STRING;
+    value.str = _arena.copyString(str, len);
+    this->processValue(value);
+}
+
+void RpcRequestDecoder::processStartMap()
+{
+    _mapDepth++;
+
+    // only the top-level object and the parameters object are allowed
+    if (_mapDepth > 2 || (_mapDepth == 2 && (!_inParams || _inParamArray))) {
+        _unexpected = true;
+    }
+}
+
+void RpcRequestDecoder::processMapKey(const char* key, std::size_t len)
+{
+    _curKey = _arena.copyString(key, len);
+}
+
+void RpcRequestDecoder::processEndMap()
+{
+    _mapDepth--;
+}
+
+void RpcRequestDecoder::processStartArray()
+{
+    if (_mapDepth == 1 && _curKey.equals("params") && !_inParams) {
+        _inParams = true;
+    } else if (_mapDepth == 2 && _inParams && !_inParamArray) {
+        Param param;
+
+        param.key = _curKey;
+        param.isArray = true;
+        param.arrayBegin = _arrayValues.size();
+        param.arrayCount = 0;
+        _params.push_back(param);
+        _inParamArray = true;
+    } else {
+        _unexpected = true;
+    }
+}
+
+void RpcRequestDecoder::processEndArray()
+{
+    if (_inParamArray) {
+        _inParamArray = false;
+    } else if (_mapDepth == 1) {
+        _inParams = false;
+    }
+}
+
+void RpcRequestDecoder::processTypedArray(MsgPackTypedArrayType type,
+                                          const std::uint8_t* data,
+                                          std::size_t count)
+{
+    // typed arrays are only expected as parameter values
+    if (_mapDepth != 2 || !_inParams || _inParamArray) {
+        _unexpected = true;
+
+        return;
+    }
+
+    this->processStartArray();
+    _arrayValues.reserve(_arrayValues.size() + count);
+
+    for (std::size_t x = 0; x < count; ++x) {
+        RpcValue value;
+        std::uint64_t bits;
+
+        switch (type) {
+        case MsgPackTypedArrayType::UINT32:
+            value.type = RpcValueType::UINT;
+            value.uint = AbstractMsgPackRpcMessageDecoder::getLittleEndian(data + x * 4, 4);
+            break;
+
+        case MsgPackTypedArrayType::UINT64:
+            value.type = RpcValueType::UINT;
+            value.uint = AbstractMsgPackRpcMessageDecoder::getLittleEndian(data + x * 8, 8);
+            break;
+
+        case MsgPackTypedArrayType::INT64:
+            value.type = RpcValueType::SINT;
+            value.sint = static_cast<std::int64_t>(AbstractMsgPackRpcMessageDecoder::getLittleEndian(data + x * 8, 8));
+            break;
+
+        case MsgPackTypedArrayType::FLOAT64:
+            bits = AbstractMsgPackRpcMessageDecoder::getLittleEndian(data + x * 8, 8);
+            value.type = RpcValueType::DOUBLE;
+            std::memcpy(&value.dbl, &bits, sizeof(value.dbl));
+            break;
+        }
+
+        this->processValue(value);
+    }
+
+    this->processEndArray();
+}
+
+}
+}
@@ -0,0 +1,316 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_RPCREQUESTDECODER_HPP
+#define _TIBEE_COMMON_RPCREQUESTDECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/RpcArena.hpp>
+#include <common/rpc/RpcEncoding.hpp>
+#include <common/rpc/AbstractJsonRpcMessageDecoder.hpp>
+#include <common/rpc/AbstractMsgPackRpcMessageDecoder.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Outcome of decoding and dispatching an RPC request.
+ */
+enum class RpcRequestStatus
+{
+    /// Request decoded (and dispatched)
+    OK,
+
+    /// Malformed JSON or MessagePack
+    PARSE_ERROR,
+
+    /// Well-formed, but not an RPC request
+    INVALID_REQUEST,
+
+    /// No handler for this method
+    METHOD_NOT_FOUND,
+
+    /// Missing or wrong parameters
+    INVALID_PARAMS,
+};
+
+/**
+ * Decoded RPC parameter value type.
+ */
+enum class RpcValueType
+{
+    NUL,
+    BOOL,
+    SINT,
+    UINT,
+    DOUBLE,
+    STRING,
+};
+
+/**
+ * Decoded RPC parameter value.
+ */
+struct RpcValue
+{
+    /// Value type (selects the union member below)
+    RpcValueType type;
+
+    union
+    {
+        bool boolean;
+        std::int64_t sint;
+        std::uint64_t uint;
+        double dbl;
+        RpcString str;
+    };
+};
+
+/**
+ * Generic RPC request decoder.
+ *
+ * Decodes requests looking like this, either as JSON text or as their
+ * MessagePack encoding (detected for each request):
+ *
+ *     {"method": "get-state", "id": 23, "params": [{"path": "a/b", "ts": 1}]}
+ *
+ * The first element of \c params is an object whose values are either
+ * scalars or arrays of scalars. Decoded values are typed (JSON numbers
+ * are unsigned integers if they fit, signed integers if negative, or
+ * doubles) and are retrieved by key with the get*Param() methods.
+ *
+ * Strings are copied into a per-decoder arena and values are kept in
+ * flat vectors which are cleared, not freed, by each decoding: once
+ * warmed up, a decoder does not touch the heap. A decoder is meant to
+ * be used by a single connection or thread; everything it returns is
+ * valid until the next decoding.
+ *
+ * @author Philippe Proulx
+ */
+class RpcRequestDecoder :
+    public AbstractJsonRpcMessageDecoder,
+    public AbstractMsgPackRpcMessageDecoder
+{
+public:
+    /**
+     * Builds a generic RPC request decoder.
+     */
+    RpcRequestDecoder();
+
+    /**
+     * Decodes a request.
+     *
+     * @param data Request data (JSON or MessagePack)
+     * @param len  Request data length (bytes)
+     * @returns    RpcRequestStatus::OK, RpcRequestStatus::PARSE_ERROR
+     *             or RpcRequestStatus::INVALID_REQUEST
+     */
+    RpcRequestStatus decode(const char* data, std::size_t len);
+
+    /**
+     * Returns the encoding of the last decoded request. Valid even if
+     * decoding failed.
+     *
+     * @returns Encoding of last decoded request
+     */
+    RpcEncoding getEncoding() const
+    {
+        return _encoding;
+    }
+
+    /**
+     * Returns the method name of the last decoded request (empty if
+     * unknown).
+     *
+     * @returns Method name of last decoded request
+     */
+    const RpcString& getMethod() const
+    {
+        return _method;
+    }
+
+    /**
+     * Returns the ID of the last decoded request (0 if unknown). Valid
+     * even if decoding failed.
+     *
+     * @returns ID of last decoded request
+     */
+    rpc_msg_id_t getId() const
+    {
+        return _id;
+    }
+
+    /**
+     * Returns whether the last decoded request has parameter \p key,
+     * scalar or array.
+     *
+     * @param key Parameter key
+     * @returns   True if the parameter exists
+     */
+    bool hasParam(const char* key) const
+    {
+        return this->findParam(key) != nullptr;
+    }
+
+    /**
+     * Returns the scalar parameter \p key of the last decoded request.
+     *
+     * @param key Parameter key
+     * @returns   Parameter value or \a nullptr if missing or array
+     */
+    const RpcValue* getParam(const char* key) const;
+
+    /**
+     * Returns the elements of array parameter \p key of the last
+     * decoded request.
+     *
+     * @param key   Parameter key
+     * @param count Number of elements (set on success)
+     * @returns     First element or \a nullptr if missing or scalar
+     */
+    const RpcValue* getArrayParam(const char* key, std::size_t& count) const;
+
+    /**
+     * Gets the unsigned integer parameter \p key; a string of decimal
+     * digits is also accepted.
+     *
+     * @param key   Parameter key
+     * @param value Parameter value (set on success)
+     * @returns     True if the parameter exists and is an unsigned integer
+     */
+    bool getUintParam(const char* key, std::uint64_t& value) const;
+
+    /**
+     * Gets the string parameter \p key.
+     *
+     * @param key   Parameter key
+     * @param value Parameter value (set on success)
+     * @returns     True if the parameter exists and is a string
+     */
+    bool getStringParam(const char* key, RpcString& value) const;
+
+    /**
+     * Gets the unsigned integer array parameter \p key. The elements
+     * of \p values are replaced, keeping its capacity.
+     *
+     * @param key    Parameter key
+     * @param values Parameter values (set on success)
+     * @returns      True if the parameter exists and all its elements
+     *               are unsigned integers fitting in a \p T
+     */
+    template<typename T>
+    bool getUintArrayParam(const char* key, std::vector<T>& values) const
+    {
+        std::size_t count;
+        auto elements = this->getArrayParam(key, count);
+
+        if (!elements) {
+            return false;
+        }
+
+        values.resize(count);
+
+        for (std::size_t x = 0; x < count; ++x) {
+            std::uint64_t value;
+
+            if (!RpcRequestDecoder::toUint(elements[x], value) ||
+                    value > std::numeric_limits<T>::max()) {
+                return false;
+            }
+
+            values[x] = static_cast<T>(value);
+        }
+
+        return true;
+    }
+
+    /**
+     * Converts a value to an unsigned integer; a string of decimal
+     * digits is also accepted.
+     *
+     * @param value Value to convert
+     * @param uint  Unsigned integer (set on success)
+     * @returns     True if converted
+     */
+    static bool toUint(const RpcValue& value, std::uint64_t& uint);
+
+private:
+    struct Param
+    {
+        RpcString key;
+        bool isArray;
+
+        // scalar value
+        RpcValue value;
+
+        // array elements in _arrayValues
+        std::size_t arrayBegin;
+        std::size_t arrayCount;
+    };
+
+private:
+    void processNull();
+    void processBoolean(bool value);
+    void processInteger(long long value);
+    void processDouble(double value);
+    void processNumber(const char* number, std::size_t len);
+    void processString(const char* value, std::size_t len);
+    void processStartMap();
+    void processMapKey(const char* key, std::size_t len);
+    void processEndMap();
+    void processStartArray();
+    void processEndArray();
+    void processTypedArray(MsgPackTypedArrayType type, const std::uint8_t* data,
+                           std::size_t count);
+
+    void processValue(const RpcValue& value);
+    void reset();
+    const Param* findParam(const char* key) const;
+
+private:
+    // storage of strings
+    RpcArena _arena;
+
+    // nesting state
+    unsigned int _mapDepth;
+    bool _inParams;
+    bool _inParamArray;
+    bool _unexpected;
+    RpcString _curKey;
+
+    // encoding of the request
+    RpcEncoding _encoding;
+
+    // decoded top-level values
+    RpcString _method;
+    rpc_msg_id_t _id;
+
+    // decoded parameters and array parameters elements
+    std::vector<Param> _params;
+    std::vector<RpcValue> _arrayValues;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_RPCREQUESTDECODER_HPP
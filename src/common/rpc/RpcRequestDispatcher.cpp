@@ -0,0 +1,69 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <common/rpc/RpcRequestDispatcher.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+RpcRequestDispatcher::RpcRequestDispatcher() :
+    _errorMessage {""}
+{
+}
+
+RpcRequestStatus RpcRequestDispatcher::dispatch(const char* data,
+                                                std::size_t len)
+{
+    _errorMessage = "";
+
+    auto status = _decoder.decode(data, len);
+
+    if (status == RpcRequestStatus::PARSE_ERROR) {
+        _errorMessage = "parse error";
+
+        return status;
+    } else if (status != RpcRequestStatus::OK) {
+        _errorMessage = "invalid request";
+
+        return status;
+    }
+
+    for (const auto& method : _methods) {
+        if (!method->isNamed(_decoder.getMethod())) {
+            continue;
+        }
+
+        auto error = method->dispatch(_decoder);
+
+        if (error) {
+            _errorMessage = error;
+
+            return RpcRequestStatus::INVALID_PARAMS;
+        }
+
+        return RpcRequestStatus::OK;
+    }
+
+    _errorMessage = "unknown method";
+
+    return RpcRequestStatus::METHOD_NOT_FOUND;
+}
+
+}
+}
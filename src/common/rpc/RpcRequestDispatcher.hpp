@@ -0,0 +1,198 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_RPCREQUESTDISPATCHER_HPP
+#define _TIBEE_COMMON_RPCREQUESTDISPATCHER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/rpc/RpcRequestDecoder.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Typed RPC request dispatcher.
+ *
+ * Methods are registered with addMethod(), each one with its own
+ * request type, a decode function filling a request object from the
+ * generic decoded parameters, and a handler. dispatch() decodes a
+ * request (see RpcRequestDecoder), decodes its parameters into the
+ * request object of its method and calls the method handler.
+ *
+ * Each method owns a single request object, reused by all its
+ * requests: a decode function must set all the members of the request
+ * object, and handlers must not keep a reference to it. Together with
+ * the decoder arena, this makes dispatching allocation-free once
+ * warmed up. A dispatcher is meant to be used by a single connection
+ * or thread.
+ *
+ * @author Philippe Proulx
+ */
+class RpcRequestDispatcher :
+    boost::noncopyable
+{
+public:
+    /**
+     * Decode function of request type \p RequestT: fills a request
+     * object from the decoded request, returning \a nullptr on
+     * success or a static error message.
+     */
+    template<typename RequestT>
+    using DecodeFunc = std::function<const char* (const RpcRequestDecoder&, RequestT&)>;
+
+    /**
+     * Handler of request type \p RequestT.
+     */
+    template<typename RequestT>
+    using HandleFunc = std::function<void (RequestT&)>;
+
+public:
+    /**
+     * Builds a dispatcher without methods.
+     */
+    RpcRequestDispatcher();
+
+    /**
+     * Registers method \p method.
+     *
+     * @param method     Method name
+     * @param decodeFunc Decode function of this method's requests
+     * @param handleFunc Handler of this method's requests
+     */
+    template<typename RequestT>
+    void addMethod(const std::string& method, DecodeFunc<RequestT> decodeFunc,
+                   HandleFunc<RequestT> handleFunc)
+    {
+        std::unique_ptr<AbstractMethod> methodObj {
+            new Method<RequestT> {method, std::move(decodeFunc),
+                                  std::move(handleFunc)}
+        };
+
+        _methods.push_back(std::move(methodObj));
+    }
+
+    /**
+     * Decodes and dispatches a request.
+     *
+     * On error, getErrorMessage() returns a description and
+     * getDecoder() may be used to get the ID and encoding of the
+     * request to build an error response.
+     *
+     * @param data Request data (JSON or MessagePack)
+     * @param len  Request data length (bytes)
+     * @returns    Dispatch status
+     */
+    RpcRequestStatus dispatch(const char* data, std::size_t len);
+
+    /**
+     * Returns the decoder of this dispatcher, holding the last decoded
+     * request.
+     *
+     * @returns Decoder
+     */
+    const RpcRequestDecoder& getDecoder() const
+    {
+        return _decoder;
+    }
+
+    /**
+     * Returns the error message of the last dispatch (empty string if
+     * successful).
+     *
+     * @returns Error message
+     */
+    const char* getErrorMessage() const
+    {
+        return _errorMessage;
+    }
+
+private:
+    class AbstractMethod
+    {
+    public:
+        AbstractMethod(const std::string& name) :
+            _name {name}
+        {
+        }
+
+        virtual ~AbstractMethod()
+        {
+        }
+
+        bool isNamed(const RpcString& name) const
+        {
+            return name.len == _name.size() &&
+                   std::memcmp(name.data, _name.data(), name.len) == 0;
+        }
+
+        virtual const char* dispatch(const RpcRequestDecoder& decoder) = 0;
+
+    private:
+        std::string _name;
+    };
+
+    template<typename RequestT>
+    class Method :
+        public AbstractMethod
+    {
+    public:
+        Method(const std::string& name, DecodeFunc<RequestT> decodeFunc,
+               HandleFunc<RequestT> handleFunc) :
+            AbstractMethod {name},
+            _decodeFunc {std::move(decodeFunc)},
+            _handleFunc {std::move(handleFunc)}
+        {
+        }
+
+        const char* dispatch(const RpcRequestDecoder& decoder)
+        {
+            auto error = _decodeFunc(decoder, _request);
+
+            if (error) {
+                return error;
+            }
+
+            _handleFunc(_request);
+
+            return nullptr;
+        }
+
+    private:
+        RequestT _request;
+        DecodeFunc<RequestT> _decodeFunc;
+        HandleFunc<RequestT> _handleFunc;
+    };
+
+private:
+    RpcRequestDecoder _decoder;
+    std::vector<std::unique_ptr<AbstractMethod>> _methods;
+    const char* _errorMessage;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_RPCREQUESTDISPATCHER_HPP
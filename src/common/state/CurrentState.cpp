@@ -157,5 +157,10 @@ const AbstractStateValue* CurrentState::getState(quark_t pathQuark) const
     return _sink->getState(pathQuark);
 }
 
+std::size_t CurrentState::getStateChangesCount() const
+{
+    return _sink->getStateChangesCount();
+}
+
 }
 }
@@ -18,6 +18,7 @@
 #ifndef _TIBEE_COMMON_CURRENTSTATE_HPP
 #define _TIBEE_COMMON_CURRENTSTATE_HPP
 
+#include <cstddef>
 #include <memory>
 #include <cstdint>
 #include <boost/utility.hpp>
@@ -224,6 +225,13 @@ public:
      */
     const AbstractStateValue* getState(quark_t pathQuark) const;
 
+    /**
+     * Returns the number of state changes so far.
+     *
+     * @returns State changes count
+     */
+    std::size_t getStateChangesCount() const;
+
 private:
     // only StateHistorySink may build a CurrentState object
     CurrentState(StateHistorySink* sink);
@@ -16,8 +16,12 @@
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <cstdint>
+#include <cstring>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <fstream>
+#include <vector>
 #include <delorean/BasicTypes.hpp>
 #include <delorean/interval/AbstractInterval.hpp>
 #include <delorean/interval/Int32Interval.hpp>
@@ -30,6 +34,9 @@
 
 #include <common/state/StateValueType.hpp>
 #include <common/state/StateHistorySink.hpp>
+#include <common/state/StateSummarySink.hpp>
+#include <common/state/StateSnapshotFormat.hpp>
+#include <common/state/StringDb.hpp>
 #include <common/state/CurrentState.hpp>
 #include <common/state/Int32StateValue.hpp>
 #include <common/state/Uint32StateValue.hpp>
@@ -37,6 +44,7 @@
 #include <common/state/Uint64StateValue.hpp>
 #include <common/state/Float32StateValue.hpp>
 #include <common/state/QuarkStateValue.hpp>
+#include <common/utils/Instr.hpp>
 
 namespace bfs = boost::filesystem;
 
@@ -56,7 +64,13 @@ StateHistorySink::StateHistorySink(const bfs::path& pathStrDbPath,
     _curPathQuark {0},
     _curStrValueQuark {0},
     _currentState {this},
-    _stateChangesCount {0}
+    _stateChangesCount {0},
+    _stateLogRecordsCount {0},
+    _snapshotBeginTs {0},
+    _snapshotPeriod {0},
+    _nextSnapshotTs {0},
+    _publishedPathsCount {0},
+    _publishedValuesCount {0}
 {
     _intervalFileSink = std::unique_ptr<delo::HistoryFileSink> {
         new delo::HistoryFileSink
@@ -201,9 +215,27 @@ void StateHistorySink::close()
 
     // write files
     _intervalFileSink->close();
+
+    if (_summarySink) {
+        _summarySink->close(_curPathQuark);
+        _summarySink = nullptr;
+    }
+
     this->writeStringDb(_pathsDb, _pathStrDbPath);
     this->writeStringDb(_strValuesDb, _valueStrDbPath);
 
+    // last snapshot: everything is committed now
+    if (_stateLog) {
+        _publishedPathsCount = _pathsDb.size();
+        _publishedValuesCount = _strValuesDb.size();
+        this->publishSnapshot(true);
+        _stateLog->close();
+        _stateLog = nullptr;
+
+        // readers following the live history keep it opened
+        bfs::remove(_stateLogPath);
+    }
+
     // clear string databases
     _pathsDb.clear();
     _strValuesDb.clear();
@@ -212,6 +244,17 @@ void StateHistorySink::close()
     _opened = false;
 }
 
+void StateHistorySink::closeStates(timestamp_t ts)
+{
+    this->setCurrentTimestamp(ts);
+
+    for (const auto& quarkStateEntryPair : _stateValues) {
+        this->writeInterval(quarkStateEntryPair.first);
+    }
+
+    _stateValues.clear();
+}
+
 quark_t StateHistorySink::getQuark(StringDb& stringDb, const std::string& value,
                                    quark_t& curQuark)
 {
@@ -241,6 +284,8 @@ quark_t StateHistorySink::getStringValueQuark(const std::string& value)
 
 void StateHistorySink::writeInterval(quark_t pathQuark)
 {
+    TIBEE_INSTR_SCOPE(WRITE_INTERVAL);
+
     // retrieve state value entry for this quark
     auto it = _stateValues.find(pathQuark);
 
@@ -253,6 +298,7 @@ void StateHistorySink::writeInterval(quark_t pathQuark)
 
     // do not bother writing a zero-length/weird interval
     if (stateValueEntry.beginTs >= _ts) {
+        TIBEE_INSTR_COUNT(EMPTY_INTERVALS, 1);
         return;
     }
 
@@ -269,10 +315,202 @@ void StateHistorySink::writeInterval(quark_t pathQuark)
     // add to interval history
     _intervalFileSink->addInterval(delo::AbstractInterval::UP {interval});
 
+    if (_summarySink || _stateLog) {
+        const auto& value = *stateValueEntry.value;
+        std::uint64_t raw;
+        double numeric;
+
+        StateHistorySink::getRawValue(value, raw, numeric);
+
+        if (_summarySink) {
+            _summarySink->addInterval(pathQuark, stateValueEntry.beginTs, _ts,
+                                      value.getType(), raw, numeric);
+        }
+
+        if (_stateLog) {
+            this->logInterval(pathQuark, stateValueEntry.beginTs,
+                              value.getType(), raw);
+        }
+    }
+
     // update internal statistics
     _stateChangesCount++;
 }
 
+void StateHistorySink::enableSummaries(const bfs::path& summaryPath,
+                                       timestamp_t beginTs, timestamp_t endTs)
+{
+    _summarySink = std::unique_ptr<StateSummarySink> {
+        new StateSummarySink {summaryPath, beginTs, endTs}
+    };
+}
+
+void StateHistorySink::getRawValue(const AbstractStateValue& value,
+                                   std::uint64_t& raw, double& numeric)
+{
+    raw = 0;
+    numeric = 0;
+
+    switch (value.getType()) {
+    case StateValueType::INT32:
+    {
+        auto v = static_cast<const Int32StateValue&>(value).getValue();
+
+        raw = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+        numeric = v;
+        break;
+    }
+
+    case StateValueType::UINT32:
+    {
+        auto v = static_cast<const Uint32StateValue&>(value).getValue();
+
+        raw = v;
+        numeric = v;
+        break;
+    }
+
+    case StateValueType::INT64:
+    {
+        auto v = static_cast<const Int64StateValue&>(value).getValue();
+
+        raw = static_cast<std::uint64_t>(v);
+        numeric = static_cast<double>(v);
+        break;
+    }
+
+    case StateValueType::UINT64:
+    {
+        auto v = static_cast<const Uint64StateValue&>(value).getValue();
+
+        raw = v;
+        numeric = static_cast<double>(v);
+        break;
+    }
+
+    case StateValueType::FLOAT32:
+        numeric = static_cast<const Float32StateValue&>(value).getValue();
+        std::memcpy(&raw, &numeric, sizeof(raw));
+        break;
+
+    case StateValueType::QUARK:
+        raw = static_cast<const QuarkStateValue&>(value).getValue();
+        break;
+    }
+}
+
+void StateHistorySink::enableSnapshots(const bfs::path& logPath,
+                                       const bfs::path& snapshotPath,
+                                       timestamp_t beginTs, timestamp_t period)
+{
+    _stateLog = std::unique_ptr<bfs::ofstream> {new bfs::ofstream};
+    _stateLog->open(logPath, std::ios::binary | std::ios::trunc);
+
+    StateLogFileHeader header;
+
+    header.magic = STATE_LOG_FILE_MAGIC;
+    header.version = STATE_SNAPSHOT_FILE_VERSION;
+    _stateLog->write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    _stateLogPath = logPath;
+    _stateLogRecordsCount = 0;
+    _snapshotPath = snapshotPath;
+    _snapshotBeginTs = beginTs;
+    _snapshotPeriod = period > 0 ? period : 1;
+
+    // replaces any snapshot of a previous build
+    this->publishSnapshot(false);
+}
+
+void StateHistorySink::logInterval(quark_t pathQuark, timestamp_t beginTs,
+                                   StateValueType type, std::uint64_t raw)
+{
+    StateLogFileRecord record;
+
+    record.beginTs = beginTs;
+    record.endTs = _ts;
+    record.value = raw;
+    record.pathQuark = pathQuark;
+    record.valueType = static_cast<std::uint32_t>(type);
+
+    _stateLog->write(reinterpret_cast<const char*>(&record), sizeof(record));
+    _stateLogRecordsCount++;
+}
+
+void StateHistorySink::publishSnapshot(bool complete)
+{
+    /* Order matters: readers only trust what the snapshot file says,
+     * so the committed records and the string databases must be on
+     * disk before the new snapshot replaces the previous one.
+     */
+    _stateLog->flush();
+
+    // string databases only grow: rewrite them only if they did
+    if (!complete) {
+        if (_pathsDb.size() != _publishedPathsCount) {
+            this->writeStringDb(_pathsDb, _pathStrDbPath);
+            _publishedPathsCount = _pathsDb.size();
+        }
+
+        if (_strValuesDb.size() != _publishedValuesCount) {
+            this->writeStringDb(_strValuesDb, _valueStrDbPath);
+            _publishedValuesCount = _strValuesDb.size();
+        }
+    }
+
+    StateSnapshotFileHeader header;
+
+    header.magic = STATE_SNAPSHOT_FILE_MAGIC;
+    header.version = STATE_SNAPSHOT_FILE_VERSION;
+    header.beginTs = _snapshotBeginTs;
+    header.watermark = _ts;
+    header.recordsCount = _stateLogRecordsCount;
+    header.openCount = 0;
+    header.complete = complete ? 1 : 0;
+    header.pathsCount = static_cast<std::uint32_t>(_publishedPathsCount);
+    header.valuesCount = static_cast<std::uint32_t>(_publishedValuesCount);
+
+    // open state intervals end at the watermark
+    std::vector<StateLogFileRecord> openRecords;
+
+    for (const auto& quarkStateEntryPair : _stateValues) {
+        const auto& stateValueEntry = quarkStateEntryPair.second;
+
+        if (stateValueEntry.beginTs >= _ts) {
+            continue;
+        }
+
+        StateLogFileRecord record;
+        double numeric;
+
+        StateHistorySink::getRawValue(*stateValueEntry.value, record.value,
+                                      numeric);
+        record.beginTs = stateValueEntry.beginTs;
+        record.endTs = _ts;
+        record.pathQuark = quarkStateEntryPair.first;
+        record.valueType = static_cast<std::uint32_t>(stateValueEntry.value->getType());
+        openRecords.push_back(record);
+    }
+
+    header.openCount = static_cast<std::uint32_t>(openRecords.size());
+
+    // write then rename so that readers never see a partial snapshot
+    auto tmpPath = _snapshotPath;
+
+    tmpPath += ".tmp";
+
+    bfs::ofstream output;
+
+    output.open(tmpPath, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(openRecords.data()),
+                 openRecords.size() * sizeof(StateLogFileRecord));
+    output.close();
+    bfs::rename(tmpPath, _snapshotPath);
+
+    _nextSnapshotTs = _ts + _snapshotPeriod;
+}
+
 void StateHistorySink::setState(quark_t pathQuark, AbstractStateValue::UP value)
 {
     // write interval and set new state value
@@ -294,28 +532,34 @@ void StateHistorySink::removeState(quark_t pathQuark)
 void StateHistorySink::writeStringDb(const StringDb& stringDb,
                                      const boost::filesystem::path& path)
 {
-    // open output file for writing
-    bfs::ofstream output;
+    /* The string databases may be published while a reader is
+     * loading them (see enableSnapshots()): write a temporary file,
+     * then rename it.
+     */
+    auto tmpPath = path;
+
+    tmpPath += ".tmp";
 
-    output.open(path, std::ios::binary);
+    // strings by quark (quarks are dense, starting at 0)
+    std::vector<const std::string*> strings(stringDb.size());
 
-    // write all string/quark pairs
     for (const auto& stringQuarkPair : stringDb) {
-        const auto& string = stringQuarkPair.first;
-        auto quark = stringQuarkPair.second;
+        strings[stringQuarkPair.second] = &stringQuarkPair.first;
+    }
 
-        // write string part
-        output.write(string.c_str(), string.size() + 1);
+    std::vector<std::uint8_t> image;
 
-        // align for quark
-        output.seekp((output.tellp() + static_cast<long>(sizeof(quark) - 1)) & ~(sizeof(quark) - 1));
+    common::StringDb::buildImage(strings, image);
 
-        // write quark
-        output.write(reinterpret_cast<char*>(&quark), sizeof(quark));
-    }
+    // open output file for writing
+    bfs::ofstream output;
+
+    output.open(tmpPath, std::ios::binary);
+    output.write(reinterpret_cast<const char*>(image.data()), image.size());
 
     // close output file
     output.close();
+    bfs::rename(tmpPath, path);
 }
 
 }
@@ -25,12 +25,15 @@
 #include <map>
 #include <boost/utility.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <delorean/HistoryFileSink.hpp>
 #include <delorean/interval/AbstractInterval.hpp>
 
 #include <common/BasicTypes.hpp>
 #include <common/state/AbstractStateValue.hpp>
+#include <common/state/StateValueType.hpp>
 #include <common/state/CurrentState.hpp>
+#include <common/state/StateSummarySink.hpp>
 
 namespace tibee
 {
@@ -42,8 +45,8 @@ namespace common
  *
  * An object of this class must be used to write a state history on
  * disk. A state history comprises a few files: two string databases
- * (one for paths and the other for state values) and a history of
- * state intervals.
+ * (one for paths and the other for state values; see
+ * StringDbFormat.hpp) and a history of state intervals.
  *
  * @author Philippe Proulx
  */
@@ -75,6 +78,10 @@ public:
     void setCurrentTimestamp(timestamp_t ts)
     {
         _ts = ts;
+
+        if (_stateLog && ts >= _nextSnapshotTs) {
+            this->publishSnapshot(false);
+        }
     }
 
     /**
@@ -87,6 +94,40 @@ public:
         return _ts;
     }
 
+    /**
+     * Enables state summaries: all state intervals written from now on
+     * are also summarized at several resolutions between \p beginTs
+     * and \p endTs, and the summaries are written to \p summaryPath
+     * when closing this sink.
+     *
+     * @param summaryPath Path to state summary file (to be created)
+     * @param beginTs     Begin timestamp of the summaries
+     * @param endTs       End timestamp of the summaries
+     */
+    void enableSummaries(const boost::filesystem::path& summaryPath,
+                         timestamp_t beginTs, timestamp_t endTs);
+
+    /**
+     * Enables live snapshots: all state intervals written from now on
+     * are also appended to the state log \p logPath, and a snapshot
+     * (see StateSnapshotFormat.hpp) is published to \p snapshotPath,
+     * along with the current string databases, every \p period
+     * nanoseconds of trace time, so that the history may be queried
+     * while it's still being built.
+     *
+     * A first, empty snapshot is published right away. The state log
+     * is removed when closing this sink, once the last snapshot says
+     * that the history is complete.
+     *
+     * @param logPath      Path to state log file (to be created)
+     * @param snapshotPath Path to state snapshot file (to be created)
+     * @param beginTs      Begin timestamp of the history
+     * @param period       Snapshot period (trace time)
+     */
+    void enableSnapshots(const boost::filesystem::path& logPath,
+                         const boost::filesystem::path& snapshotPath,
+                         timestamp_t beginTs, timestamp_t period);
+
     /**
      * Closes this state history sink, effectively closing all opened
      * files and marking it as closed.
@@ -94,10 +135,24 @@ public:
      * All opened state values are closed with the current history
      * timestamp.
      *
-     * The string databases are written here.
+     * The string databases (and the state summaries, if enabled) are
+     * written here. If snapshots are enabled, a last, complete
+     * snapshot is published and the state log is removed.
      */
     void close();
 
+    /**
+     * Writes all opened state values as intervals ending at \p ts and
+     * forgets them, and sets the current history timestamp to \p ts.
+     *
+     * Used when the following events do not follow the previous ones,
+     * like at the beginning of a sampling window: no interval then
+     * spans a part of the trace which was not read.
+     *
+     * @param ts End timestamp of opened state values
+     */
+    void closeStates(timestamp_t ts);
+
     /**
      * Returns a quark for a given path string.
      *
@@ -183,6 +238,37 @@ public:
         return _stateChangesCount;
     }
 
+    /**
+     * Returns the number of path quarks so far.
+     *
+     * @returns Path quarks count
+     */
+    std::size_t getPathsQuarksCount() const
+    {
+        return _pathsDb.size();
+    }
+
+    /**
+     * Returns the number of string value quarks so far.
+     *
+     * @returns String value quarks count
+     */
+    std::size_t getValuesQuarksCount() const
+    {
+        return _strValuesDb.size();
+    }
+
+    /**
+     * Returns the number of current state values, that is, intervals
+     * which are begun but not written yet.
+     *
+     * @returns Current state values count
+     */
+    std::size_t getStateValuesCount() const
+    {
+        return _stateValues.size();
+    }
+
 private:
     // a string database
     typedef std::map<std::string, quark_t> StringDb;
@@ -205,6 +291,11 @@ private:
                        const boost::filesystem::path& path);
     quark_t getQuark(StringDb& stringDb, const std::string& value,
                      quark_t& curQuark);
+    void logInterval(quark_t pathQuark, timestamp_t beginTs,
+                     StateValueType type, std::uint64_t raw);
+    void publishSnapshot(bool complete);
+    static void getRawValue(const AbstractStateValue& value,
+                            std::uint64_t& raw, double& numeric);
 
 private:
     // paths to files to create
@@ -242,8 +333,34 @@ private:
     // interval history sink
     std::unique_ptr<delo::HistoryFileSink> _intervalFileSink;
 
+    // state summary sink (optional)
+    std::unique_ptr<StateSummarySink> _summarySink;
+
     // count of state changes so far (including removals)
     std::size_t _stateChangesCount;
+
+    // state log (optional: only when snapshots are enabled)
+    std::unique_ptr<boost::filesystem::ofstream> _stateLog;
+
+    // path to state log file
+    boost::filesystem::path _stateLogPath;
+
+    // number of records in the state log
+    std::uint64_t _stateLogRecordsCount;
+
+    // path to state snapshot file
+    boost::filesystem::path _snapshotPath;
+
+    // history begin timestamp (for snapshots)
+    timestamp_t _snapshotBeginTs;
+
+    // snapshot period and timestamp of the next one
+    timestamp_t _snapshotPeriod;
+    timestamp_t _nextSnapshotTs;
+
+    // string database sizes at the last publication
+    std::size_t _publishedPathsCount;
+    std::size_t _publishedValuesCount;
 };
 
 }
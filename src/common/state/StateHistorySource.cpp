@@ -0,0 +1,267 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <fnmatch.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <delorean/HistoryFileSource.hpp>
+#include <delorean/interval/AbstractInterval.hpp>
+#include <delorean/interval/IntervalJar.hpp>
+
+#include <common/state/StateHistorySource.hpp>
+#include <common/ex/StateHistorySource.hpp>
+#include <common/ex/StringDb.hpp>
+#include <common/ex/MappedFile.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+StateHistorySource::StateHistorySource(const bfs::path& pathStrDbPath,
+                                       const bfs::path& valueStrDbPath,
+                                       const bfs::path& historyPath) :
+    _stringDbs {StateHistorySource::readStringDbs(pathStrDbPath, valueStrDbPath)},
+    _historyPath {historyPath}
+{
+    this->openHistory();
+}
+
+StateHistorySource::StateHistorySource(const bfs::path& pathStrDbPath,
+                                       const bfs::path& valueStrDbPath,
+                                       std::shared_ptr<StateSnapshotSource> snapshot) :
+    _stringDbs {StateHistorySource::readStringDbs(pathStrDbPath, valueStrDbPath)},
+    _snapshot {snapshot},
+    _liveStringDbs {new LiveStringDbs}
+{
+    _liveStringDbs->pathStrDbPath = pathStrDbPath;
+    _liveStringDbs->valueStrDbPath = valueStrDbPath;
+    _liveStringDbs->stringDbs = _stringDbs;
+}
+
+StateHistorySource::StateHistorySource(std::shared_ptr<const StringDbs> stringDbs,
+                                       std::shared_ptr<StateSnapshotSource> snapshot,
+                                       std::shared_ptr<LiveStringDbs> liveStringDbs) :
+    _stringDbs {stringDbs},
+    _snapshot {snapshot},
+    _liveStringDbs {liveStringDbs}
+{
+}
+
+StateHistorySource::StateHistorySource(std::shared_ptr<const StringDbs> stringDbs,
+                                       const bfs::path& historyPath) :
+    _stringDbs {stringDbs},
+    _historyPath {historyPath}
+{
+    this->openHistory();
+}
+
+StateHistorySource::~StateHistorySource()
+{
+    if (_intervalFileSource) {
+        _intervalFileSource->close();
+    }
+}
+
+StateHistorySource::UP StateHistorySource::fork() const
+{
+    if (_snapshot) {
+        return StateHistorySource::UP {
+            new StateHistorySource {_stringDbs, _snapshot, _liveStringDbs}
+        };
+    }
+
+    return StateHistorySource::UP {
+        new StateHistorySource {_stringDbs, _historyPath}
+    };
+}
+
+void StateHistorySource::openHistory()
+{
+    if (!bfs::exists(_historyPath)) {
+        throw ex::StateHistorySource {"history file does not exist", _historyPath};
+    }
+
+    _intervalFileSource = std::unique_ptr<delo::HistoryFileSource> {
+        new delo::HistoryFileSource
+    };
+
+    _intervalFileSource->open(_historyPath);
+}
+
+bool StateHistorySource::refresh()
+{
+    if (!_snapshot || !_snapshot->refresh()) {
+        return false;
+    }
+
+    std::shared_ptr<const StringDbs> stringDbs;
+
+    {
+        std::lock_guard<std::mutex> lock {_liveStringDbs->mutex};
+
+        stringDbs = _liveStringDbs->stringDbs;
+    }
+
+    // string databases only grow, and are written before the snapshot
+    if (stringDbs->paths->getCount() >= _snapshot->getPathsCount() &&
+            stringDbs->values->getCount() >= _snapshot->getValuesCount()) {
+        return true;
+    }
+
+    try {
+        stringDbs = StateHistorySource::readStringDbs(_liveStringDbs->pathStrDbPath,
+                                                      _liveStringDbs->valueStrDbPath);
+    } catch (const ex::StateHistorySource&) {
+        // keep the previous ones; paths not found yet
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock {_liveStringDbs->mutex};
+
+    _liveStringDbs->stringDbs = stringDbs;
+
+    return true;
+}
+
+void StateHistorySource::sync()
+{
+    if (!_liveStringDbs) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock {_liveStringDbs->mutex};
+
+    _stringDbs = _liveStringDbs->stringDbs;
+}
+
+std::shared_ptr<const StateHistorySource::StringDbs>
+StateHistorySource::readStringDbs(const bfs::path& pathStrDbPath,
+                                  const bfs::path& valueStrDbPath)
+{
+    std::shared_ptr<StringDbs> stringDbs {new StringDbs};
+
+    stringDbs->paths = StateHistorySource::openStringDb(pathStrDbPath);
+    stringDbs->values = StateHistorySource::openStringDb(valueStrDbPath);
+
+    return stringDbs;
+}
+
+StringDb::UP StateHistorySource::openStringDb(const bfs::path& path)
+{
+    try {
+        return StringDb::UP {new StringDb {path}};
+    } catch (const ex::StringDb& ex) {
+        throw ex::StateHistorySource {ex.what(), ex.getPath()};
+    } catch (const ex::MappedFile& ex) {
+        throw ex::StateHistorySource {"cannot open string database", ex.getPath()};
+    }
+}
+
+timestamp_t StateHistorySource::getBegin() const
+{
+    if (_snapshot) {
+        return _snapshot->getBegin();
+    }
+
+    return static_cast<timestamp_t>(_intervalFileSource->getBegin());
+}
+
+timestamp_t StateHistorySource::getEnd() const
+{
+    if (_snapshot) {
+        return _snapshot->getWatermark();
+    }
+
+    return static_cast<timestamp_t>(_intervalFileSource->getEnd());
+}
+
+bool StateHistorySource::getPathQuark(const std::string& path,
+                                      quark_t& quark) const
+{
+    return _stringDbs->paths->getQuark(path, quark);
+}
+
+const char* StateHistorySource::getPath(quark_t quark) const
+{
+    return _stringDbs->paths->getString(quark);
+}
+
+void StateHistorySource::findPaths(const std::string& glob,
+                                   std::vector<quark_t>& quarks) const
+{
+    // no wildcard: direct lookup
+    if (glob.find_first_of("*?[\\") == std::string::npos) {
+        quark_t quark;
+
+        if (this->getPathQuark(glob, quark)) {
+            quarks.push_back(quark);
+        }
+
+        return;
+    }
+
+    const auto& paths = *_stringDbs->paths;
+
+    for (std::size_t quark = 0; quark < paths.getCount(); ++quark) {
+        auto path = paths.getString(static_cast<quark_t>(quark));
+
+        if (::fnmatch(glob.c_str(), path, 0) == 0) {
+            quarks.push_back(static_cast<quark_t>(quark));
+        }
+    }
+}
+
+std::size_t StateHistorySource::getPathsCount() const
+{
+    return _stringDbs->paths->getCount();
+}
+
+const char* StateHistorySource::getStringValue(quark_t quark) const
+{
+    return _stringDbs->values->getString(quark);
+}
+
+delo::AbstractInterval::SP StateHistorySource::getState(quark_t pathQuark,
+                                                        timestamp_t ts)
+{
+    if (_snapshot) {
+        return _snapshot->getState(pathQuark, ts);
+    }
+
+    return _intervalFileSource->findOne(static_cast<delo::timestamp_t>(ts),
+                                        static_cast<delo::interval_key_t>(pathQuark));
+}
+
+bool StateHistorySource::getAllStates(timestamp_t ts,
+                                      delo::IntervalJar& intervals)
+{
+    if (_snapshot) {
+        _snapshot->getAllStates(ts, intervals);
+
+        return true;
+    }
+
+    return _intervalFileSource->findAll(static_cast<delo::timestamp_t>(ts),
+                                        intervals);
+}
+
+}
+}
@@ -0,0 +1,272 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATEHISTORYSOURCE_HPP
+#define _TIBEE_COMMON_STATEHISTORYSOURCE_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+#include <delorean/HistoryFileSource.hpp>
+#include <delorean/interval/AbstractInterval.hpp>
+#include <delorean/interval/IntervalJar.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/state/StateSnapshotSource.hpp>
+#include <common/state/StringDb.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A state history source.
+ *
+ * An object of this class reads a state history written by a
+ * StateHistorySink: the two string databases (paths and state values)
+ * and the history of state intervals.
+ *
+ * String databases are memory-mapped (see StringDb), immutable and
+ * may be shared by many sources (see fork()), but a single source must
+ * not be used by more than one thread at a time.
+ *
+ * A source may also be live, that is, read a history which is still
+ * being built (see StateSnapshotSource): states are then only known
+ * before the watermark, which is the end of the history. refresh()
+ * loads the latest published snapshot (and string databases) for all
+ * the forks of a live source, and each fork switches to the latest
+ * string databases when calling sync().
+ *
+ * @author Philippe Proulx
+ */
+class StateHistorySource :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to state history source
+    typedef std::unique_ptr<StateHistorySource> UP;
+
+public:
+    /**
+     * Builds a state history source.
+     *
+     * Throws ex::StateHistorySource if any file cannot be read.
+     *
+     * @param pathStrDbPath  Path to path string database file
+     * @param valueStrDbPath Path to value string database file
+     * @param historyPath    Path to history file
+     */
+    StateHistorySource(const boost::filesystem::path& pathStrDbPath,
+                       const boost::filesystem::path& valueStrDbPath,
+                       const boost::filesystem::path& historyPath);
+
+    /**
+     * Builds a live state history source.
+     *
+     * Throws ex::StateHistorySource if any file cannot be read.
+     *
+     * @param pathStrDbPath  Path to path string database file
+     * @param valueStrDbPath Path to value string database file
+     * @param snapshot       State snapshot source (shared)
+     */
+    StateHistorySource(const boost::filesystem::path& pathStrDbPath,
+                       const boost::filesystem::path& valueStrDbPath,
+                       std::shared_ptr<StateSnapshotSource> snapshot);
+
+    ~StateHistorySource();
+
+    /**
+     * Returns whether or not this source is live.
+     *
+     * @returns True if live
+     */
+    bool isLive() const
+    {
+        return _snapshot != nullptr;
+    }
+
+    /**
+     * Returns whether or not the history is completely built (always
+     * true if this source is not live).
+     *
+     * @returns True if complete
+     */
+    bool isComplete() const
+    {
+        return !_snapshot || _snapshot->isComplete();
+    }
+
+    /**
+     * Loads the latest published snapshot of a live source, reloading
+     * the string databases if they grew. May be called from any
+     * thread; does nothing if this source is not live.
+     *
+     * @returns True if a new snapshot was loaded
+     */
+    bool refresh();
+
+    /**
+     * Switches to the latest string databases loaded by refresh().
+     * Does nothing if this source is not live.
+     *
+     * Strings previously returned by this source remain valid until
+     * the next call.
+     */
+    void sync();
+
+    /**
+     * Builds another source reading the same history, sharing the
+     * string databases of this one but having its own history file
+     * handle, to be used by another thread.
+     *
+     * @returns New state history source
+     */
+    UP fork() const;
+
+    /**
+     * Returns the begin timestamp of the history.
+     *
+     * @returns History begin timestamp
+     */
+    timestamp_t getBegin() const;
+
+    /**
+     * Returns the end timestamp of the history.
+     *
+     * @returns History end timestamp
+     */
+    timestamp_t getEnd() const;
+
+    /**
+     * Finds the quark of a given path.
+     *
+     * @param path  Path string
+     * @param quark Found quark (set if found)
+     * @returns     True if found
+     */
+    bool getPathQuark(const std::string& path, quark_t& quark) const;
+
+    /**
+     * Returns the path string of a given path quark.
+     *
+     * @param quark Path quark
+     * @returns     Null-terminated path string or \a nullptr if not
+     *              found
+     */
+    const char* getPath(quark_t quark) const;
+
+    /**
+     * Appends to \p quarks the quarks of all paths matching the
+     * shell-style wildcard pattern \p glob (see fnmatch(3); \c * also
+     * matches \c /), in quark order.
+     *
+     * @param glob   Path glob
+     * @param quarks Matching path quarks output
+     */
+    void findPaths(const std::string& glob,
+                   std::vector<quark_t>& quarks) const;
+
+    /**
+     * Returns the number of path quarks.
+     *
+     * Path quarks go from 0 to this number minus one.
+     *
+     * @returns Number of path quarks
+     */
+    std::size_t getPathsCount() const;
+
+    /**
+     * Returns the string of a given string value quark.
+     *
+     * @param quark String value quark
+     * @returns     Null-terminated string value or \a nullptr if not
+     *              found
+     */
+    const char* getStringValue(quark_t quark) const;
+
+    /**
+     * Returns the state interval of path \p pathQuark at timestamp
+     * \p ts.
+     *
+     * @param pathQuark Path quark
+     * @param ts        Timestamp
+     * @returns         State interval or \a nullptr if no state
+     */
+    delo::AbstractInterval::SP getState(quark_t pathQuark, timestamp_t ts);
+
+    /**
+     * Appends to \p intervals all the state intervals at timestamp
+     * \p ts.
+     *
+     * @param ts        Timestamp
+     * @param intervals State intervals output
+     * @returns         True if successful
+     */
+    bool getAllStates(timestamp_t ts, delo::IntervalJar& intervals);
+
+private:
+    struct StringDbs
+    {
+        StringDb::UP paths;
+        StringDb::UP values;
+    };
+
+    // latest string databases of a live source, shared by its forks
+    struct LiveStringDbs
+    {
+        boost::filesystem::path pathStrDbPath;
+        boost::filesystem::path valueStrDbPath;
+        std::shared_ptr<const StringDbs> stringDbs;
+        std::mutex mutex;
+    };
+
+private:
+    StateHistorySource(std::shared_ptr<const StringDbs> stringDbs,
+                       const boost::filesystem::path& historyPath);
+    StateHistorySource(std::shared_ptr<const StringDbs> stringDbs,
+                       std::shared_ptr<StateSnapshotSource> snapshot,
+                       std::shared_ptr<LiveStringDbs> liveStringDbs);
+    static std::shared_ptr<const StringDbs> readStringDbs(const boost::filesystem::path& pathStrDbPath,
+                                                          const boost::filesystem::path& valueStrDbPath);
+    void openHistory();
+    static StringDb::UP openStringDb(const boost::filesystem::path& path);
+
+private:
+    // shared string databases
+    std::shared_ptr<const StringDbs> _stringDbs;
+
+    // path to history file
+    boost::filesystem::path _historyPath;
+
+    // interval history source
+    std::unique_ptr<delo::HistoryFileSource> _intervalFileSource;
+
+    // state snapshot source (live source only)
+    std::shared_ptr<StateSnapshotSource> _snapshot;
+
+    // latest string databases (live source only)
+    std::shared_ptr<LiveStringDbs> _liveStringDbs;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATEHISTORYSOURCE_HPP
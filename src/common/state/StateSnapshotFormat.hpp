@@ -0,0 +1,104 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATESNAPSHOTFORMAT_HPP
+#define _TIBEE_COMMON_STATESNAPSHOTFORMAT_HPP
+
+#include <cstdint>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * @file
+ * On-disk layout of a live state history.
+ *
+ * While a state history is being built, its history file cannot be
+ * read. A live state history makes the committed part readable before
+ * the end of the build; it comprises two files besides the string
+ * databases:
+ *
+ *   * the state log: one StateLogFileHeader, then one
+ *     StateLogFileRecord per state interval, in the order they're
+ *     committed (that is, sorted by end timestamp). This file is only
+ *     appended to.
+ *   * the state snapshot: one StateSnapshotFileHeader, then
+ *     \a openCount StateLogFileRecord objects, the state intervals
+ *     which are still open at the watermark (their end timestamp is
+ *     the watermark). This file is replaced atomically at each
+ *     publication.
+ *
+ * A snapshot is consistent: all the state intervals overlapping
+ * [begin, watermark) are either in the first \a recordsCount records
+ * of the log or open in the snapshot, and the string databases hold
+ * at least \a pathsCount paths and \a valuesCount string values (they
+ * are written before the snapshot).
+ *
+ * Everything is written in native byte order and naturally aligned.
+ */
+
+/// State log file magic number ("TBSL")
+static const std::uint32_t STATE_LOG_FILE_MAGIC = 0x5442534c;
+
+/// State snapshot file magic number ("TBSN")
+static const std::uint32_t STATE_SNAPSHOT_FILE_MAGIC = 0x5442534e;
+
+/// Live state history format version
+static const std::uint32_t STATE_SNAPSHOT_FILE_VERSION = 1;
+
+/// State log file header
+struct StateLogFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+};
+
+/**
+ * State log file record (one state interval).
+ *
+ * \a value holds the raw value, encoded like the dominant value of a
+ * StateSummaryFileRecord.
+ */
+struct StateLogFileRecord
+{
+    std::uint64_t beginTs;
+    std::uint64_t endTs;
+    std::uint64_t value;
+    std::uint32_t pathQuark;
+    std::uint32_t valueType;
+};
+
+/// State snapshot file header
+struct StateSnapshotFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t beginTs;
+    std::uint64_t watermark;
+    std::uint64_t recordsCount;
+    std::uint32_t openCount;
+    std::uint32_t complete;
+    std::uint32_t pathsCount;
+    std::uint32_t valuesCount;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATESNAPSHOTFORMAT_HPP
@@ -0,0 +1,447 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <delorean/interval/AbstractInterval.hpp>
+#include <delorean/interval/Int32Interval.hpp>
+#include <delorean/interval/Uint32Interval.hpp>
+#include <delorean/interval/Int64Interval.hpp>
+#include <delorean/interval/Uint64Interval.hpp>
+#include <delorean/interval/Float32Interval.hpp>
+#include <delorean/interval/QuarkInterval.hpp>
+
+#include <common/state/StateValueType.hpp>
+#include <common/state/StateSnapshotSource.hpp>
+#include <common/ex/StateSnapshotSource.hpp>
+#include <common/ex/MappedFile.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+StateSnapshotSource::StateSnapshotSource(const bfs::path& logPath,
+                                         const bfs::path& snapshotPath) :
+    _logPath {logPath},
+    _snapshotPath {snapshotPath}
+{
+    _logFd = ::open(logPath.string().c_str(), O_RDONLY);
+
+    if (_logFd < 0) {
+        throw ex::StateSnapshotSource {"cannot open state log", logPath};
+    }
+
+    try {
+        MappedFile log {_logFd, logPath};
+        auto logHeader = log.getAt<StateLogFileHeader>(0);
+
+        if (!logHeader || logHeader->magic != STATE_LOG_FILE_MAGIC ||
+                logHeader->version != STATE_SNAPSHOT_FILE_VERSION) {
+            throw ex::StateSnapshotSource {"not a state log", logPath};
+        }
+
+        this->refresh();
+
+        if (!this->getView()) {
+            throw ex::StateSnapshotSource {"cannot read state snapshot", snapshotPath};
+        }
+    } catch (const ex::MappedFile& ex) {
+        ::close(_logFd);
+
+        throw ex::StateSnapshotSource {"cannot map state log", logPath};
+    } catch (...) {
+        ::close(_logFd);
+        throw;
+    }
+}
+
+StateSnapshotSource::~StateSnapshotSource()
+{
+    ::close(_logFd);
+}
+
+bool StateSnapshotSource::isBuilding(const bfs::path& snapshotPath)
+{
+    bfs::ifstream input;
+    StateSnapshotFileHeader header;
+
+    input.open(snapshotPath, std::ios::binary);
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!input || header.magic != STATE_SNAPSHOT_FILE_MAGIC ||
+            header.version != STATE_SNAPSHOT_FILE_VERSION) {
+        return false;
+    }
+
+    return header.complete == 0;
+}
+
+bool StateSnapshotSource::readSnapshot(StateSnapshotFileHeader& header,
+                                       std::vector<StateLogFileRecord>& openRecords)
+{
+    bfs::ifstream input;
+
+    input.open(_snapshotPath, std::ios::binary);
+
+    if (!input) {
+        return false;
+    }
+
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!input || header.magic != STATE_SNAPSHOT_FILE_MAGIC ||
+            header.version != STATE_SNAPSHOT_FILE_VERSION) {
+        return false;
+    }
+
+    openRecords.resize(header.openCount);
+    input.read(reinterpret_cast<char*>(openRecords.data()),
+               openRecords.size() * sizeof(StateLogFileRecord));
+
+    return static_cast<bool>(input);
+}
+
+bool StateSnapshotSource::refresh()
+{
+    std::lock_guard<std::mutex> refreshLock {_refreshMutex};
+
+    StateSnapshotFileHeader header;
+    std::vector<StateLogFileRecord> openRecords;
+
+    /* The snapshot file is replaced atomically by the sink, so a
+     * successfully read snapshot is always consistent.
+     */
+    if (!this->readSnapshot(header, openRecords)) {
+        return false;
+    }
+
+    auto oldView = this->getView();
+    std::uint64_t oldRecordsCount = 0;
+
+    if (oldView) {
+        const auto& oldHeader = oldView->header;
+
+        // nothing new?
+        if (header.watermark == oldHeader.watermark &&
+                header.complete == oldHeader.complete &&
+                header.recordsCount == oldHeader.recordsCount) {
+            return false;
+        }
+
+        // the sink was restarted: cannot follow
+        if (header.recordsCount < oldHeader.recordsCount) {
+            return false;
+        }
+
+        oldRecordsCount = oldHeader.recordsCount;
+    }
+
+    // map the state log again only if it grew past the current mapping
+    std::shared_ptr<const MappedFile> log;
+    auto logSize = sizeof(StateLogFileHeader) +
+                   header.recordsCount * sizeof(StateLogFileRecord);
+
+    if (oldView && oldView->log->getSize() >= logSize) {
+        log = oldView->log;
+    } else {
+        try {
+            log = std::make_shared<MappedFile>(_logFd, _logPath);
+        } catch (const ex::MappedFile& ex) {
+            return false;
+        }
+    }
+
+    auto records = log->getAt<StateLogFileRecord>(sizeof(StateLogFileHeader),
+                                                  header.recordsCount);
+
+    if (!records) {
+        return false;
+    }
+
+    // new view sharing the unchanged path indexes and chunks
+    std::shared_ptr<View> view {new View};
+
+    view->header = header;
+    view->log = log;
+
+    if (oldView) {
+        view->paths = oldView->paths;
+    }
+
+    // path indexes being extended, with their (private) last chunk
+    struct ExtendedIndex
+    {
+        std::shared_ptr<PathIndex> index;
+        std::shared_ptr<IndexChunk> lastChunk;
+    };
+
+    std::unordered_map<quark_t, ExtendedIndex> extendedIndexes;
+
+    for (auto pos = oldRecordsCount; pos < header.recordsCount; ++pos) {
+        auto pathQuark = records[pos].pathQuark;
+
+        if (pathQuark >= view->paths.size()) {
+            view->paths.resize(pathQuark + 1);
+        }
+
+        auto& extended = extendedIndexes[pathQuark];
+
+        if (!extended.index) {
+            // copy on write: published chunks are never modified
+            extended.index = std::make_shared<PathIndex>();
+            extended.index->count = 0;
+
+            if (view->paths[pathQuark]) {
+                *extended.index = *view->paths[pathQuark];
+            }
+
+            auto& chunks = extended.index->chunks;
+
+            if (extended.index->count % INDEX_CHUNK_SIZE != 0) {
+                extended.lastChunk = std::make_shared<IndexChunk>(*chunks.back());
+                extended.lastChunk->reserve(INDEX_CHUNK_SIZE);
+                chunks.back() = extended.lastChunk;
+            }
+
+            view->paths[pathQuark] = extended.index;
+        }
+
+        auto& index = *extended.index;
+
+        if (index.count % INDEX_CHUNK_SIZE == 0) {
+            extended.lastChunk = std::make_shared<IndexChunk>();
+            extended.lastChunk->reserve(INDEX_CHUNK_SIZE);
+            index.chunks.push_back(extended.lastChunk);
+        }
+
+        // committed in ascending end order, thus in ascending begin order for a path
+        extended.lastChunk->push_back(pos);
+        index.count++;
+    }
+
+    for (const auto& record : openRecords) {
+        view->openRecords[record.pathQuark] = record;
+    }
+
+    std::atomic_store(&_view, std::shared_ptr<const View> {std::move(view)});
+
+    return true;
+}
+
+std::shared_ptr<const StateSnapshotSource::View> StateSnapshotSource::getView() const
+{
+    return std::atomic_load(&_view);
+}
+
+timestamp_t StateSnapshotSource::getBegin() const
+{
+    return this->getView()->header.beginTs;
+}
+
+timestamp_t StateSnapshotSource::getWatermark() const
+{
+    return this->getView()->header.watermark;
+}
+
+bool StateSnapshotSource::isComplete() const
+{
+    return this->getView()->header.complete != 0;
+}
+
+std::size_t StateSnapshotSource::getPathsCount() const
+{
+    return this->getView()->header.pathsCount;
+}
+
+std::size_t StateSnapshotSource::getValuesCount() const
+{
+    return this->getView()->header.valuesCount;
+}
+
+bool StateSnapshotSource::isKnown(const View& view, timestamp_t ts)
+{
+    if (view.header.complete) {
+        return ts <= view.header.watermark;
+    }
+
+    return ts < view.header.watermark;
+}
+
+const StateLogFileRecord* StateSnapshotSource::findRecord(const View& view,
+                                                          quark_t pathQuark,
+                                                          timestamp_t ts)
+{
+    if (pathQuark < view.paths.size() && view.paths[pathQuark]) {
+        const auto& index = *view.paths[pathQuark];
+        auto records = view.log->getAt<StateLogFileRecord>(sizeof(StateLogFileHeader),
+                                                           view.header.recordsCount);
+        auto getRecord = [&index, records] (std::size_t at) {
+            return &records[(*index.chunks[at / INDEX_CHUNK_SIZE])[at % INDEX_CHUNK_SIZE]];
+        };
+
+        // last interval beginning at or before ts
+        std::size_t low = 0;
+        std::size_t high = index.count;
+
+        while (low < high) {
+            auto mid = low + (high - low) / 2;
+
+            if (getRecord(mid)->beginTs <= ts) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (low != 0) {
+            auto record = getRecord(low - 1);
+
+            if (ts <= record->endTs) {
+                return record;
+            }
+        }
+    }
+
+    auto it = view.openRecords.find(pathQuark);
+
+    if (it != view.openRecords.end() && it->second.beginTs <= ts) {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+
+delo::AbstractInterval::SP StateSnapshotSource::getState(quark_t pathQuark,
+                                                         timestamp_t ts) const
+{
+    // the view (and its log mapping) stays alive during this query
+    auto view = this->getView();
+
+    if (!StateSnapshotSource::isKnown(*view, ts)) {
+        return nullptr;
+    }
+
+    auto record = StateSnapshotSource::findRecord(*view, pathQuark, ts);
+
+    if (!record) {
+        return nullptr;
+    }
+
+    return StateSnapshotSource::createInterval(*record);
+}
+
+void StateSnapshotSource::getAllStates(timestamp_t ts,
+                                       delo::IntervalJar& intervals) const
+{
+    auto view = this->getView();
+
+    if (!StateSnapshotSource::isKnown(*view, ts)) {
+        return;
+    }
+
+    // open records may exist for paths without committed records
+    quark_t pathsCount = static_cast<quark_t>(view->paths.size());
+
+    for (const auto& quarkRecordPair : view->openRecords) {
+        pathsCount = std::max(pathsCount, quarkRecordPair.first + 1);
+    }
+
+    for (quark_t pathQuark = 0; pathQuark < pathsCount; ++pathQuark) {
+        auto record = StateSnapshotSource::findRecord(*view, pathQuark, ts);
+
+        if (record) {
+            intervals.push_back(StateSnapshotSource::createInterval(*record));
+        }
+    }
+}
+
+delo::AbstractInterval::SP StateSnapshotSource::createInterval(const StateLogFileRecord& record)
+{
+    auto begin = static_cast<delo::timestamp_t>(record.beginTs);
+    auto end = static_cast<delo::timestamp_t>(record.endTs);
+    auto key = static_cast<delo::interval_key_t>(record.pathQuark);
+
+    switch (static_cast<StateValueType>(record.valueType)) {
+    case StateValueType::INT32:
+    {
+        auto interval = std::make_shared<delo::Int32Interval>(begin, end, key);
+
+        interval->setValue(static_cast<std::int32_t>(record.value));
+
+        return interval;
+    }
+
+    case StateValueType::UINT32:
+    {
+        auto interval = std::make_shared<delo::Uint32Interval>(begin, end, key);
+
+        interval->setValue(static_cast<std::uint32_t>(record.value));
+
+        return interval;
+    }
+
+    case StateValueType::INT64:
+    {
+        auto interval = std::make_shared<delo::Int64Interval>(begin, end, key);
+
+        interval->setValue(static_cast<std::int64_t>(record.value));
+
+        return interval;
+    }
+
+    case StateValueType::UINT64:
+    {
+        auto interval = std::make_shared<delo::Uint64Interval>(begin, end, key);
+
+        interval->setValue(record.value);
+
+        return interval;
+    }
+
+    case StateValueType::FLOAT32:
+    {
+        auto interval = std::make_shared<delo::Float32Interval>(begin, end, key);
+        double value;
+
+        std::memcpy(&value, &record.value, sizeof(value));
+        interval->setValue(static_cast<float>(value));
+
+        return interval;
+    }
+
+    case StateValueType::QUARK:
+    {
+        auto interval = std::make_shared<delo::QuarkInterval>(begin, end, key);
+
+        interval->setValue(static_cast<std::uint32_t>(record.value));
+
+        return interval;
+    }
+    }
+
+    return nullptr;
+}
+
+}
+}
@@ -0,0 +1,210 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATESNAPSHOTSOURCE_HPP
+#define _TIBEE_COMMON_STATESNAPSHOTSOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+#include <delorean/interval/AbstractInterval.hpp>
+#include <delorean/interval/IntervalJar.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/state/StateSnapshotFormat.hpp>
+#include <common/utils/MappedFile.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A state snapshot source; reads the live state history (state log
+ * and state snapshot) published by a StateHistorySink which is still
+ * building a history.
+ *
+ * State intervals stay in the memory-mapped state log: only the
+ * positions of their records are indexed in memory, by path, as
+ * they're loaded. refresh() loads the latest published snapshot, only
+ * indexing the new records of the state log. Only states before the
+ * watermark (or at it, once the history is complete) are known.
+ *
+ * Each loaded snapshot is an immutable view, atomically swapped by
+ * refresh(): queries take the current view without locking, so that
+ * many threads may query at once while a refresh is in progress.
+ *
+ * @author Philippe Proulx
+ */
+class StateSnapshotSource :
+    boost::noncopyable
+{
+public:
+    /**
+     * Opens a live state history and loads its latest snapshot.
+     *
+     * Throws ex::StateSnapshotSource if a file cannot be read.
+     *
+     * @param logPath      Path to state log file
+     * @param snapshotPath Path to state snapshot file
+     */
+    StateSnapshotSource(const boost::filesystem::path& logPath,
+                        const boost::filesystem::path& snapshotPath);
+
+    ~StateSnapshotSource();
+
+    /**
+     * Returns whether or not the state snapshot file \p snapshotPath
+     * says that its history is still being built, without loading
+     * anything else.
+     *
+     * @param snapshotPath Path to state snapshot file
+     * @returns            True if the history is being built
+     */
+    static bool isBuilding(const boost::filesystem::path& snapshotPath);
+
+    /**
+     * Loads the latest published snapshot, if any.
+     *
+     * @returns True if a new snapshot was loaded
+     */
+    bool refresh();
+
+    /**
+     * Returns the begin timestamp of the history.
+     *
+     * @returns History begin timestamp
+     */
+    timestamp_t getBegin() const;
+
+    /**
+     * Returns the watermark of the current snapshot: all states before
+     * it are known.
+     *
+     * @returns Watermark
+     */
+    timestamp_t getWatermark() const;
+
+    /**
+     * Returns whether or not the current snapshot is the last one,
+     * that is, the history is completely built.
+     *
+     * @returns True if complete
+     */
+    bool isComplete() const;
+
+    /**
+     * Returns the minimum number of paths in the path string database
+     * for the current snapshot.
+     *
+     * @returns Number of paths
+     */
+    std::size_t getPathsCount() const;
+
+    /**
+     * Returns the minimum number of string values in the value string
+     * database for the current snapshot.
+     *
+     * @returns Number of string values
+     */
+    std::size_t getValuesCount() const;
+
+    /**
+     * Returns the state interval of path \p pathQuark at timestamp
+     * \p ts.
+     *
+     * @param pathQuark Path quark
+     * @param ts        Timestamp
+     * @returns         State interval or \a nullptr if no (known) state
+     */
+    delo::AbstractInterval::SP getState(quark_t pathQuark,
+                                        timestamp_t ts) const;
+
+    /**
+     * Appends to \p intervals all the known state intervals at
+     * timestamp \p ts.
+     *
+     * @param ts        Timestamp
+     * @param intervals State intervals output
+     */
+    void getAllStates(timestamp_t ts, delo::IntervalJar& intervals) const;
+
+private:
+    // number of record positions of a path index chunk
+    static const std::size_t INDEX_CHUNK_SIZE = 4096;
+
+    // chunk of record positions (never modified once published)
+    typedef std::vector<std::uint64_t> IndexChunk;
+
+    // positions of the committed records of one path, in log order
+    struct PathIndex
+    {
+        std::vector<std::shared_ptr<const IndexChunk>> chunks;
+        std::size_t count;
+    };
+
+    // one loaded snapshot; never modified once published
+    struct View
+    {
+        StateSnapshotFileHeader header;
+
+        // state log mapping, covering at least header.recordsCount records
+        std::shared_ptr<const MappedFile> log;
+
+        // record positions, by path quark (null if none)
+        std::vector<std::shared_ptr<const PathIndex>> paths;
+
+        // open state intervals at the watermark, by path quark
+        std::unordered_map<quark_t, StateLogFileRecord> openRecords;
+    };
+
+private:
+    bool readSnapshot(StateSnapshotFileHeader& header,
+                      std::vector<StateLogFileRecord>& openRecords);
+    std::shared_ptr<const View> getView() const;
+    static bool isKnown(const View& view, timestamp_t ts);
+    static const StateLogFileRecord* findRecord(const View& view,
+                                                quark_t pathQuark,
+                                                timestamp_t ts);
+    static delo::AbstractInterval::SP createInterval(const StateLogFileRecord& record);
+
+private:
+    // paths to files
+    boost::filesystem::path _logPath;
+    boost::filesystem::path _snapshotPath;
+
+    /* State log, kept opened: the sink removes it once the history
+     * is complete, but a last refresh may need to map it again.
+     */
+    int _logFd;
+
+    // current view (swapped atomically)
+    std::shared_ptr<const View> _view;
+
+    // serializes refreshes
+    std::mutex _refreshMutex;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATESNAPSHOTSOURCE_HPP
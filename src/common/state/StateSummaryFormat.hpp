@@ -0,0 +1,116 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATESUMMARYFORMAT_HPP
+#define _TIBEE_COMMON_STATESUMMARYFORMAT_HPP
+
+#include <cstdint>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * @file
+ * On-disk layout of a state summary file.
+ *
+ * A state summary file contains, for each state path, a summary of its
+ * state intervals in each bucket of a fixed time grid: dominant value
+ * (value held the longest), number of transitions and min/max for
+ * numeric values. Multiple grids (levels) are stored, level 0 being the
+ * finest one; each next level has buckets 4 times larger.
+ *
+ * Consecutive buckets entirely covered by the same value are stored as
+ * a single record, and buckets without any state are not stored, so
+ * that stable states cost nothing.
+ *
+ * The file is:
+ *
+ *   * one StateSummaryFileHeader
+ *   * \a levelsCount StateSummaryFileLevel objects
+ *   * for each level, \a pathsCount StateSummaryFileIndexEntry
+ *     objects (indexed by path quark) starting at the level's
+ *     \a indexOffset
+ *   * records (StateSummaryFileRecord), sorted by first bucket for
+ *     a given path and level
+ *
+ * Everything is written in native byte order and naturally aligned so
+ * that a reader may use the mapped file as is.
+ */
+
+/// State summary file magic number ("TBSS")
+static const std::uint32_t STATE_SUMMARY_FILE_MAGIC = 0x54425353;
+
+/// State summary file format version
+static const std::uint32_t STATE_SUMMARY_FILE_VERSION = 2;
+
+/// State summary file header
+struct StateSummaryFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t beginTs;
+    std::uint64_t endTs;
+    std::uint32_t levelsCount;
+    std::uint32_t pathsCount;
+};
+
+/// State summary file level descriptor
+struct StateSummaryFileLevel
+{
+    std::uint64_t bucketDuration;
+    std::uint32_t bucketsCount;
+    std::uint32_t reserved;
+    std::uint64_t indexOffset;
+};
+
+/// State summary file index entry (records of one path at one level)
+struct StateSummaryFileIndexEntry
+{
+    std::uint64_t recordsOffset;
+    std::uint32_t recordsCount;
+    std::uint32_t reserved;
+};
+
+/**
+ * State summary file record.
+ *
+ * \a dominant holds the raw dominant value: a sign-extended integer for
+ * INT32/INT64, an integer for UINT32/UINT64/QUARK, and the bits of a
+ * double for FLOAT32. \a min and \a max are only meaningful for numeric
+ * types.
+ *
+ * \a transitions is the number of intervals beginning right at the end
+ * of the previous one within the buckets of the record, so that each
+ * transition is counted in exactly one bucket.
+ */
+struct StateSummaryFileRecord
+{
+    std::uint32_t firstBucket;
+    std::uint32_t bucketsCount;
+    std::uint32_t transitions;
+    std::uint32_t valueType;
+    std::uint64_t dominant;
+    double min;
+    double max;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATESUMMARYFORMAT_HPP
@@ -0,0 +1,364 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <common/state/StateSummaryFormat.hpp>
+#include <common/state/StateSummarySink.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+StateSummarySink::StateSummarySink(const bfs::path& path,
+                                   timestamp_t beginTs, timestamp_t endTs,
+                                   std::size_t maxBuckets,
+                                   std::size_t maxLevels) :
+    _path {path},
+    _beginTs {beginTs},
+    _span {1},
+    _shift {0},
+    _opened {true}
+{
+    if (endTs > beginTs) {
+        _span = endTs - beginTs + 1;
+    }
+
+    if (maxBuckets == 0) {
+        maxBuckets = 1;
+    }
+
+    // smallest power of two bucket duration giving at most maxBuckets buckets
+    while ((_span - 1) >> _shift >= maxBuckets) {
+        _shift++;
+    }
+
+    // levels (each one has buckets 4 times larger than the previous)
+    maxLevels = std::max(maxLevels, static_cast<std::size_t>(1));
+
+    for (std::size_t x = 0; x < maxLevels; ++x) {
+        auto shift = _shift + 2 * x;
+
+        if (shift >= static_cast<unsigned int>(std::numeric_limits<timestamp_t>::digits)) {
+            break;
+        }
+
+        auto bucketsCount = static_cast<std::uint32_t>(((_span - 1) >> shift) + 1);
+
+        _bucketsCounts.push_back(bucketsCount);
+
+        // no need to go coarser than a single bucket
+        if (bucketsCount == 1) {
+            break;
+        }
+    }
+}
+
+StateSummarySink::~StateSummarySink()
+{
+    this->close(_paths.size());
+}
+
+bool StateSummarySink::isNumeric(StateValueType type)
+{
+    return type != StateValueType::QUARK;
+}
+
+void StateSummarySink::accumulate(Accumulator& acc, std::uint32_t bucket,
+                                  StateValueType type, std::uint64_t raw,
+                                  double numeric, timestamp_t duration,
+                                  bool isTransition)
+{
+    if (!acc.active) {
+        acc.active = true;
+        acc.bucket = bucket;
+        acc.transitions = 0;
+        acc.min = std::numeric_limits<double>::infinity();
+        acc.max = -std::numeric_limits<double>::infinity();
+        acc.durations.clear();
+    }
+
+    if (isTransition) {
+        acc.transitions++;
+    }
+
+    if (StateSummarySink::isNumeric(type)) {
+        acc.min = std::min(acc.min, numeric);
+        acc.max = std::max(acc.max, numeric);
+    }
+
+    // few distinct values per bucket: linear search is fine
+    for (auto& valueDuration : acc.durations) {
+        if (valueDuration.type == type && valueDuration.raw == raw) {
+            valueDuration.duration += duration;
+
+            return;
+        }
+    }
+
+    acc.durations.push_back({type, raw, duration});
+}
+
+void StateSummarySink::emit(PathLevel& pathLevel,
+                            const StateSummaryFileRecord& record)
+{
+    auto& records = pathLevel.records;
+
+    // extend the previous record if this one continues it exactly
+    if (!records.empty()) {
+        auto& last = records.back();
+        auto sameBound = [] (double a, double b) {
+            return a == b || (std::isnan(a) && std::isnan(b));
+        };
+
+        if (last.firstBucket + last.bucketsCount == record.firstBucket &&
+                last.transitions == 0 && record.transitions == 0 &&
+                last.valueType == record.valueType &&
+                last.dominant == record.dominant &&
+                sameBound(last.min, record.min) &&
+                sameBound(last.max, record.max)) {
+            last.bucketsCount += record.bucketsCount;
+
+            return;
+        }
+    }
+
+    records.push_back(record);
+}
+
+void StateSummarySink::flush(PathLevel& pathLevel)
+{
+    auto& acc = pathLevel.acc;
+
+    if (!acc.active) {
+        return;
+    }
+
+    acc.active = false;
+
+    auto dominant = std::max_element(acc.durations.begin(), acc.durations.end(),
+                                     [] (const ValueDuration& a, const ValueDuration& b) {
+        return a.duration < b.duration;
+    });
+
+    StateSummaryFileRecord record;
+
+    record.firstBucket = acc.bucket;
+    record.bucketsCount = 1;
+    record.transitions = acc.transitions;
+    record.valueType = static_cast<std::uint32_t>(dominant->type);
+    record.dominant = dominant->raw;
+    record.min = std::numeric_limits<double>::quiet_NaN();
+    record.max = std::numeric_limits<double>::quiet_NaN();
+
+    if (acc.min <= acc.max) {
+        record.min = acc.min;
+        record.max = acc.max;
+    }
+
+    StateSummarySink::emit(pathLevel, record);
+}
+
+void StateSummarySink::addInterval(quark_t pathQuark, timestamp_t begin,
+                                   timestamp_t end, StateValueType type,
+                                   std::uint64_t raw, double numeric)
+{
+    if (!_opened) {
+        return;
+    }
+
+    // relative timestamps, clamped to the summaries begin
+    begin = std::max(begin, _beginTs) - _beginTs;
+
+    if (end <= _beginTs || end - _beginTs <= begin) {
+        return;
+    }
+
+    end -= _beginTs;
+
+    if (pathQuark >= _paths.size()) {
+        _paths.resize(pathQuark + 1);
+        _lastEnds.resize(pathQuark + 1, 0);
+    }
+
+    /* A transition happens where an interval begins right at the end
+     * of the previous one: it belongs to the bucket containing this
+     * begin timestamp, even if it's a bucket boundary.
+     */
+    bool isTransition = _lastEnds[pathQuark] != 0 &&
+                        _lastEnds[pathQuark] == begin;
+
+    _lastEnds[pathQuark] = end;
+
+    auto& levels = _paths[pathQuark];
+
+    if (levels.empty()) {
+        levels.resize(_bucketsCounts.size());
+
+        for (auto& pathLevel : levels) {
+            pathLevel.acc.active = false;
+        }
+    }
+
+    bool isNumeric = StateSummarySink::isNumeric(type);
+
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+        auto& pathLevel = levels[l];
+        auto shift = _shift + 2 * l;
+        auto lastBucket = static_cast<timestamp_t>(_bucketsCounts[l] - 1);
+        auto first = static_cast<std::uint32_t>(std::min(begin >> shift, lastBucket));
+        auto last = static_cast<std::uint32_t>(std::min((end - 1) >> shift, lastBucket));
+
+        if (pathLevel.acc.active && pathLevel.acc.bucket != first) {
+            this->flush(pathLevel);
+        }
+
+        if (first == last) {
+            this->accumulate(pathLevel.acc, first, type, raw, numeric,
+                             end - begin, isTransition);
+            continue;
+        }
+
+        // partial first bucket
+        auto firstEnd = static_cast<timestamp_t>(first + 1) << shift;
+
+        this->accumulate(pathLevel.acc, first, type, raw, numeric,
+                         firstEnd - begin, isTransition);
+        this->flush(pathLevel);
+
+        // fully covered buckets
+        if (last > first + 1) {
+            StateSummaryFileRecord record;
+
+            record.firstBucket = first + 1;
+            record.bucketsCount = last - first - 1;
+            record.transitions = 0;
+            record.valueType = static_cast<std::uint32_t>(type);
+            record.dominant = raw;
+            record.min = isNumeric ? numeric : std::numeric_limits<double>::quiet_NaN();
+            record.max = record.min;
+            StateSummarySink::emit(pathLevel, record);
+        }
+
+        // partial last bucket
+        auto lastBegin = static_cast<timestamp_t>(last) << shift;
+
+        this->accumulate(pathLevel.acc, last, type, raw, numeric,
+                         end - lastBegin, false);
+    }
+}
+
+void StateSummarySink::close(std::size_t pathsCount)
+{
+    // silently ignore if already closed
+    if (!_opened) {
+        return;
+    }
+
+    _opened = false;
+
+    pathsCount = std::max(pathsCount, _paths.size());
+
+    // flush remaining accumulators
+    for (auto& levels : _paths) {
+        for (auto& pathLevel : levels) {
+            this->flush(pathLevel);
+        }
+    }
+
+    // compute layout
+    auto levelsCount = _bucketsCounts.size();
+    std::vector<StateSummaryFileLevel> levels(levelsCount);
+    std::uint64_t offset = sizeof(StateSummaryFileHeader);
+
+    offset += levelsCount * sizeof(StateSummaryFileLevel);
+
+    for (std::size_t l = 0; l < levelsCount; ++l) {
+        levels[l].bucketDuration = static_cast<std::uint64_t>(1) << (_shift + 2 * l);
+        levels[l].bucketsCount = _bucketsCounts[l];
+        levels[l].reserved = 0;
+        levels[l].indexOffset = offset;
+        offset += pathsCount * sizeof(StateSummaryFileIndexEntry);
+    }
+
+    std::vector<StateSummaryFileIndexEntry> indexes(levelsCount * pathsCount);
+
+    for (std::size_t l = 0; l < levelsCount; ++l) {
+        for (std::size_t q = 0; q < pathsCount; ++q) {
+            auto& entry = indexes[l * pathsCount + q];
+
+            entry.recordsOffset = offset;
+            entry.recordsCount = 0;
+            entry.reserved = 0;
+
+            if (q < _paths.size() && !_paths[q].empty()) {
+                entry.recordsCount = static_cast<std::uint32_t>(_paths[q][l].records.size());
+            }
+
+            offset += entry.recordsCount * sizeof(StateSummaryFileRecord);
+        }
+    }
+
+    // header
+    StateSummaryFileHeader header;
+
+    header.magic = STATE_SUMMARY_FILE_MAGIC;
+    header.version = STATE_SUMMARY_FILE_VERSION;
+    header.beginTs = _beginTs;
+    header.endTs = _beginTs + _span - 1;
+    header.levelsCount = static_cast<std::uint32_t>(levelsCount);
+    header.pathsCount = static_cast<std::uint32_t>(pathsCount);
+
+    // write everything
+    bfs::ofstream output;
+
+    output.open(_path, std::ios::binary);
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(levels.data()),
+                 levels.size() * sizeof(StateSummaryFileLevel));
+    output.write(reinterpret_cast<const char*>(indexes.data()),
+                 indexes.size() * sizeof(StateSummaryFileIndexEntry));
+
+    for (std::size_t l = 0; l < levelsCount; ++l) {
+        for (const auto& pathLevels : _paths) {
+            if (pathLevels.empty()) {
+                continue;
+            }
+
+            const auto& records = pathLevels[l].records;
+
+            output.write(reinterpret_cast<const char*>(records.data()),
+                         records.size() * sizeof(StateSummaryFileRecord));
+        }
+    }
+
+    output.close();
+
+    // free memory
+    _paths.clear();
+}
+
+}
+}
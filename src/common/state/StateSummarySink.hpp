@@ -0,0 +1,155 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATESUMMARYSINK_HPP
+#define _TIBEE_COMMON_STATESUMMARYSINK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/state/StateValueType.hpp>
+#include <common/state/StateSummaryFormat.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A state summary sink.
+ *
+ * Summarizes state intervals, as they are written to a state history,
+ * in fixed time buckets at several resolutions, and writes the result
+ * to a state summary file when closed (see StateSummaryFormat.hpp).
+ *
+ * Intervals of a given path must be added in time order, which is what
+ * a state history sink does. All levels are accumulated at once so that
+ * dominant values are exact at every resolution.
+ *
+ * @author Philippe Proulx
+ */
+class StateSummarySink :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds a state summary sink.
+     *
+     * @param path       Path to state summary file (to be created)
+     * @param beginTs    Begin timestamp of the summaries
+     * @param endTs      End timestamp of the summaries
+     * @param maxBuckets Maximum number of buckets of the finest level
+     * @param maxLevels  Maximum number of levels
+     */
+    StateSummarySink(const boost::filesystem::path& path,
+                     timestamp_t beginTs, timestamp_t endTs,
+                     std::size_t maxBuckets = 4096,
+                     std::size_t maxLevels = 5);
+
+    ~StateSummarySink();
+
+    /**
+     * Adds one state interval.
+     *
+     * @param pathQuark Path quark
+     * @param begin     Interval begin timestamp
+     * @param end       Interval end timestamp (exclusive)
+     * @param type      State value type
+     * @param raw       Raw value (see StateSummaryFileRecord)
+     * @param numeric   Numeric value (for min/max)
+     */
+    void addInterval(quark_t pathQuark, timestamp_t begin, timestamp_t end,
+                     StateValueType type, std::uint64_t raw, double numeric);
+
+    /**
+     * Writes the state summary file and marks this sink as closed.
+     *
+     * Silently ignored if already closed.
+     *
+     * @param pathsCount Total number of path quarks
+     */
+    void close(std::size_t pathsCount);
+
+private:
+    // time spent by one value within the current bucket
+    struct ValueDuration
+    {
+        StateValueType type;
+        std::uint64_t raw;
+        timestamp_t duration;
+    };
+
+    // current bucket of one path at one level
+    struct Accumulator
+    {
+        bool active;
+        std::uint32_t bucket;
+        std::uint32_t transitions;
+        double min;
+        double max;
+        std::vector<ValueDuration> durations;
+    };
+
+    // everything about one path at one level
+    struct PathLevel
+    {
+        Accumulator acc;
+        std::vector<StateSummaryFileRecord> records;
+    };
+
+private:
+    void accumulate(Accumulator& acc, std::uint32_t bucket, StateValueType type,
+                    std::uint64_t raw, double numeric, timestamp_t duration,
+                    bool isTransition);
+    void flush(PathLevel& pathLevel);
+    static void emit(PathLevel& pathLevel, const StateSummaryFileRecord& record);
+    static bool isNumeric(StateValueType type);
+
+private:
+    // path to file to create
+    boost::filesystem::path _path;
+
+    // summaries begin timestamp
+    timestamp_t _beginTs;
+
+    // summaries span (ns)
+    timestamp_t _span;
+
+    // finest bucket duration is (1 << _shift)
+    unsigned int _shift;
+
+    // number of buckets of each level
+    std::vector<std::uint32_t> _bucketsCounts;
+
+    // path quark -> level -> data
+    std::vector<std::vector<PathLevel>> _paths;
+
+    // path quark -> end of last interval (relative, 0 if none)
+    std::vector<timestamp_t> _lastEnds;
+
+    // open state
+    bool _opened;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATESUMMARYSINK_HPP
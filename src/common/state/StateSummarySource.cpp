@@ -0,0 +1,237 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <boost/filesystem/path.hpp>
+
+#include <common/state/StateSummaryFormat.hpp>
+#include <common/state/StateSummarySource.hpp>
+#include <common/ex/StateSummarySource.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+StateSummarySource::StateSummarySource(const bfs::path& path) :
+    _mappedFile {path}
+{
+    _header = _mappedFile.getAt<StateSummaryFileHeader>(0);
+
+    if (!_header || _header->magic != STATE_SUMMARY_FILE_MAGIC) {
+        throw ex::StateSummarySource {"not a state summary file"};
+    }
+
+    if (_header->version != STATE_SUMMARY_FILE_VERSION) {
+        throw ex::StateSummarySource {"unsupported state summary file version"};
+    }
+
+    _levels = _mappedFile.getAt<StateSummaryFileLevel>(sizeof(StateSummaryFileHeader),
+                                                       _header->levelsCount);
+
+    if (!_levels || _header->levelsCount == 0) {
+        throw ex::StateSummarySource {"truncated state summary file"};
+    }
+
+    // make sure all indexes are in the file
+    for (std::size_t x = 0; x < _header->levelsCount; ++x) {
+        auto index = _mappedFile.getAt<StateSummaryFileIndexEntry>(_levels[x].indexOffset,
+                                                                   _header->pathsCount);
+
+        if (!index) {
+            throw ex::StateSummarySource {"truncated state summary file"};
+        }
+    }
+}
+
+std::size_t StateSummarySource::getLevelForDuration(timestamp_t duration) const
+{
+    // levels go from finest to coarsest
+    for (std::size_t x = this->getLevelsCount(); x > 0; --x) {
+        if (_levels[x - 1].bucketDuration <= duration) {
+            return x - 1;
+        }
+    }
+
+    return 0;
+}
+
+const StateSummaryFileRecord* StateSummarySource::getRecords(std::size_t level,
+                                                             quark_t pathQuark,
+                                                             std::size_t& count) const
+{
+    count = 0;
+
+    auto entry = _mappedFile.getAt<StateSummaryFileIndexEntry>(_levels[level].indexOffset) +
+                 pathQuark;
+
+    if (entry->recordsCount == 0) {
+        return nullptr;
+    }
+
+    auto records = _mappedFile.getAt<StateSummaryFileRecord>(entry->recordsOffset,
+                                                             entry->recordsCount);
+
+    if (records) {
+        count = entry->recordsCount;
+    }
+
+    return records;
+}
+
+void StateSummarySource::summarize(quark_t pathQuark, timestamp_t begin,
+                                   timestamp_t end, std::size_t bucketsCount,
+                                   std::vector<Summary>& summaries) const
+{
+    Summary nullSummary;
+
+    nullSummary.isNull = true;
+    nullSummary.type = StateValueType::INT32;
+    nullSummary.dominant = 0;
+    nullSummary.transitions = 0;
+    nullSummary.min = std::numeric_limits<double>::quiet_NaN();
+    nullSummary.max = nullSummary.min;
+    summaries.assign(bucketsCount, nullSummary);
+
+    if (bucketsCount == 0 || end <= begin || pathQuark >= this->getPathsCount()) {
+        return;
+    }
+
+    // clamped range (requested buckets keep their original boundaries)
+    auto clampedBegin = std::max(begin, this->getBegin());
+    auto clampedEnd = std::min(end, this->getEnd() + 1);
+
+    if (clampedEnd <= clampedBegin) {
+        return;
+    }
+
+    auto span = end - begin;
+    auto level = this->getLevelForDuration(std::max(span / bucketsCount,
+                                                    static_cast<timestamp_t>(1)));
+    std::size_t count;
+    auto records = this->getRecords(level, pathQuark, count);
+
+    if (!records) {
+        return;
+    }
+
+    const auto& lvl = _levels[level];
+    auto lastStoredBucket = static_cast<timestamp_t>(lvl.bucketsCount - 1);
+    auto requestedBegin = [&] (std::size_t i) {
+        // begin + span * i / bucketsCount without overflowing
+        return begin + (span / bucketsCount) * i + (span % bucketsCount) * i / bucketsCount;
+    };
+    auto storedBucket = [&] (timestamp_t ts) {
+        return std::min((ts - this->getBegin()) / lvl.bucketDuration, lastStoredBucket);
+    };
+    auto recordEnd = [] (const StateSummaryFileRecord& record) {
+        return static_cast<timestamp_t>(record.firstBucket) + record.bucketsCount;
+    };
+
+    // first record not ending before the first stored bucket
+    auto firstSb = storedBucket(clampedBegin);
+    auto recordIt = std::upper_bound(records, records + count, firstSb,
+                                     [&] (timestamp_t sb, const StateSummaryFileRecord& record) {
+        return sb < recordEnd(record);
+    });
+    std::size_t recordIndex = recordIt - records;
+
+    // candidate dominant values of the current bucket
+    struct Candidate
+    {
+        std::uint32_t type;
+        std::uint64_t raw;
+        timestamp_t weight;
+    };
+
+    std::vector<Candidate> candidates;
+
+    for (std::size_t i = 0; i < bucketsCount; ++i) {
+        auto bi = std::max(requestedBegin(i), clampedBegin);
+        auto ei = std::min((i + 1 == bucketsCount) ? end : requestedBegin(i + 1),
+                           clampedEnd);
+
+        if (ei <= bi) {
+            continue;
+        }
+
+        auto sb = storedBucket(bi);
+        auto se = storedBucket(ei - 1);
+
+        // skip records ending before this bucket
+        while (recordIndex < count && recordEnd(records[recordIndex]) <= sb) {
+            recordIndex++;
+        }
+
+        auto& summary = summaries[i];
+
+        candidates.clear();
+
+        for (auto x = recordIndex; x < count && records[x].firstBucket <= se; ++x) {
+            const auto& record = records[x];
+            auto overlap = std::min(recordEnd(record), se + 1) -
+                           std::max(static_cast<timestamp_t>(record.firstBucket), sb);
+
+            summary.isNull = false;
+
+            /* Transitions of a record are attributed to the bucket where
+             * the record starts, so that a stored bucket spanning two
+             * requested buckets is not counted twice.
+             */
+            auto recordBegin = this->getBegin() +
+                               record.firstBucket * lvl.bucketDuration;
+
+            if (recordBegin >= bi && recordBegin < ei) {
+                summary.transitions += record.transitions;
+            }
+
+            if (!std::isnan(record.min)) {
+                summary.min = std::isnan(summary.min) ? record.min : std::min(summary.min, record.min);
+                summary.max = std::isnan(summary.max) ? record.max : std::max(summary.max, record.max);
+            }
+
+            auto candIt = std::find_if(candidates.begin(), candidates.end(),
+                                       [&record] (const Candidate& cand) {
+                return cand.type == record.valueType && cand.raw == record.dominant;
+            });
+
+            if (candIt == candidates.end()) {
+                candidates.push_back({record.valueType, record.dominant, overlap});
+            } else {
+                candIt->weight += overlap;
+            }
+
+        }
+
+        if (!candidates.empty()) {
+            auto dominant = std::max_element(candidates.begin(), candidates.end(),
+                                             [] (const Candidate& a, const Candidate& b) {
+                return a.weight < b.weight;
+            });
+
+            summary.type = static_cast<StateValueType>(dominant->type);
+            summary.dominant = dominant->raw;
+        }
+    }
+}
+
+}
+}
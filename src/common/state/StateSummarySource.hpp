@@ -0,0 +1,159 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATESUMMARYSOURCE_HPP
+#define _TIBEE_COMMON_STATESUMMARYSOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/state/StateValueType.hpp>
+#include <common/state/StateSummaryFormat.hpp>
+#include <common/utils/MappedFile.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A state summary source; reads a state summary file written by a
+ * StateSummarySink.
+ *
+ * The file is memory-mapped and is never modified, so a single source
+ * may be used by many threads at once.
+ *
+ * @author Philippe Proulx
+ */
+class StateSummarySource :
+    boost::noncopyable
+{
+public:
+    /**
+     * Summary of one state path within one time range.
+     */
+    struct Summary
+    {
+        /// True if the path has no state at all within the range
+        bool isNull;
+
+        /// Dominant value type
+        StateValueType type;
+
+        /// Raw dominant value (see StateSummaryFileRecord)
+        std::uint64_t dominant;
+
+        /// Number of transitions
+        std::uint32_t transitions;
+
+        /// Minimum numeric value (NaN if not numeric)
+        double min;
+
+        /// Maximum numeric value (NaN if not numeric)
+        double max;
+    };
+
+public:
+    /**
+     * Opens a state summary file.
+     *
+     * Throws ex::StateSummarySource if the file is not a valid state
+     * summary file.
+     *
+     * @param path Path of state summary file
+     */
+    StateSummarySource(const boost::filesystem::path& path);
+
+    /**
+     * Returns the begin timestamp of the summaries.
+     *
+     * @returns Begin timestamp
+     */
+    timestamp_t getBegin() const
+    {
+        return _header->beginTs;
+    }
+
+    /**
+     * Returns the end timestamp of the summaries.
+     *
+     * @returns End timestamp
+     */
+    timestamp_t getEnd() const
+    {
+        return _header->endTs;
+    }
+
+    /**
+     * Returns the number of levels (resolutions), level 0 being the
+     * finest one.
+     *
+     * @returns Number of levels
+     */
+    std::size_t getLevelsCount() const
+    {
+        return _header->levelsCount;
+    }
+
+    /**
+     * Returns the number of path quarks known to this file.
+     *
+     * @returns Number of path quarks
+     */
+    std::size_t getPathsCount() const
+    {
+        return _header->pathsCount;
+    }
+
+    /**
+     * Summarizes path \p pathQuark in \p bucketsCount equal buckets
+     * between \p begin and \p end, using the coarsest stored level
+     * which is at least as fine as the requested buckets.
+     *
+     * The cost depends on the number of requested buckets, not on the
+     * number of state intervals.
+     *
+     * @param pathQuark    Path quark
+     * @param begin        Begin timestamp
+     * @param end          End timestamp (exclusive)
+     * @param bucketsCount Number of buckets
+     * @param summaries    Summaries output (\p bucketsCount summaries)
+     */
+    void summarize(quark_t pathQuark, timestamp_t begin, timestamp_t end,
+                   std::size_t bucketsCount,
+                   std::vector<Summary>& summaries) const;
+
+private:
+    std::size_t getLevelForDuration(timestamp_t duration) const;
+    const StateSummaryFileRecord* getRecords(std::size_t level,
+                                             quark_t pathQuark,
+                                             std::size_t& count) const;
+
+private:
+    MappedFile _mappedFile;
+    const StateSummaryFileHeader* _header;
+    const StateSummaryFileLevel* _levels;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATESUMMARYSOURCE_HPP
@@ -0,0 +1,232 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+#include <common/state/StringDbFormat.hpp>
+#include <common/state/StringDb.hpp>
+#include <common/ex/StringDb.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+StringDb::StringDb(const bfs::path& path) :
+    _mappedFile {path}
+{
+    auto header = _mappedFile.getAt<StringDbFileHeader>(0);
+
+    if (!header || header->magic != STRING_DB_FILE_MAGIC) {
+        this->convertLegacy();
+
+        return;
+    }
+
+    if (header->version != STRING_DB_FILE_VERSION) {
+        throw ex::StringDb {"unsupported string database version", path};
+    }
+
+    this->setImage(_mappedFile.getData(), _mappedFile.getSize());
+}
+
+void StringDb::setImage(const std::uint8_t* data, std::size_t size)
+{
+    const auto& path = _mappedFile.getPath();
+
+    _header = reinterpret_cast<const StringDbFileHeader*>(data);
+
+    // make sure all sections are in the image
+    auto count = _header->stringsCount;
+    auto bucketsCount = _header->bucketsCount;
+
+    if (_header->entriesOffset > size ||
+            (size - _header->entriesOffset) / sizeof(StringDbFileEntry) < count ||
+            _header->bucketsOffset > size ||
+            (size - _header->bucketsOffset) / sizeof(std::uint32_t) < bucketsCount ||
+            _header->stringsOffset > size ||
+            size - _header->stringsOffset < _header->stringsSize) {
+        throw ex::StringDb {"truncated string database", path};
+    }
+
+    if (bucketsCount == 0 || (bucketsCount & (bucketsCount - 1)) != 0) {
+        throw ex::StringDb {"corrupted string database", path};
+    }
+
+    _entries = reinterpret_cast<const StringDbFileEntry*>(data + _header->entriesOffset);
+    _buckets = reinterpret_cast<const std::uint32_t*>(data + _header->bucketsOffset);
+    _strings = reinterpret_cast<const char*>(data + _header->stringsOffset);
+}
+
+void StringDb::convertLegacy()
+{
+    /* A legacy string database is a sequence of null-terminated
+     * strings, each one followed by its quark aligned on the quark
+     * size.
+     */
+    const auto& path = _mappedFile.getPath();
+    auto buf = reinterpret_cast<const char*>(_mappedFile.getData());
+    auto size = _mappedFile.getSize();
+    std::vector<std::string> strings;
+    std::size_t at = 0;
+
+    while (at < size) {
+        auto strEnd = static_cast<const char*>(std::memchr(buf + at, '\0',
+                                                           size - at));
+
+        if (!strEnd) {
+            throw ex::StringDb {"corrupted string database", path};
+        }
+
+        std::string string {buf + at};
+
+        // skip string, then align for quark
+        at = strEnd - buf + 1;
+        at = (at + sizeof(quark_t) - 1) & ~(sizeof(quark_t) - 1);
+
+        if (size < at || size - at < sizeof(quark_t)) {
+            throw ex::StringDb {"corrupted string database", path};
+        }
+
+        quark_t quark;
+
+        std::memcpy(&quark, buf + at, sizeof(quark));
+        at += sizeof(quark);
+
+        // quarks are dense, starting at 0
+        if (quark >= strings.size()) {
+            strings.resize(quark + 1);
+        }
+
+        strings[quark] = std::move(string);
+    }
+
+    std::vector<const std::string*> stringPtrs;
+
+    stringPtrs.reserve(strings.size());
+
+    for (const auto& string : strings) {
+        stringPtrs.push_back(&string);
+    }
+
+    StringDb::buildImage(stringPtrs, _image);
+    this->setImage(_image.data(), _image.size());
+}
+
+std::uint32_t StringDb::hash(const char* data, std::size_t size)
+{
+    std::uint32_t hash = 2166136261u;
+
+    for (std::size_t x = 0; x < size; ++x) {
+        hash ^= static_cast<std::uint8_t>(data[x]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+bool StringDb::getQuark(const std::string& string, quark_t& quark) const
+{
+    auto hash = StringDb::hash(string.data(), string.size());
+    auto mask = _header->bucketsCount - 1;
+
+    // there's always at least one empty bucket
+    for (auto bucket = hash & mask; ; bucket = (bucket + 1) & mask) {
+        auto value = _buckets[bucket];
+
+        if (value == 0) {
+            return false;
+        }
+
+        const auto& entry = _entries[value - 1];
+
+        if (entry.hash == hash && entry.length == string.size() &&
+                std::memcmp(_strings + entry.offset, string.data(), entry.length) == 0) {
+            quark = value - 1;
+
+            return true;
+        }
+    }
+}
+
+void StringDb::buildImage(const std::vector<const std::string*>& strings,
+                          std::vector<std::uint8_t>& image)
+{
+    // at least twice as many buckets as strings keeps probes short
+    std::uint32_t bucketsCount = 1;
+
+    while (bucketsCount < strings.size() * 2 + 1) {
+        bucketsCount *= 2;
+    }
+
+    std::uint64_t stringsSize = 0;
+
+    for (auto string : strings) {
+        stringsSize += string->size() + 1;
+    }
+
+    StringDbFileHeader header;
+
+    header.magic = STRING_DB_FILE_MAGIC;
+    header.version = STRING_DB_FILE_VERSION;
+    header.stringsCount = static_cast<std::uint32_t>(strings.size());
+    header.bucketsCount = bucketsCount;
+    header.entriesOffset = sizeof(StringDbFileHeader);
+    header.bucketsOffset = header.entriesOffset +
+                           strings.size() * sizeof(StringDbFileEntry);
+    header.stringsOffset = header.bucketsOffset +
+                           bucketsCount * sizeof(std::uint32_t);
+    header.stringsSize = stringsSize;
+
+    image.assign(header.stringsOffset + stringsSize, 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    auto entries = reinterpret_cast<StringDbFileEntry*>(image.data() + header.entriesOffset);
+    auto buckets = reinterpret_cast<std::uint32_t*>(image.data() + header.bucketsOffset);
+    auto stringsData = reinterpret_cast<char*>(image.data() + header.stringsOffset);
+    std::uint64_t offset = 0;
+
+    for (std::size_t quark = 0; quark < strings.size(); ++quark) {
+        const auto& string = *strings[quark];
+        auto& entry = entries[quark];
+
+        entry.offset = offset;
+        entry.length = static_cast<std::uint32_t>(string.size());
+        entry.hash = StringDb::hash(string.data(), string.size());
+        std::memcpy(stringsData + offset, string.c_str(), string.size() + 1);
+        offset += string.size() + 1;
+
+        // first empty bucket from the hash
+        auto mask = bucketsCount - 1;
+        auto bucket = entry.hash & mask;
+
+        while (buckets[bucket] != 0) {
+            bucket = (bucket + 1) & mask;
+        }
+
+        buckets[bucket] = static_cast<std::uint32_t>(quark + 1);
+    }
+}
+
+}
+}
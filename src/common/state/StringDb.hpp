@@ -0,0 +1,143 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STRINGDB_HPP
+#define _TIBEE_COMMON_STRINGDB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/state/StringDbFormat.hpp>
+#include <common/utils/MappedFile.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A read-only string database, as written by StateHistorySink (see
+ * StringDbFormat.hpp).
+ *
+ * The file is memory-mapped and used as is, so that opening a
+ * database is instantaneous, and is never modified: a single database
+ * may be used by many threads at once.
+ *
+ * Files written in the legacy format (null-terminated strings, each
+ * one followed by its aligned quark) are also accepted; they're
+ * converted in memory when opened.
+ *
+ * @author Philippe Proulx
+ */
+class StringDb :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to string database
+    typedef std::unique_ptr<StringDb> UP;
+
+public:
+    /**
+     * Opens a string database.
+     *
+     * Throws ex::StringDb if the file is not a valid string database.
+     *
+     * @param path Path to string database file
+     */
+    StringDb(const boost::filesystem::path& path);
+
+    /**
+     * Returns the number of strings. Quarks go from 0 to this number
+     * minus one.
+     *
+     * @returns Number of strings
+     */
+    std::size_t getCount() const
+    {
+        return _header->stringsCount;
+    }
+
+    /**
+     * Returns the string of a given quark.
+     *
+     * @param quark Quark
+     * @returns     Null-terminated string or \a nullptr if not found
+     */
+    const char* getString(quark_t quark) const
+    {
+        if (quark >= _header->stringsCount) {
+            return nullptr;
+        }
+
+        return _strings + _entries[quark].offset;
+    }
+
+    /**
+     * Finds the quark of a given string.
+     *
+     * @param string String
+     * @param quark  Found quark (set if found)
+     * @returns      True if found
+     */
+    bool getQuark(const std::string& string, quark_t& quark) const;
+
+    /**
+     * Builds the file image of a string database.
+     *
+     * @param strings Strings, indexed by quark
+     * @param image   File image output
+     */
+    static void buildImage(const std::vector<const std::string*>& strings,
+                           std::vector<std::uint8_t>& image);
+
+    /**
+     * Returns the hash of a string (32-bit FNV-1a).
+     *
+     * @param data String data
+     * @param size String size
+     * @returns    Hash
+     */
+    static std::uint32_t hash(const char* data, std::size_t size);
+
+private:
+    void convertLegacy();
+    void setImage(const std::uint8_t* data, std::size_t size);
+
+private:
+    // mapped file
+    MappedFile _mappedFile;
+
+    // converted image (legacy format only)
+    std::vector<std::uint8_t> _image;
+
+    // sections of the image
+    const StringDbFileHeader* _header;
+    const StringDbFileEntry* _entries;
+    const std::uint32_t* _buckets;
+    const char* _strings;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STRINGDB_HPP
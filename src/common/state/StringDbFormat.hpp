@@ -0,0 +1,87 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STRINGDBFORMAT_HPP
+#define _TIBEE_COMMON_STRINGDBFORMAT_HPP
+
+#include <cstdint>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * @file
+ * On-disk layout of a string database (paths or string state values).
+ *
+ * A string database maps dense quarks (0 to \a stringsCount minus one)
+ * to strings and strings to quarks. The file is:
+ *
+ *   * one StringDbFileHeader
+ *   * \a stringsCount StringDbFileEntry objects, indexed by quark,
+ *     starting at \a entriesOffset
+ *   * \a bucketsCount hash buckets (32-bit), starting at
+ *     \a bucketsOffset: open addressing with linear probing, each
+ *     bucket holding a quark plus one (0 means empty). \a bucketsCount
+ *     is a power of two.
+ *   * the strings themselves (null-terminated), starting at
+ *     \a stringsOffset
+ *
+ * Strings are hashed with 32-bit FNV-1a (see StringDb::hash()).
+ *
+ * Everything is written in native byte order and naturally aligned so
+ * that a reader may use the mapped file as is: opening a database is
+ * O(1), whatever its size.
+ */
+
+/// String database file magic number ("TBSD")
+static const std::uint32_t STRING_DB_FILE_MAGIC = 0x54425344;
+
+/// String database file format version
+static const std::uint32_t STRING_DB_FILE_VERSION = 1;
+
+/// String database file header
+struct StringDbFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t stringsCount;
+    std::uint32_t bucketsCount;
+    std::uint64_t entriesOffset;
+    std::uint64_t bucketsOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+};
+
+/// String database file entry (one string)
+struct StringDbFileEntry
+{
+    /// offset of string within the strings section
+    std::uint64_t offset;
+
+    /// string length (without null character)
+    std::uint32_t length;
+
+    /// string hash
+    std::uint32_t hash;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STRINGDBFORMAT_HPP
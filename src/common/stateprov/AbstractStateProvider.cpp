@@ -15,14 +15,21 @@
  * You should have received a copy of the GNU General Public License
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
 #include <common/stateprov/AbstractStateProvider.hpp>
+#include <common/utils/Instr.hpp>
 
 namespace tibee
 {
 namespace common
 {
 
-AbstractStateProvider::AbstractStateProvider()
+AbstractStateProvider::AbstractStateProvider() :
+    _profiling {false}
 {
 }
 
@@ -35,8 +42,9 @@ void AbstractStateProvider::onInit(CurrentState& state,
 {
     _curTraceSet = traceSet;
 
-    // clear the infamous map, ready for a new run
+    // clear the infamous map and profiles, ready for a new run
     _infamousMap.clear();
+    _profiles.clear();
 
     // delegate to implementation
     this->onInitImpl(state, traceSet);
@@ -59,31 +67,128 @@ bool AbstractStateProvider::onEvent(CurrentState& state,
         if (callbackIt != callbackMap.end()) {
             const auto& callback = callbackIt->second;
 
-            if (callback) {
+            if (callback.function) {
                 // match!
-                return callback(state, event);
+                TIBEE_INSTR_SCOPE(STATE_PROVIDER_CALLBACK);
+
+                if (_profiling) {
+                    return this->callProfiled(callback, state, event);
+                }
+
+                return callback.function(state, event);
             }
         }
     }
 
     // no match: continue
+    TIBEE_INSTR_COUNT(UNMATCHED_EVENTS, 1);
+
     return true;
 }
 
+bool AbstractStateProvider::callProfiled(const EventCallback& callback,
+                                         CurrentState& state, Event& event)
+{
+    auto& profile = _profiles[callback.profile];
+    auto stateChanges = state.getStateChangesCount();
+    auto start = std::chrono::steady_clock::now();
+
+    auto ret = callback.function(state, event);
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    profile.calls++;
+    profile.totalTime += time;
+    profile.maxTime = std::max(profile.maxTime, time);
+    profile.stateChanges += state.getStateChangesCount() - stateChanges;
+
+    return ret;
+}
+
+void AbstractStateProvider::onWindow(CurrentState& state, timestamp_t begin,
+                                     timestamp_t end)
+{
+    this->onWindowImpl(state, begin, end);
+}
+
 void AbstractStateProvider::onFini(CurrentState& state)
 {
     this->onFiniImpl(state);
 
-    // clear infamous map here
+    if (_profiling) {
+        this->writeProfileReport(std::cout);
+    }
+
+    // clear infamous map here (keep profiles for later queries)
     _infamousMap.clear();
 }
 
+std::vector<StateProviderCallbackProfile> AbstractStateProvider::getCallbacksProfiles() const
+{
+    auto profiles = _profiles;
+
+    std::stable_sort(profiles.begin(), profiles.end(),
+                     [] (const StateProviderCallbackProfile& a,
+                         const StateProviderCallbackProfile& b) {
+        return a.totalTime > b.totalTime;
+    });
+
+    return profiles;
+}
+
+void AbstractStateProvider::writeProfileReport(std::ostream& os) const
+{
+    auto profiles = this->getCallbacksProfiles();
+    std::uint64_t totalTime = 0;
+
+    for (const auto& profile : profiles) {
+        totalTime += profile.totalTime;
+    }
+
+    auto flags = os.flags();
+
+    os << std::fixed << std::setprecision(1) <<
+          std::left << std::setw(40) << "callback" << std::right <<
+          std::setw(8) << "share" <<
+          std::setw(12) << "calls" <<
+          std::setw(12) << "total (ms)" <<
+          std::setw(12) << "mean (ns)" <<
+          std::setw(12) << "max (ns)" <<
+          std::setw(14) << "state changes" << std::endl;
+
+    for (const auto& profile : profiles) {
+        // empty names match anything
+        auto name = (profile.traceType.empty() ? "*" : profile.traceType) +
+                    "/" + (profile.eventName.empty() ? "*" : profile.eventName);
+        double share = totalTime == 0 ? 0 : 100. * profile.totalTime / totalTime;
+        double mean = profile.calls == 0 ? 0 :
+                      static_cast<double>(profile.totalTime) / profile.calls;
+
+        os << std::left << std::setw(40) << name << std::right <<
+              std::setw(7) << share << "%" <<
+              std::setw(12) << profile.calls <<
+              std::setw(12) << profile.totalTime / 1e6 <<
+              std::setw(12) << mean <<
+              std::setw(12) << profile.maxTime <<
+              std::setw(14) << profile.stateChanges << std::endl;
+    }
+
+    os.flags(flags);
+}
+
 void AbstractStateProvider::onInitImpl(CurrentState& state,
                                        const TraceSet* traceSet)
 {
     // implemented here so that it's not mandatory for concrete providers
 }
 
+void AbstractStateProvider::onWindowImpl(CurrentState& state,
+                                         timestamp_t begin, timestamp_t end)
+{
+    // implemented here so that it's not mandatory for concrete providers
+}
+
 void AbstractStateProvider::onFiniImpl(CurrentState& state)
 {
     // implemented here so that it's not mandatory for concrete providers
@@ -96,6 +201,7 @@ bool AbstractStateProvider::registerEventCallback(const std::string& traceType,
     const auto& tracesInfos = _curTraceSet->getTracesInfos();
 
     bool matchLatch = false;
+    auto profile = _profiles.size();
 
     for (const auto& traceInfos : tracesInfos) {
         EventIdCallbackMap callbackMap;
@@ -108,8 +214,11 @@ bool AbstractStateProvider::registerEventCallback(const std::string& traceType,
                     auto traceId = traceInfos->getId();
                     auto eventId = eventNameIdPair.second;
 
-                    if (!_infamousMap[traceId][eventId]) {
-                        _infamousMap[traceId][eventId] = onEvent;
+                    auto& callback = _infamousMap[traceId][eventId];
+
+                    if (!callback.function) {
+                        callback.function = onEvent;
+                        callback.profile = profile;
                         matchLatch = true;
                     }
                 }
@@ -117,6 +226,10 @@ bool AbstractStateProvider::registerEventCallback(const std::string& traceType,
         }
     }
 
+    if (matchLatch) {
+        _profiles.push_back({traceType, eventName, 0, 0, 0, 0});
+    }
+
     return matchLatch;
 }
 
@@ -18,13 +18,19 @@
 #ifndef _TIBEE_COMMON_ABSTRACTSTATEPROVIDER_HPP
 #define _TIBEE_COMMON_ABSTRACTSTATEPROVIDER_HPP
 
+#include <cstddef>
 #include <functional>
+#include <map>
 #include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include <common/BasicTypes.hpp>
 #include <common/state/CurrentState.hpp>
 #include <common/trace/Event.hpp>
 #include <common/trace/TraceSet.hpp>
+#include <common/stateprov/StateProviderProfile.hpp>
 
 namespace tibee
 {
@@ -71,6 +77,21 @@ public:
      */
     bool onEvent(CurrentState& state, Event& event);
 
+    /**
+     * Called before the first event of each sampling window, when
+     * only parts of the trace set are processed.
+     *
+     * Events between two windows are never seen: all states are
+     * closed at the end of the previous window, so that the current
+     * state is empty here. A provider should also reset any private
+     * state depending on the unread events here.
+     *
+     * @param state Current state
+     * @param begin Window begin timestamp (inclusive)
+     * @param end   Window end timestamp (exclusive)
+     */
+    void onWindow(CurrentState& state, timestamp_t begin, timestamp_t end);
+
     /**
      * Called after having processed all events.
      *
@@ -78,6 +99,45 @@ public:
      */
     void onFini(CurrentState& state);
 
+    /**
+     * Enables or disables the profiling of registered event callbacks.
+     *
+     * When enabled, each callback invocation is timed and the state
+     * changes it causes are counted, and onFini() writes a report to
+     * the standard output. Must be called before onInit().
+     *
+     * @param profiling True to profile event callbacks
+     */
+    void setProfiling(bool profiling)
+    {
+        _profiling = profiling;
+    }
+
+    /**
+     * Returns whether or not registered event callbacks are profiled.
+     *
+     * @returns True if event callbacks are profiled
+     */
+    bool isProfiling() const
+    {
+        return _profiling;
+    }
+
+    /**
+     * Returns the profiles of the event callbacks registered during
+     * the last run, sorted by descending total time.
+     *
+     * @returns Callbacks profiles
+     */
+    std::vector<StateProviderCallbackProfile> getCallbacksProfiles() const;
+
+    /**
+     * Writes the profiles of the registered event callbacks as a table.
+     *
+     * @param os Output stream
+     */
+    void writeProfileReport(std::ostream& os) const;
+
 protected:
     /**
      * Registers an event callback to be called when an event matches
@@ -117,6 +177,9 @@ private:
     virtual void onInitImpl(CurrentState& state,
                             const TraceSet* traceSet);
 
+    virtual void onWindowImpl(CurrentState& state, timestamp_t begin,
+                              timestamp_t end);
+
     virtual void onFiniImpl(CurrentState& state);
 
     /**
@@ -130,12 +193,28 @@ private:
     }
 
 private:
-    typedef std::map<event_id_t, OnEventFunction> EventIdCallbackMap;
+    struct EventCallback
+    {
+        OnEventFunction function;
+
+        // index of this callback's profile
+        std::size_t profile;
+    };
+
+    bool callProfiled(const EventCallback& callback, CurrentState& state,
+                      Event& event);
+
+private:
+    typedef std::map<event_id_t, EventCallback> EventIdCallbackMap;
     typedef std::map<trace_id_t, EventIdCallbackMap> TraceIdEventIdCallbackMap;
 
 private:
     TraceIdEventIdCallbackMap _infamousMap;
     const TraceSet* _curTraceSet;
+    bool _profiling;
+
+    // one profile per registration, in registration order
+    std::vector<StateProviderCallbackProfile> _profiles;
 };
 
 }
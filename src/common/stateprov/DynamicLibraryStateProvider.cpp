@@ -53,6 +53,11 @@ DynamicLibraryStateProvider::DynamicLibraryStateProvider(const bfs::path& path)
     _dlOnFini = reinterpret_cast<decltype(_dlOnFini)>(
         ::dlsym(_dlHandle, DynamicLibraryStateProvider::ON_FINI_SYMBOL_NAME())
     );
+
+    // optional
+    _dlOnWindow = reinterpret_cast<decltype(_dlOnWindow)>(
+        ::dlsym(_dlHandle, DynamicLibraryStateProvider::ON_WINDOW_SYMBOL_NAME())
+    );
 }
 
 std::string DynamicLibraryStateProvider::getErrorMsg(const std::string& base)
@@ -87,6 +92,16 @@ void DynamicLibraryStateProvider::onInitImpl(CurrentState& state,
     }
 }
 
+void DynamicLibraryStateProvider::onWindowImpl(CurrentState& state,
+                                               timestamp_t begin,
+                                               timestamp_t end)
+{
+    // delegate
+    if (_dlOnWindow) {
+        _dlOnWindow(state, begin, end);
+    }
+}
+
 void DynamicLibraryStateProvider::onFiniImpl(CurrentState& state)
 {
     // delegate
@@ -88,8 +88,14 @@ private:
         return "onFini";
     }
 
+    static constexpr const char* ON_WINDOW_SYMBOL_NAME() {
+        return "onWindow";
+    }
+
     void onInitImpl(CurrentState& state, const TraceSet* traceSet);
     void onEventImpl(CurrentState& state, Event& event);
+    void onWindowImpl(CurrentState& state, timestamp_t begin,
+                      timestamp_t end);
     void onFiniImpl(CurrentState& state);
 
 private:
@@ -99,6 +105,7 @@ private:
     // DL resolved symbols
     void (*_dlOnInit)(CurrentState&, const TraceSet*, StateProviderConfig&);
     void (*_dlOnFini)(CurrentState&);
+    void (*_dlOnWindow)(CurrentState&, timestamp_t, timestamp_t);
 };
 
 }
@@ -0,0 +1,74 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_STATEPROVIDERPROFILE_HPP
+#define _TIBEE_COMMON_STATEPROVIDERPROFILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Profile of one registered state provider event callback.
+ *
+ * @author Philippe Proulx
+ */
+struct StateProviderCallbackProfile
+{
+    /// Trace type the callback was registered for (empty: any)
+    std::string traceType;
+
+    /// Event name the callback was registered for (empty: any)
+    std::string eventName;
+
+    /// Number of invocations
+    std::uint64_t calls;
+
+    /// Total time spent in the callback (ns)
+    std::uint64_t totalTime;
+
+    /// Longest invocation (ns)
+    std::uint64_t maxTime;
+
+    /// Number of state changes caused by the callback
+    std::uint64_t stateChanges;
+};
+
+/**
+ * Profile of one state provider: its callbacks profiles, sorted by
+ * descending total time.
+ *
+ * @author Philippe Proulx
+ */
+struct StateProviderProfile
+{
+    /// State provider name
+    std::string name;
+
+    /// Callbacks profiles
+    std::vector<StateProviderCallbackProfile> callbacks;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_STATEPROVIDERPROFILE_HPP
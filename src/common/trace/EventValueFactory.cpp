@@ -20,6 +20,7 @@
 #include <babeltrace/ctf/events.h>
 
 #include <common/trace/EventValueFactory.hpp>
+#include <common/utils/Instr.hpp>
 
 namespace tibee
 {
@@ -104,6 +105,8 @@ void EventValueFactory::initTypes()
 const AbstractEventValue* EventValueFactory::buildEventValue(const ::bt_definition* def,
                                                              const ::bt_ctf_event* ev) const
 {
+    TIBEE_INSTR_SCOPE(BUILD_EVENT_VALUE);
+
     // get event value type
     auto decl = ::bt_ctf_get_decl_from_def(def);
     auto valueType = ::bt_ctf_field_type(decl);
@@ -123,5 +126,13 @@ void EventValueFactory::resetPools()
     _uintPool.reset();
 }
 
+std::size_t EventValueFactory::getPoolsCapacity() const
+{
+    return _arrayPool.getCapacity() + _dictPool.getCapacity() +
+           _enumPool.getCapacity() + _floatPool.getCapacity() +
+           _sintPool.getCapacity() + _stringPool.getCapacity() +
+           _uintPool.getCapacity();
+}
+
 }
 }
@@ -80,6 +80,14 @@ public:
      */
     void resetPools();
 
+    /**
+     * Returns the total capacity of all internal pools (high-water
+     * mark of the number of event values of a single event).
+     *
+     * @returns Total pools capacity (objects)
+     */
+    std::size_t getPoolsCapacity() const;
+
 private:
     typedef std::function<const AbstractEventValue* (const ::bt_definition*, const ::bt_ctf_event* ev)> BuildValueFunc;
 
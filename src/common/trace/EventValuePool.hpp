@@ -22,6 +22,8 @@
 #include <list>
 #include <type_traits>
 
+#include <common/utils/Instr.hpp>
+
 namespace tibee
 {
 namespace common
@@ -71,6 +73,17 @@ public:
      */
     void reset();
 
+    /**
+     * Returns the capacity of the pool, that is, the maximum number of
+     * objects obtained since it was built, plus one.
+     *
+     * @returns Pool capacity (objects)
+     */
+    std::size_t getCapacity() const
+    {
+        return _pool.size();
+    }
+
 private:
     typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type alignedT;
 
@@ -116,6 +129,7 @@ T* EventValuePool<T>::get()
 
     if (_size > _pool.size()) {
         _pool.resize(_pool.size() * 2);
+        TIBEE_INSTR_COUNT(EVENT_VALUE_POOL_GROWTHS, 1);
     }
 
     _nextIt++;
@@ -0,0 +1,85 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include <common/trace/TracePacketSummary.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+TracePacketSummary::TracePacketSummary() :
+    _totalBytes {0},
+    _eventsBytes {0},
+    _packetsCount {0},
+    _eventsDiscarded {0}
+{
+}
+
+void TracePacketSummary::addStream(Stream&& stream)
+{
+    std::uint64_t bytesBefore = 0;
+
+    for (auto& packet : stream.packets) {
+        packet.bytesBefore = bytesBefore;
+        bytesBefore += packet.bytes;
+    }
+
+    _totalBytes += stream.totalBytes;
+    _eventsBytes += stream.eventsBytes;
+    _packetsCount += stream.packets.size();
+    _eventsDiscarded += stream.eventsDiscarded;
+    _streams.push_back(std::move(stream));
+}
+
+std::uint64_t TracePacketSummary::getBytesBefore(timestamp_t ts) const
+{
+    std::uint64_t bytes = 0;
+
+    for (const auto& stream : _streams) {
+        const auto& packets = stream.packets;
+
+        // first packet ending after ts
+        auto it = std::upper_bound(packets.begin(), packets.end(), ts,
+                                   [] (timestamp_t ts, const Packet& packet) {
+            return ts < packet.end;
+        });
+
+        if (it == packets.end()) {
+            // whole stream is before ts
+            bytes += stream.eventsBytes;
+            continue;
+        }
+
+        bytes += it->bytesBefore;
+
+        // interpolate within the packet containing ts
+        if (ts > it->begin && it->end > it->begin) {
+            auto fraction = static_cast<double>(ts - it->begin) /
+                            (it->end - it->begin);
+
+            bytes += static_cast<std::uint64_t>(fraction * it->bytes);
+        }
+    }
+
+    return bytes;
+}
+
+}
+}
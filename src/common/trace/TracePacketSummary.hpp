@@ -0,0 +1,180 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_TRACEPACKETSUMMARY_HPP
+#define _TIBEE_COMMON_TRACEPACKETSUMMARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Trace set packet summary.
+ *
+ * A packet summary is built by TraceSet::getPacketSummary() from the
+ * packet indexes only (packet contexts), without reading any event.
+ * It gives the size and time range of each stream, and makes it
+ * possible to estimate how many bytes of event data precede a given
+ * timestamp, which is a much better progress measure than time when
+ * the event rate varies.
+ *
+ * @author Philippe Proulx
+ */
+class TracePacketSummary
+{
+public:
+    /// Unique pointer to trace packet summary
+    typedef std::unique_ptr<TracePacketSummary> UP;
+
+    /// Packet of a stream
+    struct Packet
+    {
+        timestamp_t begin;
+        timestamp_t end;
+
+        // event data bytes of all previous packets of the same stream
+        std::uint64_t bytesBefore;
+
+        // event data bytes of this packet
+        std::uint64_t bytes;
+    };
+
+    /// Stream summary
+    struct Stream
+    {
+        trace_id_t traceId;
+        std::uint64_t streamId;
+        timestamp_t begin;
+        timestamp_t end;
+        std::uint64_t totalBytes;
+        std::uint64_t eventsBytes;
+        std::uint64_t eventsDiscarded;
+        std::vector<Packet> packets;
+    };
+
+public:
+    /**
+     * Builds an empty packet summary.
+     */
+    TracePacketSummary();
+
+    /**
+     * Adds a stream summary. Its packets must be sorted by begin
+     * timestamp; their \a bytesBefore members are computed here.
+     *
+     * @param stream Stream summary to add
+     */
+    void addStream(Stream&& stream);
+
+    /**
+     * Returns the stream summaries.
+     *
+     * @returns Stream summaries
+     */
+    const std::vector<Stream>& getStreams() const
+    {
+        return _streams;
+    }
+
+    /**
+     * Returns the total size of all packets (bytes).
+     *
+     * @returns Total size of packets
+     */
+    std::uint64_t getTotalBytes() const
+    {
+        return _totalBytes;
+    }
+
+    /**
+     * Returns the total size of event data, that is, packets content
+     * without their header and context (bytes).
+     *
+     * @returns Total size of event data
+     */
+    std::uint64_t getEventsBytes() const
+    {
+        return _eventsBytes;
+    }
+
+    /**
+     * Returns the number of packets.
+     *
+     * @returns Number of packets
+     */
+    std::size_t getPacketsCount() const
+    {
+        return _packetsCount;
+    }
+
+    /**
+     * Returns the number of events discarded by the tracer.
+     *
+     * @returns Number of discarded events
+     */
+    std::uint64_t getEventsDiscarded() const
+    {
+        return _eventsDiscarded;
+    }
+
+    /**
+     * Returns an estimation of the number of events, given an average
+     * event size.
+     *
+     * @param bytesPerEvent Average event size (bytes)
+     * @returns             Estimated number of events
+     */
+    std::uint64_t getEstimatedEventsCount(double bytesPerEvent) const
+    {
+        if (bytesPerEvent <= 0) {
+            return 0;
+        }
+
+        return static_cast<std::uint64_t>(_eventsBytes / bytesPerEvent);
+    }
+
+    /**
+     * Returns an estimation of the number of event data bytes having
+     * a timestamp lesser than \p ts, over all streams.
+     *
+     * Events are considered evenly spread in time within a packet.
+     *
+     * @param ts Timestamp
+     * @returns  Estimated number of event data bytes before \p ts
+     */
+    std::uint64_t getBytesBefore(timestamp_t ts) const;
+
+private:
+    std::vector<Stream> _streams;
+    std::uint64_t _totalBytes;
+    std::uint64_t _eventsBytes;
+    std::size_t _packetsCount;
+    std::uint64_t _eventsDiscarded;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_TRACEPACKETSUMMARY_HPP
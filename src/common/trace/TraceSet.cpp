@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <babeltrace/ctf/iterator.h>
 
 #include <common/trace/TraceSetIterator.hpp>
@@ -160,6 +161,9 @@ bool TraceSet::addTraceToSet(const bfs::path& path, int traceHandle)
     // add to our set of trace infos
     _tracesInfos.insert(std::move(traceInfos));
 
+    // keep CTF trace for packet summaries
+    _ctfTraces[static_cast<trace_id_t>(traceHandle)] = tibeeEventDecl->parent.stream->trace;
+
     return true;
 }
 
@@ -270,5 +274,98 @@ TraceSet::Iterator TraceSet::end() const
     return TraceSet::Iterator {nullptr};
 }
 
+TraceSet::Iterator TraceSet::seek(timestamp_t ts) const
+{
+    // seek time (will also affect all existing iterators)
+    ::bt_iter_pos timePos;
+    timePos.type = ::BT_SEEK_TIME;
+    timePos.u.seek_time = ts;
+
+    ::bt_iter_set_pos(_btIter, &timePos);
+
+    // create new iterator
+    return TraceSet::Iterator {_btCtfIter};
+}
+
+TracePacketSummary::UP TraceSet::getPacketSummary() const
+{
+    TracePacketSummary::UP summary {new TracePacketSummary};
+
+    for (const auto& traceIdCtfTracePair : _ctfTraces) {
+        auto ctfTrace = traceIdCtfTracePair.second;
+
+        // each stream class...
+        for (guint s = 0; s < ctfTrace->streams->len; ++s) {
+            auto streamDecl = static_cast<const ::tibee_ctf_stream_declaration*>(
+                g_ptr_array_index(ctfTrace->streams, s)
+            );
+
+            if (!streamDecl) {
+                continue;
+            }
+
+            // ...has file streams (usually one per CPU)
+            for (guint f = 0; f < streamDecl->streams->len; ++f) {
+                auto fileStream = static_cast<const ::tibee_ctf_file_stream*>(
+                    g_ptr_array_index(streamDecl->streams, f)
+                );
+
+                if (!fileStream || !fileStream->pos.packet_index) {
+                    continue;
+                }
+
+                TracePacketSummary::Stream stream;
+
+                stream.traceId = traceIdCtfTracePair.first;
+                stream.streamId = streamDecl->stream_id;
+                stream.begin = -1;
+                stream.end = 0;
+                stream.totalBytes = 0;
+                stream.eventsBytes = 0;
+                stream.eventsDiscarded = 0;
+
+                auto packetIndex = fileStream->pos.packet_index;
+
+                for (guint p = 0; p < packetIndex->len; ++p) {
+                    const auto& index = g_array_index(packetIndex,
+                                                      ::tibee_packet_index, p);
+                    TracePacketSummary::Packet packet;
+
+                    packet.begin = index.ts_real.timestamp_begin;
+                    packet.end = index.ts_real.timestamp_end;
+                    packet.bytes = 0;
+
+                    // sizes are in bits
+                    if (index.content_size > static_cast<std::uint64_t>(index.data_offset)) {
+                        packet.bytes = (index.content_size - index.data_offset) / 8;
+                    }
+
+                    stream.begin = std::min(stream.begin, packet.begin);
+                    stream.end = std::max(stream.end, packet.end);
+                    stream.totalBytes += index.packet_size / 8;
+                    stream.eventsBytes += packet.bytes;
+
+                    // this is a counter, not a per-packet count
+                    stream.eventsDiscarded = std::max(stream.eventsDiscarded,
+                                                      index.events_discarded);
+                    stream.packets.push_back(packet);
+                }
+
+                summary->addStream(std::move(stream));
+            }
+        }
+    }
+
+    return summary;
+}
+
+TraceSetCursor TraceSet::cursor() const
+{
+    // go back to beginning (will also affect all existing iterators)
+    this->seekBegin();
+
+    return TraceSetCursor {_btCtfIter};
+}
+
 }
 }
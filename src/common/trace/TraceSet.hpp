@@ -21,6 +21,7 @@
 #include <memory>
 #include <cstdint>
 #include <set>
+#include <map>
 #include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/utility.hpp>
@@ -28,7 +29,11 @@
 
 #include <common/BasicTypes.hpp>
 #include <common/trace/TraceSetIterator.hpp>
+#include <common/trace/TraceSetCursor.hpp>
 #include <common/trace/TraceInfos.hpp>
+#include <common/trace/TracePacketSummary.hpp>
+
+struct tibee_ctf_trace;
 
 namespace tibee
 {
@@ -103,6 +108,27 @@ public:
      */
     Iterator end() const;
 
+    /**
+     * Returns an iterator pointing to the first event of the set
+     * having a timestamp greater than or equal to \p ts.
+     *
+     * Like begin(), this moves all existing iterators of this set.
+     *
+     * @param ts Timestamp to seek
+     * @returns  Iterator pointing to the first event at or after \p ts
+     */
+    Iterator seek(timestamp_t ts) const;
+
+    /**
+     * Returns a lightweight cursor pointing to the first event of the
+     * set.
+     *
+     * Like begin(), this moves all existing iterators of this set.
+     *
+     * @returns Cursor pointing to the first event of the set
+     */
+    TraceSetCursor cursor() const;
+
     /**
      * Returns the set of trace informations.
      *
@@ -113,12 +139,23 @@ public:
         return _tracesInfos;
     }
 
+    /**
+     * Returns a summary of all the packets of the set.
+     *
+     * This only reads the packet indexes built when adding traces, so
+     * it's fast and doesn't move any iterator.
+     *
+     * @returns Packet summary
+     */
+    TracePacketSummary::UP getPacketSummary() const;
+
 private:
     void seekBegin() const;
     bool addTraceToSet(const boost::filesystem::path& path, int traceHandle);
 
 private:
     std::set<std::unique_ptr<TraceInfos>> _tracesInfos;
+    std::map<trace_id_t, const ::tibee_ctf_trace*> _ctfTraces;
     ::bt_context* _btCtx;
     ::bt_iter* _btIter;
     ::bt_ctf_iter* _btCtfIter;
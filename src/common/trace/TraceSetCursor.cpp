@@ -0,0 +1,80 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <babeltrace/ctf/iterator.h>
+
+#include <common/trace/babeltrace-internals.h>
+#include <common/trace/TraceSetCursor.hpp>
+#include <common/trace/TraceUtils.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+TraceSetCursor::TraceSetCursor(::bt_ctf_iter* btCtfIter) :
+    _btCtfIter {btCtfIter},
+    _btIter {nullptr},
+    _btEvent {nullptr}
+{
+    if (!_btCtfIter) {
+        return;
+    }
+
+    _btIter = ::bt_ctf_get_iter(_btCtfIter);
+
+    // read current event
+    _btEvent = ::bt_ctf_iter_read_event(_btCtfIter);
+}
+
+bool TraceSetCursor::next()
+{
+    if (!_btEvent) {
+        return false;
+    }
+
+    if (::bt_iter_next(_btIter) < 0) {
+        _btEvent = nullptr;
+        return false;
+    }
+
+    // read current event (null at end)
+    _btEvent = ::bt_ctf_iter_read_event(_btCtfIter);
+
+    return _btEvent != nullptr;
+}
+
+event_id_t TraceSetCursor::getId() const
+{
+    // see Event::setPrivateEvent()
+    auto tibeeBtCtfEvent = reinterpret_cast<::tibee_bt_ctf_event*>(_btEvent);
+    auto tibeeStream = tibeeBtCtfEvent->parent->stream;
+
+    return TraceUtils::tibeeEventIdFromCtf(tibeeStream->stream_id,
+                                           tibeeStream->event_id);
+}
+
+trace_id_t TraceSetCursor::getTraceId() const
+{
+    auto tibeeBtCtfEvent = reinterpret_cast<::tibee_bt_ctf_event*>(_btEvent);
+    auto tibeeStream = tibeeBtCtfEvent->parent->stream;
+
+    return tibeeStream->stream_class->trace->parent.handle->id;
+}
+
+}
+}
@@ -0,0 +1,103 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_TRACESETCURSOR_HPP
+#define _TIBEE_COMMON_TRACESETCURSOR_HPP
+
+#include <babeltrace/ctf/events.h>
+#include <babeltrace/ctf/iterator.h>
+
+#include <common/BasicTypes.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * A lightweight trace set cursor.
+ *
+ * Unlike a TraceSetIterator, a cursor does not wrap events into Event
+ * objects and never builds event values: it only gives access to the
+ * timestamp, the event ID and the trace ID of the current event. Use
+ * it when nothing else is needed (histograms, event counting, etc.).
+ *
+ * Do not build this class directly; use TraceSet::cursor().
+ *
+ * As with trace set iterators, a cursor doesn't own its BT iterator,
+ * so moving a cursor also moves all existing iterators of the same
+ * trace set.
+ *
+ * @author Philippe Proulx
+ */
+class TraceSetCursor
+{
+public:
+    TraceSetCursor(::bt_ctf_iter* btCtfIter);
+
+    /**
+     * Returns whether or not this cursor is past the last event.
+     *
+     * @returns True if there's no current event
+     */
+    bool isAtEnd() const
+    {
+        return !_btEvent;
+    }
+
+    /**
+     * Moves to the next event.
+     *
+     * @returns False if there's no next event
+     */
+    bool next();
+
+    /**
+     * Returns the timestamp of the current event.
+     *
+     * @returns Current event timestamp
+     */
+    timestamp_t getTimestamp() const
+    {
+        return static_cast<timestamp_t>(::bt_ctf_get_timestamp(_btEvent));
+    }
+
+    /**
+     * Returns the ID of the current event (same as Event::getId()).
+     *
+     * @returns Current event numeric ID
+     */
+    event_id_t getId() const;
+
+    /**
+     * Returns the trace ID of the current event (same as
+     * Event::getTraceId()).
+     *
+     * @returns Numeric ID of trace the current event is in
+     */
+    trace_id_t getTraceId() const;
+
+private:
+    ::bt_ctf_iter* _btCtfIter;
+    ::bt_iter* _btIter;
+    ::bt_ctf_event* _btEvent;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_TRACESETCURSOR_HPP
@@ -19,6 +19,7 @@
 
 #include <common/trace/TraceSetIterator.hpp>
 #include <common/trace/Event.hpp>
+#include <common/utils/Instr.hpp>
 
 namespace tibee
 {
@@ -79,6 +80,8 @@ TraceSetIterator& TraceSetIterator::operator=(const TraceSetIterator& rhs)
 
 TraceSetIterator& TraceSetIterator::operator++()
 {
+    TIBEE_INSTR_SCOPE(TRACE_ITER_NEXT);
+
     if (!_btIter) {
         // disabled
         return *this;
@@ -70,6 +70,17 @@ public:
      */
     Event& operator*();
 
+    /**
+     * Returns the total capacity of the event value pools of this
+     * iterator (see EventValueFactory::getPoolsCapacity()).
+     *
+     * @returns Total pools capacity (objects)
+     */
+    std::size_t getValuePoolsCapacity() const
+    {
+        return _valueFactory.getPoolsCapacity();
+    }
+
 private:
     ::bt_ctf_iter* _btCtfIter;
     ::bt_iter* _btIter;
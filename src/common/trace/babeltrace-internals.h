@@ -328,4 +328,28 @@ struct tibee_bt_ctf_event_decl {
 	GPtrArray *packet_context_decl;
 };
 
+struct tibee_packet_index_time {
+	uint64_t timestamp_begin;
+	uint64_t timestamp_end;
+};
+
+struct tibee_packet_index {
+	off_t offset;		/* offset of the packet in the file, in bytes */
+	int64_t data_offset;	/* offset of data within the packet, in bits */
+	uint64_t packet_size;	/* packet size, in bits */
+	uint64_t content_size;	/* content size, in bits */
+	uint64_t events_discarded;
+	uint64_t events_discarded_len;	/* length of the field, in bits */
+	struct tibee_packet_index_time ts_cycles;	/* timestamp in cycles */
+	struct tibee_packet_index_time ts_real;	/* realtime timestamp */
+	/* Packet header fields, used for live trace reading. */
+	uint64_t stream_instance_id;	/* ID of the channel instance */
+	uint64_t stream_id;	/* ID of the channel */
+};
+
+struct tibee_ctf_file_stream {
+	struct tibee_ctf_stream_definition parent;
+	struct tibee_ctf_stream_pos pos;	/* current stream position */
+};
+
 #endif /* _BABELTRACE_INTERNALS_H */
@@ -0,0 +1,296 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <common/utils/Instr.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+namespace
+{
+
+const char* TIMERS_NAMES[] = {
+    "trace-iter-next",
+    "build-event-value",
+    "state-provider-callback",
+    "write-interval",
+};
+
+const char* COUNTERS_NAMES[] = {
+    "unmatched-events",
+    "event-value-pool-growths",
+    "empty-intervals",
+};
+
+double getBucketsPercentile(const std::array<std::uint64_t, Instr::BUCKETS_COUNT>& buckets,
+                            std::uint64_t count, double percentile)
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<std::uint64_t>(count * percentile / 100);
+    std::uint64_t seen = 0;
+
+    for (std::size_t x = 0; x < buckets.size(); ++x) {
+        seen += buckets[x];
+
+        if (seen > rank) {
+            // upper bound of this bucket
+            return static_cast<double>(static_cast<std::uint64_t>(1) << x);
+        }
+    }
+
+    return static_cast<double>(~static_cast<std::uint64_t>(0));
+}
+
+}
+
+thread_local Instr::ThreadData* Instr::_threadData = nullptr;
+
+/*
+ * Owns the storage of one thread; merges it into the registry's
+ * storage of exited threads when the thread exits.
+ */
+class Instr::ThreadDataOwner
+{
+public:
+    ThreadDataOwner();
+    ~ThreadDataOwner();
+
+    ThreadData* get()
+    {
+        return _data.get();
+    }
+
+private:
+    std::unique_ptr<ThreadData> _data;
+};
+
+/*
+ * Storages of all live threads and merged storage of exited ones.
+ */
+struct Instr::Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadData*> threads;
+    ThreadData exited;
+};
+
+Instr::ThreadDataOwner::ThreadDataOwner() :
+    _data {new ThreadData}
+{
+}
+
+void Instr::clear(ThreadData& data)
+{
+    for (auto& timer : data.timers) {
+        timer.count.store(0, std::memory_order_relaxed);
+        timer.ticks.store(0, std::memory_order_relaxed);
+
+        for (auto& bucket : timer.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    for (auto& counter : data.counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Instr::merge(ThreadData& to, const ThreadData& from)
+{
+    for (std::size_t t = 0; t < TIMERS_COUNT; ++t) {
+        auto& toTimer = to.timers[t];
+        const auto& fromTimer = from.timers[t];
+
+        Instr::add(toTimer.count, fromTimer.count.load(std::memory_order_relaxed));
+        Instr::add(toTimer.ticks, fromTimer.ticks.load(std::memory_order_relaxed));
+
+        for (std::size_t b = 0; b < BUCKETS_COUNT; ++b) {
+            Instr::add(toTimer.buckets[b],
+                       fromTimer.buckets[b].load(std::memory_order_relaxed));
+        }
+    }
+
+    for (std::size_t c = 0; c < COUNTERS_COUNT; ++c) {
+        Instr::add(to.counters[c], from.counters[c].load(std::memory_order_relaxed));
+    }
+}
+
+Instr::Registry& Instr::getRegistry()
+{
+    // never destroyed, since threads may exit after static destruction
+    static auto registry = [] {
+        auto registry = new Registry;
+
+        Instr::clear(registry->exited);
+
+        return registry;
+    }();
+
+    return *registry;
+}
+
+Instr::ThreadDataOwner::~ThreadDataOwner()
+{
+    auto& registry = Instr::getRegistry();
+    std::lock_guard<std::mutex> lock {registry.mutex};
+
+    Instr::merge(registry.exited, *_data);
+
+    for (auto it = registry.threads.begin(); it != registry.threads.end(); ++it) {
+        if (*it == _data.get()) {
+            registry.threads.erase(it);
+            break;
+        }
+    }
+
+    _threadData = nullptr;
+}
+
+void Instr::registerThread()
+{
+    // built on the first record of this thread, destroyed on its exit
+    thread_local ThreadDataOwner owner;
+
+    auto& registry = Instr::getRegistry();
+    std::lock_guard<std::mutex> lock {registry.mutex};
+
+    Instr::clear(*owner.get());
+    registry.threads.push_back(owner.get());
+    _threadData = owner.get();
+}
+
+double Instr::getTicksPerNs()
+{
+#ifdef TIBEE_INSTR_TSC
+    // calibrate the time stamp counter against the steady clock, once
+    static const double ticksPerNs = [] {
+        auto startTime = std::chrono::steady_clock::now();
+        auto startTicks = Instr::getTicks();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        auto ticks = Instr::getTicks() - startTicks;
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+        return static_cast<double>(ticks) / ns;
+    }();
+
+    return ticksPerNs;
+#else
+    return 1;
+#endif
+}
+
+Instr::Report Instr::getReport()
+{
+    ThreadData merged;
+
+    Instr::clear(merged);
+
+    {
+        auto& registry = Instr::getRegistry();
+        std::lock_guard<std::mutex> lock {registry.mutex};
+
+        Instr::merge(merged, registry.exited);
+
+        for (auto threadData : registry.threads) {
+            Instr::merge(merged, *threadData);
+        }
+    }
+
+    Report report;
+
+    report.ticksPerNs = Instr::getTicksPerNs();
+
+    for (std::size_t t = 0; t < TIMERS_COUNT; ++t) {
+        const auto& timer = merged.timers[t];
+        auto& timerReport = report.timers[t];
+        std::array<std::uint64_t, BUCKETS_COUNT> buckets;
+
+        for (std::size_t b = 0; b < BUCKETS_COUNT; ++b) {
+            buckets[b] = timer.buckets[b].load(std::memory_order_relaxed);
+        }
+
+        timerReport.name = TIMERS_NAMES[t];
+        timerReport.count = timer.count.load(std::memory_order_relaxed);
+        timerReport.totalNs = timer.ticks.load(std::memory_order_relaxed) /
+                              report.ticksPerNs;
+        timerReport.p50Ns = getBucketsPercentile(buckets, timerReport.count, 50) /
+                            report.ticksPerNs;
+        timerReport.p99Ns = getBucketsPercentile(buckets, timerReport.count, 99) /
+                            report.ticksPerNs;
+    }
+
+    for (std::size_t c = 0; c < COUNTERS_COUNT; ++c) {
+        report.counters[c].name = COUNTERS_NAMES[c];
+        report.counters[c].value = merged.counters[c].load(std::memory_order_relaxed);
+    }
+
+    return report;
+}
+
+void Instr::dump(std::ostream& os)
+{
+    auto report = Instr::getReport();
+    auto flags = os.flags();
+
+    os << std::fixed << std::setprecision(1) <<
+          "instrumentation (" << report.ticksPerNs << " ticks/ns)" << std::endl <<
+          std::left << std::setw(26) << "timer" << std::right <<
+          std::setw(14) << "count" <<
+          std::setw(14) << "total (ms)" <<
+          std::setw(12) << "mean (ns)" <<
+          std::setw(12) << "p50 (ns)" <<
+          std::setw(12) << "p99 (ns)" << std::endl;
+
+    for (const auto& timer : report.timers) {
+        auto mean = timer.count == 0 ? 0 : timer.totalNs / timer.count;
+
+        os << std::left << std::setw(26) << timer.name << std::right <<
+              std::setw(14) << timer.count <<
+              std::setw(14) << timer.totalNs / 1000000 <<
+              std::setw(12) << mean <<
+              std::setw(12) << timer.p50Ns <<
+              std::setw(12) << timer.p99Ns << std::endl;
+    }
+
+    os << std::left << std::setw(26) << "counter" << std::right <<
+          std::setw(14) << "value" << std::endl;
+
+    for (const auto& counter : report.counters) {
+        os << std::left << std::setw(26) << counter.name << std::right <<
+              std::setw(14) << counter.value << std::endl;
+    }
+
+    os.flags(flags);
+}
+
+}
+}
@@ -0,0 +1,319 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_INSTR_HPP
+#define _TIBEE_COMMON_INSTR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <boost/utility.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+# define TIBEE_INSTR_TSC
+#else
+# include <chrono>
+#endif
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Instrumented hot path timers.
+ */
+enum class InstrTimer
+{
+    /// Reading the next event of a trace set
+    TRACE_ITER_NEXT,
+
+    /// Building an event value
+    BUILD_EVENT_VALUE,
+
+    /// State provider event callback
+    STATE_PROVIDER_CALLBACK,
+
+    /// Writing a state interval
+    WRITE_INTERVAL,
+};
+
+/**
+ * Instrumented hot path counters.
+ */
+enum class InstrCounter
+{
+    /// Events without a matching state provider callback
+    UNMATCHED_EVENTS,
+
+    /// Event value pool capacity doublings
+    EVENT_VALUE_POOL_GROWTHS,
+
+    /// Zero-length state intervals not written
+    EMPTY_INTERVALS,
+};
+
+/**
+ * Hot path instrumentation.
+ *
+ * Timers measure scopes with the CPU time stamp counter (or a steady
+ * clock on other architectures) and record, for each timer, the number
+ * of measures, their total, and a histogram of their durations with
+ * one bucket per power of two. Counters are plain sums.
+ *
+ * Each thread records into its own storage, without any atomic
+ * read-modify-write operation; reading a report merges all threads,
+ * including exited ones.
+ *
+ * Instrumentation points use the TIBEE_INSTR_SCOPE() and
+ * TIBEE_INSTR_COUNT() macros, which expand to nothing unless
+ * TIBEE_INSTR is defined (set the TIBEE_INSTR environment variable
+ * to 1 when building).
+ *
+ * @author Philippe Proulx
+ */
+class Instr :
+    boost::noncopyable
+{
+public:
+    /// Number of timers
+    static const std::size_t TIMERS_COUNT = 4;
+
+    /// Number of counters
+    static const std::size_t COUNTERS_COUNT = 3;
+
+    /// Number of histogram buckets (bucket i: [2^(i-1), 2^i) ticks, last one unbounded)
+    static const std::size_t BUCKETS_COUNT = 64;
+
+    /// Merged timer
+    struct TimerReport
+    {
+        /// Timer name
+        const char* name;
+
+        /// Number of measures
+        std::uint64_t count;
+
+        /// Total duration (ns)
+        double totalNs;
+
+        /// Duration under which half of the measures are (ns)
+        double p50Ns;
+
+        /// Duration under which 99 % of the measures are (ns)
+        double p99Ns;
+    };
+
+    /// Merged counter
+    struct CounterReport
+    {
+        /// Counter name
+        const char* name;
+
+        /// Value
+        std::uint64_t value;
+    };
+
+    /// Merged report of all threads
+    struct Report
+    {
+        /// Timers, in InstrTimer order
+        std::array<TimerReport, TIMERS_COUNT> timers;
+
+        /// Counters, in InstrCounter order
+        std::array<CounterReport, COUNTERS_COUNT> counters;
+
+        /// Number of ticks per nanosecond
+        double ticksPerNs;
+    };
+
+public:
+    /**
+     * Returns whether or not instrumentation points are compiled in.
+     *
+     * @returns True if instrumentation is enabled
+     */
+    static constexpr bool isEnabled()
+    {
+#ifdef TIBEE_INSTR
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Returns the current tick count.
+     *
+     * @returns Current tick count
+     */
+    static std::uint64_t getTicks()
+    {
+#ifdef TIBEE_INSTR_TSC
+        return __rdtsc();
+#else
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+#endif
+    }
+
+    /**
+     * Records a duration for timer \p timer in the current thread.
+     *
+     * @param timer Timer
+     * @param ticks Duration (ticks)
+     */
+    static void addTime(InstrTimer timer, std::uint64_t ticks)
+    {
+        auto& data = Instr::getThreadData().timers[static_cast<std::size_t>(timer)];
+        std::size_t bucket = ticks == 0 ? 0 : 64 - __builtin_clzll(ticks);
+
+        // 2^63 ticks and more (only bogus deltas) go to the last bucket
+        if (bucket >= BUCKETS_COUNT) {
+            bucket = BUCKETS_COUNT - 1;
+        }
+
+        Instr::add(data.count, 1);
+        Instr::add(data.ticks, ticks);
+        Instr::add(data.buckets[bucket], 1);
+    }
+
+    /**
+     * Adds \p value to counter \p counter in the current thread.
+     *
+     * @param counter Counter
+     * @param value   Value to add
+     */
+    static void addCount(InstrCounter counter, std::uint64_t value)
+    {
+        Instr::add(Instr::getThreadData().counters[static_cast<std::size_t>(counter)],
+                   value);
+    }
+
+    /**
+     * Merges the timers and counters of all threads.
+     *
+     * @returns Merged report
+     */
+    static Report getReport();
+
+    /**
+     * Writes a merged report as a table.
+     *
+     * @param os Output stream
+     */
+    static void dump(std::ostream& os);
+
+private:
+    struct TimerData
+    {
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> ticks;
+        std::array<std::atomic<std::uint64_t>, BUCKETS_COUNT> buckets;
+    };
+
+    struct ThreadData
+    {
+        std::array<TimerData, TIMERS_COUNT> timers;
+        std::array<std::atomic<std::uint64_t>, COUNTERS_COUNT> counters;
+    };
+
+    class ThreadDataOwner;
+    struct Registry;
+
+private:
+    // only the owning thread writes: no read-modify-write needed
+    static void add(std::atomic<std::uint64_t>& value, std::uint64_t n)
+    {
+        value.store(value.load(std::memory_order_relaxed) + n,
+                    std::memory_order_relaxed);
+    }
+
+    static ThreadData& getThreadData()
+    {
+        if (!_threadData) {
+            Instr::registerThread();
+        }
+
+        return *_threadData;
+    }
+
+    static Registry& getRegistry();
+    static void registerThread();
+    static void clear(ThreadData& data);
+    static void merge(ThreadData& to, const ThreadData& from);
+    static double getTicksPerNs();
+
+private:
+    // storage of the current thread (null until its first record)
+    static thread_local ThreadData* _threadData;
+};
+
+/**
+ * Scoped timer: records the duration of its own lifetime.
+ *
+ * Use TIBEE_INSTR_SCOPE() instead of this class directly.
+ *
+ * @author Philippe Proulx
+ */
+class InstrScopedTimer :
+    boost::noncopyable
+{
+public:
+    /**
+     * Starts measuring for timer \p timer.
+     *
+     * @param timer Timer
+     */
+    explicit InstrScopedTimer(InstrTimer timer) :
+        _timer {timer},
+        _start {Instr::getTicks()}
+    {
+    }
+
+    ~InstrScopedTimer()
+    {
+        Instr::addTime(_timer, Instr::getTicks() - _start);
+    }
+
+private:
+    InstrTimer _timer;
+    std::uint64_t _start;
+};
+
+}
+}
+
+#define TIBEE_INSTR_CONCAT_(a, b) a##b
+#define TIBEE_INSTR_CONCAT(a, b) TIBEE_INSTR_CONCAT_(a, b)
+
+#ifdef TIBEE_INSTR
+# define TIBEE_INSTR_SCOPE(timer) \
+    ::tibee::common::InstrScopedTimer TIBEE_INSTR_CONCAT(_instrScope, __LINE__) \
+        {::tibee::common::InstrTimer::timer}
+# define TIBEE_INSTR_COUNT(counter, value) \
+    ::tibee::common::Instr::addCount(::tibee::common::InstrCounter::counter, (value))
+#else
+# define TIBEE_INSTR_SCOPE(timer)
+# define TIBEE_INSTR_COUNT(counter, value)
+#endif
+
+#endif // _TIBEE_COMMON_INSTR_HPP
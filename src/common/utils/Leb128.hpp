@@ -0,0 +1,88 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_LEB128_HPP
+#define _TIBEE_COMMON_LEB128_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Appends the unsigned LEB128 encoding of \p value to \p output.
+ *
+ * @param value  Value to encode
+ * @param output Output byte vector
+ */
+inline void leb128Append(std::uint64_t value, std::vector<std::uint8_t>& output)
+{
+    do {
+        std::uint8_t byte = value & 0x7f;
+
+        value >>= 7;
+
+        if (value != 0) {
+            byte |= 0x80;
+        }
+
+        output.push_back(byte);
+    } while (value != 0);
+}
+
+/**
+ * Decodes one unsigned LEB128 value starting at \p data and advances
+ * \p data past it.
+ *
+ * Fails, leaving \p data and \p value unspecified, if the encoded
+ * value reaches \p end or does not fit 64 bits.
+ *
+ * @param data  Pointer to encoded value (advanced)
+ * @param end   Pointer past the last readable byte
+ * @param value Decoded value
+ * @returns     True if a complete value was decoded
+ */
+inline bool leb128Read(const std::uint8_t*& data, const std::uint8_t* end,
+                       std::uint64_t& value)
+{
+    unsigned int shift = 0;
+    std::uint8_t byte;
+
+    value = 0;
+
+    do {
+        if (data == end || shift > 63) {
+            return false;
+        }
+
+        byte = *data;
+        data++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return true;
+}
+
+}
+}
+
+#endif // _TIBEE_COMMON_LEB128_HPP
@@ -0,0 +1,96 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/filesystem/path.hpp>
+
+#include <common/utils/MappedFile.hpp>
+#include <common/ex/MappedFile.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+namespace common
+{
+
+MappedFile::MappedFile(const bfs::path& path) :
+    _path {path},
+    _data {nullptr},
+    _size {0}
+{
+    auto fd = ::open(path.string().c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        throw ex::MappedFile {"cannot open file", path};
+    }
+
+    try {
+        this->map(fd);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+}
+
+MappedFile::MappedFile(int fd, const bfs::path& path) :
+    _path {path},
+    _data {nullptr},
+    _size {0}
+{
+    this->map(fd);
+}
+
+void MappedFile::map(int fd)
+{
+    struct ::stat st;
+
+    if (::fstat(fd, &st) < 0) {
+        throw ex::MappedFile {"cannot stat file", _path};
+    }
+
+    _size = static_cast<std::size_t>(st.st_size);
+
+    // mapping an empty file is an error for mmap(); keep a null pointer
+    if (_size == 0) {
+        return;
+    }
+
+    auto addr = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+
+    if (addr == MAP_FAILED) {
+        throw ex::MappedFile {"cannot map file", _path};
+    }
+
+    _data = static_cast<const std::uint8_t*>(addr);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data) {
+        ::munmap(const_cast<std::uint8_t*>(_data), _size);
+    }
+}
+
+}
+}
@@ -0,0 +1,132 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TIBEE_COMMON_MAPPEDFILE_HPP
+#define _TIBEE_COMMON_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <boost/utility.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace tibee
+{
+namespace common
+{
+
+/**
+ * Read-only memory-mapped file.
+ *
+ * The whole file is mapped when building the object and unmapped on
+ * destruction. Pages are only loaded by the kernel when touched, so
+ * opening a huge file is instantaneous.
+ *
+ * @author Philippe Proulx
+ */
+class MappedFile :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to mapped file
+    typedef std::unique_ptr<MappedFile> UP;
+
+public:
+    /**
+     * Maps the file at path \p path.
+     *
+     * Throws ex::MappedFile if the file cannot be opened or mapped.
+     *
+     * @param path Path of file to map
+     */
+    MappedFile(const boost::filesystem::path& path);
+
+    /**
+     * Maps the whole file opened as \p fd, with its current size.
+     * \p fd is not closed, and the file may have been unlinked.
+     *
+     * Throws ex::MappedFile if the file cannot be mapped.
+     *
+     * @param fd   Descriptor of file to map (opened for reading)
+     * @param path Path of file to map (informative)
+     */
+    MappedFile(int fd, const boost::filesystem::path& path);
+
+    ~MappedFile();
+
+    /**
+     * Returns the mapped data.
+     *
+     * @returns Mapped data (\a nullptr if the file is empty)
+     */
+    const std::uint8_t* getData() const
+    {
+        return _data;
+    }
+
+    /**
+     * Returns the mapped data size in bytes.
+     *
+     * @returns Mapped data size (bytes)
+     */
+    std::size_t getSize() const
+    {
+        return _size;
+    }
+
+    /**
+     * Returns the mapped file path.
+     *
+     * @returns Mapped file path
+     */
+    const boost::filesystem::path& getPath() const
+    {
+        return _path;
+    }
+
+    /**
+     * Returns a typed pointer to the data at offset \p offset, or
+     * \a nullptr if \p count objects of type \p T starting at
+     * \p offset would go past the end of the mapped data.
+     *
+     * @param offset Offset from beginning of data (bytes)
+     * @param count  Number of contiguous objects to validate
+     * @returns      Typed pointer or \a nullptr if out of bounds
+     */
+    template<typename T>
+    const T* getAt(std::uint64_t offset, std::size_t count = 1) const
+    {
+        if (offset > _size || (_size - offset) / sizeof(T) < count) {
+            return nullptr;
+        }
+
+        return reinterpret_cast<const T*>(_data + offset);
+    }
+
+private:
+    void map(int fd);
+
+private:
+    boost::filesystem::path _path;
+    const std::uint8_t* _data;
+    std::size_t _size;
+};
+
+}
+}
+
+#endif // _TIBEE_COMMON_MAPPEDFILE_HPP
@@ -86,6 +86,9 @@ class _App(Qt.QApplication):
 
         self._main_wnd_progress.set_progress_update(update)
 
+    def _on_telemetry_available(self, update):
+        self._main_wnd_progress.set_telemetry_update(update)
+
     def _on_zmq_error(self):
         msg = 'error: cannot connect to "{}"'.format(self._addr)
         print(msg, file=sys.stderr)
@@ -110,6 +113,7 @@ class _App(Qt.QApplication):
         ul = self._update_listener
         self.start_update_listener.connect(ul.start)
         ul.update_available.connect(self._on_update_available)
+        ul.telemetry_available.connect(self._on_telemetry_available)
         ul.zmq_error.connect(self._on_zmq_error)
 
         # start update listener
@@ -4,6 +4,7 @@ from PyQt5 import Qt
 from PyQt5 import QtGui
 from qtibeeprogress import utils
 from qtibeeprogress.qprogresswidget import QProgressWidget
+from qtibeeprogress.qtelemetrywidget import QTelemetryWidget
 
 
 logger = logging.getLogger(__name__)
@@ -20,6 +21,11 @@ class QProgressMainWindow(Qt.QMainWindow, utils.QtUiLoad):
         self._progress_widget = QProgressWidget(5, 3, 15)
         layout.insertWidget(0, self._progress_widget)
 
+    def _add_telemetry_widget(self):
+        layout = self._widget_central.layout()
+        self._telemetry_widget = QTelemetryWidget(120, 15)
+        layout.insertWidget(1, self._telemetry_widget)
+
     def _setup_labels(self):
         self._labels = [
             self._lbl_begin_time,
@@ -62,6 +68,7 @@ class QProgressMainWindow(Qt.QMainWindow, utils.QtUiLoad):
         self._setup_labels()
         self._setup_edits()
         self._add_progress_widget()
+        self._add_telemetry_widget()
         self.adjustSize()
 
     def on_update_progress(self, progress):
@@ -113,8 +120,13 @@ class QProgressMainWindow(Qt.QMainWindow, utils.QtUiLoad):
         # range (ns)
         trace_range = end - begin
 
-        # fraction done (only considering current time)
-        done = (cur - begin) / trace_range
+        # fraction done (event data bytes if known, else current time)
+        total_bytes = update.get_total_bytes()
+
+        if total_bytes > 0:
+            done = update.get_cur_bytes() / total_bytes
+        else:
+            done = (cur - begin) / trace_range
 
         # processed events count
         processed_events = update.get_processed_events()
@@ -156,3 +168,6 @@ class QProgressMainWindow(Qt.QMainWindow, utils.QtUiLoad):
 
         # progress widget value
         self._progress_widget.set_value(done)
+
+    def set_telemetry_update(self, update):
+        self._telemetry_widget.add_update(update)
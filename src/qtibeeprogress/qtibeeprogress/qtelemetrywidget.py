@@ -0,0 +1,172 @@
+import collections
+from PyQt5 import Qt
+from PyQt5 import QtGui
+from PyQt5 import QtCore
+from qtibeeprogress import config
+
+
+_stage_colors = [
+    QtGui.QColor('#ce2239'),
+    QtGui.QColor('#2d7dd2'),
+    QtGui.QColor('#97cc04'),
+    QtGui.QColor('#eeb902'),
+    QtGui.QColor('#f45d01'),
+    QtGui.QColor('#8e6c8a'),
+]
+
+_events_rate_color = config.theme_foreground
+_intervals_rate_color = QtGui.QColor('#2d7dd2')
+
+
+def _format_count(value):
+    for unit in ['', 'k', 'M', 'G']:
+        if value < 1000:
+            return '{:.4g}{}'.format(value, unit)
+
+        value /= 1000
+
+    return '{:.4g}T'.format(value)
+
+
+def _format_bytes(value):
+    for unit in ['B', 'KiB', 'MiB', 'GiB']:
+        if value < 1024:
+            return '{:.4g} {}'.format(value, unit)
+
+        value /= 1024
+
+    return '{:.4g} TiB'.format(value)
+
+
+class QTelemetryWidget(Qt.QWidget):
+    def __init__(self, history_size, padding):
+        super().__init__()
+
+        self._setup_ui()
+        self._events_rates = collections.deque(maxlen=history_size)
+        self._intervals_rates = collections.deque(maxlen=history_size)
+        self._history_size = history_size
+        self._padding = padding
+        self._last_update = None
+
+    def _setup_ui(self):
+        self.setSizePolicy(Qt.QSizePolicy(Qt.QSizePolicy.Expanding,
+                                          Qt.QSizePolicy.Expanding))
+        self.setMinimumSize(0, 220)
+
+    def _draw_rates(self, painter, x, y, w, h):
+        # both rates share the same scale
+        top = max(list(self._events_rates) + list(self._intervals_rates) + [1])
+        step = w / max(self._history_size - 1, 1)
+
+        painter.setBrush(QtCore.Qt.NoBrush)
+
+        for rates, color in [(self._events_rates, _events_rate_color),
+                             (self._intervals_rates, _intervals_rate_color)]:
+            points = [Qt.QPointF(x + i * step, y + h - rate / top * h)
+                      for i, rate in enumerate(rates)]
+
+            painter.setPen(QtGui.QPen(color, 2))
+            painter.drawPolyline(QtGui.QPolygonF(points))
+
+        painter.setPen(QtGui.QColor('#999'))
+        text = 'events/s: {}   intervals/s: {}'.format(
+            _format_count(self._events_rates[-1]),
+            _format_count(self._intervals_rates[-1]))
+        painter.drawText(Qt.QPointF(x, y - 4), text)
+
+    def _draw_stages(self, painter, x, y, w, h):
+        stages = self._last_update.get_stages()
+        total = sum(time for name, time in stages)
+
+        if total == 0:
+            return
+
+        # one segment per stage, proportional to its time share
+        cx = x
+        legend = []
+
+        for index, (name, time) in enumerate(stages):
+            color = _stage_colors[index % len(_stage_colors)]
+            sw = time / total * w
+
+            painter.setPen(QtCore.Qt.NoPen)
+            painter.setBrush(color)
+            painter.drawRect(Qt.QRectF(cx, y, sw, h))
+            cx += sw
+            legend.append((name, time / total, color))
+
+        cx = x
+
+        for name, share, color in legend:
+            text = '{} {:.1f} %'.format(name, share * 100)
+
+            painter.setPen(color)
+            painter.drawText(Qt.QPointF(cx, y + h + 14), text)
+            cx += painter.fontMetrics().width(text) + 12
+
+    def _draw_gauges(self, painter, x, y):
+        u = self._last_update
+        text = 'quarks: {} paths, {} values   live states: {}   ' \
+               'pools: {}   RSS: {}   CPU: {:.1f} s'.format(
+                   _format_count(u.get_paths_quarks()),
+                   _format_count(u.get_values_quarks()),
+                   _format_count(u.get_live_states()),
+                   _format_count(u.get_pools_capacity()),
+                   _format_bytes(u.get_rss()),
+                   u.get_cpu_time() / 1e9)
+
+        painter.setPen(QtGui.QColor('#999'))
+        painter.drawText(Qt.QPointF(x, y), text)
+
+    def _draw_callbacks(self, painter, x, y):
+        callbacks = self._last_update.get_callbacks()
+        total = sum(cb[3] for cb in callbacks)
+
+        # only when state providers are profiled
+        if total == 0:
+            return
+
+        parts = []
+
+        for provider, trace_type, event_name, time, calls in callbacks[:3]:
+            name = '{}/{}'.format(trace_type or '*', event_name or '*')
+            parts.append('{} {:.1f} %'.format(name, time / total * 100))
+
+        painter.setPen(QtGui.QColor('#999'))
+        painter.drawText(Qt.QPointF(x, y),
+                         'hottest callbacks: ' + '   '.join(parts))
+
+    def _draw(self, painter):
+        w = self.width()
+        h = self.height()
+        p = self._padding
+
+        # background
+        painter.setPen(QtCore.Qt.NoPen)
+        painter.setBrush(QtGui.QColor('#080808'))
+        painter.drawRect(0, 0, w, h)
+
+        if self._last_update is None:
+            return
+
+        iw = w - 2 * p
+        rates_h = h - 2 * p - 80
+
+        self._draw_rates(painter, p, p + 14, iw, rates_h)
+        self._draw_stages(painter, p, h - p - 46, iw, 14)
+        self._draw_callbacks(painter, p, h - p - 16)
+        self._draw_gauges(painter, p, h - p)
+
+    def add_update(self, update):
+        self._events_rates.append(update.get_events_rate())
+        self._intervals_rates.append(update.get_intervals_rate())
+        self._last_update = update
+        self.update()
+
+    def paintEvent(self, ev):
+        painter = QtGui.QPainter()
+
+        painter.begin(self)
+        self._draw(painter)
+        painter.end()
@@ -9,26 +9,23 @@ from qtibeeprogress import utils
 logger = logging.getLogger(__name__)
 
 
-class ProgressUpdate:
-    def __init__(self, json_bytes):
-        self._valid = True
+def _decode_notification(json_bytes, method):
+    try:
+        json_str = json_bytes.decode('utf-8')
+        msg = json.loads(json_str)
+    except:
+        return None
 
-        try:
-            json_str = json_bytes.decode('utf-8')
-            msg = json.loads(json_str)
-        except:
-            self._valid = False
-            return
+    if msg.get('method') != method:
+        return None
 
-        if 'method' not in msg:
-            self._valid = False
-            return
+    return msg['params'][0]
 
-        if msg['method'] != 'progress-update':
-            self._valid = False
-            return
 
-        self._infos = msg['params'][0]
+class ProgressUpdate:
+    def __init__(self, json_bytes):
+        self._infos = _decode_notification(json_bytes, 'progress-update')
+        self._valid = self._infos is not None
 
     def is_valid(self):
         return self._valid
@@ -48,6 +45,15 @@ class ProgressUpdate:
     def get_state_changes(self):
         return self._infos['state-changes']
 
+    def get_total_bytes(self):
+        return self._infos.get('traces-total-bytes', 0)
+
+    def get_cur_bytes(self):
+        return self._infos.get('traces-cur-bytes', 0)
+
+    def get_estimated_events(self):
+        return self._infos.get('estimated-events', 0)
+
     def get_traces_paths(self):
         return self._infos['traces-paths']
 
@@ -58,8 +64,67 @@ class ProgressUpdate:
         return self.get_cur_ts() == self.get_end_ts()
 
 
+class TelemetryUpdate:
+    def __init__(self, json_bytes):
+        self._infos = _decode_notification(json_bytes, 'telemetry-update')
+        self._valid = self._infos is not None
+
+    def is_valid(self):
+        return self._valid
+
+    def get_processed_events(self):
+        return self._infos['processed-events']
+
+    def get_events_rate(self):
+        return self._infos['events-rate']
+
+    def get_intervals(self):
+        return self._infos['intervals']
+
+    def get_intervals_rate(self):
+        return self._infos['intervals-rate']
+
+    def get_paths_quarks(self):
+        return self._infos['paths-quarks']
+
+    def get_values_quarks(self):
+        return self._infos['values-quarks']
+
+    def get_live_states(self):
+        return self._infos['live-states']
+
+    def get_pools_capacity(self):
+        return self._infos['pools-capacity']
+
+    def get_cpu_time(self):
+        return self._infos['cpu-time']
+
+    def get_rss(self):
+        return self._infos['rss']
+
+    def get_stages(self):
+        # list of (name, time in ns) in playback order
+        return [(s['name'], s['time']) for s in self._infos['stages']]
+
+    def get_callbacks(self):
+        # list of (provider, trace type, event name, total time in ns,
+        # calls), all state providers, descending total time
+        callbacks = []
+
+        for provider in self._infos.get('providers', []):
+            for cb in provider['callbacks']:
+                callbacks.append((provider['name'], cb['trace-type'],
+                                  cb['event-name'], cb['total-time'],
+                                  cb['calls']))
+
+        callbacks.sort(key=lambda cb: cb[3], reverse=True)
+
+        return callbacks
+
+
 class QUpdateListener(Qt.QObject):
     update_available = QtCore.pyqtSignal(object)
+    telemetry_available = QtCore.pyqtSignal(object)
     zmq_error = QtCore.pyqtSignal()
 
     def __init__(self, addr, quit_after):
@@ -90,7 +155,15 @@ class QUpdateListener(Qt.QObject):
 
                 if not self._stop:
                     progress_update = ProgressUpdate(msg)
-                    self.update_available.emit(progress_update)
+
+                    if progress_update.is_valid():
+                        self.update_available.emit(progress_update)
+                        continue
+
+                    telemetry_update = TelemetryUpdate(msg)
+
+                    if telemetry_update.is_valid():
+                        self.telemetry_available.emit(telemetry_update)
             except:
                 logger.debug('Nothing available from publisher')
 
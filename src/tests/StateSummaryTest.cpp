@@ -0,0 +1,149 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/state/StateValueType.hpp>
+#include <common/state/StateSummarySink.hpp>
+#include <common/state/StateSummarySource.hpp>
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+using tibee::common::timestamp_t;
+using tibee::common::StateValueType;
+using tibee::common::StateSummarySink;
+using tibee::common::StateSummarySource;
+
+const timestamp_t BEGIN_TS = 1400000000000000000ULL;
+
+// alternating values: path 0 changes at every interval
+const std::size_t INTERVALS_COUNT = 10000;
+
+// path 1 holds a single value until STABLE_END, then alternates
+const timestamp_t STABLE_END = 3000000;
+const timestamp_t STABLE_SPAN = 4000000;
+
+timestamp_t writeSummaries(const bfs::path& path)
+{
+    // timestamps must fit the summaries of both paths
+    std::vector<timestamp_t> durations;
+    timestamp_t span = 0;
+
+    for (std::size_t x = 0; x < INTERVALS_COUNT; ++x) {
+        // some intervals end right on bucket boundaries
+        auto duration = (x % 7 == 0) ? 4096 : 1 + (x * 7919) % 3000;
+
+        durations.push_back(duration);
+        span += duration;
+    }
+
+    StateSummarySink sink {path, BEGIN_TS, BEGIN_TS + std::max(span, STABLE_SPAN)};
+    timestamp_t ts = BEGIN_TS;
+
+    for (std::size_t x = 0; x < INTERVALS_COUNT; ++x) {
+        sink.addInterval(0, ts, ts + durations[x], StateValueType::UINT32,
+                         x % 2, x % 2);
+        ts += durations[x];
+    }
+
+    sink.addInterval(1, BEGIN_TS, BEGIN_TS + STABLE_END, StateValueType::UINT32,
+                     0, 0);
+    ts = BEGIN_TS + STABLE_END;
+
+    for (std::size_t x = 1; ts < BEGIN_TS + STABLE_SPAN; ++x) {
+        sink.addInterval(1, ts, ts + 1000, StateValueType::UINT32, x % 2, x % 2);
+        ts += 1000;
+    }
+
+    sink.close(2);
+
+    return span;
+}
+
+bool checkTransitionsSum(const StateSummarySource& source, timestamp_t span,
+                         std::size_t bucketsCount)
+{
+    std::vector<StateSummarySource::Summary> summaries;
+    std::uint64_t transitions = 0;
+
+    source.summarize(0, BEGIN_TS, BEGIN_TS + span, bucketsCount, summaries);
+
+    for (const auto& summary : summaries) {
+        transitions += summary.transitions;
+    }
+
+    if (transitions != INTERVALS_COUNT - 1) {
+        std::cerr << "Error: " << transitions << " transitions in " <<
+                     bucketsCount << " buckets (expecting " <<
+                     INTERVALS_COUNT - 1 << ")" << std::endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+bool checkStableBuckets(const StateSummarySource& source)
+{
+    std::vector<StateSummarySource::Summary> summaries;
+
+    // the first two buckets are far from the first transition
+    source.summarize(1, BEGIN_TS, BEGIN_TS + STABLE_SPAN, 4, summaries);
+
+    for (std::size_t x = 0; x < 2; ++x) {
+        if (summaries[x].isNull || summaries[x].transitions != 0) {
+            std::cerr << "Error: " << summaries[x].transitions <<
+                         " transitions in stable bucket " << x << std::endl;
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+int main()
+{
+    auto path = bfs::temp_directory_path() / bfs::unique_path("state-summary-%%%%-%%%%.db");
+    auto span = writeSummaries(path);
+    bool ok = true;
+
+    {
+        StateSummarySource source {path};
+
+        for (std::size_t bucketsCount : {1, 4, 10, 1000, 10000}) {
+            ok = checkTransitionsSum(source, span, bucketsCount) && ok;
+        }
+
+        ok = checkStableBuckets(source) && ok;
+    }
+
+    bfs::remove(path);
+
+    return ok ? 0 : 1;
+}
@@ -24,4 +24,15 @@ AbstractTracePlaybackListener::~AbstractTracePlaybackListener()
 {
 }
 
+void AbstractTracePlaybackListener::onWindowImpl(common::timestamp_t begin,
+                                                 common::timestamp_t end)
+{
+    // implemented here so that it's not mandatory for concrete listeners
+}
+
+void AbstractTracePlaybackListener::onTelemetryImpl(BuildTelemetry& telemetry)
+{
+    // implemented here so that it's not mandatory for concrete listeners
+}
+
 }
@@ -20,8 +20,10 @@
 
 #include <memory>
 
+#include <common/BasicTypes.hpp>
 #include <common/trace/TraceSet.hpp>
 #include <common/trace/Event.hpp>
+#include "BuildTelemetry.hpp"
 
 namespace tibee
 {
@@ -67,6 +69,22 @@ public:
         this->onEventImpl(event);
     }
 
+    /**
+     * Sampling window notification.
+     *
+     * Only called when playing a sampled trace set, before the first
+     * event of each window. Events between two windows are not played,
+     * so listeners keeping state across events should reset or
+     * extrapolate it here.
+     *
+     * @param begin Window begin timestamp (inclusive)
+     * @param end   Window end timestamp (exclusive)
+     */
+    void onWindow(common::timestamp_t begin, common::timestamp_t end)
+    {
+        this->onWindowImpl(begin, end);
+    }
+
     /**
      * Playback stop notification.
      *
@@ -77,10 +95,37 @@ public:
         return this->onStopImpl();
     }
 
+    /**
+     * Returns the name of this listener, used as its playback stage
+     * name in build telemetry.
+     *
+     * @returns Listener name
+     */
+    const char* getName() const
+    {
+        return this->getNameImpl();
+    }
+
+    /**
+     * Telemetry update request: the listener sets the telemetry gauges
+     * it knows about. Called periodically during the playback, in the
+     * playback thread.
+     *
+     * @param telemetry Build telemetry to update
+     */
+    void onTelemetry(BuildTelemetry& telemetry)
+    {
+        this->onTelemetryImpl(telemetry);
+    }
+
 private:
     virtual bool onStartImpl(const common::TraceSet* traceSet) = 0;
     virtual void onEventImpl(common::Event& event) = 0;
     virtual bool onStopImpl() = 0;
+    virtual void onWindowImpl(common::timestamp_t begin,
+                              common::timestamp_t end);
+    virtual const char* getNameImpl() const = 0;
+    virtual void onTelemetryImpl(BuildTelemetry& telemetry);
 };
 
 }
@@ -22,9 +22,23 @@
 #include <string>
 #include <boost/filesystem/path.hpp>
 
+#include <common/BasicTypes.hpp>
+#include <common/rpc/RpcEncoding.hpp>
+
 namespace tibee
 {
 
+/**
+ * Indexed event field.
+ *
+ * @author Philippe Proulx
+ */
+struct FieldIndexSpec
+{
+    std::string eventName;
+    std::string fieldName;
+};
+
 /**
  * Program arguments.
  *
@@ -35,9 +49,16 @@ struct Arguments
     std::vector<boost::filesystem::path> traces;
     std::vector<boost::filesystem::path> stateProviders;
     std::string bindProgress;
+    common::RpcEncoding progressEncoding;
     boost::filesystem::path cacheDir;
+    std::vector<FieldIndexSpec> indexedFields;
+    common::timestamp_t sampleWindow;
+    common::timestamp_t samplePeriod;
     bool verbose;
     bool force;
+    bool profileProviders;
+    bool liveSnapshots;
+    boost::filesystem::path statsPath;
 };
 
 }
@@ -0,0 +1,51 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BuildTelemetry.hpp"
+
+namespace tibee
+{
+
+BuildTelemetry::BuildTelemetry() :
+    _intervals {0},
+    _pathsQuarks {0},
+    _valuesQuarks {0},
+    _liveStates {0},
+    _poolsCapacity {0}
+{
+}
+
+void BuildTelemetry::reset(const std::vector<std::string>& stagesNames)
+{
+    _stagesNames = stagesNames;
+    _stagesTimes = std::unique_ptr<std::atomic<std::uint64_t>[]> {
+        new std::atomic<std::uint64_t>[stagesNames.size()]
+    };
+
+    for (std::size_t x = 0; x < stagesNames.size(); ++x) {
+        _stagesTimes[x].store(0, std::memory_order_relaxed);
+    }
+
+    _intervals.store(0, std::memory_order_relaxed);
+    _pathsQuarks.store(0, std::memory_order_relaxed);
+    _valuesQuarks.store(0, std::memory_order_relaxed);
+    _liveStates.store(0, std::memory_order_relaxed);
+    _poolsCapacity.store(0, std::memory_order_relaxed);
+    this->setProvidersProfiles({});
+}
+
+}
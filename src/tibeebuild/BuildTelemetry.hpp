@@ -0,0 +1,245 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BUILDTELEMETRY_HPP
+#define _BUILDTELEMETRY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/stateprov/StateProviderProfile.hpp>
+
+namespace tibee
+{
+
+/**
+ * Build telemetry.
+ *
+ * Counters and gauges written by the playback thread (trace deck and
+ * listeners) and read by any other thread, typically to publish them
+ * (see ProgressPublisher). Writers use relaxed single-writer stores,
+ * so readers may see values from slightly different moments.
+ *
+ * Playback stages are decoding, followed by each listener. Their
+ * times are measured on a sample of events and extrapolated to all
+ * events.
+ *
+ * @author Philippe Proulx
+ */
+class BuildTelemetry :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds build telemetry without stages.
+     */
+    BuildTelemetry();
+
+    /**
+     * Sets the playback stages and resets all values. Must be called
+     * before any reader starts.
+     *
+     * @param stagesNames Names of stages, in playback order
+     */
+    void reset(const std::vector<std::string>& stagesNames);
+
+    /**
+     * Returns the number of stages.
+     *
+     * @returns Number of stages
+     */
+    std::size_t getStagesCount() const
+    {
+        return _stagesNames.size();
+    }
+
+    /**
+     * Returns the name of stage \p stage.
+     *
+     * @param stage Stage index
+     * @returns     Stage name
+     */
+    const std::string& getStageName(std::size_t stage) const
+    {
+        return _stagesNames[stage];
+    }
+
+    /**
+     * Adds time spent in stage \p stage (playback thread only).
+     *
+     * @param stage Stage index
+     * @param ns    Time to add (ns)
+     */
+    void addStageTime(std::size_t stage, std::uint64_t ns)
+    {
+        auto& time = _stagesTimes[stage];
+
+        time.store(time.load(std::memory_order_relaxed) + ns,
+                   std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the estimated time spent in stage \p stage so far.
+     *
+     * @param stage Stage index
+     * @returns     Stage time (ns)
+     */
+    std::uint64_t getStageTime(std::size_t stage) const
+    {
+        return _stagesTimes[stage].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the number of state intervals written so far.
+     *
+     * @param intervals Number of intervals
+     */
+    void setIntervals(std::uint64_t intervals)
+    {
+        _intervals.store(intervals, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the number of state intervals written so far.
+     *
+     * @returns Number of intervals
+     */
+    std::uint64_t getIntervals() const
+    {
+        return _intervals.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the sizes of the paths and string values quark databases.
+     *
+     * @param pathsQuarks  Number of path quarks
+     * @param valuesQuarks Number of string value quarks
+     */
+    void setQuarks(std::uint64_t pathsQuarks, std::uint64_t valuesQuarks)
+    {
+        _pathsQuarks.store(pathsQuarks, std::memory_order_relaxed);
+        _valuesQuarks.store(valuesQuarks, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the number of path quarks.
+     *
+     * @returns Number of path quarks
+     */
+    std::uint64_t getPathsQuarks() const
+    {
+        return _pathsQuarks.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the number of string value quarks.
+     *
+     * @returns Number of string value quarks
+     */
+    std::uint64_t getValuesQuarks() const
+    {
+        return _valuesQuarks.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the number of live (not yet closed) state entries.
+     *
+     * @param liveStates Number of live state entries
+     */
+    void setLiveStates(std::uint64_t liveStates)
+    {
+        _liveStates.store(liveStates, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the number of live (not yet closed) state entries.
+     *
+     * @returns Number of live state entries
+     */
+    std::uint64_t getLiveStates() const
+    {
+        return _liveStates.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the high-water mark of the event value pools.
+     *
+     * @param poolsCapacity Total capacity of event value pools (objects)
+     */
+    void setPoolsCapacity(std::uint64_t poolsCapacity)
+    {
+        _poolsCapacity.store(poolsCapacity, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the high-water mark of the event value pools.
+     *
+     * @returns Total capacity of event value pools (objects)
+     */
+    std::uint64_t getPoolsCapacity() const
+    {
+        return _poolsCapacity.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the state providers profiles.
+     *
+     * @param providersProfiles State providers profiles
+     */
+    void setProvidersProfiles(std::vector<common::StateProviderProfile> providersProfiles)
+    {
+        std::lock_guard<std::mutex> lock {_providersProfilesMutex};
+
+        _providersProfiles = std::move(providersProfiles);
+    }
+
+    /**
+     * Returns a copy of the state providers profiles (empty if state
+     * providers are not profiled).
+     *
+     * @returns State providers profiles
+     */
+    std::vector<common::StateProviderProfile> getProvidersProfiles() const
+    {
+        std::lock_guard<std::mutex> lock {_providersProfilesMutex};
+
+        return _providersProfiles;
+    }
+
+private:
+    std::vector<std::string> _stagesNames;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> _stagesTimes;
+    std::atomic<std::uint64_t> _intervals;
+    std::atomic<std::uint64_t> _pathsQuarks;
+    std::atomic<std::uint64_t> _valuesQuarks;
+    std::atomic<std::uint64_t> _liveStates;
+    std::atomic<std::uint64_t> _poolsCapacity;
+
+    // profiles are not plain counters: copied under this lock
+    mutable std::mutex _providersProfilesMutex;
+    std::vector<common::StateProviderProfile> _providersProfiles;
+};
+
+}
+
+#endif // _BUILDTELEMETRY_HPP
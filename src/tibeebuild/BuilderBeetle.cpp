@@ -15,14 +15,21 @@
  * You should have received a copy of the GNU General Public License
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
+#include <sys/resource.h>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include <common/trace/TraceSet.hpp>
 #include <common/ex/WrongStateProvider.hpp>
+#include <common/utils/Instr.hpp>
 #include "StateHistoryBuilder.hpp"
+#include "EventDensityBuilder.hpp"
+#include "FieldIndexBuilder.hpp"
 #include "ProgressPublisher.hpp"
 #include "TraceDeck.hpp"
 #include "Arguments.hpp"
@@ -54,6 +61,17 @@ bool BuilderBeetle::run()
         }
     }
 
+    // summarize packets (fast: only packet indexes are read)
+    auto packetSummary = traceSet->getPacketSummary();
+
+    if (_args.verbose) {
+        std::cout << "packets: " << packetSummary->getPacketsCount() <<
+                     ", bytes: " << packetSummary->getTotalBytes() <<
+                     ", event bytes: " << packetSummary->getEventsBytes() <<
+                     ", discarded events: " << packetSummary->getEventsDiscarded() <<
+                     std::endl;
+    }
+
     // create a list of trace listeners
     std::vector<AbstractTracePlaybackListener::UP> listeners;
 
@@ -63,7 +81,9 @@ bool BuilderBeetle::run()
         stateHistoryBuilder = std::unique_ptr<StateHistoryBuilder> {
             new StateHistoryBuilder {
                 _args.cacheDir,
-                _args.stateProviders
+                _args.stateProviders,
+                _args.profileProviders,
+                _args.liveSnapshots
             }
         };
     } catch (const common::ex::WrongStateProvider& ex) {
@@ -79,8 +99,23 @@ bool BuilderBeetle::run()
         return false;
     }
 
+    // the progress publisher queries it once owned by the listeners
+    auto stateHistoryBuilderPtr = stateHistoryBuilder.get();
+
     listeners.push_back(std::move(stateHistoryBuilder));
 
+    // create an event density builder
+    listeners.push_back(AbstractTracePlaybackListener::UP {
+        new EventDensityBuilder {_args.cacheDir}
+    });
+
+    // create a field index builder if fields are to be indexed
+    if (!_args.indexedFields.empty()) {
+        listeners.push_back(AbstractTracePlaybackListener::UP {
+            new FieldIndexBuilder {_args.cacheDir, _args.indexedFields}
+        });
+    }
+
     // create a progress publisher
     if (!_args.bindProgress.empty()) {
         std::unique_ptr<ProgressPublisher> progressPublisher;
@@ -92,9 +127,11 @@ bool BuilderBeetle::run()
                     traceSet->getEnd(),
                     _args.traces,
                     _args.stateProviders,
-                    stateHistoryBuilder.get(),
-                    2801,
-                    200
+                    stateHistoryBuilderPtr,
+                    packetSummary.get(),
+                    &_telemetry,
+                    200,
+                    _args.progressEncoding
                 }
             };
         } catch (const ex::MqBindError& ex) {
@@ -105,10 +142,106 @@ bool BuilderBeetle::run()
         }
 
         listeners.push_back(std::move(progressPublisher));
+
+        // telemetry is published alongside progress
+        _traceDeck.setTelemetry(&_telemetry);
     }
 
+    // statistics include the stages times
+    if (!_args.statsPath.empty()) {
+        _traceDeck.setTelemetry(&_telemetry);
+    }
+
+    // sample if asked
+    _traceDeck.setSampling(_args.sampleWindow, _args.samplePeriod);
+
     // ready for the deck
-    return _traceDeck.play(traceSet.get(), listeners);
+    auto begin = std::chrono::steady_clock::now();
+
+    if (!_traceDeck.play(traceSet.get(), listeners)) {
+        return false;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    this->writeSamplingInfos(traceSet.get());
+
+    if (!_args.statsPath.empty()) {
+        this->writeStats(packetSummary.get(), elapsed.count());
+    }
+
+    if (common::Instr::isEnabled()) {
+        common::Instr::dump(std::cout);
+    }
+
+    return true;
+}
+
+void BuilderBeetle::writeSamplingInfos(const common::TraceSet* traceSet) const
+{
+    auto path = _args.cacheDir / "sampling.yml";
+
+    // complete build: make sure no stale sampling infos remain
+    if (!_traceDeck.isSampling()) {
+        bfs::remove(path);
+        return;
+    }
+
+    bfs::ofstream output {path};
+
+    output << "strategy: time-windows" << std::endl <<
+              "window-duration: " << _args.sampleWindow << std::endl <<
+              "period: " << _args.samplePeriod << std::endl <<
+              "begin: " << traceSet->getBegin() << std::endl <<
+              "end: " << traceSet->getEnd() << std::endl <<
+              "windows: " << _traceDeck.getWindowsCount() << std::endl <<
+              "ratio: " << static_cast<double>(_args.sampleWindow) /
+                           _args.samplePeriod << std::endl;
+}
+
+void BuilderBeetle::writeStats(const common::TracePacketSummary* packetSummary,
+                               double elapsed) const
+{
+    struct ::rusage usage;
+    double cpuTime = 0;
+    std::uint64_t peakRss = 0;
+
+    if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+        auto toSeconds = [] (const ::timeval& tv) {
+            return tv.tv_sec + tv.tv_usec / 1e6;
+        };
+
+        cpuTime = toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+
+        // kilobytes on Linux
+        peakRss = static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+    }
+
+    bfs::ofstream output {_args.statsPath};
+
+    output << "{" << std::endl <<
+              "  \"events\": " << _traceDeck.getPlayedEventsCount() << "," << std::endl <<
+              "  \"state-changes\": " << _telemetry.getIntervals() << "," << std::endl <<
+              "  \"trace-bytes\": " << packetSummary->getTotalBytes() << "," << std::endl <<
+              "  \"time\": " << elapsed << "," << std::endl <<
+              "  \"cpu-time\": " << cpuTime << "," << std::endl <<
+              "  \"peak-rss\": " << peakRss << "," << std::endl <<
+              "  \"stages\": [";
+
+    // stages times are in nanoseconds
+    for (std::size_t x = 0; x < _telemetry.getStagesCount(); ++x) {
+        if (x != 0) {
+            output << ",";
+        }
+
+        output << std::endl <<
+                  "    {\"name\": \"" << _telemetry.getStageName(x) << "\", " <<
+                  "\"time\": " << _telemetry.getStageTime(x) / 1e9 << "}";
+    }
+
+    output << std::endl <<
+              "  ]" << std::endl <<
+              "}" << std::endl;
 }
 
 void BuilderBeetle::stop()
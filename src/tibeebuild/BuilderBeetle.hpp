@@ -19,6 +19,7 @@
 #define _BUILDERBEETLE_HPP
 
 #include "TraceDeck.hpp"
+#include "BuildTelemetry.hpp"
 #include "Arguments.hpp"
 
 namespace tibee
@@ -51,9 +52,15 @@ public:
      */
     void stop();
 
+private:
+    void writeSamplingInfos(const common::TraceSet* traceSet) const;
+    void writeStats(const common::TracePacketSummary* packetSummary,
+                    double elapsed) const;
+
 private:
     Arguments _args;
     TraceDeck _traceDeck;
+    BuildTelemetry _telemetry;
 };
 
 }
@@ -0,0 +1,76 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <memory>
+#include <boost/filesystem/path.hpp>
+
+#include <common/cache/EventDensitySink.hpp>
+#include "AbstractCacheBuilder.hpp"
+#include "EventDensityBuilder.hpp"
+
+namespace bfs = boost::filesystem;
+
+namespace tibee
+{
+
+EventDensityBuilder::EventDensityBuilder(const bfs::path& dir) :
+    AbstractCacheBuilder {dir}
+{
+}
+
+EventDensityBuilder::~EventDensityBuilder()
+{
+}
+
+bool EventDensityBuilder::onStartImpl(const common::TraceSet* traceSet)
+{
+    std::cout << "event density builder: starting" << std::endl;
+
+    // create new event density sink (destroying the previous one)
+    _eventDensitySink = std::unique_ptr<common::EventDensitySink> {
+        new common::EventDensitySink {
+            this->getCacheDir() / "event-density.db",
+            traceSet->getBegin(),
+            traceSet->getEnd()
+        }
+    };
+
+    return true;
+}
+
+void EventDensityBuilder::onEventImpl(common::Event& event)
+{
+    _eventDensitySink->addEvent(event.getTraceId(), event.getId(),
+                                event.getTimestamp());
+}
+
+bool EventDensityBuilder::onStopImpl()
+{
+    std::cout << "event density builder: stopping" << std::endl;
+
+    _eventDensitySink->close();
+
+    return true;
+}
+
+const char* EventDensityBuilder::getNameImpl() const
+{
+    return "event-density";
+}
+
+}
@@ -0,0 +1,65 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EVENTDENSITYBUILDER_HPP
+#define _EVENTDENSITYBUILDER_HPP
+
+#include <memory>
+#include <boost/filesystem/path.hpp>
+
+#include <common/cache/EventDensitySink.hpp>
+#include <common/trace/TraceSet.hpp>
+#include <common/trace/Event.hpp>
+#include "AbstractCacheBuilder.hpp"
+
+namespace tibee
+{
+
+/**
+ * Event density builder.
+ *
+ * An instance of this class is responsible for building the event
+ * density histograms on disk during a trace playback.
+ *
+ * @author Philippe Proulx
+ */
+class EventDensityBuilder :
+    public AbstractCacheBuilder
+{
+public:
+    /**
+     * Builds an event density builder.
+     *
+     * @param dir Cache directory
+     */
+    EventDensityBuilder(const boost::filesystem::path& dir);
+
+    ~EventDensityBuilder();
+
+private:
+    bool onStartImpl(const common::TraceSet* traceSet);
+    void onEventImpl(common::Event& event);
+    bool onStopImpl();
+    const char* getNameImpl() const;
+
+private:
+    std::unique_ptr<common::EventDensitySink> _eventDensitySink;
+};
+
+}
+
+#endif // _EVENTDENSITYBUILDER_HPP
@@ -0,0 +1,162 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <memory>
+#include <boost/filesystem/path.hpp>
+
+#include <common/cache/FieldIndexSink.hpp>
+#include <common/trace/AbstractEventValue.hpp>
+#include <common/trace/SintEventValue.hpp>
+#include <common/trace/UintEventValue.hpp>
+#include <common/trace/EnumEventValue.hpp>
+#include <common/trace/StringEventValue.hpp>
+#include "AbstractCacheBuilder.hpp"
+#include "FieldIndexBuilder.hpp"
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+std::uint64_t getKey(tibee::common::trace_id_t traceId,
+                     tibee::common::event_id_t eventId)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(traceId)) << 32) |
+           static_cast<std::uint32_t>(eventId);
+}
+
+}
+
+namespace tibee
+{
+
+FieldIndexBuilder::FieldIndexBuilder(const bfs::path& dir,
+                                     const std::vector<FieldIndexSpec>& specs) :
+    AbstractCacheBuilder {dir},
+    _specs {specs}
+{
+}
+
+FieldIndexBuilder::~FieldIndexBuilder()
+{
+}
+
+bfs::path FieldIndexBuilder::getIndexPath(const bfs::path& dir,
+                                          const FieldIndexSpec& spec)
+{
+    return dir / ("field-index-" + spec.eventName + "-" +
+                  spec.fieldName + ".db");
+}
+
+bool FieldIndexBuilder::onStartImpl(const common::TraceSet* traceSet)
+{
+    std::cout << "field index builder: starting" << std::endl;
+
+    // create new sinks (destroying the previous ones)
+    _sinks.clear();
+    _eventSpecs.clear();
+
+    for (const auto& spec : _specs) {
+        _sinks.push_back(std::unique_ptr<common::FieldIndexSink> {
+            new common::FieldIndexSink {
+                FieldIndexBuilder::getIndexPath(this->getCacheDir(), spec)
+            }
+        });
+    }
+
+    // find which (trace ID, event ID) pairs are indexed
+    for (const auto& traceInfos : traceSet->getTracesInfos()) {
+        const auto& eventMap = traceInfos->getEventMap();
+
+        for (std::size_t x = 0; x < _specs.size(); ++x) {
+            auto it = eventMap.find(_specs[x].eventName);
+
+            if (it == eventMap.end()) {
+                continue;
+            }
+
+            auto key = getKey(traceInfos->getId(), it->second);
+
+            _eventSpecs[key].push_back(x);
+        }
+    }
+
+    return true;
+}
+
+void FieldIndexBuilder::onEventImpl(common::Event& event)
+{
+    auto it = _eventSpecs.find(getKey(event.getTraceId(), event.getId()));
+
+    // not indexed: do not decode anything
+    if (it == _eventSpecs.end()) {
+        return;
+    }
+
+    auto ts = event.getTimestamp();
+
+    for (auto specIndex : it->second) {
+        auto value = event[_specs[specIndex].fieldName];
+
+        if (!value) {
+            continue;
+        }
+
+        auto& sink = *_sinks[specIndex];
+
+        switch (value->getType()) {
+        case common::EventValueType::SINT:
+            sink.addSint(value->asSint()->getValue(), ts);
+            break;
+
+        case common::EventValueType::UINT:
+            sink.addUint(value->asUint()->getValue(), ts);
+            break;
+
+        case common::EventValueType::ENUM:
+            sink.addUint(value->asEnum()->getValue(), ts);
+            break;
+
+        case common::EventValueType::STRING:
+            sink.addString(value->asString()->getValue(), ts);
+            break;
+
+        default:
+            // other types cannot be indexed
+            break;
+        }
+    }
+}
+
+bool FieldIndexBuilder::onStopImpl()
+{
+    std::cout << "field index builder: stopping" << std::endl;
+
+    for (auto& sink : _sinks) {
+        sink->close();
+    }
+
+    return true;
+}
+
+const char* FieldIndexBuilder::getNameImpl() const
+{
+    return "field-index";
+}
+
+}
@@ -0,0 +1,89 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _FIELDINDEXBUILDER_HPP
+#define _FIELDINDEXBUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <boost/filesystem/path.hpp>
+
+#include <common/cache/FieldIndexSink.hpp>
+#include <common/trace/TraceSet.hpp>
+#include <common/trace/Event.hpp>
+#include "AbstractCacheBuilder.hpp"
+#include "Arguments.hpp"
+
+namespace tibee
+{
+
+/**
+ * Field index builder.
+ *
+ * An instance of this class is responsible for building one field
+ * index file per indexed (event name, field name) pair during a trace
+ * playback.
+ *
+ * Only the fields of events having an indexed name are decoded.
+ *
+ * @author Philippe Proulx
+ */
+class FieldIndexBuilder :
+    public AbstractCacheBuilder
+{
+public:
+    /**
+     * Builds a field index builder.
+     *
+     * @param dir   Cache directory
+     * @param specs Indexed fields
+     */
+    FieldIndexBuilder(const boost::filesystem::path& dir,
+                      const std::vector<FieldIndexSpec>& specs);
+
+    ~FieldIndexBuilder();
+
+    /**
+     * Returns the path of the field index file of a given indexed
+     * field within cache directory \p dir.
+     *
+     * @param dir  Cache directory
+     * @param spec Indexed field
+     * @returns    Field index file path
+     */
+    static boost::filesystem::path getIndexPath(const boost::filesystem::path& dir,
+                                                const FieldIndexSpec& spec);
+
+private:
+    bool onStartImpl(const common::TraceSet* traceSet);
+    void onEventImpl(common::Event& event);
+    bool onStopImpl();
+    const char* getNameImpl() const;
+
+private:
+    std::vector<FieldIndexSpec> _specs;
+    std::vector<std::unique_ptr<common::FieldIndexSink>> _sinks;
+
+    // (trace ID, event ID) key -> indexes of specs to feed
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> _eventSpecs;
+};
+
+}
+
+#endif // _FIELDINDEXBUILDER_HPP
@@ -15,7 +15,14 @@
  * You should have received a copy of the GNU General Public License
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <sys/resource.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <boost/filesystem/path.hpp>
 
 #include <common/trace/EventValueType.hpp>
@@ -25,27 +32,70 @@
 #include "ex/MqBindError.hpp"
 
 namespace bfs = boost::filesystem;
-namespace bptime = boost::posix_time;
 
 namespace tibee
 {
 
+namespace
+{
+
+std::uint64_t getCpuTime()
+{
+    struct ::rusage usage;
+
+    if (::getrusage(RUSAGE_SELF, &usage) < 0) {
+        return 0;
+    }
+
+    auto toNs = [] (const ::timeval& tv) {
+        return static_cast<std::uint64_t>(tv.tv_sec) * 1000000000 +
+               static_cast<std::uint64_t>(tv.tv_usec) * 1000;
+    };
+
+    return toNs(usage.ru_utime) + toNs(usage.ru_stime);
+}
+
+std::uint64_t getRss()
+{
+    // second field is the resident set size (pages)
+    std::ifstream statm {"/proc/self/statm"};
+    std::uint64_t size;
+    std::uint64_t resident;
+
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+
+    return resident * static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+}
+
+}
+
 ProgressPublisher::ProgressPublisher(const std::string& bindAddr,
                                      common::timestamp_t beginTs, common::timestamp_t endTs,
                                      const std::vector<boost::filesystem::path>& tracesPaths,
                                      const std::vector<boost::filesystem::path>& stateProvidersPaths,
                                      const StateHistoryBuilder* stateHistoryBuilder,
-                                     std::size_t updatePeriodEvents,
-                                     std::size_t updatePeriodMs) :
+                                     const common::TracePacketSummary* packetSummary,
+                                     const BuildTelemetry* telemetry,
+                                     std::size_t updatePeriodMs,
+                                     common::RpcEncoding encoding) :
     _bindAddr {bindAddr},
     _evCount {0},
+    _curTs {beginTs},
+    _encoding {encoding},
     _rpcMessageEncoder {new BuilderJsonRpcMessageEncoder},
+    _msgPackEncoder {new BuilderMsgPackRpcMessageEncoder},
     _rpcNotification {new ProgressUpdateRpcNotification},
+    _telemetryNotification {new TelemetryUpdateRpcNotification},
     _stateHistoryBuilder {stateHistoryBuilder},
-    _updatePeriodEvents {updatePeriodEvents},
+    _packetSummary {packetSummary},
+    _telemetry {telemetry},
     _updatePeriodMs {updatePeriodMs},
-    _tmpEvCounter {0},
-    _lastTs {beginTs}
+    _lastEvCount {0},
+    _lastStateChanges {0},
+    _lastIntervals {0},
+    _stopped {false}
 {
     // initially set progress update RPC notification
     _rpcNotification->setBeginTs(beginTs);
@@ -55,6 +105,10 @@ ProgressPublisher::ProgressPublisher(const std::string& bindAddr,
     _rpcNotification->setStateProvidersPaths(stateProvidersPaths);
     _rpcNotification->setStateChanges(0);
 
+    if (_packetSummary) {
+        _rpcNotification->setTotalBytes(_packetSummary->getEventsBytes());
+    }
+
     // create and bind to message queue publish socket
     _mqContext = std::unique_ptr<common::MqContext> {
         new common::MqContext {1}
@@ -71,6 +125,9 @@ ProgressPublisher::ProgressPublisher(const std::string& bindAddr,
 
 ProgressPublisher::~ProgressPublisher()
 {
+    // playback may have been interrupted before onStopImpl()
+    this->stopSampler();
+
     _mqSocket = nullptr;
     _mqContext = nullptr;
 }
@@ -79,55 +136,179 @@ bool ProgressPublisher::onStartImpl(const common::TraceSet* traceSet)
 {
     std::cout << "progress publisher: publishing start" << std::endl;
 
-    // first publication
-    _evCount = 0;
-    _tmpEvCounter = 0;
-    _lastTs = _rpcNotification->getBeginTs();
-    _rpcNotification->setStateChanges(0);
-    this->publish();
+    // previous sampler, if any, must be done with the counters
+    this->stopSampler();
 
-    // update last time
-    _lastTime = bptime::microsec_clock::local_time();
+    _evCount.store(0, std::memory_order_relaxed);
+    _curTs.store(_rpcNotification->getBeginTs(), std::memory_order_relaxed);
+    _lastEvCount = 0;
+    _lastStateChanges = _stateHistoryBuilder->getStateChanges();
+    _lastIntervals = 0;
+    _lastTime = std::chrono::steady_clock::now();
+    _stopped = false;
+
+    // the socket is handed over to the sampler thread from now on
+    _sampler = std::thread {&ProgressPublisher::sample, this};
 
     return true;
 }
 
 void ProgressPublisher::onEventImpl(common::Event& event)
 {
-    // increase event count
-    _evCount++;
+    // plain loads and stores: this is the only writer
+    _evCount.store(_evCount.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    _curTs.store(event.getTimestamp(), std::memory_order_relaxed);
+}
 
-    // update?
-    if (_tmpEvCounter++ == _updatePeriodEvents) {
-        // reset temporary counter
-        _tmpEvCounter = 0;
+void ProgressPublisher::sample()
+{
+    // first publication
+    this->publish(_rpcNotification->getBeginTs());
 
-        // really update?
-        bptime::ptime curTime {bptime::microsec_clock::local_time()};
+    std::unique_lock<std::mutex> lock {_mutex};
 
-        if (curTime - _lastTime > bptime::milliseconds(_updatePeriodMs)) {
-            // publish now
-            _lastTs = event.getTimestamp();
-            this->publish();
+    while (!_stopped) {
+        _cond.wait_for(lock, std::chrono::milliseconds(_updatePeriodMs));
 
-            // update last time
-            _lastTime = curTime;
+        if (_stopped) {
+            break;
         }
+
+        lock.unlock();
+        this->publish(_curTs.load(std::memory_order_relaxed));
+        lock.lock();
     }
+
+    lock.unlock();
+
+    // last publication: the whole trace set was played
+    this->publish(_rpcNotification->getEndTs());
 }
 
-void ProgressPublisher::publish()
+void ProgressPublisher::stopSampler()
 {
+    if (!_sampler.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock {_mutex};
+
+        _stopped = true;
+        _cond.notify_one();
+    }
+
+    _sampler.join();
+}
+
+void ProgressPublisher::publish(common::timestamp_t curTs)
+{
+    auto evCount = _evCount.load(std::memory_order_relaxed);
+    auto stateChanges = _stateHistoryBuilder->getStateChanges();
+    auto curTime = std::chrono::steady_clock::now();
+
+    // rates since the previous sample
+    std::chrono::duration<double> elapsed = curTime - _lastTime;
+
+    if (elapsed.count() > 0) {
+        _rpcNotification->setEventsRate((evCount - _lastEvCount) /
+                                        elapsed.count());
+        _rpcNotification->setStateChangesRate((stateChanges - _lastStateChanges) /
+                                              elapsed.count());
+    }
+
+    _lastEvCount = evCount;
+    _lastStateChanges = stateChanges;
+    _lastTime = curTime;
+
+    // update RPC notification object
+    _rpcNotification->setCurTs(curTs);
+    _rpcNotification->setStateChanges(stateChanges);
+    _rpcNotification->setProcessedEvents(evCount);
+
+    if (_packetSummary) {
+        auto curBytes = _packetSummary->getBytesBefore(curTs);
+
+        _rpcNotification->setCurBytes(curBytes);
+
+        // average event size measured so far gives the total estimate
+        if (evCount > 0 && curBytes > 0) {
+            auto bytesPerEvent = static_cast<double>(curBytes) / evCount;
+
+            _rpcNotification->setEstimatedEvents(
+                _packetSummary->getEstimatedEventsCount(bytesPerEvent)
+            );
+        }
+    }
+
+    // get encoded RPC notification
+    std::unique_ptr<std::string> encoded;
+
+    if (_encoding == common::RpcEncoding::MSGPACK) {
+        encoded = _msgPackEncoder->encodeProgressUpdateRpcNotification(*_rpcNotification);
+    } else {
+        encoded = _rpcMessageEncoder->encodeProgressUpdateRpcNotification(*_rpcNotification);
+    }
+
+    this->send(std::move(encoded));
+
+    if (_telemetry) {
+        this->publishTelemetry(evCount, elapsed.count());
+    }
+}
+
+void ProgressPublisher::publishTelemetry(std::size_t evCount, double elapsed)
+{
+    auto intervals = _telemetry->getIntervals();
+
+    // rates since the previous sample
+    _telemetryNotification->setEventsRate(_rpcNotification->getEventsRate());
+
+    if (elapsed > 0) {
+        _telemetryNotification->setIntervalsRate((intervals - _lastIntervals) /
+                                                 elapsed);
+    }
+
+    _lastIntervals = intervals;
+
     // update RPC notification object
-    _rpcNotification->setCurTs(_lastTs);
-    _rpcNotification->setStateChanges(_stateHistoryBuilder->getStateChanges());
-    _rpcNotification->setProcessedEvents(_evCount);
+    _telemetryNotification->setProcessedEvents(evCount);
+    _telemetryNotification->setIntervals(intervals);
+    _telemetryNotification->setPathsQuarks(_telemetry->getPathsQuarks());
+    _telemetryNotification->setValuesQuarks(_telemetry->getValuesQuarks());
+    _telemetryNotification->setLiveStates(_telemetry->getLiveStates());
+    _telemetryNotification->setPoolsCapacity(_telemetry->getPoolsCapacity());
+    _telemetryNotification->setCpuTime(getCpuTime());
+    _telemetryNotification->setRss(getRss());
+
+    auto& stages = _telemetryNotification->getStages();
+
+    stages.resize(_telemetry->getStagesCount());
+
+    for (std::size_t x = 0; x < stages.size(); ++x) {
+        stages[x].name = _telemetry->getStageName(x);
+        stages[x].time = _telemetry->getStageTime(x);
+    }
 
-    // get JSON-RPC notification
-    auto json = _rpcMessageEncoder->encodeProgressUpdateRpcNotification(*_rpcNotification);
+    _telemetryNotification->getProvidersProfiles() = _telemetry->getProvidersProfiles();
 
+    // get encoded RPC notification
+    std::unique_ptr<std::string> encoded;
+
+    if (_encoding == common::RpcEncoding::MSGPACK) {
+        encoded = _msgPackEncoder->encodeTelemetryUpdateRpcNotification(*_telemetryNotification);
+    } else {
+        encoded = _rpcMessageEncoder->encodeTelemetryUpdateRpcNotification(*_telemetryNotification);
+    }
+
+    this->send(std::move(encoded));
+}
+
+void ProgressPublisher::send(std::unique_ptr<std::string> encoded)
+{
     // create message to publish
-    common::MqMessage::UP msg {new common::MqMessage {json->c_str(), json->size()}};
+    common::MqMessage::UP msg {new common::MqMessage {std::move(encoded)}};
 
     // publish message
     _mqSocket->send(std::move(msg));
@@ -135,11 +316,15 @@ void ProgressPublisher::publish()
 
 bool ProgressPublisher::onStopImpl()
 {
-    // publish one last time
-    _lastTs = _rpcNotification->getEndTs();
-    this->publish();
+    // the sampler publishes one last time before returning
+    this->stopSampler();
 
     return true;
 }
 
+const char* ProgressPublisher::getNameImpl() const
+{
+    return "progress";
+}
+
 }
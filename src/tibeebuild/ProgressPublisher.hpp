@@ -18,25 +18,44 @@
 #ifndef _PROGRESSPUBLISHER_HPP
 #define _PROGRESSPUBLISHER_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <boost/filesystem/path.hpp>
-#include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <common/BasicTypes.hpp>
 #include <common/trace/TraceSet.hpp>
+#include <common/trace/TracePacketSummary.hpp>
 #include <common/trace/Event.hpp>
 #include <common/mq/MqContext.hpp>
+#include <common/rpc/RpcEncoding.hpp>
 #include "AbstractTracePlaybackListener.hpp"
 #include "StateHistoryBuilder.hpp"
+#include "BuildTelemetry.hpp"
 #include "rpc/ProgressUpdateRpcNotification.hpp"
+#include "rpc/TelemetryUpdateRpcNotification.hpp"
 #include "rpc/BuilderJsonRpcMessageEncoder.hpp"
+#include "rpc/BuilderMsgPackRpcMessageEncoder.hpp"
 
 namespace tibee
 {
 
 /**
- * Abstract cache builder. All cache builders must inherit this.
+ * Progress publisher.
+ *
+ * The playback thread only updates a few counters for each event.
+ * A sampler thread, started when the playback starts, reads them every
+ * update period, computes rates since the previous sample, and
+ * encodes and publishes a progress update notification.
+ *
+ * If build telemetry is given, the sampler also publishes a telemetry
+ * update notification (TelemetryUpdateRpcNotification) after each
+ * progress update, on the same socket.
  *
  * @author Philippe Proulx
  */
@@ -47,27 +66,28 @@ public:
     /**
      * Builds a progress publisher.
      *
-     * The publisher will check the current system timestamp every
-     * \p updatePeriodEvents events. If the difference since the last
-     * check is greater than \p updatePeriodMs milliseconds, there will
-     * be a progress publication.
-     *
      * @param bindAddr            Bind address for publishing progress
      * @param beginTs             Begin timestamp of trace set
      * @param endTs               End timestamp of trace set
      * @param tracesPaths         Paths of all traces
      * @param stateProvidersPaths Paths of all state providers
      * @param stateHistoryBuilder State history builder reference
-     * @param updatePeriodEvents  Update emission period in number of events
+     * @param packetSummary       Packet summary of trace set (progress
+     *                            is reported in bytes if not null)
+     * @param telemetry           Build telemetry to publish (may be
+     *                            null)
      * @param updatePeriodMs      Update emission period in milliseconds
+     * @param encoding            Encoding of published notifications
      */
     ProgressPublisher(const std::string& bindAddr,
                       common::timestamp_t beginTs, common::timestamp_t endTs,
                       const std::vector<boost::filesystem::path>& tracesPaths,
                       const std::vector<boost::filesystem::path>& stateProvidersPaths,
                       const StateHistoryBuilder* stateHistoryBuilder,
-                      std::size_t updatePeriodEvents,
-                      std::size_t updatePeriodMs);
+                      const common::TracePacketSummary* packetSummary,
+                      const BuildTelemetry* telemetry,
+                      std::size_t updatePeriodMs,
+                      common::RpcEncoding encoding);
 
     ~ProgressPublisher();
 
@@ -75,43 +95,66 @@ protected:
     bool onStartImpl(const common::TraceSet* traceSet);
     void onEventImpl(common::Event& event);
     bool onStopImpl();
-    void publish();
+    const char* getNameImpl() const;
+
+private:
+    void sample();
+    void publish(common::timestamp_t curTs);
+    void publishTelemetry(std::size_t evCount, double elapsed);
+    void send(std::unique_ptr<std::string> encoded);
+    void stopSampler();
 
 private:
     // bind address
     boost::filesystem::path _bindAddr;
 
-    // number of processed events so far
-    std::size_t _evCount;
+    // number of processed events so far (written by the playback thread)
+    std::atomic<std::size_t> _evCount;
 
-    // RPC message encoder
+    // last event timestamp (written by the playback thread)
+    std::atomic<common::timestamp_t> _curTs;
+
+    // encoding of published notifications
+    common::RpcEncoding _encoding;
+
+    // RPC message encoders
     std::unique_ptr<BuilderJsonRpcMessageEncoder> _rpcMessageEncoder;
+    std::unique_ptr<BuilderMsgPackRpcMessageEncoder> _msgPackEncoder;
 
     // RPC notification (progress update)
     std::unique_ptr<ProgressUpdateRpcNotification> _rpcNotification;
 
+    // RPC notification (telemetry update)
+    std::unique_ptr<TelemetryUpdateRpcNotification> _telemetryNotification;
+
     // state history builder reference
     const StateHistoryBuilder* _stateHistoryBuilder;
 
-    // update period in number of events
-    std::size_t _updatePeriodEvents;
+    // packet summary reference (may be null)
+    const common::TracePacketSummary* _packetSummary;
+
+    // build telemetry reference (may be null)
+    const BuildTelemetry* _telemetry;
 
     // update period in milliseconds
     std::size_t _updatePeriodMs;
 
-    // temporary event counter
-    std::size_t _tmpEvCounter;
-
-    // last event timestamp (set before publishing)
-    common::timestamp_t _lastTs;
+    // counters and time of the previous sample (for rates)
+    std::size_t _lastEvCount;
+    std::size_t _lastStateChanges;
+    std::uint64_t _lastIntervals;
+    std::chrono::steady_clock::time_point _lastTime;
 
-    // last system time
-    boost::posix_time::ptime _lastTime;
+    // sampler thread and its stop request
+    std::thread _sampler;
+    bool _stopped;
+    std::mutex _mutex;
+    std::condition_variable _cond;
 
     // message queue context
     std::unique_ptr<common::MqContext> _mqContext;
 
-    // message queue socket
+    // message queue socket (only used by the sampler thread)
     std::unique_ptr<common::PublishMqSocket> _mqSocket;
 };
 
@@ -18,6 +18,7 @@
 #include <iostream>
 #include <memory>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <common/trace/EventValueType.hpp>
 #include <common/trace/AbstractEventValue.hpp>
@@ -33,10 +34,24 @@ namespace bfs = boost::filesystem;
 namespace tibee
 {
 
+namespace
+{
+
+// number of live snapshots published during a build
+const common::timestamp_t SNAPSHOTS_COUNT = 100;
+
+}
+
 StateHistoryBuilder::StateHistoryBuilder(const bfs::path& dir,
-                                         const std::vector<bfs::path>& providersPaths) :
+                                         const std::vector<bfs::path>& providersPaths,
+                                         bool profileProviders,
+                                         bool liveSnapshots) :
     AbstractCacheBuilder {dir},
-    _providersPaths {providersPaths}
+    _providersPaths {providersPaths},
+    _profileProviders {profileProviders},
+    _liveSnapshots {liveSnapshots},
+    _windowEnd {0},
+    _stateChanges {0}
 {
     std::cout << "state history builder: opening files for writing" << std::endl;
 
@@ -58,6 +73,8 @@ StateHistoryBuilder::StateHistoryBuilder(const bfs::path& dir,
             throw ex::UnknownStateProviderType {providerPath};
         }
 
+        stateProvider->setProfiling(profileProviders);
+
         _providers.push_back(std::move(stateProvider));
     }
 }
@@ -79,6 +96,27 @@ bool StateHistoryBuilder::onStartImpl(const common::TraceSet* traceSet)
             this->getCacheDir() / "history"
         }
     };
+    _stateChanges.store(0, std::memory_order_relaxed);
+    _windowEnd = 0;
+
+    // summarize states for zoomed out views
+    _stateHistorySink->enableSummaries(this->getCacheDir() / "state-summary.db",
+                                       traceSet->getBegin(),
+                                       traceSet->getEnd());
+
+    // publish snapshots so that the history may be queried while being built
+    auto logPath = this->getCacheDir() / "history.live";
+    auto snapshotPath = this->getCacheDir() / "state-snapshot.db";
+
+    if (_liveSnapshots) {
+        _stateHistorySink->enableSnapshots(logPath, snapshotPath,
+                                           traceSet->getBegin(),
+                                           (traceSet->getEnd() - traceSet->getBegin()) / SNAPSHOTS_COUNT);
+    } else {
+        // a stale snapshot would make tibeecore wait for this build
+        bfs::remove(logPath);
+        bfs::remove(snapshotPath);
+    }
 
     // also notify each state provider
     for (auto& provider : _providers) {
@@ -90,10 +128,36 @@ bool StateHistoryBuilder::onStartImpl(const common::TraceSet* traceSet)
 
 void StateHistoryBuilder::onEventImpl(common::Event& event)
 {
+    // state changes happen at the time of this event
+    _stateHistorySink->setCurrentTimestamp(event.getTimestamp());
+
     // also notify each state provider
     for (auto& provider : _providers) {
         provider->onEvent(_stateHistorySink->getCurrentState(), event);
     }
+
+    // plain store: this is the only writer
+    _stateChanges.store(_stateHistorySink->getStateChangesCount(),
+                        std::memory_order_relaxed);
+}
+
+void StateHistoryBuilder::onWindowImpl(common::timestamp_t begin,
+                                       common::timestamp_t end)
+{
+    /* Events between the previous window and this one are never read:
+     * states known at the end of the previous window end there, and
+     * providers start this window from an empty state.
+     */
+    if (_windowEnd != 0) {
+        _stateHistorySink->closeStates(_windowEnd);
+    }
+
+    _windowEnd = end;
+
+    // also notify each state provider
+    for (auto& provider : _providers) {
+        provider->onWindow(_stateHistorySink->getCurrentState(), begin, end);
+    }
 }
 
 bool StateHistoryBuilder::onStopImpl()
@@ -105,7 +169,37 @@ bool StateHistoryBuilder::onStopImpl()
         provider->onFini(_stateHistorySink->getCurrentState());
     }
 
+    _stateChanges.store(_stateHistorySink->getStateChangesCount(),
+                        std::memory_order_relaxed);
+
     return true;
 }
 
+const char* StateHistoryBuilder::getNameImpl() const
+{
+    return "state-history";
+}
+
+void StateHistoryBuilder::onTelemetryImpl(BuildTelemetry& telemetry)
+{
+    // each state change writes one interval
+    telemetry.setIntervals(_stateHistorySink->getStateChangesCount());
+    telemetry.setQuarks(_stateHistorySink->getPathsQuarksCount(),
+                        _stateHistorySink->getValuesQuarksCount());
+    telemetry.setLiveStates(_stateHistorySink->getStateValuesCount());
+
+    if (_profileProviders) {
+        std::vector<common::StateProviderProfile> profiles;
+
+        for (std::size_t x = 0; x < _providers.size(); ++x) {
+            profiles.push_back({
+                _providersPaths[x].filename().string(),
+                _providers[x]->getCallbacksProfiles()
+            });
+        }
+
+        telemetry.setProvidersProfiles(std::move(profiles));
+    }
+}
+
 }
@@ -18,6 +18,8 @@
 #ifndef _STATEHISTORYBUILDER_HPP
 #define _STATEHISTORYBUILDER_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include <memory>
 #include <boost/filesystem.hpp>
@@ -46,33 +48,48 @@ public:
     /**
      * Builds a state history builder.
      *
-     * @param dir            Cache directory
-     * @param providersPaths List of state providers paths
+     * @param dir              Cache directory
+     * @param providersPaths   List of state providers paths
+     * @param profileProviders True to profile state providers callbacks
+     * @param liveSnapshots    True to publish live snapshots of the history
      */
     StateHistoryBuilder(const boost::filesystem::path& dir,
-                        const std::vector<boost::filesystem::path>& providersPaths);
+                        const std::vector<boost::filesystem::path>& providersPaths,
+                        bool profileProviders, bool liveSnapshots);
 
     ~StateHistoryBuilder();
 
     /**
-     * Returns the number of state changes so far.
+     * Returns the number of state changes so far. May be called from
+     * any thread.
      *
      * @returns State changes so far
      */
-    unsigned int getStateChanges() const
+    std::size_t getStateChanges() const
     {
-        return 0;
+        return _stateChanges.load(std::memory_order_relaxed);
     }
 
 private:
     bool onStartImpl(const common::TraceSet* traceSet);
     void onEventImpl(common::Event& event);
     bool onStopImpl();
+    const char* getNameImpl() const;
+    void onTelemetryImpl(BuildTelemetry& telemetry);
+    void onWindowImpl(common::timestamp_t begin, common::timestamp_t end);
 
 private:
     std::vector<boost::filesystem::path> _providersPaths;
     std::vector<common::AbstractStateProvider::UP> _providers;
     std::unique_ptr<common::StateHistorySink> _stateHistorySink;
+    bool _profileProviders;
+    bool _liveSnapshots;
+
+    // end of the current sampling window (0 if none)
+    common::timestamp_t _windowEnd;
+
+    // state changes so far, published after each event for readers
+    std::atomic<std::size_t> _stateChanges;
 };
 
 }
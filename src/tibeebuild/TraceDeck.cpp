@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
 #include <memory>
 #include <string>
 #include <boost/filesystem/path.hpp>
@@ -28,9 +29,43 @@ namespace bfs = boost::filesystem;
 namespace tibee
 {
 
+namespace
+{
+
+// one event out of this many is timed when telemetry is enabled
+const std::size_t TELEMETRY_EVENTS_PERIOD = 64;
+
+// listeners update their telemetry gauges every this many timed events
+const std::size_t TELEMETRY_GAUGES_PERIOD = 64;
+
+std::uint64_t getExtrapolatedNs(std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    return static_cast<std::uint64_t>(ns) * TELEMETRY_EVENTS_PERIOD;
+}
+
+}
+
 TraceDeck::TraceDeck() :
-    _playing {false}
+    _playing {false},
+    _windowDuration {0},
+    _period {0},
+    _windowsCount {0},
+    _playedEventsCount {0},
+    _telemetry {nullptr},
+    _telemetryCountdown {0},
+    _timedEvents {0},
+    _timing {false}
+{
+}
+
+void TraceDeck::setSampling(common::timestamp_t windowDuration,
+                            common::timestamp_t period)
 {
+    _windowDuration = windowDuration;
+    _period = period;
 }
 
 bool TraceDeck::play(const common::TraceSet* traceSet,
@@ -38,21 +73,44 @@ bool TraceDeck::play(const common::TraceSet* traceSet,
 {
     // mark as playing
     _playing = true;
+    _playedEventsCount = 0;
+
+    // telemetry stages: decoding, then each listener
+    if (_telemetry) {
+        std::vector<std::string> stagesNames {"decode"};
+
+        for (auto& listener : listeners) {
+            stagesNames.push_back(listener->getName());
+        }
+
+        _telemetry->reset(stagesNames);
+        _telemetryCountdown = TELEMETRY_EVENTS_PERIOD;
+        _timedEvents = 0;
+        _timing = false;
+    }
 
     // start
     for (auto& listener : listeners) {
         listener->onStart(traceSet);
     }
 
-    // go through all events
-    for (auto& event : *traceSet) {
-        if (!_playing) {
-            return false;
-        }
+    // go through all (or sampled) events
+    bool complete;
 
-        // play this event to all listeners
+    if (this->isSampling()) {
+        complete = this->playWindows(traceSet, listeners);
+    } else {
+        complete = this->playAll(traceSet, listeners);
+    }
+
+    if (!complete) {
+        return false;
+    }
+
+    // final telemetry gauges
+    if (_telemetry) {
         for (auto& listener : listeners) {
-            listener->onEvent(event);
+            listener->onTelemetry(*_telemetry);
         }
     }
 
@@ -67,6 +125,120 @@ bool TraceDeck::play(const common::TraceSet* traceSet,
     return true;
 }
 
+bool TraceDeck::playAll(const common::TraceSet* traceSet,
+                        const std::vector<AbstractTracePlaybackListener::UP>& listeners)
+{
+    auto end = traceSet->end();
+
+    for (auto it = traceSet->begin(); it != end; this->advance(it, listeners)) {
+        if (!_playing) {
+            return false;
+        }
+
+        // play this event to all listeners
+        this->playEvent(*it, listeners);
+    }
+
+    return true;
+}
+
+bool TraceDeck::playWindows(const common::TraceSet* traceSet,
+                            const std::vector<AbstractTracePlaybackListener::UP>& listeners)
+{
+    auto begin = traceSet->getBegin();
+    auto end = traceSet->getEnd();
+
+    _windowsCount = 0;
+
+    for (auto windowBegin = begin; windowBegin <= end; windowBegin += _period) {
+        auto windowEnd = windowBegin + _windowDuration;
+
+        // tell listeners where we are
+        for (auto& listener : listeners) {
+            listener->onWindow(windowBegin, windowEnd);
+        }
+
+        _windowsCount++;
+
+        for (auto it = traceSet->seek(windowBegin); it != traceSet->end();
+                this->advance(it, listeners)) {
+            if (!_playing) {
+                return false;
+            }
+
+            auto& event = *it;
+
+            if (event.getTimestamp() >= windowEnd) {
+                break;
+            }
+
+            // play this event to all listeners
+            this->playEvent(event, listeners);
+        }
+
+        // avoid wrapping around
+        if (end - windowBegin < _period) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+void TraceDeck::playEvent(common::Event& event,
+                          const std::vector<AbstractTracePlaybackListener::UP>& listeners)
+{
+    _playedEventsCount++;
+
+    if (!_telemetry || --_telemetryCountdown != 0) {
+        for (auto& listener : listeners) {
+            listener->onEvent(event);
+        }
+
+        return;
+    }
+
+    // timed event (decoding of the next one is timed by advance())
+    _telemetryCountdown = TELEMETRY_EVENTS_PERIOD;
+    _timing = true;
+
+    std::size_t stage = 1;
+
+    for (auto& listener : listeners) {
+        auto start = std::chrono::steady_clock::now();
+
+        listener->onEvent(event);
+        _telemetry->addStageTime(stage, getExtrapolatedNs(start));
+        stage++;
+    }
+}
+
+void TraceDeck::advance(common::TraceSet::Iterator& it,
+                        const std::vector<AbstractTracePlaybackListener::UP>& listeners)
+{
+    if (!_timing) {
+        ++it;
+
+        return;
+    }
+
+    _timing = false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    ++it;
+    _telemetry->addStageTime(0, getExtrapolatedNs(start));
+
+    // gauges are more expensive to get than times
+    if (++_timedEvents % TELEMETRY_GAUGES_PERIOD == 0) {
+        _telemetry->setPoolsCapacity(it.getValuePoolsCapacity());
+
+        for (auto& listener : listeners) {
+            listener->onTelemetry(*_telemetry);
+        }
+    }
+}
+
 void TraceDeck::stop()
 {
     _playing = false;
@@ -18,13 +18,16 @@
 #ifndef _TRACEDECK_HPP
 #define _TRACEDECK_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <boost/filesystem/path.hpp>
 
+#include <common/BasicTypes.hpp>
 #include <common/trace/TraceSet.hpp>
 #include <common/trace/Event.hpp>
 #include "AbstractTracePlaybackListener.hpp"
+#include "BuildTelemetry.hpp"
 
 namespace tibee
 {
@@ -58,8 +61,100 @@ public:
      */
     void stop();
 
+    /**
+     * Enables time-stratified sampling for the next playbacks: only
+     * the events within the first \p windowDuration nanoseconds of
+     * each \p period nanoseconds of the trace set are played.
+     *
+     * Listeners are notified of each window with
+     * AbstractTracePlaybackListener::onWindow(). The trace set is
+     * seeked to the beginning of each window, so packets between
+     * windows are not read at all.
+     *
+     * Sampling is disabled if \p windowDuration is 0 or is not less
+     * than \p period.
+     *
+     * @param windowDuration Duration of a sampling window (ns)
+     * @param period         Time between two window beginnings (ns)
+     */
+    void setSampling(common::timestamp_t windowDuration,
+                     common::timestamp_t period);
+
+    /**
+     * Returns whether or not sampling is enabled.
+     *
+     * @returns True if sampling is enabled
+     */
+    bool isSampling() const
+    {
+        return _windowDuration != 0 && _windowDuration < _period;
+    }
+
+    /**
+     * Returns the number of windows played during the last sampled
+     * playback.
+     *
+     * @returns Number of played windows
+     */
+    std::size_t getWindowsCount() const
+    {
+        return _windowsCount;
+    }
+
+    /**
+     * Returns the number of events played during the last playback.
+     *
+     * @returns Number of played events
+     */
+    std::uint64_t getPlayedEventsCount() const
+    {
+        return _playedEventsCount;
+    }
+
+    /**
+     * Sets the build telemetry to update during the next playbacks
+     * (none if \p telemetry is null).
+     *
+     * Its stages are decoding followed by each listener. Only one
+     * event out of a fixed period is timed, and its times are
+     * extrapolated to the whole period, so that telemetry costs about
+     * nothing per event.
+     *
+     * @param telemetry Build telemetry (not owned) or \a nullptr
+     */
+    void setTelemetry(BuildTelemetry* telemetry)
+    {
+        _telemetry = telemetry;
+    }
+
+private:
+    bool playAll(const common::TraceSet* traceSet,
+                 const std::vector<AbstractTracePlaybackListener::UP>& listeners);
+    bool playWindows(const common::TraceSet* traceSet,
+                     const std::vector<AbstractTracePlaybackListener::UP>& listeners);
+    void playEvent(common::Event& event,
+                   const std::vector<AbstractTracePlaybackListener::UP>& listeners);
+    void advance(common::TraceSet::Iterator& it,
+                 const std::vector<AbstractTracePlaybackListener::UP>& listeners);
+
 private:
     bool _playing;
+    common::timestamp_t _windowDuration;
+    common::timestamp_t _period;
+    std::size_t _windowsCount;
+    std::uint64_t _playedEventsCount;
+
+    // build telemetry (may be null)
+    BuildTelemetry* _telemetry;
+
+    // events until the next timed one
+    std::size_t _telemetryCountdown;
+
+    // number of timed events so far
+    std::size_t _timedEvents;
+
+    // true if the current event is timed
+    bool _timing;
 };
 
 }
@@ -17,6 +17,7 @@
  */
 #include <iostream>
 #include <cstdio>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <boost/program_options.hpp>
@@ -51,8 +52,15 @@ int parseOptions(int argc, char* argv[], tibee::Arguments& args)
         ("verbose,v", bpo::bool_switch()->default_value(false))
         ("stateprov,s", bpo::value<std::vector<std::string>>())
         ("bind-progress,b", bpo::value<std::string>())
+        ("progress-msgpack", bpo::bool_switch()->default_value(false))
         ("cache-dir,d", bpo::value<std::string>())
         ("force,f", bpo::bool_switch()->default_value(false))
+        ("index,i", bpo::value<std::vector<std::string>>())
+        ("live,l", bpo::bool_switch()->default_value(false))
+        ("sample-window", bpo::value<std::uint64_t>())
+        ("sample-period", bpo::value<std::uint64_t>())
+        ("profile-providers", bpo::bool_switch()->default_value(false))
+        ("stats", bpo::value<std::string>())
     ;
 
     bpo::positional_options_description pos;
@@ -81,7 +89,14 @@ int parseOptions(int argc, char* argv[], tibee::Arguments& args)
             "  -b, --bind-progress  bind address for build progress (default: none)" << std::endl <<
             "  -d, --cache-dir      write caches to this directory (default: CWD)" << std::endl <<
             "  -f, --force          force cache building, even if already existing" << std::endl <<
+            "  -i <event>:<field>   index values of this event field (any number)" << std::endl <<
+            "  -l, --live           publish live snapshots for tibeecore during the build" << std::endl <<
+            "  --profile-providers  profile state providers callbacks" << std::endl <<
+            "  --progress-msgpack   publish progress as MessagePack instead of JSON" << std::endl <<
             "  -s <provider path>   state provider file path (at least one)" << std::endl <<
+            "  --sample-window <ns> only play this duration of each sample period" << std::endl <<
+            "  --sample-period <ns> sample period (with --sample-window)" << std::endl <<
+            "  --stats <path>       write build statistics (JSON) to this file" << std::endl <<
             "  -v, --verbose        verbose" << std::endl;
 
         return -1;
@@ -146,17 +161,76 @@ int parseOptions(int argc, char* argv[], tibee::Arguments& args)
         }
     }
 
+    // indexed fields
+    if (!vm["index"].empty()) {
+        auto indexes = vm["index"].as<std::vector<std::string>>();
+
+        for (const auto& index : indexes) {
+            // event names may contain colons, but field names may not
+            auto pos = index.rfind(':');
+
+            if (pos == std::string::npos || pos == 0 || pos == index.size() - 1) {
+                std::cerr << "Command line error: wrong indexed field \"" <<
+                             index << "\" (expecting <event>:<field>)" << std::endl;
+                return 1;
+            }
+
+            tibee::FieldIndexSpec spec;
+
+            spec.eventName = index.substr(0, pos);
+            spec.fieldName = index.substr(pos + 1);
+            args.indexedFields.push_back(spec);
+        }
+    }
+
+    // sampling
+    args.sampleWindow = 0;
+    args.samplePeriod = 0;
+
+    if (vm["sample-window"].empty() != vm["sample-period"].empty()) {
+        std::cerr << "Command line error: --sample-window and --sample-period go together" << std::endl;
+        return 1;
+    }
+
+    if (!vm["sample-window"].empty()) {
+        args.sampleWindow = vm["sample-window"].as<std::uint64_t>();
+        args.samplePeriod = vm["sample-period"].as<std::uint64_t>();
+
+        if (args.sampleWindow == 0 || args.sampleWindow >= args.samplePeriod) {
+            std::cerr << "Command line error: sample window must be within (0, sample period)" << std::endl;
+            return 1;
+        }
+    }
+
     // bind progress
     if (!vm["bind-progress"].empty()) {
         args.bindProgress = vm["bind-progress"].as<std::string>();
     }
 
+    // progress encoding
+    if (vm["progress-msgpack"].as<bool>()) {
+        args.progressEncoding = tibee::common::RpcEncoding::MSGPACK;
+    } else {
+        args.progressEncoding = tibee::common::RpcEncoding::JSON;
+    }
+
     // verbose
     args.verbose = vm["verbose"].as<bool>();
 
     // force
     args.force = vm["force"].as<bool>();
 
+    // live snapshots
+    args.liveSnapshots = vm["live"].as<bool>();
+
+    // profile state providers
+    args.profileProviders = vm["profile-providers"].as<bool>();
+
+    // build statistics
+    if (!vm["stats"].empty()) {
+        args.statsPath = vm["stats"].as<std::string>();
+    }
+
     return 0;
 }
 
@@ -31,6 +31,13 @@ BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotification(const Progress
                                     BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams);
 }
 
+std::unique_ptr<std::string>
+BuilderJsonRpcMessageEncoder::encodeTelemetryUpdateRpcNotification(const TelemetryUpdateRpcNotification& object)
+{
+    return this->encodeNotification(object,
+                                    BuilderJsonRpcMessageEncoder::encodeTelemetryUpdateRpcNotificationParams);
+}
+
 bool BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
                                                                              ::yajl_gen yajlGen)
 {
@@ -42,6 +49,11 @@ bool BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams(con
     TIBEE_DEF_YAJL_STR(TRACES_END_TS, "traces-end-ts");
     TIBEE_DEF_YAJL_STR(TRACES_CUR_TS, "traces-cur-ts");
     TIBEE_DEF_YAJL_STR(STATE_CHANGES, "state-changes");
+    TIBEE_DEF_YAJL_STR(TRACES_TOTAL_BYTES, "traces-total-bytes");
+    TIBEE_DEF_YAJL_STR(TRACES_CUR_BYTES, "traces-cur-bytes");
+    TIBEE_DEF_YAJL_STR(ESTIMATED_EVENTS, "estimated-events");
+    TIBEE_DEF_YAJL_STR(EVENTS_RATE, "events-rate");
+    TIBEE_DEF_YAJL_STR(STATE_CHANGES_RATE, "state-changes-rate");
     TIBEE_DEF_YAJL_STR(TRACES_PATHS, "traces-paths");
     TIBEE_DEF_YAJL_STR(STATE_PROVIDERS_PATHS, "state-providers-paths");
 
@@ -68,6 +80,26 @@ bool BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams(con
     ::yajl_gen_string(yajlGen, STATE_CHANGES, STATE_CHANGES_LEN);
     ::yajl_gen_integer(yajlGen, pu.getStateChanges());
 
+    // traces total bytes
+    ::yajl_gen_string(yajlGen, TRACES_TOTAL_BYTES, TRACES_TOTAL_BYTES_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(pu.getTotalBytes()));
+
+    // traces current bytes
+    ::yajl_gen_string(yajlGen, TRACES_CUR_BYTES, TRACES_CUR_BYTES_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(pu.getCurBytes()));
+
+    // estimated events
+    ::yajl_gen_string(yajlGen, ESTIMATED_EVENTS, ESTIMATED_EVENTS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(pu.getEstimatedEvents()));
+
+    // events rate
+    ::yajl_gen_string(yajlGen, EVENTS_RATE, EVENTS_RATE_LEN);
+    ::yajl_gen_double(yajlGen, pu.getEventsRate());
+
+    // state changes rate
+    ::yajl_gen_string(yajlGen, STATE_CHANGES_RATE, STATE_CHANGES_RATE_LEN);
+    ::yajl_gen_double(yajlGen, pu.getStateChangesRate());
+
     // traces paths
     ::yajl_gen_string(yajlGen, TRACES_PATHS, TRACES_PATHS_LEN);
     ::yajl_gen_array_open(yajlGen);
@@ -105,4 +137,124 @@ bool BuilderJsonRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams(con
     return true;
 }
 
+bool BuilderJsonRpcMessageEncoder::encodeTelemetryUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                                              ::yajl_gen yajlGen)
+{
+    const auto& tu = static_cast<const TelemetryUpdateRpcNotification&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(PROCESSED_EVENTS, "processed-events");
+    TIBEE_DEF_YAJL_STR(EVENTS_RATE, "events-rate");
+    TIBEE_DEF_YAJL_STR(INTERVALS, "intervals");
+    TIBEE_DEF_YAJL_STR(INTERVALS_RATE, "intervals-rate");
+    TIBEE_DEF_YAJL_STR(PATHS_QUARKS, "paths-quarks");
+    TIBEE_DEF_YAJL_STR(VALUES_QUARKS, "values-quarks");
+    TIBEE_DEF_YAJL_STR(LIVE_STATES, "live-states");
+    TIBEE_DEF_YAJL_STR(POOLS_CAPACITY, "pools-capacity");
+    TIBEE_DEF_YAJL_STR(CPU_TIME, "cpu-time");
+    TIBEE_DEF_YAJL_STR(RSS, "rss");
+    TIBEE_DEF_YAJL_STR(STAGES, "stages");
+    TIBEE_DEF_YAJL_STR(NAME, "name");
+    TIBEE_DEF_YAJL_STR(TIME, "time");
+    TIBEE_DEF_YAJL_STR(PROVIDERS, "providers");
+    TIBEE_DEF_YAJL_STR(CALLBACKS, "callbacks");
+    TIBEE_DEF_YAJL_STR(TRACE_TYPE, "trace-type");
+    TIBEE_DEF_YAJL_STR(EVENT_NAME, "event-name");
+    TIBEE_DEF_YAJL_STR(CALLS, "calls");
+    TIBEE_DEF_YAJL_STR(TOTAL_TIME, "total-time");
+    TIBEE_DEF_YAJL_STR(MAX_TIME, "max-time");
+    TIBEE_DEF_YAJL_STR(STATE_CHANGES, "state-changes");
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // throughput
+    ::yajl_gen_string(yajlGen, PROCESSED_EVENTS, PROCESSED_EVENTS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getProcessedEvents()));
+    ::yajl_gen_string(yajlGen, EVENTS_RATE, EVENTS_RATE_LEN);
+    ::yajl_gen_double(yajlGen, tu.getEventsRate());
+    ::yajl_gen_string(yajlGen, INTERVALS, INTERVALS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getIntervals()));
+    ::yajl_gen_string(yajlGen, INTERVALS_RATE, INTERVALS_RATE_LEN);
+    ::yajl_gen_double(yajlGen, tu.getIntervalsRate());
+
+    // state history
+    ::yajl_gen_string(yajlGen, PATHS_QUARKS, PATHS_QUARKS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getPathsQuarks()));
+    ::yajl_gen_string(yajlGen, VALUES_QUARKS, VALUES_QUARKS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getValuesQuarks()));
+    ::yajl_gen_string(yajlGen, LIVE_STATES, LIVE_STATES_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getLiveStates()));
+
+    // memory and CPU
+    ::yajl_gen_string(yajlGen, POOLS_CAPACITY, POOLS_CAPACITY_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getPoolsCapacity()));
+    ::yajl_gen_string(yajlGen, CPU_TIME, CPU_TIME_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getCpuTime()));
+    ::yajl_gen_string(yajlGen, RSS, RSS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(tu.getRss()));
+
+    // playback stages
+    ::yajl_gen_string(yajlGen, STAGES, STAGES_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (const auto& stage : tu.getStages()) {
+        ::yajl_gen_map_open(yajlGen);
+        ::yajl_gen_string(yajlGen, NAME, NAME_LEN);
+        ::yajl_gen_string(yajlGen,
+                          reinterpret_cast<const unsigned char*>(stage.name.c_str()),
+                          stage.name.size());
+        ::yajl_gen_string(yajlGen, TIME, TIME_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(stage.time));
+        ::yajl_gen_map_close(yajlGen);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // state providers profiles
+    ::yajl_gen_string(yajlGen, PROVIDERS, PROVIDERS_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (const auto& provider : tu.getProvidersProfiles()) {
+        ::yajl_gen_map_open(yajlGen);
+        ::yajl_gen_string(yajlGen, NAME, NAME_LEN);
+        ::yajl_gen_string(yajlGen,
+                          reinterpret_cast<const unsigned char*>(provider.name.c_str()),
+                          provider.name.size());
+        ::yajl_gen_string(yajlGen, CALLBACKS, CALLBACKS_LEN);
+        ::yajl_gen_array_open(yajlGen);
+
+        for (const auto& callback : provider.callbacks) {
+            ::yajl_gen_map_open(yajlGen);
+            ::yajl_gen_string(yajlGen, TRACE_TYPE, TRACE_TYPE_LEN);
+            ::yajl_gen_string(yajlGen,
+                              reinterpret_cast<const unsigned char*>(callback.traceType.c_str()),
+                              callback.traceType.size());
+            ::yajl_gen_string(yajlGen, EVENT_NAME, EVENT_NAME_LEN);
+            ::yajl_gen_string(yajlGen,
+                              reinterpret_cast<const unsigned char*>(callback.eventName.c_str()),
+                              callback.eventName.size());
+            ::yajl_gen_string(yajlGen, CALLS, CALLS_LEN);
+            ::yajl_gen_integer(yajlGen, static_cast<long long int>(callback.calls));
+            ::yajl_gen_string(yajlGen, TOTAL_TIME, TOTAL_TIME_LEN);
+            ::yajl_gen_integer(yajlGen, static_cast<long long int>(callback.totalTime));
+            ::yajl_gen_string(yajlGen, MAX_TIME, MAX_TIME_LEN);
+            ::yajl_gen_integer(yajlGen, static_cast<long long int>(callback.maxTime));
+            ::yajl_gen_string(yajlGen, STATE_CHANGES, STATE_CHANGES_LEN);
+            ::yajl_gen_integer(yajlGen, static_cast<long long int>(callback.stateChanges));
+            ::yajl_gen_map_close(yajlGen);
+        }
+
+        ::yajl_gen_array_close(yajlGen);
+        ::yajl_gen_map_close(yajlGen);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
 }
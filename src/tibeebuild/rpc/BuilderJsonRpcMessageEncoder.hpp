@@ -23,6 +23,7 @@
 #include <common/rpc/AbstractJsonRpcMessageEncoder.hpp>
 
 #include "ProgressUpdateRpcNotification.hpp"
+#include "TelemetryUpdateRpcNotification.hpp"
 
 namespace tibee
 {
@@ -48,8 +49,16 @@ public:
      */
     std::unique_ptr<std::string> encodeProgressUpdateRpcNotification(const ProgressUpdateRpcNotification& object);
 
+    /**
+     * Encodes a TelemetryUpdateRpcNotification object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeTelemetryUpdateRpcNotification(const TelemetryUpdateRpcNotification& object);
+
 protected:
     static bool encodeProgressUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeTelemetryUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg, ::yajl_gen);
 };
 
 }
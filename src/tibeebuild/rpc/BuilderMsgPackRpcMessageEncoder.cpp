@@ -0,0 +1,175 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BuilderMsgPackRpcMessageEncoder.hpp"
+
+namespace tibee
+{
+
+BuilderMsgPackRpcMessageEncoder::BuilderMsgPackRpcMessageEncoder()
+{
+}
+
+std::unique_ptr<std::string>
+BuilderMsgPackRpcMessageEncoder::encodeProgressUpdateRpcNotification(const ProgressUpdateRpcNotification& object)
+{
+    return this->encodeNotification(object,
+                                    BuilderMsgPackRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams);
+}
+
+std::unique_ptr<std::string>
+BuilderMsgPackRpcMessageEncoder::encodeTelemetryUpdateRpcNotification(const TelemetryUpdateRpcNotification& object)
+{
+    return this->encodeNotification(object,
+                                    BuilderMsgPackRpcMessageEncoder::encodeTelemetryUpdateRpcNotificationParams);
+}
+
+bool BuilderMsgPackRpcMessageEncoder::encodeProgressUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                                                common::MsgPackWriter& writer)
+{
+    const auto& pu = static_cast<const ProgressUpdateRpcNotification&>(msg);
+
+    writer.writeMapHeader(12);
+
+    // counters and timestamps
+    writer.writeString("processed-events", 16);
+    writer.writeUint(pu.getProcessedEvents());
+    writer.writeString("traces-begin-ts", 15);
+    writer.writeUint(pu.getBeginTs());
+    writer.writeString("traces-end-ts", 13);
+    writer.writeUint(pu.getEndTs());
+    writer.writeString("traces-cur-ts", 13);
+    writer.writeUint(pu.getCurTs());
+    writer.writeString("state-changes", 13);
+    writer.writeUint(pu.getStateChanges());
+    writer.writeString("traces-total-bytes", 18);
+    writer.writeUint(pu.getTotalBytes());
+    writer.writeString("traces-cur-bytes", 16);
+    writer.writeUint(pu.getCurBytes());
+    writer.writeString("estimated-events", 16);
+    writer.writeUint(pu.getEstimatedEvents());
+
+    // rates
+    writer.writeString("events-rate", 11);
+    writer.writeDouble(pu.getEventsRate());
+    writer.writeString("state-changes-rate", 18);
+    writer.writeDouble(pu.getStateChangesRate());
+
+    // traces paths
+    const auto& tracesPaths = pu.getTracesPaths();
+
+    writer.writeString("traces-paths", 12);
+    writer.writeArrayHeader(tracesPaths.size());
+
+    for (const auto& path : tracesPaths) {
+        writer.writeString(path.string());
+    }
+
+    // state providers paths
+    const auto& stateProvidersPaths = pu.getStateProvidersPaths();
+
+    writer.writeString("state-providers-paths", 21);
+    writer.writeArrayHeader(stateProvidersPaths.size());
+
+    for (const auto& path : stateProvidersPaths) {
+        writer.writeString(path.string());
+    }
+
+    return true;
+}
+
+bool BuilderMsgPackRpcMessageEncoder::encodeTelemetryUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                                                 common::MsgPackWriter& writer)
+{
+    const auto& tu = static_cast<const TelemetryUpdateRpcNotification&>(msg);
+
+    writer.writeMapHeader(12);
+
+    // throughput
+    writer.writeString("processed-events", 16);
+    writer.writeUint(tu.getProcessedEvents());
+    writer.writeString("events-rate", 11);
+    writer.writeDouble(tu.getEventsRate());
+    writer.writeString("intervals", 9);
+    writer.writeUint(tu.getIntervals());
+    writer.writeString("intervals-rate", 14);
+    writer.writeDouble(tu.getIntervalsRate());
+
+    // state history
+    writer.writeString("paths-quarks", 12);
+    writer.writeUint(tu.getPathsQuarks());
+    writer.writeString("values-quarks", 13);
+    writer.writeUint(tu.getValuesQuarks());
+    writer.writeString("live-states", 11);
+    writer.writeUint(tu.getLiveStates());
+
+    // memory and CPU
+    writer.writeString("pools-capacity", 14);
+    writer.writeUint(tu.getPoolsCapacity());
+    writer.writeString("cpu-time", 8);
+    writer.writeUint(tu.getCpuTime());
+    writer.writeString("rss", 3);
+    writer.writeUint(tu.getRss());
+
+    // playback stages
+    const auto& stages = tu.getStages();
+
+    writer.writeString("stages", 6);
+    writer.writeArrayHeader(stages.size());
+
+    for (const auto& stage : stages) {
+        writer.writeMapHeader(2);
+        writer.writeString("name", 4);
+        writer.writeString(stage.name);
+        writer.writeString("time", 4);
+        writer.writeUint(stage.time);
+    }
+
+    // state providers profiles
+    const auto& providers = tu.getProvidersProfiles();
+
+    writer.writeString("providers", 9);
+    writer.writeArrayHeader(providers.size());
+
+    for (const auto& provider : providers) {
+        writer.writeMapHeader(2);
+        writer.writeString("name", 4);
+        writer.writeString(provider.name);
+        writer.writeString("callbacks", 9);
+        writer.writeArrayHeader(provider.callbacks.size());
+
+        for (const auto& callback : provider.callbacks) {
+            writer.writeMapHeader(6);
+            writer.writeString("trace-type", 10);
+            writer.writeString(callback.traceType);
+            writer.writeString("event-name", 10);
+            writer.writeString(callback.eventName);
+            writer.writeString("calls", 5);
+            writer.writeUint(callback.calls);
+            writer.writeString("total-time", 10);
+            writer.writeUint(callback.totalTime);
+            writer.writeString("max-time", 8);
+            writer.writeUint(callback.maxTime);
+            writer.writeString("state-changes", 13);
+            writer.writeUint(callback.stateChanges);
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,72 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BUILDERMSGPACKRPCMESSAGEENCODER_HPP
+#define _BUILDERMSGPACKRPCMESSAGEENCODER_HPP
+
+#include <memory>
+#include <string>
+#include <common/rpc/AbstractMsgPackRpcMessageEncoder.hpp>
+#include <common/rpc/MsgPackWriter.hpp>
+
+#include "ProgressUpdateRpcNotification.hpp"
+#include "TelemetryUpdateRpcNotification.hpp"
+
+namespace tibee
+{
+
+/**
+ * MessagePack RPC message encoder for builder messages.
+ *
+ * Messages have the same members as those of
+ * BuilderJsonRpcMessageEncoder.
+ *
+ * @author Philippe Proulx
+ */
+class BuilderMsgPackRpcMessageEncoder :
+    public common::AbstractMsgPackRpcMessageEncoder
+{
+public:
+    /**
+     * Builds a MessagePack encoder for builder messages.
+     */
+    BuilderMsgPackRpcMessageEncoder();
+
+    /**
+     * Encodes a ProgressUpdateRpcNotification object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeProgressUpdateRpcNotification(const ProgressUpdateRpcNotification& object);
+
+    /**
+     * Encodes a TelemetryUpdateRpcNotification object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeTelemetryUpdateRpcNotification(const TelemetryUpdateRpcNotification& object);
+
+protected:
+    static bool encodeProgressUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                          common::MsgPackWriter& writer);
+    static bool encodeTelemetryUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                           common::MsgPackWriter& writer);
+};
+
+}
+
+#endif // _BUILDERMSGPACKRPCMESSAGEENCODER_HPP
@@ -26,7 +26,12 @@ ProgressUpdateRpcNotification::ProgressUpdateRpcNotification() :
     _beginTs {0},
     _endTs {0},
     _curTs {0},
-    _stateChanges {0}
+    _stateChanges {0},
+    _totalBytes {0},
+    _curBytes {0},
+    _estimatedEvents {0},
+    _eventsRate {0},
+    _stateChangesRate {0}
 {
 }
 
@@ -19,6 +19,7 @@
 #define _PROGRESSUPDATERPCNOTIFICATION_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <boost/filesystem/path.hpp>
 
 #include <common/BasicTypes.hpp>
@@ -147,6 +148,109 @@ public:
         return _stateChanges;
     }
 
+    /**
+     * Sets the total size of traces event data (bytes).
+     *
+     * @param totalBytes Total size of traces event data (bytes)
+     */
+    void setTotalBytes(std::uint64_t totalBytes)
+    {
+        _totalBytes = totalBytes;
+    }
+
+    /**
+     * Returns the total size of traces event data (bytes).
+     *
+     * @returns Total size of traces event data (bytes)
+     */
+    std::uint64_t getTotalBytes() const
+    {
+        return _totalBytes;
+    }
+
+    /**
+     * Sets the estimated size of processed event data so far (bytes).
+     *
+     * @param curBytes Estimated size of processed event data so far (bytes)
+     */
+    void setCurBytes(std::uint64_t curBytes)
+    {
+        _curBytes = curBytes;
+    }
+
+    /**
+     * Returns the estimated size of processed event data so far (bytes).
+     *
+     * @returns Estimated size of processed event data so far (bytes)
+     */
+    std::uint64_t getCurBytes() const
+    {
+        return _curBytes;
+    }
+
+    /**
+     * Sets the estimated total number of events.
+     *
+     * @param estimatedEvents Estimated total number of events
+     */
+    void setEstimatedEvents(std::uint64_t estimatedEvents)
+    {
+        _estimatedEvents = estimatedEvents;
+    }
+
+    /**
+     * Returns the estimated total number of events.
+     *
+     * @returns Estimated total number of events
+     */
+    std::uint64_t getEstimatedEvents() const
+    {
+        return _estimatedEvents;
+    }
+
+    /**
+     * Sets the event processing rate measured over the last update
+     * period.
+     *
+     * @param eventsRate Event processing rate (events/s)
+     */
+    void setEventsRate(double eventsRate)
+    {
+        _eventsRate = eventsRate;
+    }
+
+    /**
+     * Returns the event processing rate measured over the last update
+     * period.
+     *
+     * @returns Event processing rate (events/s)
+     */
+    double getEventsRate() const
+    {
+        return _eventsRate;
+    }
+
+    /**
+     * Sets the state change rate measured over the last update period.
+     *
+     * @param stateChangesRate State change rate (state changes/s)
+     */
+    void setStateChangesRate(double stateChangesRate)
+    {
+        _stateChangesRate = stateChangesRate;
+    }
+
+    /**
+     * Returns the state change rate measured over the last update
+     * period.
+     *
+     * @returns State change rate (state changes/s)
+     */
+    double getStateChangesRate() const
+    {
+        return _stateChangesRate;
+    }
+
     /**
      * Sets the traces paths used to build the caches.
      *
@@ -193,6 +297,11 @@ private:
     common::timestamp_t _endTs;
     common::timestamp_t _curTs;
     unsigned int _stateChanges;
+    std::uint64_t _totalBytes;
+    std::uint64_t _curBytes;
+    std::uint64_t _estimatedEvents;
+    double _eventsRate;
+    double _stateChangesRate;
     std::vector<boost::filesystem::path> _tracesPaths;
     std::vector<boost::filesystem::path> _stateProvidersPaths;
 };
@@ -0,0 +1,38 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TelemetryUpdateRpcNotification.hpp"
+
+namespace tibee
+{
+
+TelemetryUpdateRpcNotification::TelemetryUpdateRpcNotification() :
+    AbstractRpcNotification {"telemetry-update"},
+    _processedEvents {0},
+    _eventsRate {0},
+    _intervals {0},
+    _intervalsRate {0},
+    _pathsQuarks {0},
+    _valuesQuarks {0},
+    _liveStates {0},
+    _poolsCapacity {0},
+    _cpuTime {0},
+    _rss {0}
+{
+}
+
+}
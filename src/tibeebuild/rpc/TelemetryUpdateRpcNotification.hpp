@@ -0,0 +1,319 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TELEMETRYUPDATERPCNOTIFICATION_HPP
+#define _TELEMETRYUPDATERPCNOTIFICATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <common/rpc/AbstractRpcNotification.hpp>
+#include <common/stateprov/StateProviderProfile.hpp>
+
+namespace tibee
+{
+
+/**
+ * Telemetry update RPC notification.
+ *
+ * This message is sent periodically, alongside progress updates, to
+ * show where a cache construction spends its time and memory.
+ *
+ * @author Philippe Proulx
+ */
+class TelemetryUpdateRpcNotification :
+    public common::AbstractRpcNotification
+{
+public:
+    /// Playback stage time
+    struct Stage
+    {
+        /// Stage name
+        std::string name;
+
+        /// Estimated time spent in this stage so far (ns)
+        std::uint64_t time;
+    };
+
+public:
+    /**
+     * Builds a telemetry update RPC notification.
+     */
+    TelemetryUpdateRpcNotification();
+
+    /**
+     * Sets the number of processed events so far.
+     *
+     * @param processedEvents Number of processed events so far
+     */
+    void setProcessedEvents(std::uint64_t processedEvents)
+    {
+        _processedEvents = processedEvents;
+    }
+
+    /**
+     * Returns the number of processed events so far.
+     *
+     * @returns Number of processed events so far
+     */
+    std::uint64_t getProcessedEvents() const
+    {
+        return _processedEvents;
+    }
+
+    /**
+     * Sets the event processing rate.
+     *
+     * @param eventsRate Event processing rate (events/s)
+     */
+    void setEventsRate(double eventsRate)
+    {
+        _eventsRate = eventsRate;
+    }
+
+    /**
+     * Returns the event processing rate.
+     *
+     * @returns Event processing rate (events/s)
+     */
+    double getEventsRate() const
+    {
+        return _eventsRate;
+    }
+
+    /**
+     * Sets the number of state intervals written so far.
+     *
+     * @param intervals Number of intervals
+     */
+    void setIntervals(std::uint64_t intervals)
+    {
+        _intervals = intervals;
+    }
+
+    /**
+     * Returns the number of state intervals written so far.
+     *
+     * @returns Number of intervals
+     */
+    std::uint64_t getIntervals() const
+    {
+        return _intervals;
+    }
+
+    /**
+     * Sets the interval writing rate.
+     *
+     * @param intervalsRate Interval writing rate (intervals/s)
+     */
+    void setIntervalsRate(double intervalsRate)
+    {
+        _intervalsRate = intervalsRate;
+    }
+
+    /**
+     * Returns the interval writing rate.
+     *
+     * @returns Interval writing rate (intervals/s)
+     */
+    double getIntervalsRate() const
+    {
+        return _intervalsRate;
+    }
+
+    /**
+     * Sets the number of path quarks.
+     *
+     * @param pathsQuarks Number of path quarks
+     */
+    void setPathsQuarks(std::uint64_t pathsQuarks)
+    {
+        _pathsQuarks = pathsQuarks;
+    }
+
+    /**
+     * Returns the number of path quarks.
+     *
+     * @returns Number of path quarks
+     */
+    std::uint64_t getPathsQuarks() const
+    {
+        return _pathsQuarks;
+    }
+
+    /**
+     * Sets the number of string value quarks.
+     *
+     * @param valuesQuarks Number of string value quarks
+     */
+    void setValuesQuarks(std::uint64_t valuesQuarks)
+    {
+        _valuesQuarks = valuesQuarks;
+    }
+
+    /**
+     * Returns the number of string value quarks.
+     *
+     * @returns Number of string value quarks
+     */
+    std::uint64_t getValuesQuarks() const
+    {
+        return _valuesQuarks;
+    }
+
+    /**
+     * Sets the number of live (not yet closed) state entries.
+     *
+     * @param liveStates Number of live state entries
+     */
+    void setLiveStates(std::uint64_t liveStates)
+    {
+        _liveStates = liveStates;
+    }
+
+    /**
+     * Returns the number of live (not yet closed) state entries.
+     *
+     * @returns Number of live state entries
+     */
+    std::uint64_t getLiveStates() const
+    {
+        return _liveStates;
+    }
+
+    /**
+     * Sets the high-water mark of the event value pools.
+     *
+     * @param poolsCapacity Total capacity of event value pools (objects)
+     */
+    void setPoolsCapacity(std::uint64_t poolsCapacity)
+    {
+        _poolsCapacity = poolsCapacity;
+    }
+
+    /**
+     * Returns the high-water mark of the event value pools.
+     *
+     * @returns Total capacity of event value pools (objects)
+     */
+    std::uint64_t getPoolsCapacity() const
+    {
+        return _poolsCapacity;
+    }
+
+    /**
+     * Sets the CPU time (user and system) of the process so far.
+     *
+     * @param cpuTime CPU time (ns)
+     */
+    void setCpuTime(std::uint64_t cpuTime)
+    {
+        _cpuTime = cpuTime;
+    }
+
+    /**
+     * Returns the CPU time (user and system) of the process so far.
+     *
+     * @returns CPU time (ns)
+     */
+    std::uint64_t getCpuTime() const
+    {
+        return _cpuTime;
+    }
+
+    /**
+     * Sets the resident set size of the process.
+     *
+     * @param rss Resident set size (bytes)
+     */
+    void setRss(std::uint64_t rss)
+    {
+        _rss = rss;
+    }
+
+    /**
+     * Returns the resident set size of the process.
+     *
+     * @returns Resident set size (bytes)
+     */
+    std::uint64_t getRss() const
+    {
+        return _rss;
+    }
+
+    /**
+     * Returns the playback stages times, in playback order.
+     *
+     * @returns Stages times
+     */
+    std::vector<Stage>& getStages()
+    {
+        return _stages;
+    }
+
+    /**
+     * Returns the playback stages times, in playback order.
+     *
+     * @returns Stages times
+     */
+    const std::vector<Stage>& getStages() const
+    {
+        return _stages;
+    }
+
+    /**
+     * Returns the state providers profiles (empty if state providers
+     * are not profiled).
+     *
+     * @returns State providers profiles
+     */
+    std::vector<common::StateProviderProfile>& getProvidersProfiles()
+    {
+        return _providersProfiles;
+    }
+
+    /**
+     * Returns the state providers profiles (empty if state providers
+     * are not profiled).
+     *
+     * @returns State providers profiles
+     */
+    const std::vector<common::StateProviderProfile>& getProvidersProfiles() const
+    {
+        return _providersProfiles;
+    }
+
+private:
+    std::uint64_t _processedEvents;
+    double _eventsRate;
+    std::uint64_t _intervals;
+    double _intervalsRate;
+    std::uint64_t _pathsQuarks;
+    std::uint64_t _valuesQuarks;
+    std::uint64_t _liveStates;
+    std::uint64_t _poolsCapacity;
+    std::uint64_t _cpuTime;
+    std::uint64_t _rss;
+    std::vector<Stage> _stages;
+    std::vector<common::StateProviderProfile> _providersProfiles;
+};
+
+}
+
+#endif // _TELEMETRYUPDATERPCNOTIFICATION_HPP
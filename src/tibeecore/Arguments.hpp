@@ -0,0 +1,49 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _ARGUMENTS_HPP
+#define _ARGUMENTS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+namespace tibee
+{
+
+/**
+ * Program arguments.
+ *
+ * @author Philippe Proulx
+ */
+struct Arguments
+{
+    boost::filesystem::path cacheDir;
+    std::vector<boost::filesystem::path> traces;
+    std::string bindAddr;
+    std::string streamBindAddr;
+    std::string notifyBindAddr;
+    std::size_t workers;
+    std::size_t resultCacheSize;
+    std::size_t shmBulkSize;
+    bool verbose;
+};
+
+}
+
+#endif // _ARGUMENTS_HPP
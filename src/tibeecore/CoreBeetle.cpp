@@ -0,0 +1,343 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <pthread.h>
+#include <thread>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <common/mq/MqContext.hpp>
+#include <common/mq/AbstractMqSocket.hpp>
+#include <common/mq/ShmBulkWriter.hpp>
+#include <common/state/StateHistorySource.hpp>
+#include <common/ex/StateHistorySource.hpp>
+#include <common/state/StateSnapshotSource.hpp>
+#include <common/ex/StateSnapshotSource.hpp>
+#include <common/state/StateSummarySource.hpp>
+#include <common/ex/StateSummarySource.hpp>
+#include <common/trace/TraceSet.hpp>
+#include "CoreBroker.hpp"
+#include "CoreMetrics.hpp"
+#include "EventStreamer.hpp"
+#include "PrefetchQueue.hpp"
+#include "ResultCache.hpp"
+#include "QueryWorker.hpp"
+#include "SnapshotWatcher.hpp"
+#include "Arguments.hpp"
+#include "CoreBeetle.hpp"
+
+namespace tibee
+{
+
+namespace
+{
+
+// broker backend address (workers connect to it)
+const char* WORKERS_ADDR = "inproc://tibeecore-workers";
+
+// maximum number of pending speculative queries
+const std::size_t PREFETCH_QUEUE_SIZE = 16;
+
+// period of snapshot checks when the state history is being built
+const std::size_t SNAPSHOT_WATCH_PERIOD_MS = 500;
+
+// set by SIGINT/SIGTERM to stop the broker
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+/**
+ * Blocks or unblocks SIGINT and SIGTERM for the calling thread (and
+ * the threads it creates afterwards).
+ *
+ * @param block True to block, false to unblock
+ */
+void blockStopSignals(bool block)
+{
+    ::sigset_t signals;
+
+    ::sigemptyset(&signals);
+    ::sigaddset(&signals, SIGINT);
+    ::sigaddset(&signals, SIGTERM);
+    ::pthread_sigmask(block ? SIG_BLOCK : SIG_UNBLOCK, &signals, nullptr);
+}
+
+}
+
+CoreBeetle::CoreBeetle(const Arguments& args) :
+    _args(args)
+{
+}
+
+bool CoreBeetle::run()
+{
+    /* A state snapshot which is not complete means the state history
+     * is still being built: serve the live snapshots until then.
+     */
+    std::shared_ptr<common::StateSnapshotSource> stateSnapshot;
+    auto stateSnapshotPath = _args.cacheDir / "state-snapshot.db";
+
+    if (common::StateSnapshotSource::isBuilding(stateSnapshotPath)) {
+        try {
+            stateSnapshot = std::make_shared<common::StateSnapshotSource>(_args.cacheDir / "history.live",
+                                                                          stateSnapshotPath);
+        } catch (const common::ex::StateSnapshotSource& ex) {
+            /* The build could have completed (and removed the state
+             * log) in the meantime: open the complete history then.
+             */
+            if (common::StateSnapshotSource::isBuilding(stateSnapshotPath)) {
+                std::cerr << "Error: cannot open state snapshot: " <<
+                             ex.getPath() << std::endl <<
+                             "  " << ex.what() << std::endl;
+
+                return false;
+            }
+        }
+    }
+
+    // open state history
+    common::StateHistorySource::UP stateHistory;
+
+    try {
+        if (stateSnapshot) {
+            stateHistory = common::StateHistorySource::UP {
+                new common::StateHistorySource {
+                    _args.cacheDir / "paths-quarks.db",
+                    _args.cacheDir / "values-quarks.db",
+                    stateSnapshot
+                }
+            };
+        } else {
+            stateHistory = common::StateHistorySource::UP {
+                new common::StateHistorySource {
+                    _args.cacheDir / "paths-quarks.db",
+                    _args.cacheDir / "values-quarks.db",
+                    _args.cacheDir / "history"
+                }
+            };
+        }
+    } catch (const common::ex::StateHistorySource& ex) {
+        std::cerr << "Error: cannot open state history: " <<
+                     ex.getPath() << std::endl <<
+                     "  " << ex.what() << std::endl;
+
+        return false;
+    }
+
+    if (_args.verbose) {
+        std::cout << "state history" <<
+                     (stateHistory->isLive() ? " (being built)" : "") <<
+                     ": [" << stateHistory->getBegin() <<
+                     ", " << stateHistory->getEnd() << "], " <<
+                     stateHistory->getPathsCount() << " paths" << std::endl;
+    }
+
+    // the snapshot watcher needs its own history handle
+    common::StateHistorySource::UP watcherStateHistory;
+
+    if (stateHistory->isLive()) {
+        watcherStateHistory = stateHistory->fork();
+    }
+
+    // open traces (optional: only needed to stream events)
+    std::unique_ptr<common::TraceSet> traceSet;
+
+    if (!_args.traces.empty()) {
+        traceSet = std::unique_ptr<common::TraceSet> {new common::TraceSet};
+
+        for (const auto& tracePath : _args.traces) {
+            if (!traceSet->addTrace(tracePath)) {
+                std::cerr << "Error: could not add trace " << tracePath << std::endl;
+
+                return false;
+            }
+        }
+    }
+
+    // open state summary (optional; written at the end of the build)
+    std::shared_ptr<const common::StateSummarySource> stateSummary;
+    auto stateSummaryPath = _args.cacheDir / "state-summary.db";
+
+    if (!stateSnapshot && boost::filesystem::exists(stateSummaryPath)) {
+        try {
+            stateSummary = std::make_shared<const common::StateSummarySource>(stateSummaryPath);
+        } catch (const common::ex::StateSummarySource& ex) {
+            std::cerr << "Warning: cannot open state summary: " <<
+                         ex.what() << std::endl;
+        }
+    }
+
+    // broker sockets
+    std::unique_ptr<common::MqContext> context {new common::MqContext {1}};
+    auto frontend = context->createRouterSocket();
+    auto backend = context->createRouterSocket();
+
+    if (!frontend->bind(_args.bindAddr)) {
+        std::cerr << "Error: cannot bind to address \"" <<
+                     _args.bindAddr << "\"" << std::endl;
+
+        return false;
+    }
+
+    // inproc endpoints must be bound before workers connect
+    if (!backend->bind(WORKERS_ADDR)) {
+        std::cerr << "Error: cannot bind to address \"" <<
+                     WORKERS_ADDR << "\"" << std::endl;
+
+        return false;
+    }
+
+    // result cache and prefetch queue (prefetching is useless without a cache)
+    std::unique_ptr<ResultCache> resultCache;
+    std::unique_ptr<PrefetchQueue> prefetchQueue;
+
+    if (_args.resultCacheSize > 0) {
+        resultCache = std::unique_ptr<ResultCache> {
+            new ResultCache {_args.resultCacheSize}
+        };
+        prefetchQueue = std::unique_ptr<PrefetchQueue> {
+            new PrefetchQueue {PREFETCH_QUEUE_SIZE}
+        };
+    }
+
+    // query workers
+    CoreMetrics metrics;
+    std::vector<QueryWorker::UP> workers;
+    std::vector<std::thread> threads;
+
+    for (std::size_t x = 0; x < _args.workers; ++x) {
+        // each worker needs its own history handle
+        auto workerStateHistory = (x + 1 < _args.workers) ?
+                                  stateHistory->fork() :
+                                  std::move(stateHistory);
+
+        workers.push_back(QueryWorker::UP {
+            new QueryWorker {
+                context.get(),
+                WORKERS_ADDR,
+                std::move(workerStateHistory),
+                stateSummary,
+                resultCache.get(),
+                prefetchQueue.get(),
+                &metrics,
+                x,
+                _args.workers,
+                _args.shmBulkSize,
+                common::ShmBulkWriter::isLocalAddress(_args.bindAddr)
+            }
+        });
+    }
+
+    /* Stop signals must interrupt the broker's poll: only this thread
+     * may handle them, so they stay blocked in the others.
+     */
+    blockStopSignals(true);
+
+    for (auto& worker : workers) {
+        threads.push_back(std::thread {&QueryWorker::run, worker.get()});
+    }
+
+    // event streamer
+    EventStreamer::UP eventStreamer;
+
+    if (traceSet) {
+        eventStreamer = EventStreamer::UP {
+            new EventStreamer {
+                context.get(),
+                _args.streamBindAddr,
+                std::move(traceSet),
+                _args.shmBulkSize
+            }
+        };
+
+        threads.push_back(std::thread {&EventStreamer::run, eventStreamer.get()});
+    }
+
+    // snapshot watcher
+    SnapshotWatcher::UP snapshotWatcher;
+
+    if (watcherStateHistory) {
+        snapshotWatcher = SnapshotWatcher::UP {
+            new SnapshotWatcher {
+                context.get(),
+                _args.notifyBindAddr,
+                std::move(watcherStateHistory),
+                SNAPSHOT_WATCH_PERIOD_MS
+            }
+        };
+
+        threads.push_back(std::thread {&SnapshotWatcher::run, snapshotWatcher.get()});
+    }
+
+    stopRequested = 0;
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    blockStopSignals(false);
+
+    if (_args.verbose) {
+        std::cout << "listening on " << _args.bindAddr << " with " <<
+                     _args.workers << " workers" << std::endl;
+
+        if (eventStreamer) {
+            std::cout << "streaming events on " << _args.streamBindAddr << std::endl;
+        }
+
+        if (snapshotWatcher) {
+            std::cout << "publishing watermark updates on " <<
+                         _args.notifyBindAddr << std::endl;
+        }
+    }
+
+    // schedule client requests on workers
+    std::vector<QueryWorker*> workerPtrs;
+
+    for (const auto& worker : workers) {
+        workerPtrs.push_back(worker.get());
+    }
+
+    CoreBroker broker {frontend.get(), backend.get(), workerPtrs, &metrics};
+    bool ret = broker.run(stopRequested);
+
+    // a second signal kills a stuck shutdown
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+
+    // the watcher's socket must be closed for the context to terminate
+    if (snapshotWatcher) {
+        snapshotWatcher->stop();
+    }
+
+    // terminating the context wakes up and stops all workers (and the streamer)
+    frontend->close();
+    backend->close();
+    context = nullptr;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return ret;
+}
+
+}
@@ -0,0 +1,66 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _COREBEETLE_HPP
+#define _COREBEETLE_HPP
+
+#include "Arguments.hpp"
+
+namespace tibee
+{
+
+/**
+ * Core beetle. This beetle loads the caches built by the builder
+ * beetle and answers queries about them.
+ *
+ * Clients send JSON-RPC requests to a router socket; requests are
+ * forwarded to a pool of query workers, each one running in its own
+ * thread with its own state history source. Requests may also be
+ * encoded as MessagePack, in which case they're answered likewise.
+ *
+ * With a shared memory ring size (see Arguments), large results of
+ * clients connected through ipc or inproc addresses asking for it
+ * are placed in shared memory and replaced by a small descriptor (see
+ * common::ShmBulkWriter and common::ShmBulkReader); control messages
+ * stay on the sockets.
+ *
+ * @author Philippe Proulx
+ */
+class CoreBeetle
+{
+public:
+    /**
+     * Instanciates a core beetle.
+     *
+     * @param args Program arguments
+     */
+    CoreBeetle(const Arguments& args);
+
+    /**
+     * Runs the core.
+     *
+     * @returns True if everything went fine
+     */
+    bool run();
+
+private:
+    Arguments _args;
+};
+
+}
+
+#endif // _COREBEETLE_HPP
@@ -0,0 +1,366 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "rpc/ErrorRpcResponse.hpp"
+#include "CoreBroker.hpp"
+
+namespace tibee
+{
+
+namespace
+{
+
+// prefix of the IDs given to anonymous clients
+const char ANONYMOUS_CLIENT_PREFIX[] = "anonymous-";
+
+// key of the metrics shared by anonymous and overflow clients
+const char OTHER_CLIENTS_KEY[] = "(others)";
+
+}
+
+CoreBroker::CoreBroker(common::AbstractMqSocket* frontend,
+                       common::AbstractMqSocket* backend,
+                       const std::vector<QueryWorker*>& workers,
+                       CoreMetrics* metrics) :
+    _frontend {frontend},
+    _backend {backend},
+    _workers {workers},
+    _metrics {metrics},
+    _nextTag {1},
+    _otherClientsMetrics {nullptr}
+{
+}
+
+bool CoreBroker::run(const volatile std::sig_atomic_t& stopRequested)
+{
+    std::vector<common::AbstractMqSocket*> sockets {_frontend, _backend};
+    std::vector<bool> ready;
+
+    while (!stopRequested) {
+        if (!common::AbstractMqSocket::poll(sockets, ready, -1)) {
+            // interrupted by a signal: the loop condition decides
+            if (common::AbstractMqSocket::isInterrupted()) {
+                continue;
+            }
+
+            break;
+        }
+
+        // replies first: they free workers
+        if (ready[1] && !this->processBackend()) {
+            break;
+        }
+
+        if (ready[0] && !this->processFrontend()) {
+            break;
+        }
+
+        this->dispatch();
+    }
+
+    if (stopRequested) {
+        return true;
+    }
+
+    return common::AbstractMqSocket::isTerminated();
+}
+
+bool CoreBroker::recvParts(common::AbstractMqSocket& socket,
+                           std::vector<common::MqMessage::UP>& parts)
+{
+    parts.clear();
+
+    do {
+        auto part = socket.recv();
+
+        if (!part) {
+            return false;
+        }
+
+        parts.push_back(std::move(part));
+    } while (socket.hasMore());
+
+    return true;
+}
+
+std::string CoreBroker::getPartString(common::MqMessage& part)
+{
+    return std::string {static_cast<const char*>(part.data()), part.size()};
+}
+
+ClientMetrics* CoreBroker::getClientMetrics(const std::string& client)
+{
+    auto it = _clientMetrics.find(client);
+
+    if (it != _clientMetrics.end()) {
+        return it->second;
+    }
+
+    /* Anonymous clients (one ID per connection) and clients beyond
+     * the limit share the same metrics, and are not cached, so that
+     * reconnecting clients don't grow the cache forever.
+     */
+    bool isAnonymous = client.compare(0, sizeof(ANONYMOUS_CLIENT_PREFIX) - 1,
+                                      ANONYMOUS_CLIENT_PREFIX) == 0;
+
+    if ((isAnonymous || _clientMetrics.size() >= MAX_CLIENTS_METRICS) &&
+            _otherClientsMetrics) {
+        return _otherClientsMetrics;
+    }
+
+    std::lock_guard<std::mutex> lock {_metrics->clientsMutex};
+    bool isOther = isAnonymous ||
+                   _clientMetrics.size() >= MAX_CLIENTS_METRICS;
+    auto& metrics = _metrics->clients[isOther ? OTHER_CLIENTS_KEY : client];
+
+    if (!metrics) {
+        metrics = std::unique_ptr<ClientMetrics> {new ClientMetrics};
+    }
+
+    if (isOther) {
+        _otherClientsMetrics = metrics.get();
+    } else {
+        _clientMetrics[client] = metrics.get();
+    }
+
+    return metrics.get();
+}
+
+bool CoreBroker::processFrontend()
+{
+    std::vector<common::MqMessage::UP> parts;
+
+    if (!CoreBroker::recvParts(*_frontend, parts)) {
+        return false;
+    }
+
+    // routing envelope (identity, maybe a delimiter), then the request
+    if (parts.size() < 2) {
+        return true;
+    }
+
+    QueryScheduler::Query query;
+
+    for (std::size_t x = 0; x + 1 < parts.size(); ++x) {
+        query.envelope.push_back(CoreBroker::getPartString(*parts[x]));
+    }
+
+    query.payload = CoreBroker::getPartString(*parts.back());
+    query.receivedAt = std::chrono::steady_clock::now();
+    query.tag = _nextTag++;
+    query.charged = 0;
+
+    // only scheduling parameters matter here (workers report errors)
+    _decoder.decodeRequest(query.payload.data(), query.payload.size());
+    query.id = _decoder.getId();
+    query.client = _decoder.getClient();
+    query.priority = _decoder.getPriority();
+    query.group = _decoder.getGroup();
+    query.encoding = _decoder.getEncoding();
+
+    // anonymous client: use its connection identity
+    if (query.client.empty()) {
+        std::ostringstream ss;
+
+        ss << ANONYMOUS_CLIENT_PREFIX << std::hex << std::setfill('0');
+
+        for (auto ch : query.envelope.front()) {
+            ss << std::setw(2) << static_cast<unsigned int>(static_cast<unsigned char>(ch));
+        }
+
+        query.client = ss.str();
+    }
+
+    auto clientMetrics = this->getClientMetrics(query.client);
+    std::vector<QueryScheduler::Query> superseded;
+
+    if (!query.group.empty()) {
+        this->cancelRunning(query.client, query.group);
+    }
+
+    _scheduler.push(std::move(query), superseded);
+    clientMetrics->queued.fetch_add(1, std::memory_order_relaxed);
+
+    for (const auto& supersededQuery : superseded) {
+        this->replyCancelled(supersededQuery);
+    }
+
+    return true;
+}
+
+bool CoreBroker::processBackend()
+{
+    std::vector<common::MqMessage::UP> parts;
+
+    if (!CoreBroker::recvParts(*_backend, parts)) {
+        return false;
+    }
+
+    // worker routing ID, delimiter, then index or tag and reply
+    if (parts.size() < 3) {
+        return true;
+    }
+
+    auto workerId = CoreBroker::getPartString(*parts[0]);
+
+    if (parts.size() == 3) {
+        // new worker
+        auto index = std::strtoul(CoreBroker::getPartString(*parts[2]).c_str(),
+                                  nullptr, 10);
+
+        if (index < _workers.size()) {
+            _workerIndexes[workerId] = index;
+            _freeWorkers.push_back(workerId);
+        }
+
+        return true;
+    }
+
+    _freeWorkers.push_back(workerId);
+
+    std::uint64_t tag = 0;
+
+    if (parts[2]->size() == sizeof(tag)) {
+        std::memcpy(&tag, parts[2]->data(), sizeof(tag));
+    }
+
+    auto runningIt = _running.find(tag);
+
+    if (runningIt == _running.end()) {
+        return true;
+    }
+
+    const auto& running = runningIt->second;
+    const auto& query = running.query;
+    auto now = std::chrono::steady_clock::now();
+    auto serviceNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - running.dispatchedAt).count();
+    auto latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - query.receivedAt).count();
+    auto clientMetrics = this->getClientMetrics(query.client);
+
+    // forward the worker's reply as is
+    this->reply(query.envelope, std::move(parts[3]));
+    _scheduler.finish(query, serviceNs);
+    clientMetrics->running.fetch_sub(1, std::memory_order_relaxed);
+    clientMetrics->requests.fetch_add(1, std::memory_order_relaxed);
+    clientMetrics->latency.record(latencyNs);
+    _running.erase(runningIt);
+
+    return true;
+}
+
+void CoreBroker::dispatch()
+{
+    while (!_freeWorkers.empty()) {
+        QueryScheduler::Query query;
+
+        if (!_scheduler.pop(query)) {
+            return;
+        }
+
+        auto workerId = _freeWorkers.back();
+
+        _freeWorkers.pop_back();
+
+        // worker routing ID, delimiter (REQ worker), tag, request
+        _backend->send(common::MqMessage::UP {
+            new common::MqMessage {workerId.data(), workerId.size()}
+        }, true);
+        _backend->send(common::MqMessage::UP {
+            new common::MqMessage {"", 0}
+        }, true);
+        _backend->send(common::MqMessage::UP {
+            new common::MqMessage {&query.tag, sizeof(query.tag)}
+        }, true);
+        _backend->send(common::MqMessage::UP {
+            new common::MqMessage {std::move(query.payload)}
+        });
+
+        auto clientMetrics = this->getClientMetrics(query.client);
+
+        clientMetrics->queued.fetch_sub(1, std::memory_order_relaxed);
+        clientMetrics->running.fetch_add(1, std::memory_order_relaxed);
+
+        Running running;
+
+        running.worker = _workerIndexes[workerId];
+        running.dispatchedAt = std::chrono::steady_clock::now();
+        running.query = std::move(query);
+        _running[running.query.tag] = std::move(running);
+    }
+}
+
+void CoreBroker::cancelRunning(const std::string& client,
+                               const std::string& group)
+{
+    for (const auto& tagRunningPair : _running) {
+        const auto& running = tagRunningPair.second;
+
+        if (running.query.client == client && running.query.group == group) {
+            _workers[running.worker]->cancel(tagRunningPair.first);
+            this->getClientMetrics(client)->cancelled.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void CoreBroker::replyCancelled(const QueryScheduler::Query& query)
+{
+    ErrorRpcResponse response {
+        ErrorRpcResponse::REQUEST_CANCELLED, "request superseded"
+    };
+
+    response.setId(query.id);
+
+    AbstractCoreRpcMessageEncoder* encoder = &_jsonEncoder;
+
+    if (query.encoding == common::RpcEncoding::MSGPACK) {
+        encoder = &_msgPackEncoder;
+    }
+
+    auto encoded = encoder->encodeErrorRpcResponse(response);
+
+    if (encoded) {
+        this->reply(query.envelope, common::MqMessage::UP {
+            new common::MqMessage {std::move(encoded)}
+        });
+    }
+
+    auto clientMetrics = this->getClientMetrics(query.client);
+
+    clientMetrics->queued.fetch_sub(1, std::memory_order_relaxed);
+    clientMetrics->cancelled.fetch_add(1, std::memory_order_relaxed);
+    clientMetrics->requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CoreBroker::reply(const std::vector<std::string>& envelope,
+                       common::MqMessage::UP msg)
+{
+    for (const auto& part : envelope) {
+        _frontend->send(common::MqMessage::UP {
+            new common::MqMessage {part.data(), part.size()}
+        }, true);
+    }
+
+    _frontend->send(std::move(msg));
+}
+
+}
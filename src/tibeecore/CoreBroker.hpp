@@ -0,0 +1,142 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _COREBROKER_HPP
+#define _COREBROKER_HPP
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/mq/AbstractMqSocket.hpp>
+#include <common/mq/MqMessage.hpp>
+#include "rpc/CoreRpcMessageDecoder.hpp"
+#include "rpc/CoreJsonRpcMessageEncoder.hpp"
+#include "rpc/CoreMsgPackRpcMessageEncoder.hpp"
+#include "CoreMetrics.hpp"
+#include "QueryScheduler.hpp"
+#include "QueryWorker.hpp"
+
+namespace tibee
+{
+
+/**
+ * Analysis core broker.
+ *
+ * Receives client requests on a router frontend socket, queues them
+ * in a QueryScheduler and hands them, one at a time, to free query
+ * workers connected to a router backend socket.
+ *
+ * A request having a supersession group cancels the requests of the
+ * same client and group: queued ones are answered right away with a
+ * REQUEST_CANCELLED error, while running ones are cancelled
+ * cooperatively (see QueryWorker::cancel()).
+ *
+ * Worker protocol: a worker first sends its index, then each request
+ * it receives is made of a tag and the request itself, and it answers
+ * with the same tag and its reply.
+ *
+ * @author Philippe Proulx
+ */
+class CoreBroker :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds a broker.
+     *
+     * @param frontend Frontend router socket (clients connect to it)
+     * @param backend  Backend router socket (workers connect to it)
+     * @param workers  Query workers, by index
+     * @param metrics  Core metrics (shared)
+     */
+    CoreBroker(common::AbstractMqSocket* frontend,
+               common::AbstractMqSocket* backend,
+               const std::vector<QueryWorker*>& workers,
+               CoreMetrics* metrics);
+
+    /**
+     * Routes requests and replies until the message queue context is
+     * terminated or \p stopRequested is set (by a signal handler).
+     *
+     * @param stopRequested Stop flag, checked when interrupted by a
+     *                      signal
+     * @returns             True if the context was terminated normally
+     *                      or if stopped
+     */
+    bool run(const volatile std::sig_atomic_t& stopRequested);
+
+private:
+    struct Running
+    {
+        QueryScheduler::Query query;
+        std::size_t worker;
+        std::chrono::steady_clock::time_point dispatchedAt;
+    };
+
+private:
+    bool processFrontend();
+    bool processBackend();
+    void dispatch();
+    void cancelRunning(const std::string& client, const std::string& group);
+    void replyCancelled(const QueryScheduler::Query& query);
+    void reply(const std::vector<std::string>& envelope,
+               common::MqMessage::UP msg);
+    ClientMetrics* getClientMetrics(const std::string& client);
+    static bool recvParts(common::AbstractMqSocket& socket,
+                          std::vector<common::MqMessage::UP>& parts);
+    static std::string getPartString(common::MqMessage& part);
+
+private:
+    // maximum number of clients having their own metrics
+    static const std::size_t MAX_CLIENTS_METRICS = 256;
+
+private:
+    common::AbstractMqSocket* _frontend;
+    common::AbstractMqSocket* _backend;
+    std::vector<QueryWorker*> _workers;
+    CoreMetrics* _metrics;
+    QueryScheduler _scheduler;
+    CoreRpcMessageDecoder _decoder;
+    CoreJsonRpcMessageEncoder _jsonEncoder;
+    CoreMsgPackRpcMessageEncoder _msgPackEncoder;
+
+    // routing IDs of free workers, and worker index of routing IDs
+    std::vector<std::string> _freeWorkers;
+    std::unordered_map<std::string, std::size_t> _workerIndexes;
+
+    // running queries (tag -> running query)
+    std::unordered_map<std::uint64_t, Running> _running;
+
+    // next query tag (0 is never used)
+    std::uint64_t _nextTag;
+
+    // metrics of named clients having their own slot (client ID ->
+    // metrics, owned by _metrics)
+    std::unordered_map<std::string, ClientMetrics*> _clientMetrics;
+
+    // metrics shared by other clients (null until needed)
+    ClientMetrics* _otherClientsMetrics;
+};
+
+}
+
+#endif // _COREBROKER_HPP
@@ -0,0 +1,109 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _COREMETRICS_HPP
+#define _COREMETRICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <boost/utility.hpp>
+
+#include "LatencyHistogram.hpp"
+
+namespace tibee
+{
+
+/**
+ * Metrics of one analysis core client.
+ *
+ * Only the broker updates them; anyone may read them.
+ *
+ * @author Philippe Proulx
+ */
+struct ClientMetrics :
+    boost::noncopyable
+{
+    ClientMetrics() :
+        queued {0},
+        running {0},
+        requests {0},
+        cancelled {0}
+    {
+    }
+
+    /// Number of requests waiting for a worker
+    std::atomic<std::size_t> queued;
+
+    /// Number of requests being processed by a worker
+    std::atomic<std::size_t> running;
+
+    /// Number of answered requests
+    std::atomic<std::uint64_t> requests;
+
+    /// Number of cancelled (superseded) requests
+    std::atomic<std::uint64_t> cancelled;
+
+    /// Request latencies, including queueing (receive to reply)
+    LatencyHistogram latency;
+};
+
+/**
+ * Analysis core metrics, shared by all query workers.
+ *
+ * @author Philippe Proulx
+ */
+struct CoreMetrics :
+    boost::noncopyable
+{
+    CoreMetrics() :
+        errors {0},
+        cacheHits {0},
+        cacheMisses {0},
+        prefetches {0}
+    {
+    }
+
+    /// Request latencies (receive to reply)
+    LatencyHistogram latency;
+
+    /// Number of requests which led to an error response
+    std::atomic<std::uint64_t> errors;
+
+    /// Number of result cache hits
+    std::atomic<std::uint64_t> cacheHits;
+
+    /// Number of result cache misses
+    std::atomic<std::uint64_t> cacheMisses;
+
+    /// Number of results computed speculatively
+    std::atomic<std::uint64_t> prefetches;
+
+    /// Per-client metrics (client ID to metrics), guarded by clientsMutex
+    std::map<std::string, std::unique_ptr<ClientMetrics>> clients;
+
+    /// Mutex guarding clients (not the metrics themselves)
+    std::mutex clientsMutex;
+};
+
+}
+
+#endif // _COREMETRICS_HPP
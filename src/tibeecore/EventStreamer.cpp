@@ -0,0 +1,433 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <unistd.h>
+
+#include <common/ex/ShmBulk.hpp>
+#include <common/mq/MqMessage.hpp>
+#include <common/trace/Event.hpp>
+#include "rpc/ErrorRpcResponse.hpp"
+#include "rpc/EventsChunkRpcResponse.hpp"
+#include "rpc/GrantCreditsRpcRequest.hpp"
+#include "rpc/CancelEventsRpcRequest.hpp"
+#include "EventStreamer.hpp"
+
+namespace tibee
+{
+
+EventStreamer::EventStreamer(common::MqContext* context,
+                             const std::string& bindAddr,
+                             std::unique_ptr<common::TraceSet> traceSet,
+                             std::size_t shmBulkSize) :
+    _context {context},
+    _bindAddr {bindAddr},
+    _traceSet {std::move(traceSet)},
+    _shmBulkSize {shmBulkSize},
+    _iter {_traceSet->end()},
+    _iterStream {nullptr}
+{
+}
+
+void EventStreamer::run()
+{
+    // sockets must be created in the thread using them
+    auto socket = _context->createRouterSocket();
+
+    if (!socket->bind(_bindAddr)) {
+        std::cerr << "Error: cannot bind event streamer to \"" <<
+                     _bindAddr << "\"" << std::endl;
+
+        return;
+    }
+
+    // shared memory ring for events of local clients
+    if (_shmBulkSize > 0 && common::ShmBulkWriter::isLocalAddress(_bindAddr)) {
+        auto name = "/tibeecore-" + std::to_string(::getpid()) + "-events";
+
+        try {
+            _shmBulkWriter = common::ShmBulkWriter::UP {
+                new common::ShmBulkWriter {
+                    name, _shmBulkSize, common::ShmBulkWriter::DEFAULT_MIN_SIZE
+                }
+            };
+        } catch (const common::ex::ShmBulk& ex) {
+            std::cerr << "Warning: " << ex.what() << " \"" <<
+                         ex.getName() << "\"" << std::endl;
+        }
+    }
+
+    while (true) {
+        this->expireStreams(*socket);
+
+        auto streamIt = this->findReadyStream();
+        bool hasReadyStream = streamIt != _streams.end();
+        long timeout = -1;
+
+        if (hasReadyStream) {
+            timeout = 0;
+        } else if (!_streams.empty()) {
+            // wake up to expire streams waiting for credits
+            timeout = EXPIRE_PERIOD_MS;
+        }
+
+        /* Incoming messages (new streams, credits, cancellations) come
+         * first; only block when there's nothing to send.
+         */
+        if (socket->poll(timeout)) {
+            // false means the context is terminated
+            if (!this->processMessage(*socket)) {
+                break;
+            }
+
+            continue;
+        }
+
+        this->sendChunk(*socket, streamIt);
+    }
+
+    socket->close();
+}
+
+bool EventStreamer::processMessage(common::AbstractMqSocket& socket)
+{
+    // router sockets prepend the identity of the client
+    auto identityMsg = socket.recv();
+
+    if (!identityMsg) {
+        return false;
+    }
+
+    // request is the last part
+    common::MqMessage::UP requestMsg;
+
+    while (socket.hasMore()) {
+        requestMsg = socket.recv();
+
+        if (!requestMsg) {
+            return false;
+        }
+    }
+
+    if (!requestMsg) {
+        return true;
+    }
+
+    std::string identity {
+        static_cast<const char*>(identityMsg->data()),
+        identityMsg->size()
+    };
+
+    this->processRequest(socket, identity,
+                         static_cast<const char*>(requestMsg->data()),
+                         requestMsg->size());
+
+    return true;
+}
+
+void EventStreamer::processRequest(common::AbstractMqSocket& socket,
+                                   const std::string& identity,
+                                   const char* data, std::size_t len)
+{
+    auto request = _decoder.decodeRequest(data, len);
+
+    if (!request) {
+        this->sendError(socket, identity, _decoder.getId(),
+                        _decoder.getErrorCode(), _decoder.getErrorMessage());
+
+        return;
+    }
+
+    const auto& method = request->getMethod();
+
+    if (method == "get-events") {
+        this->startStream(socket, identity,
+                          static_cast<const GetEventsRpcRequest&>(*request));
+    } else if (method == "grant-credits") {
+        const auto& grant = static_cast<const GrantCreditsRpcRequest&>(*request);
+        auto it = this->findStream(identity, grant.getStreamId());
+
+        // the stream could be done already: ignore
+        if (it != _streams.end()) {
+            auto max = std::numeric_limits<std::uint64_t>::max();
+
+            it->credits = std::min(max - grant.getCredits(), it->credits) +
+                          grant.getCredits();
+            it->lastActivity = std::chrono::steady_clock::now();
+        }
+    } else if (method == "cancel-events") {
+        const auto& cancel = static_cast<const CancelEventsRpcRequest&>(*request);
+        auto it = this->findStream(identity, cancel.getStreamId());
+
+        if (it != _streams.end()) {
+            this->sendHeader(socket, *it, 0, true, true, nullptr);
+            this->removeStream(it);
+        }
+    } else {
+        this->sendError(socket, identity, request->getId(),
+                        ErrorRpcResponse::METHOD_NOT_FOUND, "unknown method");
+    }
+}
+
+void EventStreamer::startStream(common::AbstractMqSocket& socket,
+                                const std::string& identity,
+                                const GetEventsRpcRequest& request)
+{
+    if (this->findStream(identity, request.getId()) != _streams.end()) {
+        this->sendError(socket, identity, request.getId(),
+                        ErrorRpcResponse::INVALID_REQUEST,
+                        "stream ID already in use");
+
+        return;
+    }
+
+    // remote clients cannot map the segment of a descriptor
+    if (_decoder.wantsShmBulk() &&
+            !common::ShmBulkWriter::isLocalAddress(_bindAddr)) {
+        this->sendError(socket, identity, request.getId(),
+                        ErrorRpcResponse::INVALID_PARAMS,
+                        "shared memory bulk results need an ipc or inproc connection");
+
+        return;
+    }
+
+    if (_streams.size() >= MAX_STREAMS) {
+        this->sendError(socket, identity, request.getId(),
+                        ErrorRpcResponse::INTERNAL_ERROR, "too many streams");
+
+        return;
+    }
+
+    Stream stream;
+
+    stream.identity = identity;
+    stream.id = request.getId();
+    stream.nextTs = request.getBegin();
+    stream.sentAtNextTs = 0;
+    stream.end = request.getEnd();
+    stream.remaining = request.getMaxEvents();
+    stream.credits = request.getCredits();
+    stream.seq = 0;
+    stream.chunkSize = FIRST_CHUNK_SIZE;
+    stream.encoding = _decoder.getEncoding();
+    stream.shmBulk = _decoder.wantsShmBulk();
+    stream.lastActivity = std::chrono::steady_clock::now();
+
+    // new streams are served first
+    _streams.push_front(std::move(stream));
+}
+
+EventStreamer::Streams::iterator EventStreamer::findStream(const std::string& identity,
+                                                           common::rpc_msg_id_t id)
+{
+    return std::find_if(_streams.begin(), _streams.end(),
+                        [&identity, id] (const Stream& stream) {
+        return stream.id == id && stream.identity == identity;
+    });
+}
+
+EventStreamer::Streams::iterator EventStreamer::findReadyStream()
+{
+    return std::find_if(_streams.begin(), _streams.end(),
+                        [] (const Stream& stream) {
+        return stream.credits > 0;
+    });
+}
+
+void EventStreamer::removeStream(Streams::iterator it)
+{
+    if (_iterStream == &*it) {
+        _iterStream = nullptr;
+    }
+
+    _streams.erase(it);
+}
+
+void EventStreamer::expireStreams(common::AbstractMqSocket& socket)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto it = _streams.begin(); it != _streams.end();) {
+        auto cur = it++;
+        auto idle = std::chrono::duration_cast<std::chrono::milliseconds>(now - cur->lastActivity);
+
+        if (cur->credits == 0 && idle.count() >= STREAM_TIMEOUT_MS) {
+            // in case the client is still there
+            this->sendError(socket, cur->identity, cur->id,
+                            ErrorRpcResponse::REQUEST_CANCELLED,
+                            "stream expired (no credits granted)");
+            this->removeStream(cur);
+        }
+    }
+}
+
+void EventStreamer::sendChunk(common::AbstractMqSocket& socket,
+                              Streams::iterator it)
+{
+    auto& stream = *it;
+    auto endIter = _traceSet->end();
+
+    // only seek if another stream moved the iterator
+    if (_iterStream != &stream) {
+        _iter = _traceSet->seek(stream.nextTs);
+
+        for (auto x = stream.sentAtNextTs; x > 0 && _iter != endIter; --x) {
+            if ((*_iter).getTimestamp() != stream.nextTs) {
+                break;
+            }
+
+            ++_iter;
+        }
+
+        _iterStream = &stream;
+    }
+
+    auto isDone = [&] () {
+        return stream.remaining == 0 || _iter == endIter ||
+               (*_iter).getTimestamp() >= stream.end;
+    };
+
+    std::size_t count = 0;
+
+    _eventsEncoder.reset();
+
+    while (count < stream.chunkSize && !isDone()) {
+        auto& event = *_iter;
+        auto ts = event.getTimestamp();
+
+        _eventsEncoder.addEvent(event);
+
+        if (ts == stream.nextTs) {
+            stream.sentAtNextTs++;
+        } else {
+            stream.nextTs = ts;
+            stream.sentAtNextTs = 1;
+        }
+
+        count++;
+        stream.remaining--;
+        ++_iter;
+    }
+
+    bool last = isDone();
+
+    this->sendHeader(socket, stream, count, last, false,
+                     _eventsEncoder.finish());
+
+    if (last) {
+        this->removeStream(it);
+
+        return;
+    }
+
+    stream.seq++;
+    stream.credits--;
+    stream.lastActivity = std::chrono::steady_clock::now();
+    stream.chunkSize = std::min(stream.chunkSize * 2,
+                                static_cast<std::size_t>(MAX_CHUNK_SIZE));
+
+    // round-robin
+    _streams.splice(_streams.end(), _streams, it);
+}
+
+void EventStreamer::sendHeader(common::AbstractMqSocket& socket,
+                               const Stream& stream, std::size_t count,
+                               bool last, bool cancelled,
+                               std::unique_ptr<std::string> events)
+{
+    EventsChunkRpcResponse response;
+
+    response.setId(stream.id);
+    response.setSeq(stream.seq);
+    response.setCount(count);
+    response.setLast(last);
+    response.setCancelled(cancelled);
+
+    auto header = this->getEncoder(stream.encoding).encodeEventsChunkRpcResponse(response);
+
+    if (!header) {
+        return;
+    }
+
+    common::MqMessage::UP eventsMsg;
+
+    // large chunks of local clients go through shared memory
+    if (events && stream.shmBulk && _shmBulkWriter) {
+        eventsMsg = _shmBulkWriter->write(events->data(), events->size());
+    }
+
+    if (!eventsMsg && events) {
+        eventsMsg = common::MqMessage::UP {
+            new common::MqMessage {std::move(events)}
+        };
+    }
+
+    this->send(socket, stream.identity, std::move(header), std::move(eventsMsg));
+}
+
+void EventStreamer::sendError(common::AbstractMqSocket& socket,
+                              const std::string& identity,
+                              common::rpc_msg_id_t id, int code,
+                              const std::string& message)
+{
+    ErrorRpcResponse response {code, message};
+
+    response.setId(id);
+
+    // errors always answer the last decoded request
+    auto header = this->getEncoder(_decoder.getEncoding()).encodeErrorRpcResponse(response);
+
+    if (!header) {
+        return;
+    }
+
+    this->send(socket, identity, std::move(header), nullptr);
+}
+
+AbstractCoreRpcMessageEncoder& EventStreamer::getEncoder(common::RpcEncoding encoding)
+{
+    if (encoding == common::RpcEncoding::MSGPACK) {
+        return _msgPackEncoder;
+    }
+
+    return _jsonEncoder;
+}
+
+void EventStreamer::send(common::AbstractMqSocket& socket,
+                         const std::string& identity,
+                         std::unique_ptr<std::string> header,
+                         common::MqMessage::UP events)
+{
+    if (!events) {
+        events = common::MqMessage::UP {new common::MqMessage {std::string {"[]"}}};
+    }
+
+    // identity, header, events (encoded buffers are handed over)
+    socket.send(common::MqMessage::UP {
+        new common::MqMessage {identity.data(), identity.size()}
+    }, true);
+    socket.send(common::MqMessage::UP {
+        new common::MqMessage {std::move(header)}
+    }, true);
+    socket.send(std::move(events));
+}
+
+}
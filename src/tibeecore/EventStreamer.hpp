@@ -0,0 +1,213 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EVENTSTREAMER_HPP
+#define _EVENTSTREAMER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <boost/utility.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/mq/MqContext.hpp>
+#include <common/rpc/RpcEncoding.hpp>
+#include <common/mq/AbstractMqSocket.hpp>
+#include <common/mq/MqMessage.hpp>
+#include <common/mq/ShmBulkWriter.hpp>
+#include <common/trace/TraceSet.hpp>
+#include "rpc/CoreRpcMessageDecoder.hpp"
+#include "rpc/CoreJsonRpcMessageEncoder.hpp"
+#include "rpc/CoreMsgPackRpcMessageEncoder.hpp"
+#include "rpc/EventsJsonEncoder.hpp"
+#include "rpc/GetEventsRpcRequest.hpp"
+
+namespace tibee
+{
+
+/**
+ * Event streamer.
+ *
+ * Answers event range requests (get-events) on its own router socket
+ * by streaming events as chunks, each one being a multipart message
+ * made of a JSON-RPC response header (EventsChunkRpcResponse) and a
+ * JSON array of events. Clients must use dealer sockets. Headers use
+ * the encoding of the get-events request (JSON or MessagePack), but
+ * events are always JSON.
+ *
+ * Flow control is credit-based: each chunk consumes one credit of its
+ * stream and nothing is sent for a stream without credits, until the
+ * client grants more (grant-credits). A client may stop a stream at
+ * any time (cancel-events). Several streams are served round-robin,
+ * one chunk at a time, and incoming messages always take precedence
+ * over sending chunks.
+ *
+ * A stream without credits for STREAM_TIMEOUT_MS milliseconds (its
+ * client is probably gone) is expired, so that it does not take one
+ * of the MAX_STREAMS slots forever.
+ *
+ * The first chunk of a stream is small so that the first events are
+ * sent quickly, whatever the size of the range; following chunks are
+ * larger.
+ *
+ * The events of a stream whose get-events request has the \c bulk
+ * parameter set to \c "shm" are placed in shared memory, if enabled,
+ * and replaced by a descriptor (see common::ShmBulkWriter). Such
+ * requests are rejected if the bind address is not local (see
+ * common::ShmBulkWriter::isLocalAddress()).
+ *
+ * Its run() method, meant to be executed in a dedicated thread, serves
+ * streams until the message queue context is terminated.
+ *
+ * @author Philippe Proulx
+ */
+class EventStreamer :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to event streamer
+    typedef std::unique_ptr<EventStreamer> UP;
+
+public:
+    /**
+     * Builds an event streamer.
+     *
+     * @param context     Message queue context (shared)
+     * @param bindAddr    Address to bind the router socket to
+     * @param traceSet    Trace set to read events from (owned)
+     * @param shmBulkSize Size of the shared memory ring for events
+     *                    (bytes, 0 to disable)
+     */
+    EventStreamer(common::MqContext* context, const std::string& bindAddr,
+                  std::unique_ptr<common::TraceSet> traceSet,
+                  std::size_t shmBulkSize);
+
+    /**
+     * Serves streams until the message queue context is terminated.
+     */
+    void run();
+
+private:
+    struct Stream
+    {
+        // client identity (router socket)
+        std::string identity;
+
+        // stream ID (ID of the get events request)
+        common::rpc_msg_id_t id;
+
+        // timestamp of next event and number of events already sent
+        // at this timestamp (to resume after a seek)
+        common::timestamp_t nextTs;
+        std::uint64_t sentAtNextTs;
+
+        // end timestamp (exclusive)
+        common::timestamp_t end;
+
+        // number of events left to send
+        std::uint64_t remaining;
+
+        // number of chunks the client accepts
+        std::uint64_t credits;
+
+        // sequence number of next chunk
+        std::uint64_t seq;
+
+        // number of events of next chunk
+        std::size_t chunkSize;
+
+        // encoding of headers (encoding of the get events request)
+        common::RpcEncoding encoding;
+
+        // true to send events through shared memory
+        bool shmBulk;
+
+        // last time the client or this streamer made progress (start,
+        // granted credits, sent chunk)
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+    typedef std::list<Stream> Streams;
+
+private:
+    bool processMessage(common::AbstractMqSocket& socket);
+    void processRequest(common::AbstractMqSocket& socket,
+                        const std::string& identity, const char* data,
+                        std::size_t len);
+    void startStream(common::AbstractMqSocket& socket,
+                     const std::string& identity,
+                     const GetEventsRpcRequest& request);
+    Streams::iterator findStream(const std::string& identity,
+                                 common::rpc_msg_id_t id);
+    Streams::iterator findReadyStream();
+    void removeStream(Streams::iterator it);
+    void expireStreams(common::AbstractMqSocket& socket);
+    void sendChunk(common::AbstractMqSocket& socket, Streams::iterator it);
+    void sendHeader(common::AbstractMqSocket& socket, const Stream& stream,
+                    std::size_t count, bool last, bool cancelled,
+                    std::unique_ptr<std::string> events);
+    void sendError(common::AbstractMqSocket& socket,
+                   const std::string& identity, common::rpc_msg_id_t id,
+                   int code, const std::string& message);
+    AbstractCoreRpcMessageEncoder& getEncoder(common::RpcEncoding encoding);
+    void send(common::AbstractMqSocket& socket, const std::string& identity,
+              std::unique_ptr<std::string> header,
+              common::MqMessage::UP events);
+
+private:
+    // number of events of the first chunk of a stream
+    static const std::size_t FIRST_CHUNK_SIZE = 64;
+
+    // maximum number of events of one chunk
+    static const std::size_t MAX_CHUNK_SIZE = 4096;
+
+    // maximum number of concurrent streams
+    static const std::size_t MAX_STREAMS = 64;
+
+    // time after which a stream without credits is expired (ms)
+    static const long STREAM_TIMEOUT_MS = 60000;
+
+    // period of expiry checks while waiting for messages (ms)
+    static const long EXPIRE_PERIOD_MS = 1000;
+
+private:
+    common::MqContext* _context;
+    std::string _bindAddr;
+    std::unique_ptr<common::TraceSet> _traceSet;
+    std::size_t _shmBulkSize;
+
+    // shared memory ring for events (null if disabled)
+    common::ShmBulkWriter::UP _shmBulkWriter;
+    CoreRpcMessageDecoder _decoder;
+    CoreJsonRpcMessageEncoder _jsonEncoder;
+    CoreMsgPackRpcMessageEncoder _msgPackEncoder;
+    EventsJsonEncoder _eventsEncoder;
+
+    // active streams (round-robin: served streams go to the back)
+    Streams _streams;
+
+    // trace set iterator and stream for which it's positioned
+    common::TraceSet::Iterator _iter;
+    const Stream* _iterStream;
+};
+
+}
+
+#endif // _EVENTSTREAMER_HPP
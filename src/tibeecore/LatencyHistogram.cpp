@@ -0,0 +1,83 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "LatencyHistogram.hpp"
+
+namespace tibee
+{
+
+LatencyHistogram::LatencyHistogram() :
+    _count {0},
+    _max {0}
+{
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t LatencyHistogram::getBucketUpperBound(std::size_t index)
+{
+    if (index < 8) {
+        return index;
+    }
+
+    unsigned int exp = index / 8 + 2;
+    std::uint64_t sub = index % 8;
+    std::uint64_t width = static_cast<std::uint64_t>(1) << (exp - 3);
+
+    return (8 + sub) * width + width - 1;
+}
+
+std::uint64_t LatencyHistogram::getPercentile(double percentile) const
+{
+    // snapshot counts: concurrent records may make them drift a little
+    std::array<std::uint64_t, BUCKETS_COUNT> counts;
+    std::uint64_t total = 0;
+
+    for (std::size_t x = 0; x < BUCKETS_COUNT; ++x) {
+        counts[x] = _buckets[x].load(std::memory_order_relaxed);
+        total += counts[x];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    percentile = std::min(std::max(percentile, 0.), 100.);
+
+    auto rank = static_cast<std::uint64_t>(std::ceil(percentile / 100. * total));
+
+    rank = std::max(rank, static_cast<std::uint64_t>(1));
+
+    std::uint64_t seen = 0;
+
+    for (std::size_t x = 0; x < BUCKETS_COUNT; ++x) {
+        seen += counts[x];
+
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::getBucketUpperBound(x),
+                            this->getMax());
+        }
+    }
+
+    return this->getMax();
+}
+
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _LATENCYHISTOGRAM_HPP
+#define _LATENCYHISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <boost/utility.hpp>
+
+namespace tibee
+{
+
+/**
+ * Latency histogram.
+ *
+ * Records durations (ns) in logarithmic buckets, each power of two
+ * being split into 8 linear sub-buckets, so that any percentile is
+ * known within 12.5 % whatever the range. Recording is lock-free and
+ * may be done concurrently by many threads.
+ *
+ * @author Philippe Proulx
+ */
+class LatencyHistogram :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds an empty latency histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * Records one duration.
+     *
+     * @param ns Duration (ns)
+     */
+    void record(std::uint64_t ns)
+    {
+        _buckets[LatencyHistogram::getBucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+
+        auto max = _max.load(std::memory_order_relaxed);
+
+        while (ns > max && !_max.compare_exchange_weak(max, ns,
+                                                       std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Returns the number of recorded durations.
+     *
+     * @returns Number of recorded durations
+     */
+    std::uint64_t getCount() const
+    {
+        return _count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the maximum recorded duration.
+     *
+     * @returns Maximum recorded duration (ns)
+     */
+    std::uint64_t getMax() const
+    {
+        return _max.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the duration under which \p percentile percent of
+     * recorded durations are (upper bound of the bucket containing
+     * this percentile).
+     *
+     * @param percentile Percentile within [0, 100]
+     * @returns          Duration (ns), or 0 if nothing is recorded
+     */
+    std::uint64_t getPercentile(double percentile) const;
+
+private:
+    static std::size_t getBucketIndex(std::uint64_t ns)
+    {
+        if (ns < 8) {
+            return static_cast<std::size_t>(ns);
+        }
+
+        unsigned int exp = 63 - __builtin_clzll(ns);
+
+        return (exp - 2) * 8 + ((ns >> (exp - 3)) & 7);
+    }
+
+    static std::uint64_t getBucketUpperBound(std::size_t index);
+
+private:
+    static const std::size_t BUCKETS_COUNT = 62 * 8;
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS_COUNT> _buckets;
+    std::atomic<std::uint64_t> _count;
+    std::atomic<std::uint64_t> _max;
+};
+
+}
+
+#endif // _LATENCYHISTOGRAM_HPP
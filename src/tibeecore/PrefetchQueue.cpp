@@ -0,0 +1,65 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "PrefetchQueue.hpp"
+
+namespace tibee
+{
+
+PrefetchQueue::PrefetchQueue(std::size_t maxJobs) :
+    _maxJobs {maxJobs}
+{
+}
+
+void PrefetchQueue::push(Job job)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    auto samePending = std::any_of(_jobs.begin(), _jobs.end(),
+                                   [&job] (const Job& pending) {
+        return pending.key == job.key;
+    });
+
+    if (samePending || _maxJobs == 0) {
+        return;
+    }
+
+    if (_jobs.size() >= _maxJobs) {
+        _jobs.pop_front();
+    }
+
+    _jobs.push_back(std::move(job));
+}
+
+bool PrefetchQueue::pop(Job& job)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    if (_jobs.empty()) {
+        return false;
+    }
+
+    // most recent first
+    job = std::move(_jobs.back());
+    _jobs.pop_back();
+
+    return true;
+}
+
+}
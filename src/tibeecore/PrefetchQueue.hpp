@@ -0,0 +1,101 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PREFETCHQUEUE_HPP
+#define _PREFETCHQUEUE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/BasicTypes.hpp>
+
+namespace tibee
+{
+
+/**
+ * Prefetch queue, shared by all query workers.
+ *
+ * Holds speculative state summary queries (typically the viewports
+ * adjacent to the last requested one) which idle query workers
+ * compute ahead of time. Recent viewports matter more: jobs are
+ * removed most recent first and, when the queue is full, the oldest
+ * job is dropped.
+ *
+ * @author Philippe Proulx
+ */
+class PrefetchQueue :
+    boost::noncopyable
+{
+public:
+    /**
+     * Speculative state summary query.
+     */
+    struct Job
+    {
+        /// Normalized query (result cache key)
+        std::string key;
+
+        /// Path quarks (rows)
+        std::vector<common::quark_t> pathQuarks;
+
+        /// Begin timestamp
+        common::timestamp_t begin;
+
+        /// End timestamp (exclusive)
+        common::timestamp_t end;
+
+        /// Number of buckets (columns)
+        std::size_t bucketsCount;
+    };
+
+public:
+    /**
+     * Builds a prefetch queue.
+     *
+     * @param maxJobs Maximum number of pending jobs
+     */
+    explicit PrefetchQueue(std::size_t maxJobs);
+
+    /**
+     * Appends a job, dropping the oldest one if the queue is full.
+     * Jobs having the same key as a pending job are ignored.
+     *
+     * @param job Job to append
+     */
+    void push(Job job);
+
+    /**
+     * Removes the most recent job.
+     *
+     * @param job Removed job (set if any)
+     * @returns   True if a job was removed
+     */
+    bool pop(Job& job);
+
+private:
+    std::mutex _mutex;
+    std::deque<Job> _jobs;
+    std::size_t _maxJobs;
+};
+
+}
+
+#endif // _PREFETCHQUEUE_HPP
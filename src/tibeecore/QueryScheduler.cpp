@@ -0,0 +1,135 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "QueryScheduler.hpp"
+
+namespace tibee
+{
+
+namespace
+{
+
+// assumed cost of the first query of a client (ns)
+const double INITIAL_COST = 1e6;
+
+}
+
+QueryScheduler::QueryScheduler() :
+    _vtime {0},
+    _queuedCount {0}
+{
+}
+
+void QueryScheduler::push(Query query, std::vector<Query>& superseded)
+{
+    auto clientIt = _clients.find(query.client);
+
+    if (clientIt == _clients.end()) {
+        Client client;
+
+        client.vtime = _vtime;
+        client.avgCost = INITIAL_COST;
+        client.running = 0;
+        clientIt = _clients.emplace(query.client, std::move(client)).first;
+    }
+
+    auto& client = clientIt->second;
+
+    // back from idle: no banking of unused time
+    if (client.queries.empty() && client.running == 0) {
+        client.vtime = std::max(client.vtime, _vtime);
+    }
+
+    // supersede queued queries of the same group
+    if (!query.group.empty()) {
+        auto it = client.queries.begin();
+
+        while (it != client.queries.end()) {
+            if (it->group == query.group) {
+                superseded.push_back(std::move(*it));
+                it = client.queries.erase(it);
+                _queuedCount--;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // insert after queries of the same or higher priority
+    auto pos = std::find_if(client.queries.begin(), client.queries.end(),
+                            [&query] (const Query& queued) {
+        return queued.priority < query.priority;
+    });
+
+    client.queries.insert(pos, std::move(query));
+    _queuedCount++;
+}
+
+bool QueryScheduler::pop(Query& query)
+{
+    Client* next = nullptr;
+
+    // client having paid the least
+    for (auto& idClientPair : _clients) {
+        auto& client = idClientPair.second;
+
+        if (!client.queries.empty() && (!next || client.vtime < next->vtime)) {
+            next = &client;
+        }
+    }
+
+    if (!next) {
+        return false;
+    }
+
+    query = std::move(next->queries.front());
+    next->queries.pop_front();
+    _queuedCount--;
+
+    // charge the average cost now, settle in finish()
+    query.charged = next->avgCost;
+    _vtime = next->vtime;
+    next->vtime += query.charged / QueryScheduler::getWeight(query.priority);
+    next->running++;
+
+    return true;
+}
+
+void QueryScheduler::finish(const Query& query, std::uint64_t serviceNs)
+{
+    auto clientIt = _clients.find(query.client);
+
+    if (clientIt == _clients.end()) {
+        return;
+    }
+
+    auto& client = clientIt->second;
+    auto cost = static_cast<double>(serviceNs);
+
+    client.vtime += (cost - query.charged) / QueryScheduler::getWeight(query.priority);
+    client.avgCost = client.avgCost * 0.875 + cost * 0.125;
+    client.running--;
+
+    // forget idle clients which owe nothing
+    if (client.queries.empty() && client.running == 0 && client.vtime <= _vtime) {
+        _clients.erase(clientIt);
+    }
+}
+
+}
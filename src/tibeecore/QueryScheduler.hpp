@@ -0,0 +1,173 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _QUERYSCHEDULER_HPP
+#define _QUERYSCHEDULER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/RpcEncoding.hpp>
+
+namespace tibee
+{
+
+/**
+ * Query scheduler.
+ *
+ * Decides which queued query a free worker gets next, so that a client
+ * sending many heavy queries cannot starve the others. Each client has
+ * its own queue, ordered by priority; clients are served by weighted
+ * fair queueing: a client pays for the worker time its queries use,
+ * divided by a weight doubling with each priority level, and the
+ * client having paid the least goes first. Since the cost of a query
+ * is only known once it's done, its client is first charged with its
+ * average cost when the query is dispatched, and the difference is
+ * settled when it finishes.
+ *
+ * A client coming back after being idle starts at the current virtual
+ * time, so that it cannot bank unused time.
+ *
+ * @author Philippe Proulx
+ */
+class QueryScheduler :
+    boost::noncopyable
+{
+public:
+    /**
+     * Scheduled query.
+     */
+    struct Query
+    {
+        /// Unique tag (given by the broker)
+        std::uint64_t tag;
+
+        /// Client ID
+        std::string client;
+
+        /// Supersession group (empty if none)
+        std::string group;
+
+        /// Priority (higher is more urgent)
+        unsigned int priority;
+
+        /// Request ID
+        common::rpc_msg_id_t id;
+
+        /// Routing envelope of the request
+        std::vector<std::string> envelope;
+
+        /// Request
+        std::string payload;
+
+        /// Encoding of the request (and of its response)
+        common::RpcEncoding encoding;
+
+        /// Time at which the request was received
+        std::chrono::steady_clock::time_point receivedAt;
+
+        /// Cost charged when dispatched (scheduler internal)
+        double charged;
+    };
+
+public:
+    /**
+     * Builds a query scheduler.
+     */
+    QueryScheduler();
+
+    /**
+     * Queues a query.
+     *
+     * If the group of \p query is not empty, the queued queries of the
+     * same client and group are superseded: they are removed and
+     * appended to \p superseded.
+     *
+     * @param query      Query to queue
+     * @param superseded Superseded queries (appended)
+     */
+    void push(Query query, std::vector<Query>& superseded);
+
+    /**
+     * Removes the next query to dispatch.
+     *
+     * @param query Next query (set if any)
+     * @returns     True if a query was removed
+     */
+    bool pop(Query& query);
+
+    /**
+     * Settles the cost of a dispatched query which is now done.
+     *
+     * @param query     Query returned by pop()
+     * @param serviceNs Worker time used by \p query (ns)
+     */
+    void finish(const Query& query, std::uint64_t serviceNs);
+
+    /**
+     * Returns the total number of queued queries.
+     *
+     * @returns Number of queued queries
+     */
+    std::size_t getQueuedCount() const
+    {
+        return _queuedCount;
+    }
+
+private:
+    struct Client
+    {
+        // queued queries, by decreasing priority, then FIFO
+        std::list<Query> queries;
+
+        // virtual time (weighted ns)
+        double vtime;
+
+        // average query cost (ns)
+        double avgCost;
+
+        // number of dispatched queries not done yet
+        std::size_t running;
+    };
+
+private:
+    static double getWeight(unsigned int priority)
+    {
+        return static_cast<double>(1u << priority);
+    }
+
+private:
+    // clients (client ID -> client)
+    std::unordered_map<std::string, Client> _clients;
+
+    // virtual time of the last dispatched query
+    double _vtime;
+
+    // total number of queued queries
+    std::size_t _queuedCount;
+};
+
+}
+
+#endif // _QUERYSCHEDULER_HPP
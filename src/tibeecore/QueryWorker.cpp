@@ -0,0 +1,810 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <delorean/interval/AbstractInterval.hpp>
+#include <delorean/interval/IntervalJar.hpp>
+#include <delorean/interval/Int32Interval.hpp>
+#include <delorean/interval/Uint32Interval.hpp>
+#include <delorean/interval/Int64Interval.hpp>
+#include <delorean/interval/Uint64Interval.hpp>
+#include <delorean/interval/Float32Interval.hpp>
+#include <delorean/interval/QuarkInterval.hpp>
+
+#include <common/ex/ShmBulk.hpp>
+#include <common/mq/MqMessage.hpp>
+#include <common/state/StateValueType.hpp>
+#include "rpc/ErrorRpcResponse.hpp"
+#include "rpc/StatsRpcResponse.hpp"
+#include "rpc/StateMatrixRpcResponse.hpp"
+#include "rpc/StateSummaryRpcResponse.hpp"
+#include "QueryWorker.hpp"
+
+namespace tibee
+{
+
+QueryWorker::QueryWorker(common::MqContext* context,
+                         const std::string& backendAddr,
+                         common::StateHistorySource::UP stateHistory,
+                         std::shared_ptr<const common::StateSummarySource> stateSummary,
+                         ResultCache* resultCache, PrefetchQueue* prefetchQueue,
+                         CoreMetrics* metrics, std::size_t index,
+                         std::size_t workersCount, std::size_t shmBulkSize,
+                         bool localClients) :
+    _context {context},
+    _backendAddr {backendAddr},
+    _stateHistory {std::move(stateHistory)},
+    _stateSummary {std::move(stateSummary)},
+    _resultCache {resultCache},
+    _prefetchQueue {prefetchQueue},
+    _metrics {metrics},
+    _index {index},
+    _workersCount {workersCount},
+    _shmBulkSize {shmBulkSize},
+    _localClients {localClients},
+    _currentTag {0},
+    _cancelTag {0},
+    _prefetchSocket {nullptr},
+    _encoder {&_jsonEncoder}
+{
+}
+
+void QueryWorker::run()
+{
+    // sockets must be created in the thread using them
+    auto socket = _context->createRequestSocket();
+
+    if (!socket->connect(_backendAddr)) {
+        std::cerr << "Error: cannot connect worker to \"" <<
+                     _backendAddr << "\"" << std::endl;
+
+        return;
+    }
+
+    // tell the broker we're ready
+    auto index = std::to_string(_index);
+
+    // shared memory ring for bulk results of local clients
+    if (_shmBulkSize > 0 && _localClients) {
+        auto name = "/tibeecore-" + std::to_string(::getpid()) + "-worker-" + index;
+
+        try {
+            _shmBulkWriter = common::ShmBulkWriter::UP {
+                new common::ShmBulkWriter {
+                    name, _shmBulkSize, common::ShmBulkWriter::DEFAULT_MIN_SIZE
+                }
+            };
+        } catch (const common::ex::ShmBulk& ex) {
+            std::cerr << "Warning: " << ex.what() << " \"" <<
+                         ex.getName() << "\"" << std::endl;
+        }
+    }
+
+    socket->send(common::MqMessage::UP {
+        new common::MqMessage {index.data(), index.size()}
+    });
+
+    while (true) {
+        // speculative work only when no request is pending
+        if (_prefetchQueue && !socket->poll(0)) {
+            PrefetchQueue::Job job;
+
+            if (_prefetchQueue->pop(job)) {
+                this->prefetch(job, socket.get());
+                continue;
+            }
+        }
+
+        // tag, then request; a null message means the context is terminated
+        auto tag = socket->recv();
+
+        if (!tag || !socket->hasMore()) {
+            break;
+        }
+
+        auto request = socket->recv();
+
+        if (!request) {
+            break;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        _currentTag = 0;
+
+        if (tag->size() == sizeof(_currentTag)) {
+            std::memcpy(&_currentTag, tag->data(), sizeof(_currentTag));
+        }
+
+        auto reply = this->processRequest(static_cast<const char*>(request->data()),
+                                          request->size());
+
+        if (!reply) {
+            reply = this->error(_decoder.getId(),
+                                ErrorRpcResponse::INTERNAL_ERROR,
+                                "cannot encode response");
+        }
+
+        _currentTag = 0;
+        socket->send(std::move(tag), true);
+
+        // large results of local clients go through shared memory
+        common::MqMessage::UP replyMsg;
+
+        if (_shmBulkWriter && _decoder.wantsShmBulk()) {
+            replyMsg = _shmBulkWriter->write(reply->data(), reply->size());
+        }
+
+        if (!replyMsg) {
+            replyMsg = common::MqMessage::UP {
+                new common::MqMessage {std::move(reply)}
+            };
+        }
+
+        socket->send(std::move(replyMsg));
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        _metrics->latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    socket->close();
+}
+
+std::unique_ptr<std::string> QueryWorker::error(common::rpc_msg_id_t id,
+                                                int code,
+                                                const std::string& message)
+{
+    ErrorRpcResponse response {code, message};
+
+    response.setId(id);
+    _metrics->errors.fetch_add(1, std::memory_order_relaxed);
+
+    return _encoder->encodeErrorRpcResponse(response);
+}
+
+std::unique_ptr<std::string> QueryWorker::processRequest(const char* data,
+                                                         std::size_t len)
+{
+    auto request = _decoder.decodeRequest(data, len);
+
+    // answer with the encoding of the request
+    if (_decoder.getEncoding() == common::RpcEncoding::MSGPACK) {
+        _encoder = &_msgPackEncoder;
+    } else {
+        _encoder = &_jsonEncoder;
+    }
+
+    if (!request) {
+        return this->error(_decoder.getId(), _decoder.getErrorCode(),
+                           _decoder.getErrorMessage());
+    }
+
+    // remote clients cannot map the segment of a descriptor
+    if (_decoder.wantsShmBulk() && !_localClients) {
+        return this->error(request->getId(), ErrorRpcResponse::INVALID_PARAMS,
+                           "shared memory bulk results need an ipc or inproc connection");
+    }
+
+    // use the latest string databases if the history is being built
+    _stateHistory->sync();
+
+    const auto& method = request->getMethod();
+
+    if (method == "get-state") {
+        return this->processGetState(static_cast<const GetStateRpcRequest&>(*request));
+    } else if (method == "get-all-states") {
+        return this->processGetAllStates(static_cast<const GetAllStatesRpcRequest&>(*request));
+    } else if (method == "get-states-batch") {
+        return this->processGetStatesBatch(static_cast<const GetStatesBatchRpcRequest&>(*request));
+    } else if (method == "get-state-summary") {
+        return this->processGetStateSummary(static_cast<const GetStateSummaryRpcRequest&>(*request));
+    } else if (method == "get-stats") {
+        return this->processGetStats(static_cast<const GetStatsRpcRequest&>(*request));
+    }
+
+    return this->error(request->getId(), ErrorRpcResponse::METHOD_NOT_FOUND,
+                       "unknown method");
+}
+
+void QueryWorker::fillValue(const delo::AbstractInterval* interval,
+                            StateValue& value) const
+{
+    value.isNull = true;
+    value.type = common::StateValueType::INT32;
+    value.sint = 0;
+    value.uint = 0;
+    value.flt = 0;
+    value.str = nullptr;
+
+    if (!interval) {
+        return;
+    }
+
+    value.isNull = false;
+
+    switch (interval->getType()) {
+    case delo::IntervalType::INT32:
+        value.type = common::StateValueType::INT32;
+        value.sint = static_cast<const delo::Int32Interval*>(interval)->getValue();
+        break;
+
+    case delo::IntervalType::UINT32:
+        value.type = common::StateValueType::UINT32;
+        value.uint = static_cast<const delo::Uint32Interval*>(interval)->getValue();
+        break;
+
+    case delo::IntervalType::INT64:
+        value.type = common::StateValueType::INT64;
+        value.sint = static_cast<const delo::Int64Interval*>(interval)->getValue();
+        break;
+
+    case delo::IntervalType::UINT64:
+        value.type = common::StateValueType::UINT64;
+        value.uint = static_cast<const delo::Uint64Interval*>(interval)->getValue();
+        break;
+
+    case delo::IntervalType::FLOAT32:
+        value.type = common::StateValueType::FLOAT32;
+        value.flt = static_cast<const delo::Float32Interval*>(interval)->getValue();
+        break;
+
+    case delo::IntervalType::QUARK:
+    {
+        auto quark = static_cast<const delo::QuarkInterval*>(interval)->getValue();
+
+        value.type = common::StateValueType::QUARK;
+        value.str = _stateHistory->getStringValue(quark);
+        break;
+    }
+
+    default:
+        // null state: not a state at all
+        value.isNull = true;
+        break;
+    }
+}
+
+bool QueryWorker::fillState(const delo::AbstractInterval& interval,
+                            StatesRpcResponse::State& state) const
+{
+    state.pathQuark = static_cast<common::quark_t>(interval.getKey());
+    state.begin = interval.getBegin();
+    state.end = interval.getEnd();
+
+    auto path = _stateHistory->getPath(state.pathQuark);
+
+    if (path) {
+        state.path = path;
+    }
+
+    this->fillValue(&interval, state.value);
+
+    return !state.value.isNull;
+}
+
+std::unique_ptr<std::string> QueryWorker::processGetState(const GetStateRpcRequest& request)
+{
+    common::quark_t pathQuark = request.getPathQuark();
+
+    if (!request.hasPathQuark()) {
+        if (!_stateHistory->getPathQuark(request.getPath(), pathQuark)) {
+            return this->error(request.getId(), ErrorRpcResponse::INVALID_PARAMS,
+                               "unknown path \"" + request.getPath() + "\"");
+        }
+    } else if (pathQuark >= _stateHistory->getPathsCount()) {
+        return this->error(request.getId(), ErrorRpcResponse::INVALID_PARAMS,
+                           "unknown path quark");
+    }
+
+    StatesRpcResponse response;
+
+    response.setId(request.getId());
+    response.setTs(request.getTs());
+
+    auto interval = _stateHistory->getState(pathQuark, request.getTs());
+
+    if (interval) {
+        StatesRpcResponse::State state;
+
+        if (this->fillState(*interval, state)) {
+            response.getStates().push_back(std::move(state));
+        }
+    }
+
+    return _encoder->encodeStatesRpcResponse(response);
+}
+
+std::unique_ptr<std::string> QueryWorker::processGetAllStates(const GetAllStatesRpcRequest& request)
+{
+    StatesRpcResponse response;
+
+    response.setId(request.getId());
+    response.setTs(request.getTs());
+
+    delo::IntervalJar intervals;
+
+    if (!_stateHistory->getAllStates(request.getTs(), intervals)) {
+        return this->error(request.getId(), ErrorRpcResponse::INTERNAL_ERROR,
+                           "cannot query state history");
+    }
+
+    auto& states = response.getStates();
+
+    states.reserve(intervals.size());
+
+    for (const auto& interval : intervals) {
+        StatesRpcResponse::State state;
+
+        if (this->fillState(*interval, state)) {
+            states.push_back(std::move(state));
+        }
+    }
+
+    return _encoder->encodeStatesRpcResponse(response);
+}
+
+bool QueryWorker::resolvePaths(const std::vector<common::quark_t>& quarks,
+                               const std::vector<std::string>& globs,
+                               std::vector<common::quark_t>& pathQuarks) const
+{
+    auto pathsCount = _stateHistory->getPathsCount();
+
+    // explicit quarks first, then globs, without duplicates
+    std::vector<common::quark_t> candidates;
+    std::vector<bool> seen(pathsCount, false);
+
+    for (auto quark : quarks) {
+        if (quark >= pathsCount) {
+            return false;
+        }
+
+        candidates.push_back(quark);
+    }
+
+    for (const auto& glob : globs) {
+        _stateHistory->findPaths(glob, candidates);
+    }
+
+    for (auto quark : candidates) {
+        if (!seen[quark]) {
+            seen[quark] = true;
+            pathQuarks.push_back(quark);
+        }
+    }
+
+    return true;
+}
+
+bool QueryWorker::sweepStates(const std::vector<common::quark_t>& pathQuarks,
+                              const std::vector<common::timestamp_t>& timestamps,
+                              std::vector<StateValue>& values)
+{
+    /* Timestamps are sorted, so we sweep them once, keeping the last
+     * interval of each attribute: as long as it covers the current
+     * timestamp, the previous value is reused without touching the
+     * history. Only stale attributes are looked up; when many of them
+     * are stale at once, a single findAll() is cheaper than as many
+     * findOne().
+     *
+     * Null attributes (no interval at the last lookup) are stale on
+     * every timestamp, since we cannot tell when they get a value. They
+     * are not counted in the stale ratio, otherwise a mostly null
+     * matrix would fall back to findAll() on each timestamp.
+     */
+    auto rows = pathQuarks.size();
+    auto cols = timestamps.size();
+
+    values.resize(rows * cols);
+
+    std::vector<delo::AbstractInterval::SP> intervals(rows);
+    std::vector<bool> isNull(rows, false);
+    std::vector<std::size_t> stale;
+    std::unordered_map<common::quark_t, std::size_t> rowOfQuark;
+    delo::IntervalJar jar;
+
+    for (std::size_t row = 0; row < rows; ++row) {
+        rowOfQuark[pathQuarks[row]] = row;
+    }
+
+    for (std::size_t col = 0; col < cols; ++col) {
+        auto ts = timestamps[col];
+
+        if (this->isCancelled()) {
+            return false;
+        }
+
+        stale.clear();
+
+        std::size_t expiredCount = 0;
+
+        for (std::size_t row = 0; row < rows; ++row) {
+            const auto& interval = intervals[row];
+
+            if (isNull[row]) {
+                stale.push_back(row);
+            } else if (!interval || ts < interval->getBegin() || ts > interval->getEnd()) {
+                stale.push_back(row);
+                expiredCount++;
+            }
+        }
+
+        if (expiredCount * 4 > rows) {
+            jar.clear();
+            _stateHistory->getAllStates(ts, jar);
+
+            for (auto row : stale) {
+                intervals[row] = nullptr;
+            }
+
+            for (const auto& interval : jar) {
+                auto it = rowOfQuark.find(static_cast<common::quark_t>(interval->getKey()));
+
+                if (it != rowOfQuark.end()) {
+                    intervals[it->second] = interval;
+                }
+            }
+        } else {
+            for (auto row : stale) {
+                intervals[row] = _stateHistory->getState(pathQuarks[row], ts);
+            }
+        }
+
+        for (auto row : stale) {
+            isNull[row] = !intervals[row];
+        }
+
+        // fill stale cells and copy the others from the previous column
+        std::size_t staleIndex = 0;
+
+        for (std::size_t row = 0; row < rows; ++row) {
+            auto& value = values[row * cols + col];
+
+            if (staleIndex < stale.size() && stale[staleIndex] == row) {
+                staleIndex++;
+                this->fillValue(intervals[row].get(), value);
+            } else {
+                value = values[row * cols + col - 1];
+            }
+        }
+    }
+
+    return true;
+}
+
+std::unique_ptr<std::string> QueryWorker::processGetStatesBatch(const GetStatesBatchRpcRequest& request)
+{
+    StateMatrixRpcResponse response;
+    auto& pathQuarks = response.getPathQuarks();
+
+    response.setId(request.getId());
+
+    if (!this->resolvePaths(request.getPathQuarks(), request.getPathGlobs(),
+                            pathQuarks)) {
+        return this->error(request.getId(), ErrorRpcResponse::INVALID_PARAMS,
+                           "unknown path quark");
+    }
+
+    const auto& timestamps = request.getTimestamps();
+
+    if (pathQuarks.size() * timestamps.size() > MAX_BATCH_VALUES) {
+        return this->error(request.getId(), ErrorRpcResponse::INVALID_PARAMS,
+                           "too many values requested");
+    }
+
+    response.getTimestamps() = timestamps;
+
+    for (auto quark : pathQuarks) {
+        response.getPaths().push_back(_stateHistory->getPath(quark));
+    }
+
+    if (!this->sweepStates(pathQuarks, timestamps, response.getValues())) {
+        return this->error(request.getId(), ErrorRpcResponse::REQUEST_CANCELLED,
+                           "request cancelled");
+    }
+
+    return _encoder->encodeStateMatrixRpcResponse(response);
+}
+
+void QueryWorker::fillSummaryValue(const common::StateSummarySource::Summary& summary,
+                                   StateValue& value) const
+{
+    value.isNull = summary.isNull;
+    value.type = summary.type;
+    value.sint = 0;
+    value.uint = 0;
+    value.flt = 0;
+    value.str = nullptr;
+
+    if (summary.isNull) {
+        return;
+    }
+
+    switch (summary.type) {
+    case common::StateValueType::INT32:
+    case common::StateValueType::INT64:
+        value.sint = static_cast<std::int64_t>(summary.dominant);
+        break;
+
+    case common::StateValueType::UINT32:
+    case common::StateValueType::UINT64:
+        value.uint = summary.dominant;
+        break;
+
+    case common::StateValueType::FLOAT32:
+    {
+        // raw value holds the bits of a double
+        double flt;
+
+        std::memcpy(&flt, &summary.dominant, sizeof(flt));
+        value.flt = flt;
+        break;
+    }
+
+    case common::StateValueType::QUARK:
+        value.str = _stateHistory->getStringValue(static_cast<common::quark_t>(summary.dominant));
+        break;
+
+    default:
+        value.isNull = true;
+        break;
+    }
+}
+
+std::unique_ptr<std::string> QueryWorker::processGetStateSummary(const GetStateSummaryRpcRequest& request)
+{
+    if (!_stateSummary) {
+        return this->error(request.getId(), ErrorRpcResponse::INTERNAL_ERROR,
+                           "no state summary in cache");
+    }
+
+    std::vector<common::quark_t> pathQuarks;
+    auto bucketsCount = request.getBucketsCount();
+
+    if (!this->resolvePaths(request.getPathQuarks(), request.getPathGlobs(),
+                            pathQuarks)) {
+        return this->error(request.getId(), ErrorRpcResponse::INVALID_PARAMS,
+                           "unknown path quark");
+    }
+
+    if (bucketsCount > MAX_BATCH_VALUES ||
+            pathQuarks.size() * bucketsCount > MAX_BATCH_VALUES) {
+        return this->error(request.getId(), ErrorRpcResponse::INVALID_PARAMS,
+                           "too many values requested");
+    }
+
+    auto key = QueryWorker::getSummaryKey(pathQuarks, request.getBegin(),
+                                          request.getEnd(), bucketsCount);
+    ResultCache::Value cached;
+
+    if (_resultCache) {
+        cached = _resultCache->get(key);
+
+        if (cached) {
+            _metrics->cacheHits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            _metrics->cacheMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!cached) {
+        cached = this->summarize(key, pathQuarks, request.getBegin(),
+                                 request.getEnd(), bucketsCount);
+
+        if (!cached) {
+            return this->error(request.getId(), ErrorRpcResponse::REQUEST_CANCELLED,
+                               "request cancelled");
+        }
+    }
+
+    this->queueAdjacentSummaries(pathQuarks, request.getBegin(),
+                                 request.getEnd(), bucketsCount);
+
+    // cached responses are shared: copy to set the ID
+    StateSummaryRpcResponse response {*cached};
+
+    response.setId(request.getId());
+
+    return _encoder->encodeStateSummaryRpcResponse(response);
+}
+
+ResultCache::Value QueryWorker::summarize(const std::string& key,
+                                          const std::vector<common::quark_t>& pathQuarks,
+                                          common::timestamp_t begin,
+                                          common::timestamp_t end,
+                                          std::size_t bucketsCount)
+{
+    std::shared_ptr<StateSummaryRpcResponse> response {new StateSummaryRpcResponse};
+    auto& cells = response->getCells();
+    std::vector<common::StateSummarySource::Summary> summaries;
+
+    response->setRange(begin, end, bucketsCount);
+    response->getPathQuarks() = pathQuarks;
+    cells.resize(pathQuarks.size() * bucketsCount);
+
+    for (std::size_t row = 0; row < pathQuarks.size(); ++row) {
+        auto quark = pathQuarks[row];
+
+        if (this->isCancelled()) {
+            return nullptr;
+        }
+
+        response->getPaths().push_back(_stateHistory->getPath(quark));
+        _stateSummary->summarize(quark, begin, end, bucketsCount, summaries);
+
+        for (std::size_t col = 0; col < bucketsCount; ++col) {
+            const auto& summary = summaries[col];
+            auto& cell = cells[row * bucketsCount + col];
+
+            this->fillSummaryValue(summary, cell.dominant);
+            cell.transitions = summary.transitions;
+            cell.min = summary.min;
+            cell.max = summary.max;
+        }
+    }
+
+    if (_resultCache) {
+        auto bytes = sizeof(StateSummaryRpcResponse) +
+                     cells.size() * sizeof(StateSummaryRpcResponse::Cell) +
+                     pathQuarks.size() * (sizeof(common::quark_t) + sizeof(const std::string*));
+
+        _resultCache->put(key, response, bytes);
+    }
+
+    return response;
+}
+
+void QueryWorker::queueAdjacentSummaries(const std::vector<common::quark_t>& pathQuarks,
+                                         common::timestamp_t begin,
+                                         common::timestamp_t end,
+                                         std::size_t bucketsCount)
+{
+    if (!_prefetchQueue) {
+        return;
+    }
+
+    auto span = end - begin;
+    PrefetchQueue::Job job;
+
+    job.pathQuarks = pathQuarks;
+    job.bucketsCount = bucketsCount;
+
+    // previous viewport
+    if (begin > _stateSummary->getBegin() && begin >= span) {
+        job.begin = begin - span;
+        job.end = begin;
+        job.key = QueryWorker::getSummaryKey(pathQuarks, job.begin, job.end,
+                                             bucketsCount);
+
+        if (!_resultCache->contains(job.key)) {
+            _prefetchQueue->push(job);
+        }
+    }
+
+    // next viewport
+    if (end <= _stateSummary->getEnd() &&
+            end <= std::numeric_limits<common::timestamp_t>::max() - span) {
+        job.begin = end;
+        job.end = end + span;
+        job.key = QueryWorker::getSummaryKey(pathQuarks, job.begin, job.end,
+                                             bucketsCount);
+
+        if (!_resultCache->contains(job.key)) {
+            _prefetchQueue->push(std::move(job));
+        }
+    }
+}
+
+void QueryWorker::prefetch(const PrefetchQueue::Job& job,
+                           common::AbstractMqSocket* socket)
+{
+    // another worker could have been asked for it in the meantime
+    if (_resultCache->contains(job.key)) {
+        return;
+    }
+
+    /* The broker does not know this worker is prefetching: abort
+     * between rows as soon as a request is pending (see isCancelled()),
+     * and retry later.
+     */
+    _prefetchSocket = socket;
+
+    auto response = this->summarize(job.key, job.pathQuarks, job.begin,
+                                    job.end, job.bucketsCount);
+
+    _prefetchSocket = nullptr;
+
+    if (!response) {
+        _prefetchQueue->push(job);
+
+        return;
+    }
+
+    _metrics->prefetches.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string QueryWorker::getSummaryKey(const std::vector<common::quark_t>& pathQuarks,
+                                       common::timestamp_t begin,
+                                       common::timestamp_t end,
+                                       std::size_t bucketsCount)
+{
+    /* Paths are resolved (globs expanded, duplicates removed) before
+     * building the key, so that equivalent queries share results.
+     */
+    std::string key;
+    std::uint64_t buckets = bucketsCount;
+
+    key.reserve(3 * sizeof(std::uint64_t) +
+                pathQuarks.size() * sizeof(common::quark_t));
+    key.append(reinterpret_cast<const char*>(&begin), sizeof(begin));
+    key.append(reinterpret_cast<const char*>(&end), sizeof(end));
+    key.append(reinterpret_cast<const char*>(&buckets), sizeof(buckets));
+    key.append(reinterpret_cast<const char*>(pathQuarks.data()),
+               pathQuarks.size() * sizeof(common::quark_t));
+
+    return key;
+}
+
+std::unique_ptr<std::string> QueryWorker::processGetStats(const GetStatsRpcRequest& request)
+{
+    StatsRpcResponse response;
+    const auto& latency = _metrics->latency;
+
+    response.setId(request.getId());
+    response.setHistoryRange(_stateHistory->getBegin(), _stateHistory->getEnd());
+    response.setWorkers(_workersCount);
+    response.setRequests(latency.getCount());
+    response.setErrors(_metrics->errors.load(std::memory_order_relaxed));
+    response.setLatencies(latency.getPercentile(50),
+                          latency.getPercentile(90),
+                          latency.getPercentile(99),
+                          latency.getMax());
+    response.setCacheStats(_metrics->cacheHits.load(std::memory_order_relaxed),
+                           _metrics->cacheMisses.load(std::memory_order_relaxed),
+                           _metrics->prefetches.load(std::memory_order_relaxed),
+                           _resultCache ? _resultCache->getBytes() : 0);
+
+    // per-client statistics
+    {
+        std::lock_guard<std::mutex> lock {_metrics->clientsMutex};
+
+        for (const auto& idMetricsPair : _metrics->clients) {
+            const auto& clientMetrics = *idMetricsPair.second;
+            StatsRpcResponse::Client client;
+
+            client.id = idMetricsPair.first;
+            client.queued = clientMetrics.queued.load(std::memory_order_relaxed);
+            client.running = clientMetrics.running.load(std::memory_order_relaxed);
+            client.requests = clientMetrics.requests.load(std::memory_order_relaxed);
+            client.cancelled = clientMetrics.cancelled.load(std::memory_order_relaxed);
+            client.p50 = clientMetrics.latency.getPercentile(50);
+            client.p99 = clientMetrics.latency.getPercentile(99);
+            response.getClients().push_back(std::move(client));
+        }
+    }
+
+    return _encoder->encodeStatsRpcResponse(response);
+}
+
+}
@@ -0,0 +1,210 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _QUERYWORKER_HPP
+#define _QUERYWORKER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <delorean/interval/AbstractInterval.hpp>
+
+#include <common/BasicTypes.hpp>
+#include <common/mq/AbstractMqSocket.hpp>
+#include <common/mq/MqContext.hpp>
+#include <common/mq/ShmBulkWriter.hpp>
+#include <common/state/StateHistorySource.hpp>
+#include <common/state/StateSummarySource.hpp>
+#include "rpc/CoreRpcMessageDecoder.hpp"
+#include "rpc/CoreJsonRpcMessageEncoder.hpp"
+#include "rpc/CoreMsgPackRpcMessageEncoder.hpp"
+#include "rpc/GetStateRpcRequest.hpp"
+#include "rpc/GetAllStatesRpcRequest.hpp"
+#include "rpc/GetStatesBatchRpcRequest.hpp"
+#include "rpc/GetStateSummaryRpcRequest.hpp"
+#include "rpc/GetStatsRpcRequest.hpp"
+#include "rpc/StateValue.hpp"
+#include "rpc/StatesRpcResponse.hpp"
+#include "CoreMetrics.hpp"
+#include "PrefetchQueue.hpp"
+#include "ResultCache.hpp"
+
+namespace tibee
+{
+
+/**
+ * Query worker.
+ *
+ * A query worker owns a request socket connected to the backend of
+ * the analysis core broker (see CoreBroker) and its own state history
+ * source. Its run() method, meant to be executed in a dedicated
+ * thread, answers requests until the message queue context is
+ * terminated.
+ *
+ * Long requests check, between steps, whether the broker cancelled
+ * them (see cancel()), in which case they're answered with a
+ * REQUEST_CANCELLED error.
+ *
+ * State summaries are kept in a shared result cache. After answering
+ * a state summary request, the adjacent viewports (same duration and
+ * resolution, before and after) are queued for prefetching; a worker
+ * computes such speculative queries only when no request is pending,
+ * and aborts them between rows as soon as one arrives.
+ *
+ * Requests asking for shared memory bulk results (see
+ * common::ShmBulkWriter) are rejected unless clients are local.
+ *
+ * @author Philippe Proulx
+ */
+class QueryWorker :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to query worker
+    typedef std::unique_ptr<QueryWorker> UP;
+
+public:
+    /**
+     * Builds a query worker.
+     *
+     * @param context       Message queue context (shared)
+     * @param backendAddr   Address of broker backend to connect to
+     * @param stateHistory  State history source (owned by this worker)
+     * @param stateSummary  State summary source (shared, may be null)
+     * @param resultCache   Result cache (shared, may be null)
+     * @param prefetchQueue Prefetch queue (shared, may be null)
+     * @param metrics       Core metrics (shared)
+     * @param index         Index of this worker
+     * @param workersCount  Total number of workers (for statistics)
+     * @param shmBulkSize   Size of the shared memory ring for bulk
+     *                      results (bytes, 0 to disable)
+     * @param localClients  True if clients connect through a local
+     *                      transport (see
+     *                      common::ShmBulkWriter::isLocalAddress())
+     */
+    QueryWorker(common::MqContext* context, const std::string& backendAddr,
+                common::StateHistorySource::UP stateHistory,
+                std::shared_ptr<const common::StateSummarySource> stateSummary,
+                ResultCache* resultCache, PrefetchQueue* prefetchQueue,
+                CoreMetrics* metrics, std::size_t index,
+                std::size_t workersCount, std::size_t shmBulkSize,
+                bool localClients);
+
+    /**
+     * Answers requests until the message queue context is terminated.
+     */
+    void run();
+
+    /**
+     * Cancels the request having tag \p tag if it's the current one
+     * of this worker. May be called from any thread.
+     *
+     * @param tag Tag of request to cancel (given by the broker)
+     */
+    void cancel(std::uint64_t tag)
+    {
+        _cancelTag.store(tag, std::memory_order_relaxed);
+    }
+
+private:
+    bool isCancelled() const
+    {
+        // speculative work yields to any pending request
+        if (_prefetchSocket) {
+            return _prefetchSocket->poll(0);
+        }
+
+        return _currentTag != 0 &&
+               _cancelTag.load(std::memory_order_relaxed) == _currentTag;
+    }
+
+    std::unique_ptr<std::string> processRequest(const char* data,
+                                                std::size_t len);
+    std::unique_ptr<std::string> processGetState(const GetStateRpcRequest& request);
+    std::unique_ptr<std::string> processGetAllStates(const GetAllStatesRpcRequest& request);
+    std::unique_ptr<std::string> processGetStatesBatch(const GetStatesBatchRpcRequest& request);
+    std::unique_ptr<std::string> processGetStateSummary(const GetStateSummaryRpcRequest& request);
+    std::unique_ptr<std::string> processGetStats(const GetStatsRpcRequest& request);
+    std::unique_ptr<std::string> error(common::rpc_msg_id_t id, int code,
+                                       const std::string& message);
+    bool fillState(const delo::AbstractInterval& interval,
+                   StatesRpcResponse::State& state) const;
+    void fillValue(const delo::AbstractInterval* interval,
+                   StateValue& value) const;
+    ResultCache::Value summarize(const std::string& key,
+                                 const std::vector<common::quark_t>& pathQuarks,
+                                 common::timestamp_t begin,
+                                 common::timestamp_t end,
+                                 std::size_t bucketsCount);
+    void queueAdjacentSummaries(const std::vector<common::quark_t>& pathQuarks,
+                                common::timestamp_t begin,
+                                common::timestamp_t end,
+                                std::size_t bucketsCount);
+    void prefetch(const PrefetchQueue::Job& job, common::AbstractMqSocket* socket);
+    static std::string getSummaryKey(const std::vector<common::quark_t>& pathQuarks,
+                                     common::timestamp_t begin,
+                                     common::timestamp_t end,
+                                     std::size_t bucketsCount);
+    bool resolvePaths(const std::vector<common::quark_t>& quarks,
+                      const std::vector<std::string>& globs,
+                      std::vector<common::quark_t>& pathQuarks) const;
+    void fillSummaryValue(const common::StateSummarySource::Summary& summary,
+                          StateValue& value) const;
+    bool sweepStates(const std::vector<common::quark_t>& pathQuarks,
+                     const std::vector<common::timestamp_t>& timestamps,
+                     std::vector<StateValue>& values);
+
+private:
+    // maximum number of values of a batch response
+    static const std::size_t MAX_BATCH_VALUES = 1 << 22;
+
+private:
+    common::MqContext* _context;
+    std::string _backendAddr;
+    common::StateHistorySource::UP _stateHistory;
+    std::shared_ptr<const common::StateSummarySource> _stateSummary;
+    ResultCache* _resultCache;
+    PrefetchQueue* _prefetchQueue;
+    CoreMetrics* _metrics;
+    std::size_t _index;
+    std::size_t _workersCount;
+    std::size_t _shmBulkSize;
+    bool _localClients;
+
+    // shared memory ring for bulk results (null if disabled)
+    common::ShmBulkWriter::UP _shmBulkWriter;
+
+    // tag of current request (0 if none) and of the cancelled one
+    std::uint64_t _currentTag;
+    std::atomic<std::uint64_t> _cancelTag;
+
+    // request socket while prefetching (null otherwise)
+    common::AbstractMqSocket* _prefetchSocket;
+    CoreRpcMessageDecoder _decoder;
+    CoreJsonRpcMessageEncoder _jsonEncoder;
+    CoreMsgPackRpcMessageEncoder _msgPackEncoder;
+
+    // encoder of the current request's encoding
+    AbstractCoreRpcMessageEncoder* _encoder;
+};
+
+}
+
+#endif // _QUERYWORKER_HPP
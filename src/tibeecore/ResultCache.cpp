@@ -0,0 +1,99 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ResultCache.hpp"
+
+namespace tibee
+{
+
+ResultCache::ResultCache(std::size_t maxBytes) :
+    _bytes {0},
+    _maxBytes {maxBytes}
+{
+}
+
+ResultCache::Value ResultCache::get(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    auto it = _index.find(key);
+
+    if (it == _index.end()) {
+        return nullptr;
+    }
+
+    // move to front
+    _entries.splice(_entries.begin(), _entries, it->second);
+
+    return it->second->value;
+}
+
+bool ResultCache::contains(const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _index.count(key) != 0;
+}
+
+void ResultCache::put(const std::string& key, Value value, std::size_t bytes)
+{
+    bytes += key.size() + sizeof(Entry);
+
+    if (bytes > _maxBytes) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    // another worker could have computed the same value
+    auto it = _index.find(key);
+
+    if (it != _index.end()) {
+        _bytes -= it->second->bytes;
+        _entries.erase(it->second);
+        _index.erase(it);
+    }
+
+    // evict least recently used values
+    while (_bytes + bytes > _maxBytes) {
+        const auto& last = _entries.back();
+
+        _bytes -= last.bytes;
+        _index.erase(last.key);
+        _entries.pop_back();
+    }
+
+    _entries.push_front(Entry {key, std::move(value), bytes});
+    _index[key] = _entries.begin();
+    _bytes += bytes;
+}
+
+std::size_t ResultCache::getBytes() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _bytes;
+}
+
+std::size_t ResultCache::getCount() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _entries.size();
+}
+
+}
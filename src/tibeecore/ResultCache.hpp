@@ -0,0 +1,127 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _RESULTCACHE_HPP
+#define _RESULTCACHE_HPP
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <boost/utility.hpp>
+
+#include "rpc/StateSummaryRpcResponse.hpp"
+
+namespace tibee
+{
+
+/**
+ * Result cache, shared by all query workers.
+ *
+ * Keeps computed state summaries, keyed by normalized query (see
+ * QueryWorker), and evicts the least recently used ones when the
+ * total size exceeds a given number of bytes. Cached responses are
+ * immutable; their request ID is meaningless.
+ *
+ * @author Philippe Proulx
+ */
+class ResultCache :
+    boost::noncopyable
+{
+public:
+    /// Cached value
+    typedef std::shared_ptr<const StateSummaryRpcResponse> Value;
+
+public:
+    /**
+     * Builds a result cache.
+     *
+     * @param maxBytes Maximum total size of cached values (bytes)
+     */
+    explicit ResultCache(std::size_t maxBytes);
+
+    /**
+     * Returns the value of \p key and marks it as the most recently
+     * used one.
+     *
+     * @param key Normalized query
+     * @returns   Cached value or \a nullptr if not found
+     */
+    Value get(const std::string& key);
+
+    /**
+     * Checks whether or not \p key is cached, without changing its
+     * position.
+     *
+     * @param key Normalized query
+     * @returns   True if cached
+     */
+    bool contains(const std::string& key) const;
+
+    /**
+     * Caches a value, evicting the least recently used values if
+     * needed. Values larger than the whole cache are not cached.
+     *
+     * @param key   Normalized query
+     * @param value Value to cache
+     * @param bytes Approximate size of \p value (bytes)
+     */
+    void put(const std::string& key, Value value, std::size_t bytes);
+
+    /**
+     * Returns the total size of cached values (bytes).
+     *
+     * @returns Total size of cached values
+     */
+    std::size_t getBytes() const;
+
+    /**
+     * Returns the number of cached values.
+     *
+     * @returns Number of cached values
+     */
+    std::size_t getCount() const;
+
+private:
+    struct Entry
+    {
+        std::string key;
+        Value value;
+        std::size_t bytes;
+    };
+
+    typedef std::list<Entry> Entries;
+
+private:
+    mutable std::mutex _mutex;
+
+    // entries, most recently used first
+    Entries _entries;
+
+    // key -> position in _entries
+    std::unordered_map<std::string, Entries::iterator> _index;
+
+    // current and maximum total size (bytes)
+    std::size_t _bytes;
+    std::size_t _maxBytes;
+};
+
+}
+
+#endif // _RESULTCACHE_HPP
@@ -0,0 +1,103 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <common/mq/MqMessage.hpp>
+#include "SnapshotWatcher.hpp"
+
+namespace tibee
+{
+
+SnapshotWatcher::SnapshotWatcher(common::MqContext* context,
+                                 const std::string& bindAddr,
+                                 common::StateHistorySource::UP stateHistory,
+                                 std::size_t periodMs) :
+    _context {context},
+    _bindAddr {bindAddr},
+    _stateHistory {std::move(stateHistory)},
+    _periodMs {periodMs},
+    _stopped {false}
+{
+}
+
+void SnapshotWatcher::run()
+{
+    // sockets must be created in the thread using them
+    auto socket = _context->createPublishSocket();
+
+    if (!socket->bind(_bindAddr)) {
+        std::cerr << "Error: cannot bind snapshot watcher to \"" <<
+                     _bindAddr << "\"" << std::endl;
+
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock {_mutex};
+
+    while (!_stopped) {
+        _cond.wait_for(lock, std::chrono::milliseconds(_periodMs));
+
+        if (_stopped) {
+            break;
+        }
+
+        lock.unlock();
+
+        // the watermark only moves when a new snapshot is loaded
+        if (_stateHistory->refresh()) {
+            _stateHistory->sync();
+            this->publish(*socket);
+        }
+
+        lock.lock();
+    }
+
+    socket->close();
+}
+
+void SnapshotWatcher::stop()
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    _stopped = true;
+    _cond.notify_one();
+}
+
+void SnapshotWatcher::publish(common::AbstractMqSocket& socket)
+{
+    _notification.setBegin(_stateHistory->getBegin());
+    _notification.setWatermark(_stateHistory->getEnd());
+    _notification.setComplete(_stateHistory->isComplete());
+    _notification.setPathsCount(_stateHistory->getPathsCount());
+
+    auto json = _encoder.encodeWatermarkUpdateRpcNotification(_notification);
+
+    if (!json) {
+        return;
+    }
+
+    socket.send(common::MqMessage::UP {
+        new common::MqMessage {std::move(json)}
+    });
+}
+
+}
@@ -0,0 +1,113 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SNAPSHOTWATCHER_HPP
+#define _SNAPSHOTWATCHER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <boost/utility.hpp>
+
+#include <common/mq/MqContext.hpp>
+#include <common/state/StateHistorySource.hpp>
+#include "rpc/CoreJsonRpcMessageEncoder.hpp"
+#include "rpc/WatermarkUpdateRpcNotification.hpp"
+
+namespace tibee
+{
+
+/**
+ * Snapshot watcher.
+ *
+ * When the state history is still being built, the analysis core
+ * serves its latest published snapshot (see
+ * common::StateSnapshotSource). A snapshot watcher periodically loads
+ * the latest snapshot for all the query workers and publishes a
+ * watermark update notification (WatermarkUpdateRpcNotification) on
+ * its own publish socket each time the watermark moves.
+ *
+ * Its run() method, meant to be executed in a dedicated thread, watches
+ * until stop() is called.
+ *
+ * @author Philippe Proulx
+ */
+class SnapshotWatcher :
+    boost::noncopyable
+{
+public:
+    /// Unique pointer to snapshot watcher
+    typedef std::unique_ptr<SnapshotWatcher> UP;
+
+public:
+    /**
+     * Builds a snapshot watcher.
+     *
+     * @param context      Message queue context (shared)
+     * @param bindAddr     Address to bind the publish socket to
+     * @param stateHistory Live state history source (owned; a fork of
+     *                     the workers' ones)
+     * @param periodMs     Watch period in milliseconds
+     */
+    SnapshotWatcher(common::MqContext* context, const std::string& bindAddr,
+                    common::StateHistorySource::UP stateHistory,
+                    std::size_t periodMs);
+
+    /**
+     * Watches until stop() is called.
+     */
+    void run();
+
+    /**
+     * Stops watching; the socket is closed before run() returns. May
+     * be called from any thread.
+     */
+    void stop();
+
+private:
+    void publish(common::AbstractMqSocket& socket);
+
+private:
+    // message queue context
+    common::MqContext* _context;
+
+    // bind address
+    std::string _bindAddr;
+
+    // live state history source
+    common::StateHistorySource::UP _stateHistory;
+
+    // watch period
+    std::size_t _periodMs;
+
+    // RPC message encoder
+    CoreJsonRpcMessageEncoder _encoder;
+
+    // RPC notification (watermark update)
+    WatermarkUpdateRpcNotification _notification;
+
+    // stop request
+    bool _stopped;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+};
+
+}
+
+#endif // _SNAPSHOTWATCHER_HPP
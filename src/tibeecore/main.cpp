@@ -1,9 +1,217 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
 #include <iostream>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <thread>
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
 
-int main(int argc, char* argv[])
+#include "CoreBeetle.hpp"
+#include "Arguments.hpp"
+
+namespace bfs = boost::filesystem;
+
+namespace
 {
-    std::cout << "Hello, tiger beetle!" << std::endl <<
-                         "I'm the analysis core." << std::endl;
+
+/**
+ * Parses the command line arguments passed to the program.
+ *
+ * @param argc Number of arguments in \p argv
+ * @param argv Command line arguments
+ * @param args Arguments values to fill
+ *
+ * @returns    0 to continue, 1 if there's a command line error
+ */
+int parseOptions(int argc, char* argv[], tibee::Arguments& args)
+{
+    namespace bpo = boost::program_options;
+
+    bpo::options_description desc;
+
+    desc.add_options()
+        ("help,h", "help")
+        ("verbose,v", bpo::bool_switch()->default_value(false))
+        ("traces,T", bpo::value<std::vector<std::string>>())
+        ("bind,b", bpo::value<std::string>())
+        ("stream-bind,s", bpo::value<std::string>())
+        ("notify-bind,n", bpo::value<std::string>())
+        ("cache-dir,d", bpo::value<std::string>())
+        ("workers,w", bpo::value<std::size_t>())
+        ("result-cache,r", bpo::value<std::size_t>())
+        ("shm-bulk", bpo::value<std::size_t>())
+    ;
+
+    bpo::positional_options_description pos;
+
+    pos.add("traces", -1);
+
+    bpo::variables_map vm;
+
+    try {
+        auto cliParser = bpo::command_line_parser(argc, argv);
+        auto parsedOptions = cliParser.options(desc).positional(pos).run();
+
+        bpo::store(parsedOptions, vm);
+    } catch (const std::exception& ex) {
+        std::cerr << "Command line error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (!vm["help"].empty()) {
+        std::cout <<
+            "usage: tibeecore [options] [<trace path>...]" << std::endl <<
+            std::endl <<
+            "options:" << std::endl <<
+            std::endl <<
+            "  -h, --help       print this help message" << std::endl <<
+            "  -b, --bind       bind address for queries (default: tcp://*:2800)" << std::endl <<
+            "  -s, --stream-bind" << std::endl <<
+            "                   bind address for event streams, if traces are given" << std::endl <<
+            "                   (default: tcp://*:2801)" << std::endl <<
+            "  -n, --notify-bind" << std::endl <<
+            "                   bind address for watermark updates, if the state" << std::endl <<
+            "                   history is being built with tibeebuild -l" << std::endl <<
+            "                   (default: tcp://*:2802)" << std::endl <<
+            "  -d, --cache-dir  read caches from this directory (default: CWD)" << std::endl <<
+            "  -w, --workers    number of query workers (default: number of CPUs)" << std::endl <<
+            "  -r, --result-cache" << std::endl <<
+            "                   result cache size in MiB, 0 to disable (default: 64)" << std::endl <<
+            "  --shm-bulk       shared memory ring size in MiB of each worker and of" << std::endl <<
+            "                   the event streamer for bulk results of local" << std::endl <<
+            "                   clients (ipc:// bind addresses only), 0 to disable" << std::endl <<
+            "                   (default: 0)" << std::endl <<
+            "  -v, --verbose    verbose" << std::endl;
+
+        return -1;
+    }
+
+    try {
+        vm.notify();
+    } catch (const std::exception& ex) {
+        std::cerr << "Command line error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    // traces (optional: only needed to stream events)
+    if (!vm["traces"].empty()) {
+        auto traces = vm["traces"].as<std::vector<std::string>>();
+
+        for (const auto& trace : traces) {
+            bfs::path p {trace};
+
+            if (!bfs::exists(p)) {
+                std::cerr << "Trace path " << p << " does not exist" << std::endl;
+                return 1;
+            }
+
+            args.traces.push_back(p);
+        }
+    }
+
+    // cache directory
+    bfs::path cacheDirPath = bfs::current_path();
+
+    if (!vm["cache-dir"].empty()) {
+        cacheDirPath = vm["cache-dir"].as<std::string>();
+    }
+
+    if (bfs::exists(cacheDirPath) && bfs::is_directory(cacheDirPath)) {
+        args.cacheDir = cacheDirPath;
+    } else {
+        std::cerr << "Cache directory " << cacheDirPath << " is not a directory" << std::endl;
+        return 1;
+    }
+
+    // bind address
+    args.bindAddr = "tcp://*:2800";
+
+    if (!vm["bind"].empty()) {
+        args.bindAddr = vm["bind"].as<std::string>();
+    }
+
+    // event streams bind address
+    args.streamBindAddr = "tcp://*:2801";
+
+    if (!vm["stream-bind"].empty()) {
+        args.streamBindAddr = vm["stream-bind"].as<std::string>();
+    }
+
+    // watermark updates bind address
+    args.notifyBindAddr = "tcp://*:2802";
+
+    if (!vm["notify-bind"].empty()) {
+        args.notifyBindAddr = vm["notify-bind"].as<std::string>();
+    }
+
+    // workers
+    args.workers = std::thread::hardware_concurrency();
+
+    if (!vm["workers"].empty()) {
+        args.workers = vm["workers"].as<std::size_t>();
+    }
+
+    if (args.workers == 0) {
+        args.workers = 1;
+    }
+
+    // result cache size
+    args.resultCacheSize = 64;
+
+    if (!vm["result-cache"].empty()) {
+        args.resultCacheSize = vm["result-cache"].as<std::size_t>();
+    }
+
+    args.resultCacheSize *= 1024 * 1024;
+
+    // shared memory bulk ring size
+    args.shmBulkSize = 0;
+
+    if (!vm["shm-bulk"].empty()) {
+        args.shmBulkSize = vm["shm-bulk"].as<std::size_t>();
+    }
+
+    args.shmBulkSize *= 1024 * 1024;
+
+    // verbose
+    args.verbose = vm["verbose"].as<bool>();
 
     return 0;
 }
+
+}
+
+int main(int argc, char* argv[])
+{
+    tibee::Arguments args;
+
+    int ret = parseOptions(argc, argv, args);
+
+    if (ret < 0) {
+        return 0;
+    } else if (ret > 0) {
+        return ret;
+    }
+
+    // create the core beetle and run it
+    std::unique_ptr<tibee::CoreBeetle> coreBeetle {new tibee::CoreBeetle {args}};
+
+    return coreBeetle->run() ? 0 : 1;
+}
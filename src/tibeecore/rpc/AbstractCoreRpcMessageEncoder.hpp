@@ -0,0 +1,103 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _ABSTRACTCORERPCMESSAGEENCODER_HPP
+#define _ABSTRACTCORERPCMESSAGEENCODER_HPP
+
+#include <memory>
+#include <string>
+
+#include "StatesRpcResponse.hpp"
+#include "StateMatrixRpcResponse.hpp"
+#include "StateSummaryRpcResponse.hpp"
+#include "EventsChunkRpcResponse.hpp"
+#include "StatsRpcResponse.hpp"
+#include "ErrorRpcResponse.hpp"
+#include "WatermarkUpdateRpcNotification.hpp"
+
+namespace tibee
+{
+
+/**
+ * Abstract RPC message encoder for analysis core messages.
+ *
+ * There's one concrete encoder per wire encoding (see
+ * common::RpcEncoding); each request is answered using the encoding
+ * of the request.
+ *
+ * @author Philippe Proulx
+ */
+class AbstractCoreRpcMessageEncoder
+{
+public:
+    virtual ~AbstractCoreRpcMessageEncoder()
+    {
+    }
+
+    /**
+     * Encodes a StatesRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeStatesRpcResponse(const StatesRpcResponse& object) = 0;
+
+    /**
+     * Encodes a StateMatrixRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeStateMatrixRpcResponse(const StateMatrixRpcResponse& object) = 0;
+
+    /**
+     * Encodes a StateSummaryRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeStateSummaryRpcResponse(const StateSummaryRpcResponse& object) = 0;
+
+    /**
+     * Encodes an EventsChunkRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeEventsChunkRpcResponse(const EventsChunkRpcResponse& object) = 0;
+
+    /**
+     * Encodes a StatsRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeStatsRpcResponse(const StatsRpcResponse& object) = 0;
+
+    /**
+     * Encodes an ErrorRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeErrorRpcResponse(const ErrorRpcResponse& object) = 0;
+
+    /**
+     * Encodes a WatermarkUpdateRpcNotification object.
+     *
+     * @param object Object to encode
+     */
+    virtual std::unique_ptr<std::string> encodeWatermarkUpdateRpcNotification(const WatermarkUpdateRpcNotification& object) = 0;
+};
+
+}
+
+#endif // _ABSTRACTCORERPCMESSAGEENCODER_HPP
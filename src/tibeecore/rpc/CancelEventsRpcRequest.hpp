@@ -0,0 +1,70 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _CANCELEVENTSRPCREQUEST_HPP
+#define _CANCELEVENTSRPCREQUEST_HPP
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Cancel events RPC request.
+ *
+ * Stops an event stream. The server answers with a last, empty chunk
+ * marked as cancelled (unless the stream was already done).
+ *
+ * @author Philippe Proulx
+ */
+class CancelEventsRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a cancel events RPC request.
+     */
+    CancelEventsRpcRequest();
+
+    /**
+     * Sets the stream ID (ID of the get events request).
+     *
+     * @param streamId Stream ID
+     */
+    void setStreamId(common::rpc_msg_id_t streamId)
+    {
+        _streamId = streamId;
+    }
+
+    /**
+     * Returns the stream ID (ID of the get events request).
+     *
+     * @returns Stream ID
+     */
+    common::rpc_msg_id_t getStreamId() const
+    {
+        return _streamId;
+    }
+
+private:
+    common::rpc_msg_id_t _streamId;
+};
+
+}
+
+#endif // _CANCELEVENTSRPCREQUEST_HPP
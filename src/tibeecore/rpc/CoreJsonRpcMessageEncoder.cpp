@@ -0,0 +1,583 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstring>
+#include <common/state/StateValueType.hpp>
+
+#include "CoreJsonRpcMessageEncoder.hpp"
+
+namespace tibee
+{
+
+CoreJsonRpcMessageEncoder::CoreJsonRpcMessageEncoder()
+{
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeStatesRpcResponse(const StatesRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreJsonRpcMessageEncoder::encodeStatesRpcResponseResult,
+                                CoreJsonRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeStateMatrixRpcResponse(const StateMatrixRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreJsonRpcMessageEncoder::encodeStateMatrixRpcResponseResult,
+                                CoreJsonRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeStateSummaryRpcResponse(const StateSummaryRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreJsonRpcMessageEncoder::encodeStateSummaryRpcResponseResult,
+                                CoreJsonRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeEventsChunkRpcResponse(const EventsChunkRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreJsonRpcMessageEncoder::encodeEventsChunkRpcResponseResult,
+                                CoreJsonRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeStatsRpcResponse(const StatsRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreJsonRpcMessageEncoder::encodeStatsRpcResponseResult,
+                                CoreJsonRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeErrorRpcResponse(const ErrorRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreJsonRpcMessageEncoder::encodeNull,
+                                CoreJsonRpcMessageEncoder::encodeErrorRpcResponseError);
+}
+
+std::unique_ptr<std::string>
+CoreJsonRpcMessageEncoder::encodeWatermarkUpdateRpcNotification(const WatermarkUpdateRpcNotification& object)
+{
+    return this->encodeNotification(object,
+                                    CoreJsonRpcMessageEncoder::encodeWatermarkUpdateRpcNotificationParams);
+}
+
+bool CoreJsonRpcMessageEncoder::encodeNull(const common::AbstractRpcMessage& msg,
+                                           ::yajl_gen yajlGen)
+{
+    ::yajl_gen_null(yajlGen);
+
+    return true;
+}
+
+void CoreJsonRpcMessageEncoder::encodeString(const std::string& str,
+                                             ::yajl_gen yajlGen)
+{
+    ::yajl_gen_string(yajlGen,
+                      reinterpret_cast<const unsigned char*>(str.c_str()),
+                      str.size());
+}
+
+void CoreJsonRpcMessageEncoder::encodeString(const char* str,
+                                             ::yajl_gen yajlGen)
+{
+    ::yajl_gen_string(yajlGen,
+                      reinterpret_cast<const unsigned char*>(str),
+                      std::strlen(str));
+}
+
+void CoreJsonRpcMessageEncoder::encodeStateValue(const StateValue& value,
+                                                 ::yajl_gen yajlGen)
+{
+    if (value.isNull) {
+        ::yajl_gen_null(yajlGen);
+
+        return;
+    }
+
+    switch (value.type) {
+    case common::StateValueType::INT32:
+    case common::StateValueType::INT64:
+        ::yajl_gen_integer(yajlGen, value.sint);
+        break;
+
+    case common::StateValueType::UINT32:
+    case common::StateValueType::UINT64:
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(value.uint));
+        break;
+
+    case common::StateValueType::FLOAT32:
+        ::yajl_gen_double(yajlGen, value.flt);
+        break;
+
+    case common::StateValueType::QUARK:
+        if (value.str) {
+            CoreJsonRpcMessageEncoder::encodeString(value.str, yajlGen);
+        } else {
+            ::yajl_gen_null(yajlGen);
+        }
+
+        break;
+    }
+}
+
+void CoreJsonRpcMessageEncoder::encodePaths(const std::vector<const char*>& paths,
+                                            ::yajl_gen yajlGen)
+{
+    ::yajl_gen_array_open(yajlGen);
+
+    for (auto path : paths) {
+        if (path) {
+            CoreJsonRpcMessageEncoder::encodeString(path, yajlGen);
+        } else {
+            ::yajl_gen_null(yajlGen);
+        }
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+}
+
+void CoreJsonRpcMessageEncoder::encodeDouble(double value, ::yajl_gen yajlGen)
+{
+    // JSON has no NaN
+    if (std::isnan(value)) {
+        ::yajl_gen_null(yajlGen);
+    } else {
+        ::yajl_gen_double(yajlGen, value);
+    }
+}
+
+bool CoreJsonRpcMessageEncoder::encodeStatesRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                              ::yajl_gen yajlGen)
+{
+    const auto& sr = static_cast<const StatesRpcResponse&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(TS, "ts");
+    TIBEE_DEF_YAJL_STR(STATES, "states");
+    TIBEE_DEF_YAJL_STR(PATH, "path");
+    TIBEE_DEF_YAJL_STR(QUARK, "quark");
+    TIBEE_DEF_YAJL_STR(BEGIN, "begin");
+    TIBEE_DEF_YAJL_STR(END, "end");
+    TIBEE_DEF_YAJL_STR(VALUE, "value");
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // timestamp
+    ::yajl_gen_string(yajlGen, TS, TS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getTs()));
+
+    // states
+    ::yajl_gen_string(yajlGen, STATES, STATES_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (const auto& state : sr.getStates()) {
+        ::yajl_gen_map_open(yajlGen);
+
+        // path
+        ::yajl_gen_string(yajlGen, PATH, PATH_LEN);
+        CoreJsonRpcMessageEncoder::encodeString(state.path, yajlGen);
+
+        // path quark
+        ::yajl_gen_string(yajlGen, QUARK, QUARK_LEN);
+        ::yajl_gen_integer(yajlGen, state.pathQuark);
+
+        // range
+        ::yajl_gen_string(yajlGen, BEGIN, BEGIN_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(state.begin));
+        ::yajl_gen_string(yajlGen, END, END_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(state.end));
+
+        // value
+        ::yajl_gen_string(yajlGen, VALUE, VALUE_LEN);
+        CoreJsonRpcMessageEncoder::encodeStateValue(state.value, yajlGen);
+
+        ::yajl_gen_map_close(yajlGen);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+bool CoreJsonRpcMessageEncoder::encodeStateMatrixRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                   ::yajl_gen yajlGen)
+{
+    const auto& smr = static_cast<const StateMatrixRpcResponse&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(TS, "ts");
+    TIBEE_DEF_YAJL_STR(PATHS, "paths");
+    TIBEE_DEF_YAJL_STR(QUARKS, "quarks");
+    TIBEE_DEF_YAJL_STR(VALUES, "values");
+
+    const auto& timestamps = smr.getTimestamps();
+    const auto& pathQuarks = smr.getPathQuarks();
+    const auto& paths = smr.getPaths();
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // timestamps (columns)
+    ::yajl_gen_string(yajlGen, TS, TS_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (auto ts : timestamps) {
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(ts));
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // paths (rows)
+    ::yajl_gen_string(yajlGen, PATHS, PATHS_LEN);
+    CoreJsonRpcMessageEncoder::encodePaths(paths, yajlGen);
+
+    // path quarks (rows)
+    ::yajl_gen_string(yajlGen, QUARKS, QUARKS_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (auto quark : pathQuarks) {
+        ::yajl_gen_integer(yajlGen, quark);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // values: one array per row
+    ::yajl_gen_string(yajlGen, VALUES, VALUES_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (std::size_t row = 0; row < pathQuarks.size(); ++row) {
+        ::yajl_gen_array_open(yajlGen);
+
+        for (std::size_t col = 0; col < timestamps.size(); ++col) {
+            CoreJsonRpcMessageEncoder::encodeStateValue(smr.getValue(row, col),
+                                                        yajlGen);
+        }
+
+        ::yajl_gen_array_close(yajlGen);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+bool CoreJsonRpcMessageEncoder::encodeStateSummaryRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                    ::yajl_gen yajlGen)
+{
+    const auto& ssr = static_cast<const StateSummaryRpcResponse&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(BEGIN, "begin");
+    TIBEE_DEF_YAJL_STR(END, "end");
+    TIBEE_DEF_YAJL_STR(BUCKETS, "buckets");
+    TIBEE_DEF_YAJL_STR(PATHS, "paths");
+    TIBEE_DEF_YAJL_STR(QUARKS, "quarks");
+    TIBEE_DEF_YAJL_STR(ROWS, "rows");
+    TIBEE_DEF_YAJL_STR(DOMINANT, "dominant");
+    TIBEE_DEF_YAJL_STR(TRANSITIONS, "transitions");
+    TIBEE_DEF_YAJL_STR(MIN, "min");
+    TIBEE_DEF_YAJL_STR(MAX, "max");
+
+    const auto& pathQuarks = ssr.getPathQuarks();
+    auto cols = ssr.getBucketsCount();
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // range
+    ::yajl_gen_string(yajlGen, BEGIN, BEGIN_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(ssr.getBegin()));
+    ::yajl_gen_string(yajlGen, END, END_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(ssr.getEnd()));
+    ::yajl_gen_string(yajlGen, BUCKETS, BUCKETS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(cols));
+
+    // paths (rows)
+    ::yajl_gen_string(yajlGen, PATHS, PATHS_LEN);
+    CoreJsonRpcMessageEncoder::encodePaths(ssr.getPaths(), yajlGen);
+
+    // path quarks (rows)
+    ::yajl_gen_string(yajlGen, QUARKS, QUARKS_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (auto quark : pathQuarks) {
+        ::yajl_gen_integer(yajlGen, quark);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // rows: one array per summary member
+    ::yajl_gen_string(yajlGen, ROWS, ROWS_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (std::size_t row = 0; row < pathQuarks.size(); ++row) {
+        ::yajl_gen_map_open(yajlGen);
+
+        ::yajl_gen_string(yajlGen, DOMINANT, DOMINANT_LEN);
+        ::yajl_gen_array_open(yajlGen);
+
+        for (std::size_t col = 0; col < cols; ++col) {
+            CoreJsonRpcMessageEncoder::encodeStateValue(ssr.getCell(row, col).dominant,
+                                                        yajlGen);
+        }
+
+        ::yajl_gen_array_close(yajlGen);
+
+        ::yajl_gen_string(yajlGen, TRANSITIONS, TRANSITIONS_LEN);
+        ::yajl_gen_array_open(yajlGen);
+
+        for (std::size_t col = 0; col < cols; ++col) {
+            ::yajl_gen_integer(yajlGen, ssr.getCell(row, col).transitions);
+        }
+
+        ::yajl_gen_array_close(yajlGen);
+
+        ::yajl_gen_string(yajlGen, MIN, MIN_LEN);
+        ::yajl_gen_array_open(yajlGen);
+
+        for (std::size_t col = 0; col < cols; ++col) {
+            CoreJsonRpcMessageEncoder::encodeDouble(ssr.getCell(row, col).min, yajlGen);
+        }
+
+        ::yajl_gen_array_close(yajlGen);
+
+        ::yajl_gen_string(yajlGen, MAX, MAX_LEN);
+        ::yajl_gen_array_open(yajlGen);
+
+        for (std::size_t col = 0; col < cols; ++col) {
+            CoreJsonRpcMessageEncoder::encodeDouble(ssr.getCell(row, col).max, yajlGen);
+        }
+
+        ::yajl_gen_array_close(yajlGen);
+
+        ::yajl_gen_map_close(yajlGen);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+bool CoreJsonRpcMessageEncoder::encodeEventsChunkRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                   ::yajl_gen yajlGen)
+{
+    const auto& ecr = static_cast<const EventsChunkRpcResponse&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(SEQ, "seq");
+    TIBEE_DEF_YAJL_STR(COUNT, "count");
+    TIBEE_DEF_YAJL_STR(LAST, "last");
+    TIBEE_DEF_YAJL_STR(CANCELLED, "cancelled");
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    ::yajl_gen_string(yajlGen, SEQ, SEQ_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(ecr.getSeq()));
+    ::yajl_gen_string(yajlGen, COUNT, COUNT_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(ecr.getCount()));
+    ::yajl_gen_string(yajlGen, LAST, LAST_LEN);
+    ::yajl_gen_bool(yajlGen, ecr.isLast());
+    ::yajl_gen_string(yajlGen, CANCELLED, CANCELLED_LEN);
+    ::yajl_gen_bool(yajlGen, ecr.isCancelled());
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+bool CoreJsonRpcMessageEncoder::encodeStatsRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                             ::yajl_gen yajlGen)
+{
+    const auto& sr = static_cast<const StatsRpcResponse&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(BEGIN, "begin");
+    TIBEE_DEF_YAJL_STR(END, "end");
+    TIBEE_DEF_YAJL_STR(WORKERS, "workers");
+    TIBEE_DEF_YAJL_STR(REQUESTS, "requests");
+    TIBEE_DEF_YAJL_STR(ERRORS, "errors");
+    TIBEE_DEF_YAJL_STR(LATENCY_P50, "latency-p50");
+    TIBEE_DEF_YAJL_STR(LATENCY_P90, "latency-p90");
+    TIBEE_DEF_YAJL_STR(LATENCY_P99, "latency-p99");
+    TIBEE_DEF_YAJL_STR(LATENCY_MAX, "latency-max");
+    TIBEE_DEF_YAJL_STR(CACHE_HITS, "cache-hits");
+    TIBEE_DEF_YAJL_STR(CACHE_MISSES, "cache-misses");
+    TIBEE_DEF_YAJL_STR(CACHE_BYTES, "cache-bytes");
+    TIBEE_DEF_YAJL_STR(PREFETCHES, "prefetches");
+    TIBEE_DEF_YAJL_STR(CLIENTS, "clients");
+    TIBEE_DEF_YAJL_STR(ID, "id");
+    TIBEE_DEF_YAJL_STR(QUEUED, "queued");
+    TIBEE_DEF_YAJL_STR(RUNNING, "running");
+    TIBEE_DEF_YAJL_STR(CANCELLED, "cancelled");
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // history range
+    ::yajl_gen_string(yajlGen, BEGIN, BEGIN_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getBegin()));
+    ::yajl_gen_string(yajlGen, END, END_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getEnd()));
+
+    // workers
+    ::yajl_gen_string(yajlGen, WORKERS, WORKERS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getWorkers()));
+
+    // requests and errors
+    ::yajl_gen_string(yajlGen, REQUESTS, REQUESTS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getRequests()));
+    ::yajl_gen_string(yajlGen, ERRORS, ERRORS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getErrors()));
+
+    // latencies
+    ::yajl_gen_string(yajlGen, LATENCY_P50, LATENCY_P50_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getLatencyP50()));
+    ::yajl_gen_string(yajlGen, LATENCY_P90, LATENCY_P90_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getLatencyP90()));
+    ::yajl_gen_string(yajlGen, LATENCY_P99, LATENCY_P99_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getLatencyP99()));
+    ::yajl_gen_string(yajlGen, LATENCY_MAX, LATENCY_MAX_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getLatencyMax()));
+
+    // result cache
+    ::yajl_gen_string(yajlGen, CACHE_HITS, CACHE_HITS_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getCacheHits()));
+    ::yajl_gen_string(yajlGen, CACHE_MISSES, CACHE_MISSES_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getCacheMisses()));
+    ::yajl_gen_string(yajlGen, CACHE_BYTES, CACHE_BYTES_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getCacheBytes()));
+    ::yajl_gen_string(yajlGen, PREFETCHES, PREFETCHES_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(sr.getPrefetches()));
+
+    // clients
+    ::yajl_gen_string(yajlGen, CLIENTS, CLIENTS_LEN);
+    ::yajl_gen_array_open(yajlGen);
+
+    for (const auto& client : sr.getClients()) {
+        ::yajl_gen_map_open(yajlGen);
+        ::yajl_gen_string(yajlGen, ID, ID_LEN);
+        CoreJsonRpcMessageEncoder::encodeString(client.id, yajlGen);
+        ::yajl_gen_string(yajlGen, QUEUED, QUEUED_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(client.queued));
+        ::yajl_gen_string(yajlGen, RUNNING, RUNNING_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(client.running));
+        ::yajl_gen_string(yajlGen, REQUESTS, REQUESTS_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(client.requests));
+        ::yajl_gen_string(yajlGen, CANCELLED, CANCELLED_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(client.cancelled));
+        ::yajl_gen_string(yajlGen, LATENCY_P50, LATENCY_P50_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(client.p50));
+        ::yajl_gen_string(yajlGen, LATENCY_P99, LATENCY_P99_LEN);
+        ::yajl_gen_integer(yajlGen, static_cast<long long int>(client.p99));
+        ::yajl_gen_map_close(yajlGen);
+    }
+
+    ::yajl_gen_array_close(yajlGen);
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+bool CoreJsonRpcMessageEncoder::encodeErrorRpcResponseError(const common::AbstractRpcMessage& msg,
+                                                            ::yajl_gen yajlGen)
+{
+    const auto& er = static_cast<const ErrorRpcResponse&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(CODE, "code");
+    TIBEE_DEF_YAJL_STR(MESSAGE, "message");
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // code
+    ::yajl_gen_string(yajlGen, CODE, CODE_LEN);
+    ::yajl_gen_integer(yajlGen, er.getCode());
+
+    // message
+    const auto& message = er.getMessage();
+
+    ::yajl_gen_string(yajlGen, MESSAGE, MESSAGE_LEN);
+    ::yajl_gen_string(yajlGen,
+                      reinterpret_cast<const unsigned char*>(message.c_str()),
+                      message.size());
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+bool CoreJsonRpcMessageEncoder::encodeWatermarkUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                                          ::yajl_gen yajlGen)
+{
+    const auto& wu = static_cast<const WatermarkUpdateRpcNotification&>(msg);
+
+    // keys
+    TIBEE_DEF_YAJL_STR(BEGIN, "begin");
+    TIBEE_DEF_YAJL_STR(WATERMARK, "watermark");
+    TIBEE_DEF_YAJL_STR(COMPLETE, "complete");
+    TIBEE_DEF_YAJL_STR(PATHS_COUNT, "paths-count");
+
+    // open object
+    ::yajl_gen_map_open(yajlGen);
+
+    // begin
+    ::yajl_gen_string(yajlGen, BEGIN, BEGIN_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(wu.getBegin()));
+
+    // watermark
+    ::yajl_gen_string(yajlGen, WATERMARK, WATERMARK_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(wu.getWatermark()));
+
+    // complete
+    ::yajl_gen_string(yajlGen, COMPLETE, COMPLETE_LEN);
+    ::yajl_gen_bool(yajlGen, wu.isComplete());
+
+    // paths count
+    ::yajl_gen_string(yajlGen, PATHS_COUNT, PATHS_COUNT_LEN);
+    ::yajl_gen_integer(yajlGen, static_cast<long long int>(wu.getPathsCount()));
+
+    // close object
+    ::yajl_gen_map_close(yajlGen);
+
+    return true;
+}
+
+}
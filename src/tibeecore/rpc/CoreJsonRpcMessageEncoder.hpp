@@ -0,0 +1,114 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _COREJSONRPCMESSAGEENCODER_HPP
+#define _COREJSONRPCMESSAGEENCODER_HPP
+
+#include <memory>
+#include <string>
+#include <common/rpc/AbstractJsonRpcMessageEncoder.hpp>
+
+#include "AbstractCoreRpcMessageEncoder.hpp"
+#include "StateValue.hpp"
+
+namespace tibee
+{
+
+/**
+ * JSON-RPC message encoder for analysis core messages.
+ *
+ * @author Philippe Proulx
+ */
+class CoreJsonRpcMessageEncoder :
+    public common::AbstractJsonRpcMessageEncoder,
+    public AbstractCoreRpcMessageEncoder
+{
+public:
+    /**
+     * Builds a JSON-RPC encoder for analysis core messages.
+     */
+    CoreJsonRpcMessageEncoder();
+
+    /**
+     * Encodes a StatesRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeStatesRpcResponse(const StatesRpcResponse& object);
+
+    /**
+     * Encodes a StateMatrixRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeStateMatrixRpcResponse(const StateMatrixRpcResponse& object);
+
+    /**
+     * Encodes a StateSummaryRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeStateSummaryRpcResponse(const StateSummaryRpcResponse& object);
+
+    /**
+     * Encodes an EventsChunkRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeEventsChunkRpcResponse(const EventsChunkRpcResponse& object);
+
+    /**
+     * Encodes a StatsRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeStatsRpcResponse(const StatsRpcResponse& object);
+
+    /**
+     * Encodes an ErrorRpcResponse object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeErrorRpcResponse(const ErrorRpcResponse& object);
+
+    /**
+     * Encodes a WatermarkUpdateRpcNotification object.
+     *
+     * @param object Object to encode
+     */
+    std::unique_ptr<std::string> encodeWatermarkUpdateRpcNotification(const WatermarkUpdateRpcNotification& object);
+
+protected:
+    static bool encodeNull(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeStatesRpcResponseResult(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeStateMatrixRpcResponseResult(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeStateSummaryRpcResponseResult(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeEventsChunkRpcResponseResult(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeStatsRpcResponseResult(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeErrorRpcResponseError(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static bool encodeWatermarkUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg, ::yajl_gen);
+    static void encodeString(const std::string& str, ::yajl_gen yajlGen);
+    static void encodeString(const char* str, ::yajl_gen yajlGen);
+    static void encodeStateValue(const StateValue& value, ::yajl_gen yajlGen);
+    static void encodePaths(const std::vector<const char*>& paths,
+                            ::yajl_gen yajlGen);
+    static void encodeDouble(double value, ::yajl_gen yajlGen);
+};
+
+}
+
+#endif // _COREJSONRPCMESSAGEENCODER_HPP
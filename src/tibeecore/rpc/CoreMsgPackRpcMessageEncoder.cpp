@@ -0,0 +1,468 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <vector>
+#include <common/state/StateValueType.hpp>
+
+#include "CoreMsgPackRpcMessageEncoder.hpp"
+
+namespace tibee
+{
+
+CoreMsgPackRpcMessageEncoder::CoreMsgPackRpcMessageEncoder()
+{
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeStatesRpcResponse(const StatesRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreMsgPackRpcMessageEncoder::encodeStatesRpcResponseResult,
+                                CoreMsgPackRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeStateMatrixRpcResponse(const StateMatrixRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreMsgPackRpcMessageEncoder::encodeStateMatrixRpcResponseResult,
+                                CoreMsgPackRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeStateSummaryRpcResponse(const StateSummaryRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreMsgPackRpcMessageEncoder::encodeStateSummaryRpcResponseResult,
+                                CoreMsgPackRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeEventsChunkRpcResponse(const EventsChunkRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreMsgPackRpcMessageEncoder::encodeEventsChunkRpcResponseResult,
+                                CoreMsgPackRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeStatsRpcResponse(const StatsRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreMsgPackRpcMessageEncoder::encodeStatsRpcResponseResult,
+                                CoreMsgPackRpcMessageEncoder::encodeNull);
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeErrorRpcResponse(const ErrorRpcResponse& object)
+{
+    return this->encodeResponse(object,
+                                CoreMsgPackRpcMessageEncoder::encodeNull,
+                                CoreMsgPackRpcMessageEncoder::encodeErrorRpcResponseError);
+}
+
+std::unique_ptr<std::string>
+CoreMsgPackRpcMessageEncoder::encodeWatermarkUpdateRpcNotification(const WatermarkUpdateRpcNotification& object)
+{
+    return this->encodeNotification(object,
+                                    CoreMsgPackRpcMessageEncoder::encodeWatermarkUpdateRpcNotificationParams);
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeNull(const common::AbstractRpcMessage& msg,
+                                              common::MsgPackWriter& writer)
+{
+    writer.writeNil();
+
+    return true;
+}
+
+void CoreMsgPackRpcMessageEncoder::encodeStateValue(const StateValue& value,
+                                                    common::MsgPackWriter& writer)
+{
+    if (value.isNull) {
+        writer.writeNil();
+
+        return;
+    }
+
+    switch (value.type) {
+    case common::StateValueType::INT32:
+    case common::StateValueType::INT64:
+        writer.writeInt(value.sint);
+        break;
+
+    case common::StateValueType::UINT32:
+    case common::StateValueType::UINT64:
+        writer.writeUint(value.uint);
+        break;
+
+    case common::StateValueType::FLOAT32:
+        writer.writeDouble(value.flt);
+        break;
+
+    case common::StateValueType::QUARK:
+        if (value.str) {
+            writer.writeString(value.str);
+        } else {
+            writer.writeNil();
+        }
+
+        break;
+    }
+}
+
+void CoreMsgPackRpcMessageEncoder::encodeStateValues(const std::vector<const StateValue*>& values,
+                                                     common::MsgPackWriter& writer)
+{
+    // numeric kind of a value: 0 (signed), 1 (unsigned), 2 (float) or -1
+    auto getKind = [] (const StateValue& value) {
+        if (value.isNull) {
+            return -1;
+        }
+
+        switch (value.type) {
+        case common::StateValueType::INT32:
+        case common::StateValueType::INT64:
+            return 0;
+
+        case common::StateValueType::UINT32:
+        case common::StateValueType::UINT64:
+            return 1;
+
+        case common::StateValueType::FLOAT32:
+            return 2;
+
+        default:
+            return -1;
+        }
+    };
+
+    int kind = values.empty() ? -1 : getKind(*values.front());
+
+    for (auto value : values) {
+        if (kind < 0 || getKind(*value) != kind) {
+            kind = -1;
+            break;
+        }
+    }
+
+    if (kind == 0) {
+        std::vector<std::int64_t> sints;
+
+        sints.reserve(values.size());
+
+        for (auto value : values) {
+            sints.push_back(value->sint);
+        }
+
+        writer.writeTypedArray(sints.data(), sints.size());
+    } else if (kind == 1) {
+        std::vector<std::uint64_t> uints;
+
+        uints.reserve(values.size());
+
+        for (auto value : values) {
+            uints.push_back(value->uint);
+        }
+
+        writer.writeTypedArray(uints.data(), uints.size());
+    } else if (kind == 2) {
+        std::vector<double> flts;
+
+        flts.reserve(values.size());
+
+        for (auto value : values) {
+            flts.push_back(value->flt);
+        }
+
+        writer.writeTypedArray(flts.data(), flts.size());
+    } else {
+        // mixed, null or string values
+        writer.writeArrayHeader(values.size());
+
+        for (auto value : values) {
+            CoreMsgPackRpcMessageEncoder::encodeStateValue(*value, writer);
+        }
+    }
+}
+
+void CoreMsgPackRpcMessageEncoder::encodePaths(const std::vector<const char*>& paths,
+                                               common::MsgPackWriter& writer)
+{
+    writer.writeArrayHeader(paths.size());
+
+    for (auto path : paths) {
+        if (path) {
+            writer.writeString(path);
+        } else {
+            writer.writeNil();
+        }
+    }
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeStatesRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                 common::MsgPackWriter& writer)
+{
+    const auto& sr = static_cast<const StatesRpcResponse&>(msg);
+    const auto& states = sr.getStates();
+
+    writer.writeMapHeader(2);
+
+    // timestamp
+    writer.writeString("ts", 2);
+    writer.writeUint(sr.getTs());
+
+    // states
+    writer.writeString("states", 6);
+    writer.writeArrayHeader(states.size());
+
+    for (const auto& state : states) {
+        writer.writeMapHeader(5);
+        writer.writeString("path", 4);
+        writer.writeString(state.path);
+        writer.writeString("quark", 5);
+        writer.writeUint(state.pathQuark);
+        writer.writeString("begin", 5);
+        writer.writeUint(state.begin);
+        writer.writeString("end", 3);
+        writer.writeUint(state.end);
+        writer.writeString("value", 5);
+        CoreMsgPackRpcMessageEncoder::encodeStateValue(state.value, writer);
+    }
+
+    return true;
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeStateMatrixRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                      common::MsgPackWriter& writer)
+{
+    const auto& smr = static_cast<const StateMatrixRpcResponse&>(msg);
+    const auto& timestamps = smr.getTimestamps();
+    const auto& pathQuarks = smr.getPathQuarks();
+
+    writer.writeMapHeader(4);
+
+    // timestamps (columns)
+    writer.writeString("ts", 2);
+    writer.writeTypedArray(timestamps.data(), timestamps.size());
+
+    // paths and path quarks (rows)
+    writer.writeString("paths", 5);
+    CoreMsgPackRpcMessageEncoder::encodePaths(smr.getPaths(), writer);
+    writer.writeString("quarks", 6);
+    writer.writeTypedArray(pathQuarks.data(), pathQuarks.size());
+
+    // values: one array per row
+    std::vector<const StateValue*> row;
+
+    row.reserve(timestamps.size());
+    writer.writeString("values", 6);
+    writer.writeArrayHeader(pathQuarks.size());
+
+    for (std::size_t r = 0; r < pathQuarks.size(); ++r) {
+        row.clear();
+
+        for (std::size_t col = 0; col < timestamps.size(); ++col) {
+            row.push_back(&smr.getValue(r, col));
+        }
+
+        CoreMsgPackRpcMessageEncoder::encodeStateValues(row, writer);
+    }
+
+    return true;
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeStateSummaryRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                       common::MsgPackWriter& writer)
+{
+    const auto& ssr = static_cast<const StateSummaryRpcResponse&>(msg);
+    const auto& pathQuarks = ssr.getPathQuarks();
+    auto cols = ssr.getBucketsCount();
+
+    writer.writeMapHeader(6);
+
+    // range
+    writer.writeString("begin", 5);
+    writer.writeUint(ssr.getBegin());
+    writer.writeString("end", 3);
+    writer.writeUint(ssr.getEnd());
+    writer.writeString("buckets", 7);
+    writer.writeUint(cols);
+
+    // paths and path quarks (rows)
+    writer.writeString("paths", 5);
+    CoreMsgPackRpcMessageEncoder::encodePaths(ssr.getPaths(), writer);
+    writer.writeString("quarks", 6);
+    writer.writeTypedArray(pathQuarks.data(), pathQuarks.size());
+
+    // rows: one map of arrays per row
+    std::vector<const StateValue*> dominants;
+    std::vector<std::uint32_t> transitions;
+    std::vector<double> mins;
+    std::vector<double> maxs;
+
+    writer.writeString("rows", 4);
+    writer.writeArrayHeader(pathQuarks.size());
+
+    for (std::size_t row = 0; row < pathQuarks.size(); ++row) {
+        dominants.clear();
+        transitions.clear();
+        mins.clear();
+        maxs.clear();
+
+        for (std::size_t col = 0; col < cols; ++col) {
+            const auto& cell = ssr.getCell(row, col);
+
+            dominants.push_back(&cell.dominant);
+            transitions.push_back(cell.transitions);
+            mins.push_back(cell.min);
+            maxs.push_back(cell.max);
+        }
+
+        writer.writeMapHeader(4);
+        writer.writeString("dominant", 8);
+        CoreMsgPackRpcMessageEncoder::encodeStateValues(dominants, writer);
+        writer.writeString("transitions", 11);
+        writer.writeTypedArray(transitions.data(), transitions.size());
+        writer.writeString("min", 3);
+        writer.writeTypedArray(mins.data(), mins.size());
+        writer.writeString("max", 3);
+        writer.writeTypedArray(maxs.data(), maxs.size());
+    }
+
+    return true;
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeEventsChunkRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                      common::MsgPackWriter& writer)
+{
+    const auto& ecr = static_cast<const EventsChunkRpcResponse&>(msg);
+
+    writer.writeMapHeader(4);
+    writer.writeString("seq", 3);
+    writer.writeUint(ecr.getSeq());
+    writer.writeString("count", 5);
+    writer.writeUint(ecr.getCount());
+    writer.writeString("last", 4);
+    writer.writeBool(ecr.isLast());
+    writer.writeString("cancelled", 9);
+    writer.writeBool(ecr.isCancelled());
+
+    return true;
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeStatsRpcResponseResult(const common::AbstractRpcMessage& msg,
+                                                                common::MsgPackWriter& writer)
+{
+    const auto& sr = static_cast<const StatsRpcResponse&>(msg);
+    const auto& clients = sr.getClients();
+
+    writer.writeMapHeader(14);
+
+    // history range
+    writer.writeString("begin", 5);
+    writer.writeUint(sr.getBegin());
+    writer.writeString("end", 3);
+    writer.writeUint(sr.getEnd());
+
+    // workers, requests and errors
+    writer.writeString("workers", 7);
+    writer.writeUint(sr.getWorkers());
+    writer.writeString("requests", 8);
+    writer.writeUint(sr.getRequests());
+    writer.writeString("errors", 6);
+    writer.writeUint(sr.getErrors());
+
+    // latencies
+    writer.writeString("latency-p50", 11);
+    writer.writeUint(sr.getLatencyP50());
+    writer.writeString("latency-p90", 11);
+    writer.writeUint(sr.getLatencyP90());
+    writer.writeString("latency-p99", 11);
+    writer.writeUint(sr.getLatencyP99());
+    writer.writeString("latency-max", 11);
+    writer.writeUint(sr.getLatencyMax());
+
+    // result cache
+    writer.writeString("cache-hits", 10);
+    writer.writeUint(sr.getCacheHits());
+    writer.writeString("cache-misses", 12);
+    writer.writeUint(sr.getCacheMisses());
+    writer.writeString("cache-bytes", 11);
+    writer.writeUint(sr.getCacheBytes());
+    writer.writeString("prefetches", 10);
+    writer.writeUint(sr.getPrefetches());
+
+    // clients
+    writer.writeString("clients", 7);
+    writer.writeArrayHeader(clients.size());
+
+    for (const auto& client : clients) {
+        writer.writeMapHeader(7);
+        writer.writeString("id", 2);
+        writer.writeString(client.id);
+        writer.writeString("queued", 6);
+        writer.writeUint(client.queued);
+        writer.writeString("running", 7);
+        writer.writeUint(client.running);
+        writer.writeString("requests", 8);
+        writer.writeUint(client.requests);
+        writer.writeString("cancelled", 9);
+        writer.writeUint(client.cancelled);
+        writer.writeString("latency-p50", 11);
+        writer.writeUint(client.p50);
+        writer.writeString("latency-p99", 11);
+        writer.writeUint(client.p99);
+    }
+
+    return true;
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeErrorRpcResponseError(const common::AbstractRpcMessage& msg,
+                                                               common::MsgPackWriter& writer)
+{
+    const auto& er = static_cast<const ErrorRpcResponse&>(msg);
+
+    writer.writeMapHeader(2);
+    writer.writeString("code", 4);
+    writer.writeInt(er.getCode());
+    writer.writeString("message", 7);
+    writer.writeString(er.getMessage());
+
+    return true;
+}
+
+bool CoreMsgPackRpcMessageEncoder::encodeWatermarkUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg,
+                                                                             common::MsgPackWriter& writer)
+{
+    const auto& wu = static_cast<const WatermarkUpdateRpcNotification&>(msg);
+
+    writer.writeMapHeader(4);
+    writer.writeString("begin", 5);
+    writer.writeUint(wu.getBegin());
+    writer.writeString("watermark", 9);
+    writer.writeUint(wu.getWatermark());
+    writer.writeString("complete", 8);
+    writer.writeBool(wu.isComplete());
+    writer.writeString("paths-count", 11);
+    writer.writeUint(wu.getPathsCount());
+
+    return true;
+}
+
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _COREMSGPACKRPCMESSAGEENCODER_HPP
+#define _COREMSGPACKRPCMESSAGEENCODER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <common/rpc/AbstractMsgPackRpcMessageEncoder.hpp>
+#include <common/rpc/MsgPackWriter.hpp>
+
+#include "AbstractCoreRpcMessageEncoder.hpp"
+#include "StateValue.hpp"
+
+namespace tibee
+{
+
+/**
+ * MessagePack RPC message encoder for analysis core messages.
+ *
+ * Messages have the same members as those of CoreJsonRpcMessageEncoder.
+ * Timestamps, quarks and numeric rows are encoded as typed arrays: a
+ * row of state values is a typed array when all its values are
+ * numbers of the same kind (signed, unsigned or floating point), and
+ * an array of values otherwise. NaN values are kept as is.
+ *
+ * @author Philippe Proulx
+ */
+class CoreMsgPackRpcMessageEncoder :
+    public common::AbstractMsgPackRpcMessageEncoder,
+    public AbstractCoreRpcMessageEncoder
+{
+public:
+    /**
+     * Builds a MessagePack encoder for analysis core messages.
+     */
+    CoreMsgPackRpcMessageEncoder();
+
+    std::unique_ptr<std::string> encodeStatesRpcResponse(const StatesRpcResponse& object);
+    std::unique_ptr<std::string> encodeStateMatrixRpcResponse(const StateMatrixRpcResponse& object);
+    std::unique_ptr<std::string> encodeStateSummaryRpcResponse(const StateSummaryRpcResponse& object);
+    std::unique_ptr<std::string> encodeEventsChunkRpcResponse(const EventsChunkRpcResponse& object);
+    std::unique_ptr<std::string> encodeStatsRpcResponse(const StatsRpcResponse& object);
+    std::unique_ptr<std::string> encodeErrorRpcResponse(const ErrorRpcResponse& object);
+    std::unique_ptr<std::string> encodeWatermarkUpdateRpcNotification(const WatermarkUpdateRpcNotification& object);
+
+protected:
+    static bool encodeNull(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeStatesRpcResponseResult(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeStateMatrixRpcResponseResult(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeStateSummaryRpcResponseResult(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeEventsChunkRpcResponseResult(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeStatsRpcResponseResult(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeErrorRpcResponseError(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static bool encodeWatermarkUpdateRpcNotificationParams(const common::AbstractRpcMessage& msg, common::MsgPackWriter& writer);
+    static void encodeStateValue(const StateValue& value,
+                                 common::MsgPackWriter& writer);
+    static void encodeStateValues(const std::vector<const StateValue*>& values,
+                                  common::MsgPackWriter& writer);
+    static void encodePaths(const std::vector<const char*>& paths,
+                            common::MsgPackWriter& writer);
+};
+
+}
+
+#endif // _COREMSGPACKRPCMESSAGEENCODER_HPP
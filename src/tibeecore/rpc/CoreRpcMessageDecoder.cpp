@@ -0,0 +1,341 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <limits>
+
+#include "CoreRpcMessageDecoder.hpp"
+#include "ErrorRpcResponse.hpp"
+#include "GetStateRpcRequest.hpp"
+#include "GetAllStatesRpcRequest.hpp"
+#include "GetStatesBatchRpcRequest.hpp"
+#include "GetStateSummaryRpcRequest.hpp"
+#include "GetEventsRpcRequest.hpp"
+#include "GrantCreditsRpcRequest.hpp"
+#include "CancelEventsRpcRequest.hpp"
+#include "GetStatsRpcRequest.hpp"
+
+namespace tibee
+{
+
+CoreRpcMessageDecoder::CoreRpcMessageDecoder() :
+    _request {nullptr},
+    _errorCode {0}
+{
+    this->addMethod("get-state", CoreRpcMessageDecoder::decodeGetState);
+    this->addMethod("get-all-states", CoreRpcMessageDecoder::decodeGetAllStates);
+    this->addMethod("get-states-batch", CoreRpcMessageDecoder::decodeGetStatesBatch);
+    this->addMethod("get-state-summary", CoreRpcMessageDecoder::decodeGetStateSummary);
+    this->addMethod("get-events", CoreRpcMessageDecoder::decodeGetEvents);
+    this->addMethod("grant-credits", CoreRpcMessageDecoder::decodeGrantCredits);
+    this->addMethod("cancel-events", CoreRpcMessageDecoder::decodeCancelEvents);
+    this->addMethod("get-stats", CoreRpcMessageDecoder::decodeGetStats);
+}
+
+template<typename RequestT>
+void CoreRpcMessageDecoder::addMethod(const std::string& method,
+                                      const char* (*decodeFunc)(const common::RpcRequestDecoder&, RequestT&))
+{
+    // the handler only remembers the decoded request
+    _dispatcher.addMethod<RequestT>(method, decodeFunc, [this] (RequestT& request) {
+        _request = &request;
+    });
+}
+
+const common::AbstractRpcRequest*
+CoreRpcMessageDecoder::decodeRequest(const char* data, std::size_t len)
+{
+    _request = nullptr;
+    _errorCode = 0;
+    _errorMessage.clear();
+
+    auto status = _dispatcher.dispatch(data, len);
+
+    switch (status) {
+    case common::RpcRequestStatus::OK:
+        return _request;
+
+    case common::RpcRequestStatus::PARSE_ERROR:
+        _errorCode = ErrorRpcResponse::PARSE_ERROR;
+        break;
+
+    case common::RpcRequestStatus::INVALID_REQUEST:
+        _errorCode = ErrorRpcResponse::INVALID_REQUEST;
+        break;
+
+    case common::RpcRequestStatus::METHOD_NOT_FOUND:
+    {
+        const auto& method = _dispatcher.getDecoder().getMethod();
+
+        _errorCode = ErrorRpcResponse::METHOD_NOT_FOUND;
+        _errorMessage = "unknown method \"" +
+                        std::string {method.data, method.len} + "\"";
+
+        return nullptr;
+    }
+
+    case common::RpcRequestStatus::INVALID_PARAMS:
+        _errorCode = ErrorRpcResponse::INVALID_PARAMS;
+        break;
+    }
+
+    _errorMessage = _dispatcher.getErrorMessage();
+
+    return nullptr;
+}
+
+std::string CoreRpcMessageDecoder::getStringParam(const char* key) const
+{
+    common::RpcString value;
+
+    if (!_dispatcher.getDecoder().getStringParam(key, value)) {
+        return std::string {};
+    }
+
+    return std::string {value.data, value.len};
+}
+
+std::string CoreRpcMessageDecoder::getClient() const
+{
+    return this->getStringParam("client");
+}
+
+unsigned int CoreRpcMessageDecoder::getPriority() const
+{
+    std::uint64_t priority;
+
+    if (!_dispatcher.getDecoder().getUintParam("priority", priority) ||
+            priority > MAX_PRIORITY) {
+        return DEFAULT_PRIORITY;
+    }
+
+    return static_cast<unsigned int>(priority);
+}
+
+std::string CoreRpcMessageDecoder::getGroup() const
+{
+    return this->getStringParam("group");
+}
+
+bool CoreRpcMessageDecoder::wantsShmBulk() const
+{
+    common::RpcString bulk;
+
+    return _dispatcher.getDecoder().getStringParam("bulk", bulk) &&
+           bulk.equals("shm");
+}
+
+bool CoreRpcMessageDecoder::decodePathsParams(const common::RpcRequestDecoder& decoder,
+                                              std::vector<std::string>& pathGlobs,
+                                              std::vector<common::quark_t>& pathQuarks)
+{
+    pathGlobs.clear();
+    pathQuarks.clear();
+
+    if (decoder.hasParam("quarks") &&
+            !decoder.getUintArrayParam("quarks", pathQuarks)) {
+        return false;
+    }
+
+    std::size_t count;
+    auto paths = decoder.getArrayParam("paths", count);
+
+    if (paths) {
+        // keep the capacity of the strings of a previous request
+        pathGlobs.resize(count);
+
+        for (std::size_t x = 0; x < count; ++x) {
+            if (paths[x].type != common::RpcValueType::STRING) {
+                return false;
+            }
+
+            pathGlobs[x].assign(paths[x].str.data, paths[x].str.len);
+        }
+    }
+
+    return true;
+}
+
+const char* CoreRpcMessageDecoder::decodeGetState(const common::RpcRequestDecoder& decoder,
+                                                  GetStateRpcRequest& request)
+{
+    std::uint64_t ts;
+    std::uint64_t quark;
+    common::RpcString path;
+
+    if (!decoder.getUintParam("ts", ts)) {
+        return "missing timestamp";
+    }
+
+    if (decoder.getUintParam("quark", quark) &&
+            quark <= std::numeric_limits<common::quark_t>::max()) {
+        request.setPathQuark(static_cast<common::quark_t>(quark));
+    } else if (decoder.getStringParam("path", path)) {
+        request.setPath(path.data, path.len);
+    } else {
+        return "missing path or quark";
+    }
+
+    request.setId(decoder.getId());
+    request.setTs(ts);
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeGetAllStates(const common::RpcRequestDecoder& decoder,
+                                                      GetAllStatesRpcRequest& request)
+{
+    std::uint64_t ts;
+
+    if (!decoder.getUintParam("ts", ts)) {
+        return "missing timestamp";
+    }
+
+    request.setId(decoder.getId());
+    request.setTs(ts);
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeGetStatesBatch(const common::RpcRequestDecoder& decoder,
+                                                        GetStatesBatchRpcRequest& request)
+{
+    auto& timestamps = request.getTimestamps();
+
+    if (!decoder.getUintArrayParam("ts", timestamps)) {
+        return "missing timestamps";
+    }
+
+    if (!std::is_sorted(timestamps.begin(), timestamps.end())) {
+        return "timestamps are not sorted";
+    }
+
+    if (!CoreRpcMessageDecoder::decodePathsParams(decoder, request.getPathGlobs(),
+                                                  request.getPathQuarks())) {
+        return "wrong quarks";
+    }
+
+    request.setId(decoder.getId());
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeGetStateSummary(const common::RpcRequestDecoder& decoder,
+                                                         GetStateSummaryRpcRequest& request)
+{
+    std::uint64_t begin;
+    std::uint64_t end;
+    std::uint64_t buckets;
+
+    if (!decoder.getUintParam("begin", begin) || !decoder.getUintParam("end", end) ||
+            begin >= end) {
+        return "wrong range";
+    }
+
+    if (!decoder.getUintParam("buckets", buckets) || buckets == 0) {
+        return "wrong number of buckets";
+    }
+
+    if (!CoreRpcMessageDecoder::decodePathsParams(decoder, request.getPathGlobs(),
+                                                  request.getPathQuarks())) {
+        return "wrong quarks";
+    }
+
+    request.setId(decoder.getId());
+    request.setRange(begin, end);
+    request.setBucketsCount(static_cast<std::size_t>(buckets));
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeGetEvents(const common::RpcRequestDecoder& decoder,
+                                                   GetEventsRpcRequest& request)
+{
+    std::uint64_t begin;
+    std::uint64_t end;
+    std::uint64_t maxEvents = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t credits = 1;
+
+    if (!decoder.getUintParam("begin", begin) || !decoder.getUintParam("end", end) ||
+            begin >= end) {
+        return "wrong range";
+    }
+
+    // optional parameters
+    if (decoder.hasParam("max") && !decoder.getUintParam("max", maxEvents)) {
+        return "wrong maximum number of events";
+    }
+
+    if (decoder.hasParam("credits") && !decoder.getUintParam("credits", credits)) {
+        return "wrong number of credits";
+    }
+
+    request.setId(decoder.getId());
+    request.setRange(begin, end);
+    request.setMaxEvents(maxEvents);
+    request.setCredits(credits);
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeGrantCredits(const common::RpcRequestDecoder& decoder,
+                                                      GrantCreditsRpcRequest& request)
+{
+    std::uint64_t streamId;
+    std::uint64_t credits;
+
+    if (!decoder.getUintParam("stream", streamId) ||
+            streamId > std::numeric_limits<common::rpc_msg_id_t>::max()) {
+        return "wrong stream ID";
+    }
+
+    if (!decoder.getUintParam("credits", credits)) {
+        return "wrong number of credits";
+    }
+
+    request.setId(decoder.getId());
+    request.setStreamId(static_cast<common::rpc_msg_id_t>(streamId));
+    request.setCredits(credits);
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeCancelEvents(const common::RpcRequestDecoder& decoder,
+                                                      CancelEventsRpcRequest& request)
+{
+    std::uint64_t streamId;
+
+    if (!decoder.getUintParam("stream", streamId) ||
+            streamId > std::numeric_limits<common::rpc_msg_id_t>::max()) {
+        return "wrong stream ID";
+    }
+
+    request.setId(decoder.getId());
+    request.setStreamId(static_cast<common::rpc_msg_id_t>(streamId));
+
+    return nullptr;
+}
+
+const char* CoreRpcMessageDecoder::decodeGetStats(const common::RpcRequestDecoder& decoder,
+                                                  GetStatsRpcRequest& request)
+{
+    request.setId(decoder.getId());
+
+    return nullptr;
+}
+
+}
@@ -0,0 +1,217 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _CORERPCMESSAGEDECODER_HPP
+#define _CORERPCMESSAGEDECODER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <common/BasicTypes.hpp>
+#include <common/rpc/RpcEncoding.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+#include <common/rpc/RpcRequestDecoder.hpp>
+#include <common/rpc/RpcRequestDispatcher.hpp>
+
+namespace tibee
+{
+
+class GetStateRpcRequest;
+class GetAllStatesRpcRequest;
+class GetStatesBatchRpcRequest;
+class GetStateSummaryRpcRequest;
+class GetEventsRpcRequest;
+class GrantCreditsRpcRequest;
+class CancelEventsRpcRequest;
+class GetStatsRpcRequest;
+
+/**
+ * RPC message decoder for analysis core requests.
+ *
+ * Requests are expected to look like this:
+ *
+ *     {"method": "get-state", "id": 23, "params": [{"path": "a/b", "ts": 1}]}
+ *
+ * The first element of \c params is an object whose values are either
+ * scalars or arrays of scalars.
+ *
+ * Requests are either JSON text or the MessagePack encoding of the
+ * same object (see common::RpcEncoding), in which case arrays may be
+ * typed arrays. The encoding is detected for each request.
+ *
+ * Any request may also have the following scheduling parameters (see
+ * QueryScheduler): \c client (client ID), \c priority (from 0 to
+ * MAX_PRIORITY, higher is more urgent) and \c group (a new request
+ * supersedes the pending requests of the same client and group).
+ *
+ * Decoding is done by a common::RpcRequestDispatcher: each method
+ * fills its own request object, reused from one request to the other,
+ * so that decoding does not allocate once warmed up.
+ *
+ * @author Philippe Proulx
+ */
+class CoreRpcMessageDecoder :
+    boost::noncopyable
+{
+public:
+    /// Priority of requests without a valid priority parameter
+    static const unsigned int DEFAULT_PRIORITY = 4;
+
+    /// Highest priority
+    static const unsigned int MAX_PRIORITY = 7;
+
+public:
+    /**
+     * Builds a decoder for analysis core requests.
+     */
+    CoreRpcMessageDecoder();
+
+    /**
+     * Decodes a request.
+     *
+     * The returned request is owned by this decoder and is only valid
+     * until the next decoding. Its concrete type is given by its
+     * method name.
+     *
+     * On error, \a nullptr is returned and getErrorCode(),
+     * getErrorMessage() and getId() may be used to build an error
+     * response.
+     *
+     * @param data Request data (JSON or MessagePack)
+     * @param len  Request data length (bytes)
+     * @returns    Decoded request or \a nullptr if any error occured
+     */
+    const common::AbstractRpcRequest* decodeRequest(const char* data,
+                                                    std::size_t len);
+
+    /**
+     * Returns the encoding of the last decoded request, with which
+     * it must be answered. Valid even if decoding failed.
+     *
+     * @returns Encoding of last decoded request
+     */
+    common::RpcEncoding getEncoding() const
+    {
+        return _dispatcher.getDecoder().getEncoding();
+    }
+
+    /**
+     * Returns the ID of the last decoded request (0 if unknown).
+     *
+     * @returns ID of last decoded request
+     */
+    common::rpc_msg_id_t getId() const
+    {
+        return _dispatcher.getDecoder().getId();
+    }
+
+    /**
+     * Returns the client ID of the last decoded request, or an empty
+     * string if unknown. Valid even if decoding failed.
+     *
+     * @returns Client ID of last decoded request
+     */
+    std::string getClient() const;
+
+    /**
+     * Returns the priority of the last decoded request, or
+     * DEFAULT_PRIORITY if unknown. Valid even if decoding failed.
+     *
+     * @returns Priority of last decoded request
+     */
+    unsigned int getPriority() const;
+
+    /**
+     * Returns the supersession group of the last decoded request, or
+     * an empty string if none. Valid even if decoding failed.
+     *
+     * @returns Supersession group of last decoded request
+     */
+    std::string getGroup() const;
+
+    /**
+     * Returns whether the client of the last decoded request asked for
+     * bulk results in shared memory (\c bulk parameter set to
+     * \c "shm"; see common::ShmBulkWriter).
+     *
+     * @returns True if the client wants shared memory bulk results
+     */
+    bool wantsShmBulk() const;
+
+    /**
+     * Returns the error code of the last decoding.
+     *
+     * @returns Error code (see ErrorRpcResponse)
+     */
+    int getErrorCode() const
+    {
+        return _errorCode;
+    }
+
+    /**
+     * Returns the error message of the last decoding.
+     *
+     * @returns Error message
+     */
+    const std::string& getErrorMessage() const
+    {
+        return _errorMessage;
+    }
+
+private:
+    template<typename RequestT>
+    void addMethod(const std::string& method,
+                   const char* (*decodeFunc)(const common::RpcRequestDecoder&, RequestT&));
+
+    std::string getStringParam(const char* key) const;
+
+    static const char* decodeGetState(const common::RpcRequestDecoder& decoder,
+                                      GetStateRpcRequest& request);
+    static const char* decodeGetAllStates(const common::RpcRequestDecoder& decoder,
+                                          GetAllStatesRpcRequest& request);
+    static const char* decodeGetStatesBatch(const common::RpcRequestDecoder& decoder,
+                                            GetStatesBatchRpcRequest& request);
+    static const char* decodeGetStateSummary(const common::RpcRequestDecoder& decoder,
+                                             GetStateSummaryRpcRequest& request);
+    static const char* decodeGetEvents(const common::RpcRequestDecoder& decoder,
+                                       GetEventsRpcRequest& request);
+    static const char* decodeGrantCredits(const common::RpcRequestDecoder& decoder,
+                                          GrantCreditsRpcRequest& request);
+    static const char* decodeCancelEvents(const common::RpcRequestDecoder& decoder,
+                                          CancelEventsRpcRequest& request);
+    static const char* decodeGetStats(const common::RpcRequestDecoder& decoder,
+                                      GetStatsRpcRequest& request);
+    static bool decodePathsParams(const common::RpcRequestDecoder& decoder,
+                                  std::vector<std::string>& pathGlobs,
+                                  std::vector<common::quark_t>& pathQuarks);
+
+private:
+    // method dispatcher (owns the request objects)
+    common::RpcRequestDispatcher _dispatcher;
+
+    // last decoded request
+    const common::AbstractRpcRequest* _request;
+
+    // last error
+    int _errorCode;
+    std::string _errorMessage;
+};
+
+}
+
+#endif // _CORERPCMESSAGEDECODER_HPP
@@ -0,0 +1,98 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _ERRORRPCRESPONSE_HPP
+#define _ERRORRPCRESPONSE_HPP
+
+#include <string>
+
+#include <common/rpc/AbstractRpcResponse.hpp>
+
+namespace tibee
+{
+
+/**
+ * Error RPC response.
+ *
+ * Sent instead of the normal response when a request cannot be
+ * satisfied. Error codes follow JSON-RPC 2.0; REQUEST_CANCELLED is
+ * specific to the analysis core.
+ *
+ * @author Philippe Proulx
+ */
+class ErrorRpcResponse :
+    public common::AbstractRpcResponse
+{
+public:
+    /// Invalid JSON
+    static const int PARSE_ERROR = -32700;
+
+    /// JSON is not a valid request object
+    static const int INVALID_REQUEST = -32600;
+
+    /// Unknown method
+    static const int METHOD_NOT_FOUND = -32601;
+
+    /// Invalid method parameters
+    static const int INVALID_PARAMS = -32602;
+
+    /// Internal error
+    static const int INTERNAL_ERROR = -32603;
+
+    /// Request was cancelled (superseded by a newer one)
+    static const int REQUEST_CANCELLED = -32800;
+
+public:
+    /**
+     * Builds an error RPC response.
+     *
+     * @param code    Error code
+     * @param message Error message
+     */
+    ErrorRpcResponse(int code, const std::string& message);
+
+    /**
+     * Returns the error code.
+     *
+     * @returns Error code
+     */
+    int getCode() const
+    {
+        return _code;
+    }
+
+    /**
+     * Returns the error message.
+     *
+     * @returns Error message
+     */
+    const std::string& getMessage() const
+    {
+        return _message;
+    }
+
+private:
+    bool hasErrorImpl() const;
+
+private:
+    int _code;
+    std::string _message;
+};
+
+}
+
+#endif // _ERRORRPCRESPONSE_HPP
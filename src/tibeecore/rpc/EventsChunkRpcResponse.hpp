@@ -0,0 +1,139 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EVENTSCHUNKRPCRESPONSE_HPP
+#define _EVENTSCHUNKRPCRESPONSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <common/rpc/AbstractRpcResponse.hpp>
+
+namespace tibee
+{
+
+/**
+ * Events chunk RPC response.
+ *
+ * Header of one chunk of an event stream; its ID is the stream ID.
+ * The events themselves travel in the next frame of the same
+ * multipart message (see EventsJsonEncoder).
+ *
+ * @author Philippe Proulx
+ */
+class EventsChunkRpcResponse :
+    public common::AbstractRpcResponse
+{
+public:
+    /**
+     * Builds an events chunk RPC response.
+     */
+    EventsChunkRpcResponse();
+
+    /**
+     * Sets the sequence number of this chunk within its stream.
+     *
+     * @param seq Sequence number (starting at 0)
+     */
+    void setSeq(std::uint64_t seq)
+    {
+        _seq = seq;
+    }
+
+    /**
+     * Returns the sequence number of this chunk within its stream.
+     *
+     * @returns Sequence number
+     */
+    std::uint64_t getSeq() const
+    {
+        return _seq;
+    }
+
+    /**
+     * Sets the number of events of this chunk.
+     *
+     * @param count Number of events
+     */
+    void setCount(std::size_t count)
+    {
+        _count = count;
+    }
+
+    /**
+     * Returns the number of events of this chunk.
+     *
+     * @returns Number of events
+     */
+    std::size_t getCount() const
+    {
+        return _count;
+    }
+
+    /**
+     * Sets whether or not this is the last chunk of its stream.
+     *
+     * @param last True if last chunk
+     */
+    void setLast(bool last)
+    {
+        _last = last;
+    }
+
+    /**
+     * Returns whether or not this is the last chunk of its stream.
+     *
+     * @returns True if last chunk
+     */
+    bool isLast() const
+    {
+        return _last;
+    }
+
+    /**
+     * Sets whether or not the stream was cancelled (implies last).
+     *
+     * @param cancelled True if cancelled
+     */
+    void setCancelled(bool cancelled)
+    {
+        _cancelled = cancelled;
+    }
+
+    /**
+     * Returns whether or not the stream was cancelled.
+     *
+     * @returns True if cancelled
+     */
+    bool isCancelled() const
+    {
+        return _cancelled;
+    }
+
+private:
+    bool hasErrorImpl() const;
+
+private:
+    std::uint64_t _seq;
+    std::size_t _count;
+    bool _last;
+    bool _cancelled;
+};
+
+}
+
+#endif // _EVENTSCHUNKRPCRESPONSE_HPP
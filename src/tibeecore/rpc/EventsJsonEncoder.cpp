@@ -0,0 +1,209 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <yajl_gen.h>
+
+#include <common/rpc/AbstractJsonRpcMessageEncoder.hpp>
+#include <common/trace/SintEventValue.hpp>
+#include <common/trace/UintEventValue.hpp>
+#include <common/trace/FloatEventValue.hpp>
+#include <common/trace/EnumEventValue.hpp>
+#include <common/trace/StringEventValue.hpp>
+#include <common/trace/ArrayEventValue.hpp>
+#include <common/trace/DictEventValue.hpp>
+#include "EventsJsonEncoder.hpp"
+
+namespace tibee
+{
+
+EventsJsonEncoder::EventsJsonEncoder() :
+    _yajlGen {nullptr},
+    _lastSize {0}
+{
+    _yajlGen = ::yajl_gen_alloc(nullptr);
+
+    // print directly to the output string instead of yajl's buffer
+    ::yajl_gen_config(_yajlGen, ::yajl_gen_print_callback,
+                      EventsJsonEncoder::print, this);
+}
+
+EventsJsonEncoder::~EventsJsonEncoder()
+{
+    if (_yajlGen) {
+        ::yajl_gen_free(_yajlGen);
+    }
+}
+
+void EventsJsonEncoder::reset()
+{
+    ::yajl_gen_reset(_yajlGen, nullptr);
+    ::yajl_gen_clear(_yajlGen);
+    _output = std::unique_ptr<std::string> {new std::string};
+    _output->reserve(_lastSize);
+    ::yajl_gen_array_open(_yajlGen);
+}
+
+void EventsJsonEncoder::print(void* ctx, const char* str, std::size_t len)
+{
+    static_cast<EventsJsonEncoder*>(ctx)->_output->append(str, len);
+}
+
+void EventsJsonEncoder::encodeString(const char* str)
+{
+    if (!str) {
+        ::yajl_gen_null(_yajlGen);
+        return;
+    }
+
+    ::yajl_gen_string(_yajlGen, reinterpret_cast<const unsigned char*>(str),
+                      std::strlen(str));
+}
+
+void EventsJsonEncoder::encodeValue(const common::AbstractEventValue& value)
+{
+    switch (value.getType()) {
+    case common::EventValueType::SINT:
+        ::yajl_gen_integer(_yajlGen, value.asSint()->getValue());
+        break;
+
+    case common::EventValueType::UINT:
+    {
+        auto uintValue = value.asUint()->getValue();
+
+        // yajl_gen_integer() takes a signed integer
+        if (uintValue > static_cast<std::uint64_t>(std::numeric_limits<long long int>::max())) {
+            auto str = std::to_string(uintValue);
+
+            ::yajl_gen_number(_yajlGen, str.c_str(), str.size());
+        } else {
+            ::yajl_gen_integer(_yajlGen, static_cast<long long int>(uintValue));
+        }
+
+        break;
+    }
+
+    case common::EventValueType::FLOAT:
+    {
+        auto floatValue = value.asFloat()->getValue();
+
+        // JSON has no NaN or infinity
+        if (std::isfinite(floatValue)) {
+            ::yajl_gen_double(_yajlGen, floatValue);
+        } else {
+            ::yajl_gen_null(_yajlGen);
+        }
+
+        break;
+    }
+
+    case common::EventValueType::ENUM:
+        this->encodeString(value.asEnum()->getLabel());
+        break;
+
+    case common::EventValueType::STRING:
+        this->encodeString(value.asString()->getValue());
+        break;
+
+    case common::EventValueType::ARRAY:
+    {
+        auto array = value.asArray();
+
+        // arrays of characters are strings
+        if (array->isString()) {
+            this->encodeString(array->getString());
+            break;
+        }
+
+        ::yajl_gen_array_open(_yajlGen);
+
+        for (std::size_t x = 0; x < array->size(); ++x) {
+            this->encodeValue(*array->get(x));
+        }
+
+        ::yajl_gen_array_close(_yajlGen);
+        break;
+    }
+
+    case common::EventValueType::DICT:
+    {
+        auto dict = value.asDict();
+
+        ::yajl_gen_map_open(_yajlGen);
+
+        for (std::size_t x = 0; x < dict->size(); ++x) {
+            this->encodeString(dict->getKeyName(x));
+            this->encodeValue(*dict->get(x));
+        }
+
+        ::yajl_gen_map_close(_yajlGen);
+        break;
+    }
+
+    default:
+        ::yajl_gen_null(_yajlGen);
+        break;
+    }
+}
+
+void EventsJsonEncoder::addEvent(common::Event& event)
+{
+    // keys
+    TIBEE_DEF_YAJL_STR(TS, "ts");
+    TIBEE_DEF_YAJL_STR(TRACE, "trace");
+    TIBEE_DEF_YAJL_STR(ID, "id");
+    TIBEE_DEF_YAJL_STR(NAME, "name");
+    TIBEE_DEF_YAJL_STR(FIELDS, "fields");
+
+    ::yajl_gen_map_open(_yajlGen);
+
+    ::yajl_gen_string(_yajlGen, TS, TS_LEN);
+    ::yajl_gen_integer(_yajlGen, static_cast<long long int>(event.getTimestamp()));
+    ::yajl_gen_string(_yajlGen, TRACE, TRACE_LEN);
+    ::yajl_gen_integer(_yajlGen, event.getTraceId());
+    ::yajl_gen_string(_yajlGen, ID, ID_LEN);
+    ::yajl_gen_integer(_yajlGen, event.getId());
+    ::yajl_gen_string(_yajlGen, NAME, NAME_LEN);
+    this->encodeString(event.getName());
+
+    ::yajl_gen_string(_yajlGen, FIELDS, FIELDS_LEN);
+
+    auto fields = event.getFields();
+
+    if (fields) {
+        this->encodeValue(*fields);
+    } else {
+        ::yajl_gen_null(_yajlGen);
+    }
+
+    ::yajl_gen_map_close(_yajlGen);
+}
+
+std::unique_ptr<std::string> EventsJsonEncoder::finish()
+{
+    ::yajl_gen_array_close(_yajlGen);
+
+    // hand the output string over (no copy)
+    _lastSize = _output->size();
+
+    return std::move(_output);
+}
+
+}
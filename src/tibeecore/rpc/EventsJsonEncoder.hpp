@@ -0,0 +1,91 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EVENTSJSONENCODER_HPP
+#define _EVENTSJSONENCODER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <yajl_gen.h>
+#include <boost/utility.hpp>
+
+#include <common/trace/Event.hpp>
+#include <common/trace/AbstractEventValue.hpp>
+
+namespace tibee
+{
+
+/**
+ * Events JSON encoder.
+ *
+ * Incrementally encodes events as a JSON array, one event at a time,
+ * so that a chunk of an event stream never needs to keep events
+ * around. Each event is an object with its timestamp ("ts"), trace
+ * ID ("trace"), event ID ("id"), name ("name") and fields
+ * ("fields").
+ *
+ * @author Philippe Proulx
+ */
+class EventsJsonEncoder :
+    boost::noncopyable
+{
+public:
+    /**
+     * Builds an events JSON encoder.
+     */
+    EventsJsonEncoder();
+
+    ~EventsJsonEncoder();
+
+    /**
+     * Starts a new array, discarding anything encoded so far.
+     */
+    void reset();
+
+    /**
+     * Appends one event to the current array.
+     *
+     * @param event Event to encode
+     */
+    void addEvent(common::Event& event);
+
+    /**
+     * Closes the current array and returns it.
+     *
+     * @returns JSON array
+     */
+    std::unique_ptr<std::string> finish();
+
+private:
+    void encodeValue(const common::AbstractEventValue& value);
+    void encodeString(const char* str);
+    static void print(void* ctx, const char* str, std::size_t len);
+
+private:
+    ::yajl_gen _yajlGen;
+
+    // output string of the array being encoded
+    std::unique_ptr<std::string> _output;
+
+    // size of the last encoded array
+    std::size_t _lastSize;
+};
+
+}
+
+#endif // _EVENTSJSONENCODER_HPP
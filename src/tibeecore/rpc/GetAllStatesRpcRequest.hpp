@@ -0,0 +1,70 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GETALLSTATESRPCREQUEST_HPP
+#define _GETALLSTATESRPCREQUEST_HPP
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Get all states RPC request.
+ *
+ * Asks for the state values of all state attributes having a state at
+ * a given timestamp.
+ *
+ * @author Philippe Proulx
+ */
+class GetAllStatesRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a get all states RPC request.
+     */
+    GetAllStatesRpcRequest();
+
+    /**
+     * Sets the timestamp at which to get the state values.
+     *
+     * @param ts Timestamp
+     */
+    void setTs(common::timestamp_t ts)
+    {
+        _ts = ts;
+    }
+
+    /**
+     * Returns the timestamp at which to get the state values.
+     *
+     * @returns Timestamp
+     */
+    common::timestamp_t getTs() const
+    {
+        return _ts;
+    }
+
+private:
+    common::timestamp_t _ts;
+};
+
+}
+
+#endif // _GETALLSTATESRPCREQUEST_HPP
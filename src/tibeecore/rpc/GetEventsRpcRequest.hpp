@@ -0,0 +1,130 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GETEVENTSRPCREQUEST_HPP
+#define _GETEVENTSRPCREQUEST_HPP
+
+#include <cstdint>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Get events RPC request.
+ *
+ * Asks for at most a given number of events between two timestamps.
+ * Events are streamed back as chunks; the ID of this request is the
+ * ID of the stream (see GrantCreditsRpcRequest and
+ * CancelEventsRpcRequest).
+ *
+ * @author Philippe Proulx
+ */
+class GetEventsRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a get events RPC request.
+     */
+    GetEventsRpcRequest();
+
+    /**
+     * Sets the time range of events.
+     *
+     * @param begin Begin timestamp
+     * @param end   End timestamp (exclusive)
+     */
+    void setRange(common::timestamp_t begin, common::timestamp_t end)
+    {
+        _begin = begin;
+        _end = end;
+    }
+
+    /**
+     * Returns the begin timestamp of events.
+     *
+     * @returns Begin timestamp
+     */
+    common::timestamp_t getBegin() const
+    {
+        return _begin;
+    }
+
+    /**
+     * Returns the end timestamp (exclusive) of events.
+     *
+     * @returns End timestamp
+     */
+    common::timestamp_t getEnd() const
+    {
+        return _end;
+    }
+
+    /**
+     * Sets the maximum number of events.
+     *
+     * @param maxEvents Maximum number of events
+     */
+    void setMaxEvents(std::uint64_t maxEvents)
+    {
+        _maxEvents = maxEvents;
+    }
+
+    /**
+     * Returns the maximum number of events.
+     *
+     * @returns Maximum number of events
+     */
+    std::uint64_t getMaxEvents() const
+    {
+        return _maxEvents;
+    }
+
+    /**
+     * Sets the initial number of credits (chunks the server may send
+     * before the client grants more).
+     *
+     * @param credits Initial number of credits
+     */
+    void setCredits(std::uint64_t credits)
+    {
+        _credits = credits;
+    }
+
+    /**
+     * Returns the initial number of credits.
+     *
+     * @returns Initial number of credits
+     */
+    std::uint64_t getCredits() const
+    {
+        return _credits;
+    }
+
+private:
+    common::timestamp_t _begin;
+    common::timestamp_t _end;
+    std::uint64_t _maxEvents;
+    std::uint64_t _credits;
+};
+
+}
+
+#endif // _GETEVENTSRPCREQUEST_HPP
@@ -0,0 +1,144 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GETSTATERPCREQUEST_HPP
+#define _GETSTATERPCREQUEST_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Get state RPC request.
+ *
+ * Asks for the state value of one state attribute, identified either
+ * by its path or by its path quark, at a given timestamp.
+ *
+ * @author Philippe Proulx
+ */
+class GetStateRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a get state RPC request.
+     */
+    GetStateRpcRequest();
+
+    /**
+     * Sets the state attribute path (clears the path quark).
+     *
+     * @param path State attribute path
+     */
+    void setPath(const std::string& path)
+    {
+        _path = path;
+        _hasPathQuark = false;
+    }
+
+    /**
+     * Sets the state attribute path (clears the path quark).
+     *
+     * @param path State attribute path
+     * @param len  State attribute path length (bytes)
+     */
+    void setPath(const char* path, std::size_t len)
+    {
+        _path.assign(path, len);
+        _hasPathQuark = false;
+    }
+
+    /**
+     * Returns the state attribute path (valid if hasPathQuark() is
+     * false).
+     *
+     * @returns State attribute path
+     */
+    const std::string& getPath() const
+    {
+        return _path;
+    }
+
+    /**
+     * Sets the state attribute path quark (clears the path).
+     *
+     * @param pathQuark State attribute path quark
+     */
+    void setPathQuark(common::quark_t pathQuark)
+    {
+        _pathQuark = pathQuark;
+        _hasPathQuark = true;
+        _path.clear();
+    }
+
+    /**
+     * Returns the state attribute path quark (valid if hasPathQuark()
+     * is true).
+     *
+     * @returns State attribute path quark
+     */
+    common::quark_t getPathQuark() const
+    {
+        return _pathQuark;
+    }
+
+    /**
+     * Returns whether the state attribute is identified by its path
+     * quark rather than by its path.
+     *
+     * @returns True if identified by its path quark
+     */
+    bool hasPathQuark() const
+    {
+        return _hasPathQuark;
+    }
+
+    /**
+     * Sets the timestamp at which to get the state value.
+     *
+     * @param ts Timestamp
+     */
+    void setTs(common::timestamp_t ts)
+    {
+        _ts = ts;
+    }
+
+    /**
+     * Returns the timestamp at which to get the state value.
+     *
+     * @returns Timestamp
+     */
+    common::timestamp_t getTs() const
+    {
+        return _ts;
+    }
+
+private:
+    std::string _path;
+    common::quark_t _pathQuark;
+    bool _hasPathQuark;
+    common::timestamp_t _ts;
+};
+
+}
+
+#endif // _GETSTATERPCREQUEST_HPP
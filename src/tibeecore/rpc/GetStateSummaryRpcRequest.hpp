@@ -0,0 +1,151 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GETSTATESUMMARYRPCREQUEST_HPP
+#define _GETSTATESUMMARYRPCREQUEST_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Get state summary RPC request.
+ *
+ * Asks for a summary (dominant value, number of transitions, min/max)
+ * of many state attributes in each of N equal time buckets of a given
+ * range. Attributes are given as path quarks and/or as path globs.
+ *
+ * @author Philippe Proulx
+ */
+class GetStateSummaryRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a get state summary RPC request.
+     */
+    GetStateSummaryRpcRequest();
+
+    /**
+     * Returns the state attribute path globs (to fill).
+     *
+     * @returns Path globs
+     */
+    std::vector<std::string>& getPathGlobs()
+    {
+        return _pathGlobs;
+    }
+
+    /**
+     * Returns the state attribute path globs.
+     *
+     * @returns Path globs
+     */
+    const std::vector<std::string>& getPathGlobs() const
+    {
+        return _pathGlobs;
+    }
+
+    /**
+     * Returns the state attribute path quarks (to fill).
+     *
+     * @returns Path quarks
+     */
+    std::vector<common::quark_t>& getPathQuarks()
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the state attribute path quarks.
+     *
+     * @returns Path quarks
+     */
+    const std::vector<common::quark_t>& getPathQuarks() const
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Sets the time range to summarize.
+     *
+     * @param begin Begin timestamp
+     * @param end   End timestamp (exclusive)
+     */
+    void setRange(common::timestamp_t begin, common::timestamp_t end)
+    {
+        _begin = begin;
+        _end = end;
+    }
+
+    /**
+     * Returns the begin timestamp of the range to summarize.
+     *
+     * @returns Begin timestamp
+     */
+    common::timestamp_t getBegin() const
+    {
+        return _begin;
+    }
+
+    /**
+     * Returns the end timestamp (exclusive) of the range to summarize.
+     *
+     * @returns End timestamp
+     */
+    common::timestamp_t getEnd() const
+    {
+        return _end;
+    }
+
+    /**
+     * Sets the number of buckets.
+     *
+     * @param bucketsCount Number of buckets
+     */
+    void setBucketsCount(std::size_t bucketsCount)
+    {
+        _bucketsCount = bucketsCount;
+    }
+
+    /**
+     * Returns the number of buckets.
+     *
+     * @returns Number of buckets
+     */
+    std::size_t getBucketsCount() const
+    {
+        return _bucketsCount;
+    }
+
+private:
+    std::vector<std::string> _pathGlobs;
+    std::vector<common::quark_t> _pathQuarks;
+    common::timestamp_t _begin;
+    common::timestamp_t _end;
+    std::size_t _bucketsCount;
+};
+
+}
+
+#endif // _GETSTATESUMMARYRPCREQUEST_HPP
@@ -0,0 +1,117 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GETSTATESBATCHRPCREQUEST_HPP
+#define _GETSTATESBATCHRPCREQUEST_HPP
+
+#include <string>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Get states batch RPC request.
+ *
+ * Asks for the state values of many state attributes at many
+ * timestamps at once. Attributes are given as path quarks and/or as
+ * path globs (shell-style wildcards, see fnmatch(3)); timestamps must
+ * be sorted.
+ *
+ * @author Philippe Proulx
+ */
+class GetStatesBatchRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a get states batch RPC request.
+     */
+    GetStatesBatchRpcRequest();
+
+    /**
+     * Returns the state attribute path globs (to fill).
+     *
+     * @returns Path globs
+     */
+    std::vector<std::string>& getPathGlobs()
+    {
+        return _pathGlobs;
+    }
+
+    /**
+     * Returns the state attribute path globs.
+     *
+     * @returns Path globs
+     */
+    const std::vector<std::string>& getPathGlobs() const
+    {
+        return _pathGlobs;
+    }
+
+    /**
+     * Returns the state attribute path quarks (to fill).
+     *
+     * @returns Path quarks
+     */
+    std::vector<common::quark_t>& getPathQuarks()
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the state attribute path quarks.
+     *
+     * @returns Path quarks
+     */
+    const std::vector<common::quark_t>& getPathQuarks() const
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the sorted timestamps (to fill).
+     *
+     * @returns Timestamps
+     */
+    std::vector<common::timestamp_t>& getTimestamps()
+    {
+        return _timestamps;
+    }
+
+    /**
+     * Returns the sorted timestamps.
+     *
+     * @returns Timestamps
+     */
+    const std::vector<common::timestamp_t>& getTimestamps() const
+    {
+        return _timestamps;
+    }
+
+private:
+    std::vector<std::string> _pathGlobs;
+    std::vector<common::quark_t> _pathQuarks;
+    std::vector<common::timestamp_t> _timestamps;
+};
+
+}
+
+#endif // _GETSTATESBATCHRPCREQUEST_HPP
@@ -0,0 +1,46 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GETSTATSRPCREQUEST_HPP
+#define _GETSTATSRPCREQUEST_HPP
+
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Get statistics RPC request.
+ *
+ * Asks for the analysis core statistics (number of requests, latency
+ * percentiles, etc.).
+ *
+ * @author Philippe Proulx
+ */
+class GetStatsRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a get statistics RPC request.
+     */
+    GetStatsRpcRequest();
+};
+
+}
+
+#endif // _GETSTATSRPCREQUEST_HPP
@@ -0,0 +1,93 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _GRANTCREDITSRPCREQUEST_HPP
+#define _GRANTCREDITSRPCREQUEST_HPP
+
+#include <cstdint>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcRequest.hpp>
+
+namespace tibee
+{
+
+/**
+ * Grant credits RPC request.
+ *
+ * Allows the server to send more chunks of an event stream. This
+ * request has no response.
+ *
+ * @author Philippe Proulx
+ */
+class GrantCreditsRpcRequest :
+    public common::AbstractRpcRequest
+{
+public:
+    /**
+     * Builds a grant credits RPC request.
+     */
+    GrantCreditsRpcRequest();
+
+    /**
+     * Sets the stream ID (ID of the get events request).
+     *
+     * @param streamId Stream ID
+     */
+    void setStreamId(common::rpc_msg_id_t streamId)
+    {
+        _streamId = streamId;
+    }
+
+    /**
+     * Returns the stream ID (ID of the get events request).
+     *
+     * @returns Stream ID
+     */
+    common::rpc_msg_id_t getStreamId() const
+    {
+        return _streamId;
+    }
+
+    /**
+     * Sets the number of credits to add.
+     *
+     * @param credits Number of credits to add
+     */
+    void setCredits(std::uint64_t credits)
+    {
+        _credits = credits;
+    }
+
+    /**
+     * Returns the number of credits to add.
+     *
+     * @returns Number of credits to add
+     */
+    std::uint64_t getCredits() const
+    {
+        return _credits;
+    }
+
+private:
+    common::rpc_msg_id_t _streamId;
+    std::uint64_t _credits;
+};
+
+}
+
+#endif // _GRANTCREDITSRPCREQUEST_HPP
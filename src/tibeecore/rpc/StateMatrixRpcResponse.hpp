@@ -0,0 +1,144 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _STATEMATRIXRPCRESPONSE_HPP
+#define _STATEMATRIXRPCRESPONSE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcResponse.hpp>
+#include "StateValue.hpp"
+
+namespace tibee
+{
+
+/**
+ * State matrix RPC response.
+ *
+ * Contains the state values of many state attributes (rows) at many
+ * timestamps (columns). Values are stored row by row.
+ *
+ * @author Philippe Proulx
+ */
+class StateMatrixRpcResponse :
+    public common::AbstractRpcResponse
+{
+public:
+    /**
+     * Builds a state matrix RPC response.
+     */
+    StateMatrixRpcResponse();
+
+    /**
+     * Returns the column timestamps (to fill).
+     *
+     * @returns Timestamps
+     */
+    std::vector<common::timestamp_t>& getTimestamps()
+    {
+        return _timestamps;
+    }
+
+    /**
+     * Returns the column timestamps.
+     *
+     * @returns Timestamps
+     */
+    const std::vector<common::timestamp_t>& getTimestamps() const
+    {
+        return _timestamps;
+    }
+
+    /**
+     * Returns the row path quarks (to fill).
+     *
+     * @returns Path quarks
+     */
+    std::vector<common::quark_t>& getPathQuarks()
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the row path quarks.
+     *
+     * @returns Path quarks
+     */
+    const std::vector<common::quark_t>& getPathQuarks() const
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the row paths (to fill). Paths point to the string
+     * database of the state history source.
+     *
+     * @returns Paths
+     */
+    std::vector<const char*>& getPaths()
+    {
+        return _paths;
+    }
+
+    /**
+     * Returns the row paths.
+     *
+     * @returns Paths
+     */
+    const std::vector<const char*>& getPaths() const
+    {
+        return _paths;
+    }
+
+    /**
+     * Returns the values, row by row (to fill).
+     *
+     * @returns Values
+     */
+    std::vector<StateValue>& getValues()
+    {
+        return _values;
+    }
+
+    /**
+     * Returns the value of row \p row at column \p col.
+     *
+     * @param row Row (attribute) index
+     * @param col Column (timestamp) index
+     * @returns   State value
+     */
+    const StateValue& getValue(std::size_t row, std::size_t col) const
+    {
+        return _values[row * _timestamps.size() + col];
+    }
+
+private:
+    bool hasErrorImpl() const;
+
+private:
+    std::vector<common::timestamp_t> _timestamps;
+    std::vector<common::quark_t> _pathQuarks;
+    std::vector<const char*> _paths;
+    std::vector<StateValue> _values;
+};
+
+}
+
+#endif // _STATEMATRIXRPCRESPONSE_HPP
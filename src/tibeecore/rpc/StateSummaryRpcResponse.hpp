@@ -0,0 +1,192 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _STATESUMMARYRPCRESPONSE_HPP
+#define _STATESUMMARYRPCRESPONSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcResponse.hpp>
+#include "StateValue.hpp"
+
+namespace tibee
+{
+
+/**
+ * State summary RPC response.
+ *
+ * Contains, for many state attributes (rows) and many time buckets
+ * (columns), the dominant value, the number of transitions and the
+ * min/max values (NaN if not numeric). Cells are stored row by row.
+ *
+ * @author Philippe Proulx
+ */
+class StateSummaryRpcResponse :
+    public common::AbstractRpcResponse
+{
+public:
+    /**
+     * One summary cell.
+     */
+    struct Cell
+    {
+        /// Dominant value (null if no state)
+        StateValue dominant;
+
+        /// Number of transitions
+        std::uint32_t transitions;
+
+        /// Minimum numeric value (NaN if unknown)
+        double min;
+
+        /// Maximum numeric value (NaN if unknown)
+        double max;
+    };
+
+public:
+    /**
+     * Builds a state summary RPC response.
+     */
+    StateSummaryRpcResponse();
+
+    /**
+     * Sets the summarized range and its number of buckets.
+     *
+     * @param begin        Begin timestamp
+     * @param end          End timestamp (exclusive)
+     * @param bucketsCount Number of buckets
+     */
+    void setRange(common::timestamp_t begin, common::timestamp_t end,
+                  std::size_t bucketsCount)
+    {
+        _begin = begin;
+        _end = end;
+        _bucketsCount = bucketsCount;
+    }
+
+    /**
+     * Returns the begin timestamp of the summarized range.
+     *
+     * @returns Begin timestamp
+     */
+    common::timestamp_t getBegin() const
+    {
+        return _begin;
+    }
+
+    /**
+     * Returns the end timestamp (exclusive) of the summarized range.
+     *
+     * @returns End timestamp
+     */
+    common::timestamp_t getEnd() const
+    {
+        return _end;
+    }
+
+    /**
+     * Returns the number of buckets (columns).
+     *
+     * @returns Number of buckets
+     */
+    std::size_t getBucketsCount() const
+    {
+        return _bucketsCount;
+    }
+
+    /**
+     * Returns the row path quarks (to fill).
+     *
+     * @returns Path quarks
+     */
+    std::vector<common::quark_t>& getPathQuarks()
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the row path quarks.
+     *
+     * @returns Path quarks
+     */
+    const std::vector<common::quark_t>& getPathQuarks() const
+    {
+        return _pathQuarks;
+    }
+
+    /**
+     * Returns the row paths (to fill). Paths point to the string
+     * database of the state history source.
+     *
+     * @returns Paths
+     */
+    std::vector<const char*>& getPaths()
+    {
+        return _paths;
+    }
+
+    /**
+     * Returns the row paths.
+     *
+     * @returns Paths
+     */
+    const std::vector<const char*>& getPaths() const
+    {
+        return _paths;
+    }
+
+    /**
+     * Returns the cells, row by row (to fill).
+     *
+     * @returns Cells
+     */
+    std::vector<Cell>& getCells()
+    {
+        return _cells;
+    }
+
+    /**
+     * Returns the cell of row \p row at column \p col.
+     *
+     * @param row Row (attribute) index
+     * @param col Column (bucket) index
+     * @returns   Cell
+     */
+    const Cell& getCell(std::size_t row, std::size_t col) const
+    {
+        return _cells[row * _bucketsCount + col];
+    }
+
+private:
+    bool hasErrorImpl() const;
+
+private:
+    common::timestamp_t _begin;
+    common::timestamp_t _end;
+    std::size_t _bucketsCount;
+    std::vector<common::quark_t> _pathQuarks;
+    std::vector<const char*> _paths;
+    std::vector<Cell> _cells;
+};
+
+}
+
+#endif // _STATESUMMARYRPCRESPONSE_HPP
@@ -0,0 +1,60 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _STATEVALUE_HPP
+#define _STATEVALUE_HPP
+
+#include <cstdint>
+
+#include <common/state/StateValueType.hpp>
+
+namespace tibee
+{
+
+/**
+ * State value as sent in RPC responses.
+ *
+ * Only the member matching \a type is meaningful. String values point
+ * to the string database of the state history source they come from,
+ * which must outlive this object.
+ *
+ * @author Philippe Proulx
+ */
+struct StateValue
+{
+    /// True if there's no state value
+    bool isNull;
+
+    /// State value type (if not null)
+    common::StateValueType type;
+
+    /// Signed integer value (INT32, INT64)
+    std::int64_t sint;
+
+    /// Unsigned integer value (UINT32, UINT64)
+    std::uint64_t uint;
+
+    /// Float value (FLOAT32)
+    double flt;
+
+    /// String value (QUARK), \a nullptr if unknown
+    const char* str;
+};
+
+}
+
+#endif // _STATEVALUE_HPP
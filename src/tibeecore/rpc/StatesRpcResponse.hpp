@@ -0,0 +1,120 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _STATESRPCRESPONSE_HPP
+#define _STATESRPCRESPONSE_HPP
+
+#include <string>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcResponse.hpp>
+#include "StateValue.hpp"
+
+namespace tibee
+{
+
+/**
+ * States RPC response.
+ *
+ * Contains the state values found at a given timestamp, with their
+ * state attribute paths and validity ranges.
+ *
+ * @author Philippe Proulx
+ */
+class StatesRpcResponse :
+    public common::AbstractRpcResponse
+{
+public:
+    /**
+     * One state value.
+     */
+    struct State
+    {
+        /// State attribute path
+        std::string path;
+
+        /// State attribute path quark
+        common::quark_t pathQuark;
+
+        /// Begin timestamp of state value
+        common::timestamp_t begin;
+
+        /// End timestamp of state value
+        common::timestamp_t end;
+
+        /// State value
+        StateValue value;
+    };
+
+public:
+    /**
+     * Builds a states RPC response.
+     */
+    StatesRpcResponse();
+
+    /**
+     * Sets the timestamp at which states were found.
+     *
+     * @param ts Timestamp
+     */
+    void setTs(common::timestamp_t ts)
+    {
+        _ts = ts;
+    }
+
+    /**
+     * Returns the timestamp at which states were found.
+     *
+     * @returns Timestamp
+     */
+    common::timestamp_t getTs() const
+    {
+        return _ts;
+    }
+
+    /**
+     * Returns the states (to fill).
+     *
+     * @returns States
+     */
+    std::vector<State>& getStates()
+    {
+        return _states;
+    }
+
+    /**
+     * Returns the states.
+     *
+     * @returns States
+     */
+    const std::vector<State>& getStates() const
+    {
+        return _states;
+    }
+
+private:
+    bool hasErrorImpl() const;
+
+private:
+    common::timestamp_t _ts;
+    std::vector<State> _states;
+};
+
+}
+
+#endif // _STATESRPCRESPONSE_HPP
@@ -0,0 +1,325 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _STATSRPCRESPONSE_HPP
+#define _STATSRPCRESPONSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcResponse.hpp>
+
+namespace tibee
+{
+
+/**
+ * Statistics RPC response.
+ *
+ * Contains analysis core statistics. Latencies are the time spent
+ * between receiving a request and sending its reply, in nanoseconds.
+ *
+ * @author Philippe Proulx
+ */
+class StatsRpcResponse :
+    public common::AbstractRpcResponse
+{
+public:
+    /**
+     * Statistics of one client.
+     */
+    struct Client
+    {
+        /// Client ID
+        std::string id;
+
+        /// Number of requests waiting for a worker
+        std::size_t queued;
+
+        /// Number of requests being processed
+        std::size_t running;
+
+        /// Number of answered requests
+        std::uint64_t requests;
+
+        /// Number of cancelled requests
+        std::uint64_t cancelled;
+
+        /// Median latency, including queueing (ns)
+        std::uint64_t p50;
+
+        /// 99th percentile latency, including queueing (ns)
+        std::uint64_t p99;
+    };
+
+public:
+    /**
+     * Builds a statistics RPC response.
+     */
+    StatsRpcResponse();
+
+    /**
+     * Sets the history begin and end timestamps.
+     *
+     * @param begin History begin timestamp
+     * @param end   History end timestamp
+     */
+    void setHistoryRange(common::timestamp_t begin, common::timestamp_t end)
+    {
+        _begin = begin;
+        _end = end;
+    }
+
+    /**
+     * Returns the history begin timestamp.
+     *
+     * @returns History begin timestamp
+     */
+    common::timestamp_t getBegin() const
+    {
+        return _begin;
+    }
+
+    /**
+     * Returns the history end timestamp.
+     *
+     * @returns History end timestamp
+     */
+    common::timestamp_t getEnd() const
+    {
+        return _end;
+    }
+
+    /**
+     * Sets the number of query workers.
+     *
+     * @param workers Number of query workers
+     */
+    void setWorkers(std::size_t workers)
+    {
+        _workers = workers;
+    }
+
+    /**
+     * Returns the number of query workers.
+     *
+     * @returns Number of query workers
+     */
+    std::size_t getWorkers() const
+    {
+        return _workers;
+    }
+
+    /**
+     * Sets the number of processed requests.
+     *
+     * @param requests Number of processed requests
+     */
+    void setRequests(std::uint64_t requests)
+    {
+        _requests = requests;
+    }
+
+    /**
+     * Returns the number of processed requests.
+     *
+     * @returns Number of processed requests
+     */
+    std::uint64_t getRequests() const
+    {
+        return _requests;
+    }
+
+    /**
+     * Sets the number of requests which led to an error.
+     *
+     * @param errors Number of erroneous requests
+     */
+    void setErrors(std::uint64_t errors)
+    {
+        _errors = errors;
+    }
+
+    /**
+     * Returns the number of requests which led to an error.
+     *
+     * @returns Number of erroneous requests
+     */
+    std::uint64_t getErrors() const
+    {
+        return _errors;
+    }
+
+    /**
+     * Sets latency statistics (ns).
+     *
+     * @param p50 Median latency
+     * @param p90 90th percentile latency
+     * @param p99 99th percentile latency
+     * @param max Maximum latency
+     */
+    void setLatencies(std::uint64_t p50, std::uint64_t p90,
+                      std::uint64_t p99, std::uint64_t max)
+    {
+        _p50 = p50;
+        _p90 = p90;
+        _p99 = p99;
+        _max = max;
+    }
+
+    /**
+     * Returns the median latency (ns).
+     *
+     * @returns Median latency (ns)
+     */
+    std::uint64_t getLatencyP50() const
+    {
+        return _p50;
+    }
+
+    /**
+     * Returns the 90th percentile latency (ns).
+     *
+     * @returns 90th percentile latency (ns)
+     */
+    std::uint64_t getLatencyP90() const
+    {
+        return _p90;
+    }
+
+    /**
+     * Returns the 99th percentile latency (ns).
+     *
+     * @returns 99th percentile latency (ns)
+     */
+    std::uint64_t getLatencyP99() const
+    {
+        return _p99;
+    }
+
+    /**
+     * Returns the maximum latency (ns).
+     *
+     * @returns Maximum latency (ns)
+     */
+    std::uint64_t getLatencyMax() const
+    {
+        return _max;
+    }
+
+    /**
+     * Sets result cache statistics.
+     *
+     * @param hits       Number of cache hits
+     * @param misses     Number of cache misses
+     * @param prefetches Number of results computed speculatively
+     * @param bytes      Current size of cached results (bytes)
+     */
+    void setCacheStats(std::uint64_t hits, std::uint64_t misses,
+                       std::uint64_t prefetches, std::size_t bytes)
+    {
+        _cacheHits = hits;
+        _cacheMisses = misses;
+        _prefetches = prefetches;
+        _cacheBytes = bytes;
+    }
+
+    /**
+     * Returns the number of result cache hits.
+     *
+     * @returns Number of cache hits
+     */
+    std::uint64_t getCacheHits() const
+    {
+        return _cacheHits;
+    }
+
+    /**
+     * Returns the number of result cache misses.
+     *
+     * @returns Number of cache misses
+     */
+    std::uint64_t getCacheMisses() const
+    {
+        return _cacheMisses;
+    }
+
+    /**
+     * Returns the number of results computed speculatively.
+     *
+     * @returns Number of prefetched results
+     */
+    std::uint64_t getPrefetches() const
+    {
+        return _prefetches;
+    }
+
+    /**
+     * Returns the current size of cached results (bytes).
+     *
+     * @returns Size of cached results
+     */
+    std::size_t getCacheBytes() const
+    {
+        return _cacheBytes;
+    }
+
+    /**
+     * Returns the statistics of clients.
+     *
+     * @returns Client statistics
+     */
+    std::vector<Client>& getClients()
+    {
+        return _clients;
+    }
+
+    /**
+     * Returns the statistics of clients.
+     *
+     * @returns Client statistics
+     */
+    const std::vector<Client>& getClients() const
+    {
+        return _clients;
+    }
+
+private:
+    bool hasErrorImpl() const;
+
+private:
+    common::timestamp_t _begin;
+    common::timestamp_t _end;
+    std::size_t _workers;
+    std::uint64_t _requests;
+    std::uint64_t _errors;
+    std::uint64_t _p50;
+    std::uint64_t _p90;
+    std::uint64_t _p99;
+    std::uint64_t _max;
+    std::uint64_t _cacheHits;
+    std::uint64_t _cacheMisses;
+    std::uint64_t _prefetches;
+    std::size_t _cacheBytes;
+    std::vector<Client> _clients;
+};
+
+}
+
+#endif // _STATSRPCRESPONSE_HPP
@@ -0,0 +1,136 @@
+/* Copyright (c) 2014 Philippe Proulx <eepp.ca>
+ *
+ * This file is part of tigerbeetle.
+ *
+ * tigerbeetle is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tigerbeetle is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tigerbeetle.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _WATERMARKUPDATERPCNOTIFICATION_HPP
+#define _WATERMARKUPDATERPCNOTIFICATION_HPP
+
+#include <cstddef>
+
+#include <common/BasicTypes.hpp>
+#include <common/rpc/AbstractRpcNotification.hpp>
+
+namespace tibee
+{
+
+/**
+ * Watermark update RPC notification.
+ *
+ * This message is published each time a new snapshot of a state
+ * history which is still being built is loaded: states may be queried
+ * within [begin, watermark).
+ *
+ * @author Philippe Proulx
+ */
+class WatermarkUpdateRpcNotification :
+    public common::AbstractRpcNotification
+{
+public:
+    /**
+     * Builds a watermark update RPC notification.
+     */
+    WatermarkUpdateRpcNotification();
+
+    /**
+     * Sets the history begin timestamp.
+     *
+     * @param begin History begin timestamp
+     */
+    void setBegin(common::timestamp_t begin)
+    {
+        _begin = begin;
+    }
+
+    /**
+     * Returns the history begin timestamp.
+     *
+     * @returns History begin timestamp
+     */
+    common::timestamp_t getBegin() const
+    {
+        return _begin;
+    }
+
+    /**
+     * Sets the watermark.
+     *
+     * @param watermark Watermark
+     */
+    void setWatermark(common::timestamp_t watermark)
+    {
+        _watermark = watermark;
+    }
+
+    /**
+     * Returns the watermark.
+     *
+     * @returns Watermark
+     */
+    common::timestamp_t getWatermark() const
+    {
+        return _watermark;
+    }
+
+    /**
+     * Sets whether or not the history is completely built.
+     *
+     * @param complete True if complete
+     */
+    void setComplete(bool complete)
+    {
+        _complete = complete;
+    }
+
+    /**
+     * Returns whether or not the history is completely built.
+     *
+     * @returns True if complete
+     */
+    bool isComplete() const
+    {
+        return _complete;
+    }
+
+    /**
+     * Sets the number of known paths.
+     *
+     * @param pathsCount Number of known paths
+     */
+    void setPathsCount(std::size_t pathsCount)
+    {
+        _pathsCount = pathsCount;
+    }
+
+    /**
+     * Returns the number of known paths.
+     *
+     * @returns Number of known paths
+     */
+    std::size_t getPathsCount() const
+    {
+        return _pathsCount;
+    }
+
+private:
+    common::timestamp_t _begin;
+    common::timestamp_t _watermark;
+    bool _complete;
+    std::size_t _pathsCount;
+};
+
+}
+
+#endif // _WATERMARKUPDATERPCNOTIFICATION_HPP